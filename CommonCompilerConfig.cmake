@@ -195,6 +195,12 @@ if(MSVC)
 		)
 
 	set(COMMON_COMPILER_DEFINITIONS ${COMMON_COMPILER_DEFINITIONS} $<$<CONFIG:Debug>:NTA_ASSERTIONS_ON>)
+	if(HTM_COUNTERS)
+	  set(COMMON_COMPILER_DEFINITIONS ${COMMON_COMPILER_DEFINITIONS} HTM_COUNTERS)
+	endif()
+	if(HTM_64BIT_INDICES)
+	  set(COMMON_COMPILER_DEFINITIONS ${COMMON_COMPILER_DEFINITIONS} HTM_64BIT_INDICES)
+	endif()
 		
 	# common libs
 	# Libraries linked by defaultwith all C++ applications
@@ -224,6 +230,12 @@ else()
 	if(NOT "${CMAKE_BUILD_TYPE}" STREQUAL "Release")
 	  set(COMMON_COMPILER_DEFINITIONS ${COMMON_COMPILER_DEFINITIONS} -DNTA_ASSERTIONS_ON)
 	endif()
+	if(HTM_COUNTERS)
+	  set(COMMON_COMPILER_DEFINITIONS ${COMMON_COMPILER_DEFINITIONS} -DHTM_COUNTERS)
+	endif()
+	if(HTM_64BIT_INDICES)
+	  set(COMMON_COMPILER_DEFINITIONS ${COMMON_COMPILER_DEFINITIONS} -DHTM_64BIT_INDICES)
+	endif()
 
 	#
 	# Set linker (ld)
@@ -395,7 +407,7 @@ else()
 	set(COMMON_OS_LIBS ${extra_lib_for_filesystem})
 
 	if("${PLATFORM}" STREQUAL "linux")
-	  list(APPEND COMMON_OS_LIBS pthread dl)
+	  list(APPEND COMMON_OS_LIBS pthread dl rt)
 	elseif("${PLATFORM}" STREQUAL "darwin")
 	  list(APPEND COMMON_OS_LIBS c++abi)
 	elseif(MSYS OR MINGW)
@@ -169,6 +169,13 @@ R"(Returns pair of:
     py_Connections.def("numSynapses",
         [](Connections &self, Segment seg) { return self.numSynapses(seg); });
 
+    py_Connections.def("getCounters", &Connections::getCounters,
+R"(Returns a dict of hot-path counters, such as segmentsCreated or synapsesAdapted.
+The dict is empty unless htm.core was built with -DHTM_COUNTERS=ON.)");
+
+    py_Connections.def("resetCounters", &Connections::resetCounters,
+        "Zero the hot-path counters.");
+
     py_Connections.def("numConnectedSynapses",
         [](Connections &self, Segment seg) {
             auto &segData = self.dataForSegment( seg );
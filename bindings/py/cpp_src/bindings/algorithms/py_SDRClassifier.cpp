@@ -80,7 +80,7 @@ R"(Argument alpha is used to adapt the weight matrix during learning.
 A larger alpha results in faster adaptation to the data.)",
             py::arg("alpha") = 0.001);
 
-        py_Classifier.def("infer", &Classifier::infer,
+        py_Classifier.def("infer", &Classifier::infer, py::call_guard<py::gil_scoped_release>(),
 R"(Compute the likelihoods for each category / bucket.
 
 Argument pattern is the SDR containing the active input bits.
@@ -92,7 +92,7 @@ Use "numpy.argmax" to find the category with the greatest probablility.)",
 
             py::arg("pattern"));
 
-        py_Classifier.def("learn", &Classifier::learn,
+        py_Classifier.def("learn", &Classifier::learn, py::call_guard<py::gil_scoped_release>(),
 R"(Learn from example data.
 
 Argument pattern is the SDR containing the active input bits.
@@ -104,9 +104,35 @@ This may also be a list for when the input has multiple categories.)",
 
         py_Classifier.def("learn", [](Classifier &self, const SDR &pattern, UInt categoryIdx)
             { self.learn( pattern, {categoryIdx} ); },
+                py::call_guard<py::gil_scoped_release>(),
                 py::arg("pattern"),
                 py::arg("classification"));
 
+        py_Classifier.def("inferBatch", [](Classifier &self, const std::vector<const SDR*> &patterns)
+            {
+                std::vector<PDF> pdfs;
+                pdfs.reserve( patterns.size() );
+                for( const auto &pattern : patterns )
+                    pdfs.push_back( self.infer( *pattern ) );
+                return pdfs;
+            }, py::call_guard<py::gil_scoped_release>(),
+R"(Run infer() on a list of SDRs, without holding the GIL.
+Returns a list of PDFs, one per pattern.)",
+            py::arg("patterns"));
+
+        py_Classifier.def("learnBatch", [](Classifier &self, const std::vector<const SDR*> &patterns,
+                                           const std::vector<UInt> &classifications)
+            {
+                NTA_CHECK( patterns.size() == classifications.size() )
+                    << "learnBatch: need one classification per pattern.";
+                for( size_t i = 0; i < patterns.size(); i++ )
+                    self.learn( *patterns[i], {classifications[i]} );
+            }, py::call_guard<py::gil_scoped_release>(),
+R"(Run learn() on a list of SDRs and their category indexes, in order, without
+holding the GIL.)",
+            py::arg("patterns"),
+            py::arg("classifications"));
+
         // TODO: Pickle support
 
 
@@ -159,7 +185,7 @@ A larger alpha results in faster adaptation to the data.)",
         py_Predictor.def("reset", &Predictor::reset,
 R"(For use with time series datasets.)");
 
-        py_Predictor.def("infer", &Predictor::infer,
+        py_Predictor.def("infer", &Predictor::infer, py::call_guard<py::gil_scoped_release>(),
 R"(Compute the likelihoods.
 
 Argument pattern is the SDR containing the active input bits.
@@ -168,7 +194,7 @@ Returns a dictionary whos keys are prediction steps, and values are PDFs.
 See help(Classifier.infer) for details about PDFs.)",
             py::arg("pattern"));
 
-        py_Predictor.def("learn", &Predictor::learn,
+        py_Predictor.def("learn", &Predictor::learn, py::call_guard<py::gil_scoped_release>(),
 R"(Learn from example data.
 
 Argument recordNum is an incrementing integer for each record.
@@ -184,6 +210,7 @@ This may also be a list for when the input has multiple categories.)",
 
         py_Predictor.def("learn", [](Predictor &self, UInt recordNum, const SDR &pattern, UInt categoryIdx)
             { self.learn( recordNum, pattern, {categoryIdx} ); },
+                py::call_guard<py::gil_scoped_release>(),
                 py::arg("recordNum"),
                 py::arg("pattern"),
                 py::arg("classification"));
@@ -21,6 +21,7 @@
 PyBind11 bindings for SpatialPooler class
 */
 
+#include <algorithm>
 #include <tuple>
 #include <iostream>
 
@@ -32,6 +33,7 @@ PyBind11 bindings for SpatialPooler class
 
 #include <htm/algorithms/SpatialPooler.hpp>
 #include <htm/types/Sdr.hpp>
+#include <htm/types/SdrBatch.hpp>
 
 #include "bindings/engine/py_utils.hpp"
 
@@ -229,6 +231,22 @@ Argument wrapAround boolean value that determines whether or not inputs
         py_SpatialPooler.def("setIterationNum", &SpatialPooler::setIterationNum);
         py_SpatialPooler.def("getIterationLearnNum", &SpatialPooler::getIterationLearnNum);
         py_SpatialPooler.def("setIterationLearnNum", &SpatialPooler::setIterationLearnNum);
+        py_SpatialPooler.def("getCounters", &SpatialPooler::getCounters,
+R"(Returns a dict of hot-path counters of the SP and its Connections, the
+latter prefixed with "connections.".  The dict is empty unless htm.core was
+built with -DHTM_COUNTERS=ON.)");
+        py_SpatialPooler.def("resetCounters", &SpatialPooler::resetCounters,
+            "Zero the hot-path counters of the SP and its Connections.");
+        py_SpatialPooler.def("setMemoryPolicy", [](SpatialPooler &self, const std::string &policy)
+            { self.setMemoryPolicy( MemoryPolicy::parse( policy ) ); },
+R"(Select the page size and NUMA placement of the SP's synapse storage, see
+TemporalMemory.setMemoryPolicy().)",
+            py::arg("policy"));
+        py_SpatialPooler.def("setNumThreads", &SpatialPooler::setNumThreads,
+R"(Learn with this many worker threads.  The learned model is identical to
+learning on one thread.  The default is 1, the setting is not pickled.)",
+            py::arg("numThreads"));
+        py_SpatialPooler.def("getNumThreads", &SpatialPooler::getNumThreads);
         py_SpatialPooler.def("getSpVerbosity", &SpatialPooler::getSpVerbosity);
         py_SpatialPooler.def("setSpVerbosity", &SpatialPooler::setSpVerbosity);
         py_SpatialPooler.def("getWrapAround", &SpatialPooler::getWrapAround);
@@ -276,8 +294,12 @@ Argument wrapAround boolean value that determines whether or not inputs
         // compute
         py_SpatialPooler.def("compute", [](SpatialPooler& self, const SDR& input, const bool learn, SDR& output)
             { 
-	      const auto& overlaps = self.compute( input, learn, output ); 
-	      return py::array_t<SynapseIdx>( overlaps.size(), overlaps.data());  
+	      std::vector<SynapseIdx> overlaps;
+	      {
+	        py::gil_scoped_release release;
+	        overlaps = self.compute( input, learn, output );
+	      }
+	      return py::array_t<SynapseIdx>( overlaps.size(), overlaps.data());
 	    },
 R"(
 This is the main workhorse method of the SpatialPooler class. This method
@@ -307,6 +329,82 @@ Argument output An SDR representing the winning columns after
         py::arg("output")
         ); 
 
+        // computeBatch
+        // The SDRBatch overload is registered first so that pybind does not
+        // try to convert an SDRBatch (which is a sequence) into a numpy array.
+        py_SpatialPooler.def("computeBatch", [](SpatialPooler& self, const SDRBatch& inputs, const bool learn)
+            {
+              NTA_CHECK( inputs.dimensions() == self.getInputDimensions() )
+                  << "computeBatch: SDRBatch dimensions do not match the input dimensions.";
+              auto outputs = std::make_shared<SDRBatch>( self.getColumnDimensions() );
+              {
+                py::gil_scoped_release release;
+                SDR input( self.getInputDimensions() );
+                SDR output( self.getColumnDimensions() );
+                outputs->reserve( inputs.size(), 0u );
+                for(size_t row = 0; row < inputs.size(); row++) {
+                  inputs.get( row, input );
+                  self.compute( input, learn, output );
+                  outputs->push_back( output );
+                }
+              }
+              return outputs;
+            },
+R"(
+Run compute() on every SDR in an SDRBatch, without holding the GIL.
+Returns a new SDRBatch with the active columns for each input.)",
+        py::arg("inputs"),
+        py::arg("learn") = true);
+
+        py_SpatialPooler.def("computeBatch", [](SpatialPooler& self, const DenseBatch& inputs, const bool learn)
+            {
+              const size_t rows = batch_rows( inputs, self.getNumInputs() );
+              DenseBatch outputs({ rows, static_cast<size_t>(self.getNumColumns()) });
+              const UInt8 *in  = inputs.data();
+              UInt8       *out = outputs.mutable_data();
+              {
+                py::gil_scoped_release release;
+                SDR input( self.getInputDimensions() );
+                SDR output( self.getColumnDimensions() );
+                for(size_t row = 0; row < rows; row++) {
+                  input.setDense( in + row * input.size );
+                  self.compute( input, learn, output );
+                  const auto &dense = output.getDense();
+                  std::copy( dense.begin(), dense.end(), out + row * output.size );
+                }
+              }
+              return outputs;
+            },
+R"(
+Run compute() on many inputs with one call, without holding the GIL.
+
+Argument inputs A 2-D numpy array with one dense input per row, and
+        getNumInputs() columns.  Rows are computed in order.
+
+Argument learn Same as compute().
+
+Returns a 2-D numpy array of dense outputs, one row per input and
+        getNumColumns() columns.
+)",
+        py::arg("inputs"),
+        py::arg("learn") = true);
+
+        py_SpatialPooler.def("computeBatch", [](SpatialPooler& self, const std::vector<const SDR*>& inputs,
+                                                const std::vector<SDR*>& outputs, const bool learn)
+            {
+              NTA_CHECK( inputs.size() == outputs.size() ) << "computeBatch: need one output SDR per input SDR.";
+              py::gil_scoped_release release;
+              for(size_t i = 0; i < inputs.size(); i++) {
+                self.compute( *inputs[i], learn, *outputs[i] );
+              }
+            },
+R"(
+Run compute() on a list of input SDRs, writing into a list of output SDRs of
+the same length.  Does not hold the GIL.)",
+        py::arg("inputs"),
+        py::arg("outputs"),
+        py::arg("learn") = true);
+
         // setBoostFactors
         py_SpatialPooler.def("setBoostFactors", [](SpatialPooler& self, py::array& x)
         {
@@ -27,7 +27,10 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+
 #include <htm/algorithms/TemporalMemory.hpp>
+#include <htm/types/SdrBatch.hpp>
 
 #include "bindings/engine/py_utils.hpp"
 
@@ -233,19 +236,21 @@ Argument anomalyMode (optional, default ANMode::RAW) selects mode for `TM.anomal
         py_HTM.def("activateCells", [](HTM_t& self, const SDR& activeColumns, bool learn)
         {
             self.activateCells(activeColumns, learn);
-        },
+        }, py::call_guard<py::gil_scoped_release>(),
 R"(Calculate the active cells, using the current active columns and
 dendrite segments.  Grow and reinforce synapses.)"
             , py::arg("activeColumns"), py::arg("learn") = true);
 
         py_HTM.def("compute", [](HTM_t& self, const SDR &activeColumns, bool learn)
             { self.compute(activeColumns, learn); },
+                py::call_guard<py::gil_scoped_release>(),
                 py::arg("activeColumns"),
                 py::arg("learn") = true);
 
         py_HTM.def("compute", [](HTM_t& self, const SDR &activeColumns, bool learn,
                                  const SDR &externalPredictiveInputsActive, const SDR &externalPredictiveInputsWinners)
             { self.compute(activeColumns, learn, externalPredictiveInputsActive, externalPredictiveInputsWinners); },
+                py::call_guard<py::gil_scoped_release>(),
 R"(Perform one time step of the Temporal Memory algorithm.
 
 This method calls activateDendrites, then calls activateCells. Using
@@ -272,6 +277,79 @@ Argument externalPredictiveInputsWinners
                 py::arg("externalPredictiveInputsActive"),
                 py::arg("externalPredictiveInputsWinners"));
 
+        // Registered before the numpy overload, see SpatialPooler.computeBatch.
+        py_HTM.def("computeBatch", [](HTM_t& self, const SDRBatch &activeColumns, bool learn)
+            {
+              NTA_CHECK( activeColumns.dimensions() == self.getColumnDimensions() )
+                  << "computeBatch: SDRBatch dimensions do not match the column dimensions.";
+              auto cellDims = self.getColumnDimensions();
+              cellDims.push_back( static_cast<UInt32>(self.getCellsPerColumn()) );
+              auto activeCells = std::make_shared<SDRBatch>( cellDims );
+              py::array_t<Real> anomaly( activeColumns.size() );
+              Real *outAnomaly = anomaly.mutable_data();
+              {
+                py::gil_scoped_release release;
+                SDR columns( self.getColumnDimensions() );
+                SDR cells( cellDims );
+                activeCells->reserve( activeColumns.size(), 0u );
+                for(size_t row = 0; row < activeColumns.size(); row++) {
+                  activeColumns.get( row, columns );
+                  self.compute( columns, learn );
+                  self.getActiveCells( cells );
+                  activeCells->push_back( cells );
+                  outAnomaly[row] = self.anomaly;
+                }
+              }
+              return py::make_tuple( activeCells, anomaly );
+            },
+R"(Run compute() on every SDR in an SDRBatch, as one sequence, without holding
+the GIL.  Returns a tuple (activeCells, anomaly) where activeCells is a new
+SDRBatch and anomaly is a numpy array with the anomaly score of each step.)",
+                py::arg("activeColumns"),
+                py::arg("learn") = true);
+
+        py_HTM.def("computeBatch", [](HTM_t& self, const DenseBatch &activeColumns, bool learn)
+            {
+              const size_t numColumns = self.numberOfColumns();
+              const size_t numCells   = self.numberOfCells();
+              const size_t rows       = batch_rows( activeColumns, numColumns );
+              DenseBatch activeCells({ rows, numCells });
+              py::array_t<Real> anomaly( rows );
+              const UInt8 *in    = activeColumns.data();
+              UInt8 *out         = activeCells.mutable_data();
+              Real  *outAnomaly  = anomaly.mutable_data();
+              {
+                py::gil_scoped_release release;
+                SDR columns( self.getColumnDimensions() );
+                auto cellDims = self.getColumnDimensions();
+                cellDims.push_back( static_cast<UInt32>(self.getCellsPerColumn()) );
+                SDR cells( cellDims );
+                for(size_t row = 0; row < rows; row++) {
+                  columns.setDense( in + row * numColumns );
+                  self.compute( columns, learn );
+                  self.getActiveCells( cells );
+                  const auto &dense = cells.getDense();
+                  std::copy( dense.begin(), dense.end(), out + row * numCells );
+                  outAnomaly[row] = self.anomaly;
+                }
+              }
+              return py::make_tuple( activeCells, anomaly );
+            },
+R"(Run compute() on many time steps with one call, without holding the GIL.
+
+Argument activeColumns
+    A 2-D numpy array with the dense active mini-columns of one time step per
+    row.  Rows are computed in order, as one sequence.
+
+Argument learn
+    Whether or not learning is enabled.
+
+Returns a tuple (activeCells, anomaly).  activeCells is a 2-D numpy array
+with the dense active cells of each time step, anomaly is a numpy array with
+the anomaly score of each time step.)",
+                py::arg("activeColumns"),
+                py::arg("learn") = true);
+
         py_HTM.def("reset", &HTM_t::reset,
 R"(Indicates the start of a new sequence.
 Resets sequence state of the TM.)");
@@ -321,6 +399,15 @@ See TM.compute() for details of the parameters.)",
             { return self.getPredictiveCells();},
 R"()");
 
+        py_HTM.def("getPredictiveColumns", [](const HTM_t& self)
+        {
+            SDR *predictiveColumns = new SDR( self.getColumnDimensions() );
+            self.getPredictiveColumns(*predictiveColumns);
+            return predictiveColumns;
+        },
+R"(Returns an SDR of the columns which contain a predictive cell.  Same as
+cellsToColumns(getPredictiveCells()), without recomputing it.)");
+
         py_HTM.def("getWinnerCells", [](const HTM_t& self)
         {
             auto dims = self.getColumnDimensions();
@@ -375,6 +462,32 @@ Argument cells
 
 Returns SDR with bits that represents columns.)");
 
+        py_HTM.def("getCounters", &HTM_t::getCounters,
+R"(Returns a dict of hot-path counters of the TM and its Connections, the
+latter prefixed with "connections.", for example burstingColumns or
+connections.segmentsCreated.  The dict is empty unless htm.core was built with
+-DHTM_COUNTERS=ON.)");
+
+        py_HTM.def("resetCounters", &HTM_t::resetCounters,
+R"(Zero the hot-path counters of the TM and its Connections.)");
+
+        py_HTM.def("reorder", &HTM_t::reorder,
+R"(Renumber the segments and synapses for locality of memory access.  After a
+long run they are scattered in creation order, which slows down learning.  The
+TM's output is not affected.)");
+
+        py_HTM.def_property("reorderPeriod", &HTM_t::getReorderPeriod, &HTM_t::setReorderPeriod,
+R"(Call reorder() automatically after every reorderPeriod-th learning step.
+Zero, the default, disables it.  Not pickled.)");
+
+        py_HTM.def("setMemoryPolicy", [](HTM_t &self, const std::string &policy)
+            { self.setMemoryPolicy( MemoryPolicy::parse( policy ) ); },
+R"(Select the page size and NUMA placement of the TM's synapse storage, for
+models of many GB.  Argument policy is "default", or a '+' separated list of
+"huge" (2 MB transparent huge pages), "interleave" (spread over all NUMA nodes)
+and "node:N" (keep on NUMA node N), for example "huge+interleave".)",
+            py::arg("policy"));
+
         py_HTM.def("numberOfCells",   &HTM_t::numberOfCells,
 R"(Returns the number of cells in this TemporalMemory.)");
 
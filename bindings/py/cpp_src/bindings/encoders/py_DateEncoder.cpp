@@ -151,13 +151,19 @@ fields are filled in.)");
 
     py_DateEnc.def("encode", [](DateEncoder &self, std::chrono::system_clock::time_point time_point) {
         auto output = new SDR( self.dimensions );
-        self.encode( time_point, *output );
+        {
+            py::gil_scoped_release release;
+            self.encode( time_point, *output );
+        }
         return output; },
 R"(Encodes a .py datetime.datetime into an SDR structure. )", 
       py::return_value_policy::take_ownership);
       
       py_DateEnc.def("encode", [](DateEncoder &self, std::chrono::system_clock::time_point time_point, SDR* output) {
-        self.encode( time_point, *output );
+        {
+            py::gil_scoped_release release;
+            self.encode( time_point, *output );
+        }
         return output; },
 R"(Encodes a .py datetime.datetime into an SDR structure. )");
   }
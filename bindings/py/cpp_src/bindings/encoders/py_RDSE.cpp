@@ -18,9 +18,12 @@
 #include <bindings/suppress_register.hpp>  //include before pybind11.h
 #include <pybind11/pybind11.h>
 #include <pybind11/iostream.h>
+#include <pybind11/numpy.h>
 
 #include <htm/encoders/RandomDistributedScalarEncoder.hpp>
 
+#include "bindings/engine/py_utils.hpp"
+
 namespace py = pybind11;
 
 using namespace htm;
@@ -108,14 +111,25 @@ fields are filled in automatically.)");
         py_RDSE.def_property_readonly("size",
             [](RDSE &self) { return self.size; });
 
-        py_RDSE.def("encode", &RDSE::encode, R"()");
+        py_RDSE.def("encode", &RDSE::encode, py::call_guard<py::gil_scoped_release>(), R"()");
 
         py_RDSE.def("encode", [](RDSE &self, Real64 value) {
             auto sdr = new SDR({self.size});
-            self.encode(value, *sdr);
+            {
+                py::gil_scoped_release release;
+                self.encode(value, *sdr);
+            }
             return sdr;
         });
 
+        py_RDSE.def("encodeBatch", [](RDSE &self, const py::array_t<Real64, py::array::forcecast> &values) {
+            return encode_batch( self, values );
+        },
+R"(Encode many values with one call, without holding the GIL.
+Argument values is a 1-D numpy array.  Returns a 2-D numpy array with the
+dense encoding of one value per row.)",
+            py::arg("values"));
+
 
 	// Serialization
 	// loadFromString
@@ -24,6 +24,8 @@ namespace py = pybind11;
 #include <htm/encoders/ScalarEncoder.hpp>
 #include <htm/types/Sdr.hpp>
 
+#include "bindings/engine/py_utils.hpp"
+
 namespace htm_ext
 {
   using namespace htm;
@@ -115,12 +117,22 @@ fields are filled in automatically.)");
     py_ScalarEnc.def_property_readonly("size",
         [](const ScalarEncoder &self) { return self.size; });
 
-    py_ScalarEnc.def("encode", &ScalarEncoder::encode, R"()");
+    py_ScalarEnc.def("encode", &ScalarEncoder::encode, py::call_guard<py::gil_scoped_release>(), R"()");
 
     py_ScalarEnc.def("encode", [](ScalarEncoder &self, htm::Real64 value) {
         auto output = new SDR( self.dimensions );
-        self.encode( value, *output );
+        {
+            py::gil_scoped_release release;
+            self.encode( value, *output );
+        }
         return output; },
 R"()");
+
+    py_ScalarEnc.def("encodeBatch", [](ScalarEncoder &self, const py::array_t<htm::Real64, py::array::forcecast> &values) {
+        return encode_batch( self, values ); },
+R"(Encode many values with one call, without holding the GIL.
+Argument values is a 1-D numpy array.  Returns a 2-D numpy array with the
+dense encoding of one value per row.)",
+        py::arg("values"));
   }
 }
@@ -233,15 +233,18 @@ This is the total number of bits in the encoded output SDR.
     //  1. Explain
     py_SimHashDocumentEncoder.def("encode", // alt: simple string. Define 1st!
       (void (SimHashDocumentEncoder::*)(std::string, htm::SDR &))
-        &SimHashDocumentEncoder::encode);
+        &SimHashDocumentEncoder::encode, py::call_guard<py::gil_scoped_release>());
     py_SimHashDocumentEncoder.def("encode", // main: list.
       (void (SimHashDocumentEncoder::*)(std::vector<std::string>, htm::SDR &))
-        &SimHashDocumentEncoder::encode);
+        &SimHashDocumentEncoder::encode, py::call_guard<py::gil_scoped_release>());
     //  2. Details
     py_SimHashDocumentEncoder.def("encode", // alt: simple string. Define 1st!
       [](SimHashDocumentEncoder &self, std::string value) {
         auto output = new SDR({ self.size });
-        self.encode( value, *output );
+        {
+          py::gil_scoped_release release;
+          self.encode( value, *output );
+        }
         return output;
       },
 R"(
@@ -253,7 +256,10 @@ whitespace). Ex: "alpha bravo delta echo".
     py_SimHashDocumentEncoder.def("encode", // main: list.
       [](SimHashDocumentEncoder &self, std::vector<std::string> value) {
         auto output = new SDR({ self.size });
-        self.encode( value, *output );
+        {
+          py::gil_scoped_release release;
+          self.encode( value, *output );
+        }
         return output;
       },
 R"(
@@ -31,6 +31,7 @@ namespace htm_ext
 {
     void init_Engine(py::module&);
     void init_Timer(py::module&);
+    void init_SharedMemory(py::module&);
 } // namespace htm_ext
 
 using namespace htm_ext;
@@ -40,4 +41,5 @@ PYBIND11_MODULE(engine_internal, m) {
 
     init_Engine(m);
     init_Timer(m);
+    init_SharedMemory(m);
 }
@@ -429,6 +429,15 @@ namespace htm_ext
             .def("getMinEnabledPhase", &htm::Network::getMinPhase)
             .def("getMaxEnabledPhase", &htm::Network::getMaxPhase)
             .def("setPhases",          &htm::Network::setPhases)
+            .def("setComputePeriod",   &htm::Network::setComputePeriod,
+                 py::arg("name"), py::arg("period"), py::arg("offset") = 0u)
+            .def("getComputePeriod",   &htm::Network::getComputePeriod)
+            .def("getComputeOffset",   &htm::Network::getComputeOffset)
+            .def("setBatchSize",       &htm::Network::setBatchSize, py::arg("k"))
+            .def("getBatchSize",       &htm::Network::getBatchSize)
+            .def("setPartition",       &htm::Network::setPartition,
+                 py::arg("partition"), py::arg("linkPrefix") = "")
+            .def("getPartition",       &htm::Network::getPartition)
             .def("run",                &htm::Network::run);
 
         py_Network.def("initialize", &htm::Network::initialize);
@@ -437,6 +446,8 @@ namespace htm_ext
             .def("load",            &htm::Network::load)
             .def("saveToFile",      &htm::Network::saveToFile, py::arg("file"), py::arg("fmt") = SerializableFormat::BINARY)
             .def("loadFromFile",    &htm::Network::loadFromFile, py::arg("file"), py::arg("fmt") = SerializableFormat::BINARY)
+            .def("saveToFileSectioned",   &htm::Network::saveToFileSectioned, py::arg("file"), py::arg("fmt") = SerializableFormat::BINARY)
+            .def("loadFromFileSectioned", &htm::Network::loadFromFileSectioned, py::arg("file"), py::arg("numThreads") = 0, py::arg("lazy") = false)
             .def("__eq__",          &htm::Network::operator==);
             
         py_Network.def(py::pickle(
@@ -0,0 +1,174 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+PyBind11 bindings for the SharedMemoryReader class
+*/
+
+
+#include <bindings/suppress_register.hpp>  //include before pybind11.h
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <htm/ntypes/BasicType.hpp>
+#include <htm/os/SharedMemory.hpp>
+#include <htm/utils/Log.hpp>
+
+#include <cstdint>
+#include <memory> // shared_ptr
+
+namespace py = pybind11;
+
+using namespace std;
+using namespace htm;
+
+namespace htm_ext
+{
+    // A frame, together with the reader that owns its memory.
+    struct PyFrame {
+        shared_ptr<SharedMemoryReader> reader;
+        SharedMemoryFrame frame;
+    };
+
+    static py::dtype channelDtype(NTA_BasicType type)
+    {
+        switch (type) {
+        case NTA_BasicType_Byte:
+        case NTA_BasicType_SDR:    return py::dtype::of<uint8_t>();
+        case NTA_BasicType_Int16:  return py::dtype::of<Int16>();
+        case NTA_BasicType_UInt16: return py::dtype::of<UInt16>();
+        case NTA_BasicType_Int32:  return py::dtype::of<Int32>();
+        case NTA_BasicType_UInt32: return py::dtype::of<UInt32>();
+        case NTA_BasicType_Int64:  return py::dtype::of<Int64>();
+        case NTA_BasicType_UInt64: return py::dtype::of<UInt64>();
+        case NTA_BasicType_Real32: return py::dtype::of<Real32>();
+        case NTA_BasicType_Real64: return py::dtype::of<Real64>();
+        case NTA_BasicType_Bool:   return py::dtype::of<bool>();
+        default:
+            NTA_THROW << "SharedMemoryReader: unsupported channel type " << BasicType::getName(type);
+        }
+    }
+
+    // A read-only numpy view of a channel, which keeps the mapping alive.
+    static py::array channelView(const PyFrame &self, size_t i)
+    {
+        const SharedMemoryChannel &ch = self.reader->getChannels()[i];
+        auto keepAlive = py::capsule( new shared_ptr<SharedMemoryReader>( self.reader ),
+            [](void *p) { delete reinterpret_cast<shared_ptr<SharedMemoryReader>*>(p); });
+        py::array view(channelDtype(ch.type), { ch.count }, self.frame.getChannel(i), keepAlive);
+        view.attr("setflags")(py::arg("write") = false);
+        return view;
+    }
+
+    static size_t channelIndex(const PyFrame &self, const string &name)
+    {
+        const auto &channels = self.reader->getChannels();
+        for (size_t i = 0u; i < channels.size(); i++) {
+            if (channels[i].name == name)
+                return i;
+        }
+        throw py::key_error(name);
+    }
+
+    void init_SharedMemory(py::module& m)
+    {
+        py::class_<PyFrame> py_Frame(m, "SharedMemoryFrame",
+R"(One frame of a shared memory ring buffer.  Index it with a channel name or
+number to get a read-only numpy view of the data, nothing is copied.  Check
+isValid() after using the data: if the writer reused the slot meanwhile, the
+data must be discarded.)");
+
+        py_Frame.def_property_readonly("frame", [](const PyFrame &self) { return self.frame.getFrame(); },
+            "The frame number, counting from 0.");
+
+        py_Frame.def("isValid", [](const PyFrame &self) { return self.reader->isValid(self.frame); },
+            "Returns True if the frame was not overwritten since it was read.");
+
+        py_Frame.def("keys", [](const PyFrame &self) {
+                vector<string> names;
+                for (const auto &ch : self.reader->getChannels())
+                    names.push_back(ch.name);
+                return names; },
+            "The channel names.");
+
+        py_Frame.def("__getitem__", [](const PyFrame &self, const string &name) {
+                return channelView(self, channelIndex(self, name)); });
+
+        py_Frame.def("__getitem__", [](const PyFrame &self, size_t i) {
+                if (i >= self.reader->getChannels().size())
+                    throw py::index_error();
+                return channelView(self, i); });
+
+        py::class_<SharedMemoryReader, shared_ptr<SharedMemoryReader>> py_Reader(m, "SharedMemoryReader",
+R"(Reads the frames published by a SharedMemoryOutputRegion, or any other
+SharedMemoryWriter, on this machine.
+
+Example Usage:
+    reader = SharedMemoryReader("/htm.anomaly")
+    frame  = reader.read(reader.frameCount - 1)
+    if frame is not None:
+        score = float(frame["dataIn"][0])
+        if frame.isValid():
+            print(score))");
+
+        py_Reader.def(py::init<const string&, bool>(), py::arg("name"), py::arg("acknowledging") = false);
+
+        py_Reader.def_property_readonly("name",  &SharedMemoryReader::getName);
+        py_Reader.def_property_readonly("slots", &SharedMemoryReader::getSlots,
+            "Number of frames kept in the ring.");
+        py_Reader.def_property_readonly("frameCount", &SharedMemoryReader::getFrameCount,
+            "Number of frames published so far.");
+
+        py_Reader.def_property_readonly("channels", [](const SharedMemoryReader &self) {
+                py::list channels;
+                for (const auto &ch : self.getChannels())
+                    channels.append(py::make_tuple(ch.name, BasicType::getName(ch.type), ch.count));
+                return channels; },
+            "List of (name, type, count) for each channel of a frame.");
+
+        py_Reader.def("read", [](shared_ptr<SharedMemoryReader> self, UInt64 frame) -> py::object {
+                PyFrame out;
+                out.reader = self;
+                if (!self->read(frame, out.frame))
+                    return py::none();
+                return py::cast(out); },
+R"(Returns the given frame, or None if it was not published yet or its slot was
+already reused.)",
+            py::arg("frame"));
+
+        py_Reader.def("waitFor", &SharedMemoryReader::waitFor,
+            py::call_guard<py::gil_scoped_release>(),
+            "Wait until the frame is published. Returns False after the timeout, in milliseconds; 0 waits forever.",
+            py::arg("frame"), py::arg("milliseconds"));
+
+        py_Reader.def("acknowledge", &SharedMemoryReader::acknowledge,
+            "Tell a writer with flow control that the frames up to this one were consumed.",
+            py::arg("frame"));
+
+        py_Reader.def_property_readonly("acknowledgedCount", &SharedMemoryReader::getAcknowledgedCount,
+            "Number of frames acknowledged so far.");
+
+        py_Reader.def_property_readonly("generation", &SharedMemoryReader::getGeneration,
+            "Random number which identifies the writer of the ring.");
+
+        py_Reader.def("isCurrent", &SharedMemoryReader::isCurrent,
+R"(Returns False if the writer of this ring is gone: its process ended, or the
+name now refers to another ring, or to nothing.  Such a ring gets no more frames.)");
+    }
+
+} // namespace htm_ext
@@ -28,6 +28,11 @@ Utility functions for PyBind11 bindings
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 
+#include <algorithm>
+
+#include <htm/types/Types.hpp>
+#include <htm/types/Sdr.hpp>
+
 namespace py = pybind11;
 
 namespace htm_ext {
@@ -43,6 +48,42 @@ namespace htm_ext {
 
     template<typename T> T* get_end(py::array& a) { return (static_cast<T*>(a.request().ptr)) + a.size(); }
 
+    // A batch of dense SDRs, one SDR per row of a 2-D numpy array.
+    // Used by the computeBatch/encodeBatch methods of the algorithms.
+    using DenseBatch = py::array_t<htm::UInt8, py::array::c_style | py::array::forcecast>;
+
+    // Check that a batch holds rows of rowSize values, returns the number of rows.
+    inline size_t batch_rows(const DenseBatch &batch, size_t rowSize)
+	{
+	if (batch.ndim() != 2 || static_cast<size_t>(batch.shape(1)) != rowSize)
+		{throw std::invalid_argument("Expected a 2-D array with " + std::to_string(rowSize) + " columns.");}
+	return static_cast<size_t>(batch.shape(0));
+	}
+
+    // Encode each value of a 1-D array into one row of a DenseBatch.
+    // The GIL is released while encoding.
+    template<typename Encoder>
+    DenseBatch encode_batch(Encoder &encoder, const py::array_t<htm::Real64, py::array::forcecast> &values)
+	{
+	if (values.ndim() != 1)
+		{throw std::invalid_argument("Expected a 1-D array of values.");}
+	const size_t rows = static_cast<size_t>(values.shape(0));
+	const size_t size = encoder.size;
+	DenseBatch outputs({ rows, size });
+	const htm::Real64 *in  = values.data();
+	htm::UInt8        *out = outputs.mutable_data();
+	{
+		py::gil_scoped_release release;
+		htm::SDR output( encoder.dimensions );
+		for (size_t row = 0; row < rows; row++) {
+			encoder.encode( in[row], output );
+			const auto &dense = output.getDense();
+			std::copy( dense.begin(), dense.end(), out + row * size );
+		}
+	}
+	return outputs;
+	}
+
     inline void enable_cout()
     {
         py::scoped_ostream_redirect stream(
@@ -31,6 +31,34 @@ using namespace htm;
 
 namespace htm_ext
 {
+    // Validate sparse indices and assign them to the SDR.  Sorted data (the
+    // common case) is checked in a single pass and copied once; unsorted
+    // data is copied, sorted and then swapped in.
+    static void setSparseBuffer(SDR &self, const ElemSparse *data, const UInt num)
+    {
+        NTA_CHECK( num <= self.size );
+        UInt i = 1u;
+        while( i < num && data[i - 1u] < data[i] )
+            ++i;
+        if( num == 0u || i == num ) {
+            NTA_CHECK( num == 0u || data[num - 1u] < self.size )
+                << "Index out of bounds of the SDR!";
+            if( data == self.getSparse().data() )
+                // We got our own data back, set inplace instead of copying.
+                self.setSparse( self.getSparse() );
+            else
+                self.setSparse( data, num );
+            return;
+        }
+        SDR_sparse_t sorted( data, data + num );
+        sort( sorted.begin(), sorted.end() );
+        NTA_CHECK( adjacent_find( sorted.begin(), sorted.end() ) == sorted.end() )
+            << "Sparse data must not contain duplicates!";
+        NTA_CHECK( sorted.back() < self.size )
+            << "Index out of bounds of the SDR!";
+        self.setSparse( sorted );
+    }
+
     void init_SDR(py::module& m)
     {
         py::class_<SDR, shared_ptr<SDR>> py_SDR(m, "SDR",
@@ -185,23 +213,28 @@ date.  If you did't copy this data, then SDR won't copy either.)");
                         delete reinterpret_cast<shared_ptr<SDR>*>(keepAlive); });
                 return py::array(self->getSum(), self->getSparse().data(), destructor);
             },
-            [](SDR &self, SDR_sparse_t data) {
-                NTA_CHECK( data.size() <= self.size );
-                // Sort data and check for duplicates.
-                if( ! is_sorted( data.begin(), data.end() ))
-                    sort( data.begin(), data.end() );
-                UInt previous = -1;
-                for( const UInt idx : data ) {
-                    NTA_CHECK( idx != previous )
-                        << "Sparse data must not contain duplicates!";
-                    previous = idx;
+            [](SDR &self, py::object value) {
+                // Fast path: a contiguous uint32 numpy array is validated and
+                // copied straight into the SDR, with no intermediate vector.
+                if( py::isinstance<py::array>( value )) {
+                    auto arr = py::reinterpret_borrow<py::array>( value );
+                    if( arr.dtype().is(py::dtype::of<ElemSparse>()) &&
+                        arr.ndim() == 1 && (arr.flags() & py::array::c_style) ) {
+                        const auto data = static_cast<const ElemSparse*>( arr.data() );
+                        const UInt num  = static_cast<UInt>( arr.shape(0) );
+                        setSparseBuffer( self, data, num );
+                        return;
+                    }
                 }
-                self.setSparse( data ); },
+                auto data = value.cast<SDR_sparse_t>();
+                setSparseBuffer( self, data.data(), static_cast<UInt>(data.size()) ); },
 R"(A numpy array containing the indices of only the true values in the SDR.
 These are indices into the flattened SDR. This format allows for quickly
 accessing all of the true bits in the SDR.
 
-Sparse data must contain no duplicates.)");
+Sparse data must contain no duplicates.  Assigning a contiguous numpy array
+with dtype uint32 is fastest: it is checked and copied in one pass, without
+converting the array element by element.)");
 
         py_SDR.def_property("coordinates",
             [](shared_ptr<SDR> self) {
@@ -0,0 +1,182 @@
+/* ----------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * ---------------------------------------------------------------------- */
+
+#include <bindings/suppress_register.hpp>  //include before pybind11.h
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <htm/types/SdrBatch.hpp>
+
+#include <memory> // shared_ptr
+
+namespace py = pybind11;
+
+using namespace std;
+using namespace htm;
+
+namespace htm_ext
+{
+    // Wrap a buffer owned by an SDRBatch in a read-only numpy array which
+    // keeps the batch alive.  No data is copied.
+    template<typename T>
+    static py::array batchView(shared_ptr<SDRBatch> self, const vector<T> &data)
+    {
+        auto destructor = py::capsule( new shared_ptr<SDRBatch>( self ),
+            [](void *keepAlive) {
+                delete reinterpret_cast<shared_ptr<SDRBatch>*>(keepAlive); });
+        py::array view(data.size(), data.data(), destructor);
+        view.attr("setflags")(py::arg("write") = false);
+        return view;
+    }
+
+    void init_SDRBatch(py::module& m)
+    {
+        py::class_<SDRBatch, shared_ptr<SDRBatch>> py_SDRBatch(m, "SDRBatch",
+R"(A sequence of SDRs with the same dimensions, stored in one compressed sparse
+row (CSR) buffer.  Use this to hand many samples to the batch APIs at once, for
+example SpatialPooler.computeBatch(), without making an SDR object per sample.
+
+    indices: The sparse indices of every SDR in the batch, concatenated.
+    offsets: offsets[i] is where SDR number i starts in indices, and
+             offsets[i+1] is where it ends.  There are len(batch)+1 offsets.
+
+Example Usage:
+    batch = SDRBatch( [10] )
+    batch.append( SDR(10).randomize(.2) )
+    batch.appendSparse( np.array([ 1, 2, 3 ], dtype=np.uint32) )
+    len(batch)     -> 2
+    batch[1]       -> SDR( 10 ) 1, 2, 3
+    batch.offsets  -> [ 0, 2, 5 ]
+
+    # Build a batch directly from CSR arrays, the data is checked & copied once.
+    batch = SDRBatch( [10], indices, offsets ))");
+
+        py_SDRBatch.def( py::init<vector<UInt>>(),
+R"(Create an empty batch of SDRs with the given dimensions.)",
+            py::arg("dimensions"));
+
+        py_SDRBatch.def( py::init( [](const vector<UInt> &dimensions,
+                                      py::array_t<ElemSparse, py::array::c_style | py::array::forcecast> indices,
+                                      py::array_t<UInt64,     py::array::c_style | py::array::forcecast> offsets) {
+                SDR_sparse_t   idx( indices.data(), indices.data() + indices.size() );
+                vector<UInt64> off( offsets.data(), offsets.data() + offsets.size() );
+                return new SDRBatch( dimensions, idx, off ); }),
+R"(Create a batch from CSR arrays.  Argument indices is a 1-D array of the
+concatenated sparse indices, argument offsets is a 1-D array with len(batch)+1
+entries, starting with zero.)",
+            py::arg("dimensions"), py::arg("indices"), py::arg("offsets"));
+
+        py_SDRBatch.def_static("fromDense",
+            [](py::array_t<Byte, py::array::c_style | py::array::forcecast> dense,
+               vector<UInt> dimensions) {
+                NTA_CHECK( dense.ndim() == 2 ) << "fromDense: expected a 2-D array.";
+                const size_t rows = static_cast<size_t>( dense.shape(0) );
+                const size_t cols = static_cast<size_t>( dense.shape(1) );
+                if( dimensions.empty() )
+                    dimensions.push_back( static_cast<UInt>(cols) );
+                auto batch = make_shared<SDRBatch>( dimensions );
+                NTA_CHECK( batch->sdrSize() == cols )
+                    << "fromDense: dimensions do not match the number of columns.";
+                batch->reserve( rows, 0u );
+                SDR_sparse_t sparse;
+                const Byte *data = dense.data();
+                for( size_t r = 0u; r < rows; r++ ) {
+                    sparse.clear();
+                    for( size_t c = 0u; c < cols; c++ ) {
+                        if( data[r * cols + c] )
+                            sparse.push_back( static_cast<ElemSparse>(c) );
+                    }
+                    batch->push_back( sparse.data(), sparse.size() );
+                }
+                return batch; },
+R"(Create a batch from a 2-D dense array, with one SDR per row.  Optional
+argument dimensions gives the shape of each SDR, its size must equal the number
+of columns.  The default is one dimension.)",
+            py::arg("dense"), py::arg("dimensions") = vector<UInt>());
+
+        py_SDRBatch.def_property_readonly("dimensions", &SDRBatch::dimensions,
+            "The dimensions of each SDR in the batch.");
+
+        py_SDRBatch.def_property_readonly("sdrSize", &SDRBatch::sdrSize,
+            "The number of bits in each SDR in the batch.");
+
+        py_SDRBatch.def("__len__", &SDRBatch::size);
+
+        py_SDRBatch.def("__getitem__", [](const SDRBatch &self, size_t index) {
+                if( index >= self.size() )
+                    throw py::index_error();
+                auto out = make_shared<SDR>( self.dimensions() );
+                self.get( index, *out );
+                return out; },
+            "Returns a copy of SDR number index, as an SDR object.");
+
+        py_SDRBatch.def("append", [](SDRBatch &self, const SDR &sdr) { self.push_back( sdr ); },
+            "Append a copy of the given SDR's value to the end of the batch.",
+            py::arg("sdr"));
+
+        py_SDRBatch.def("appendSparse",
+            [](SDRBatch &self, py::array_t<ElemSparse, py::array::c_style | py::array::forcecast> sparse) {
+                self.push_back( sparse.data(), static_cast<size_t>(sparse.size()) ); },
+R"(Append one SDR, given as sorted sparse indices, to the end of the batch.  A
+contiguous uint32 numpy array is used as-is, without conversion.)",
+            py::arg("sparse"));
+
+        py_SDRBatch.def("clear",   &SDRBatch::clear,   "Remove all SDRs from the batch.");
+
+        py_SDRBatch.def("reserve", &SDRBatch::reserve,
+            "Reserve memory for numSDRs SDRs with a total of numActive active bits.",
+            py::arg("numSDRs"), py::arg("numActive"));
+
+        py_SDRBatch.def_property_readonly("indices",
+            [](shared_ptr<SDRBatch> self) { return batchView( self, self->indices() ); },
+R"(A read-only view of the concatenated sparse indices, as a numpy array.  This
+does not copy the data.  The view is invalidated when the batch is modified.)");
+
+        py_SDRBatch.def_property_readonly("offsets",
+            [](shared_ptr<SDRBatch> self) { return batchView( self, self->offsets() ); },
+R"(A read-only view of the row offsets into indices, as a numpy array.  This does
+not copy the data.  The view is invalidated when the batch is modified.)");
+
+        py_SDRBatch.def_property_readonly("dense", [](const SDRBatch &self) {
+                py::array_t<Byte> out({ self.size(), static_cast<size_t>(self.sdrSize()) });
+                Byte *data = out.mutable_data();
+                std::fill( data, data + out.size(), Byte(0) );
+                for( size_t r = 0u; r < self.size(); r++ ) {
+                    const ElemSparse *row = self.row( r );
+                    for( size_t i = 0u; i < self.rowSize( r ); i++ )
+                        data[r * self.sdrSize() + row[i]] = 1u;
+                }
+                return out; },
+            "A new 2-D numpy array with the dense value of one SDR per row.");
+
+        py_SDRBatch.def("__eq__", [](const SDRBatch &self, const SDRBatch &other) { return self == other; });
+
+        py_SDRBatch.def(py::pickle(
+            [](const SDRBatch& self) {
+                stringstream ss;
+                self.save(ss);
+                return py::bytes(ss.str());
+            },
+            [](py::bytes& s) {
+                istringstream ss(s);
+                auto batch = make_shared<SDRBatch>();
+                batch->load(ss);
+                return batch;
+            }));
+    }
+}
@@ -46,6 +46,14 @@ average is used instead of an exponential moving average.)");
         py_Helper.def_property_readonly( "samples",
             [](const MetricsHelper_ &self){ return self.samples; },
                 "Number of data samples received & incorporated into this measurement.");
+        py_Helper.def_property_readonly( "sampleRate",
+            [](const MetricsHelper_ &self){ return self.sampleRate; },
+                "Only every sampleRate'th update of the SDR is measured.");
+        py_Helper.def( "setSampleRate", &MetricsHelper_::setSampleRate,
+R"(Only measure every k-th update of the SDR, skip the rest.  This makes the
+metric k times cheaper.  The period still counts samples, so the time constant
+becomes (period * k) updates.  Default is 1, every update is measured.)",
+            py::arg("k"));
         py_Helper.def_property_readonly( "dimensions",
             [](const MetricsHelper_ &self){ return self.dimensions; },
                 "Shape of the SDR data source.");
@@ -148,7 +156,8 @@ Argument period is time constant for exponential moving average.)",
         py_ActivationFrequency.def_property_readonly("activationFrequency",
             [](const ActivationFrequency &self) {
                 auto capsule = py::capsule(&self, [](void *self) {});
-                return py::array(self.activationFrequency.size(), self.activationFrequency.data(), capsule); },
+                const auto &frequencies = self.activationFrequency();
+                return py::array(frequencies.size(), frequencies.data(), capsule); },
                     "Data Buffer of Activation Frequencies");
         py_ActivationFrequency.def( "min",     &ActivationFrequency::min, "Minimum of Activation Frequencies");
         py_ActivationFrequency.def( "max",     &ActivationFrequency::max, "Maximum of Activation Frequencies");
@@ -257,6 +266,8 @@ by calling method metrics.addData( SDR ) with an SDR which has these dimensions.
 Argument period is time constant for exponential moving average.)",
             py::arg("dimensions"), py::arg("period"));
         py_Metrics.def( "reset", &Metrics::reset, "For use with time-series data sets.");
+        py_Metrics.def( "setSampleRate", &Metrics::setSampleRate,
+            "Measure every k-th update only, for all three metrics.", py::arg("k"));
         py_Metrics.def( "addData", &Metrics::addData,
 R"(Add an SDR datum to these Metrics.  This method can only be called if
 Metrics was constructed with dimensions and NOT an SDR.
@@ -31,6 +31,7 @@ In this case, the C++ engine is actually calling into the Python code.
 #include <regex>
 #include <vector>
 #include <sstream>      // std::stringstream
+#include <cstring>      // std::memcpy
 
 #include <htm/engine/Region.hpp>
 #include <htm/engine/Input.hpp>
@@ -304,6 +305,9 @@ namespace py = pybind11;
 
     std::string PyBindRegion::pickleSerialize() const
     {
+        // Iterations still being batched are not computed here, serializing
+        // must not change the region; see RegionImpl::finishRun().
+
         // 1. serialize main state using pickle
         // 2. call class method to serialize external state
 
@@ -636,6 +640,7 @@ namespace py = pybind11;
         //    py::String s(args[i]);
         //    t.setItem(i - 1, s);
         //}
+        flushBatch_();  // commands see the state after all computed iterations.
         std::vector<std::string> t(args.begin() + 1, args.end());
 
         py::args commandArgs = py::make_tuple(args[0], t);
@@ -645,12 +650,14 @@ namespace py = pybind11;
         return s;
     }
 
-    void PyBindRegion::compute()
+    void PyBindRegion::buildComputeArgs_()
     {
         const Spec& ns = nodeSpec_;
+        inputViews_.clear();
+        outputViews_.clear();
+        inputs_ = py::dict();
+        outputs_ = py::dict();
 
-        // Prepare the inputs dict
-        py::dict inputs;
         for (size_t i = 0; i < ns.inputs.getCount(); ++i)
         {
             const std::pair<std::string, InputSpec> & p = ns.inputs.getByIndex(i);
@@ -658,27 +665,12 @@ namespace py = pybind11;
             // Get the corresponding input buffer
             auto inp = region_->getInput(p.first);
             NTA_CHECK(inp);
-
-            // Set pa to point to the original input array
-            const htm::Array * pa = &(inp->getData());
-
-            // Skip unlinked inputs of size 0
-    		    if (pa->getCount() == 0)
-                continue;
-
-
-            // Create a numpy array from pa, which wil be either
-            // the original input array or a stored input array copy
-            // (if a splitter map is needed)
-            inputs[p.first.c_str()] = create_numpy_view(*pa);
+            inputViews_.push_back({ p.first, &(inp->getData()), nullptr, 0u, NTA_BasicType_Last });
         }
 
-        // Prepare the outputs dict
-        py::dict outputs;
-
+        bool hasOutgoingLinks = false;
         for (size_t i = 0; i < ns.outputs.getCount(); ++i)
         {
-            // Get the current OutputSpec object
             const std::pair<std::string, OutputSpec> & p = ns.outputs.getByIndex(i);
 
             // Get the corresponding output buffer
@@ -686,13 +678,143 @@ namespace py = pybind11;
             // Skip optional outputs
             if (!out)
                 continue;
+            hasOutgoingLinks = hasOutgoingLinks || out->hasOutgoingLinks();
+            outputViews_.push_back({ p.first, &(out->getData()), nullptr, 0u, NTA_BasicType_Last });
+        }
+
+        // Batching is only possible when nothing reads our outputs while the
+        // batch is being collected.
+        batchSize_ = 0;
+        batchPending_ = 0;
+        batchInputs_ = py::dict();
+        if (!hasOutgoingLinks && py::hasattr(node_, "computeBatchSize")
+                              && py::hasattr(node_, "guardedComputeBatch"))
+        {
+            auto k = node_.attr("computeBatchSize").cast<size_t>();
+            if (k > 1)
+                batchSize_ = k;
+        }
+
+        computeArgsValid_ = true;
+        refreshComputeArgs_();
+    }
+
+    void PyBindRegion::refreshComputeArgs_()
+    {
+        for (auto &v : inputViews_)
+        {
+            const Array &a = *v.array;
+            if (a.getBuffer() == v.buffer && a.getCount() == v.count && a.getType() == v.type)
+                continue;
+            v.buffer = a.getBuffer();
+            v.count  = a.getCount();
+            v.type   = a.getType();
+
+            // Skip unlinked inputs of size 0
+            if (v.count == 0) {
+                if (inputs_.contains(v.name))
+                    PyDict_DelItemString(inputs_.ptr(), v.name.c_str());
+                continue;
+            }
+            inputs_[v.name.c_str()] = create_numpy_view(a);
+        }
+
+        for (auto &v : outputViews_)
+        {
+            const Array &a = *v.array;
+            if (a.getBuffer() == v.buffer && a.getCount() == v.count && a.getType() == v.type)
+                continue;
+            v.buffer = a.getBuffer();
+            v.count  = a.getCount();
+            v.type   = a.getType();
+            outputs_[v.name.c_str()] = create_numpy_view(a);
+        }
+    }
 
-            const Array & data = out->getData();
-            outputs[p.first.c_str()] = create_numpy_view(data);
+    void PyBindRegion::compute()
+    {
+        if (computeArgsValid_)
+            refreshComputeArgs_();
+        else
+            buildComputeArgs_();
+
+        // A batch is made of input rows, so regions without inputs are not batched.
+        if (batchSize_ > 1 && inputs_.size() > 0) {
+            appendBatch_();
+            if (batchPending_ == batchSize_)
+                flushBatch_();
+            return;
         }
 
-        py::args args = py::make_tuple(inputs, outputs);
-        node_.attr("guardedCompute")(*args);
+        flushBatch_();
+        node_.attr("guardedCompute")(inputs_, outputs_);
+    }
+
+    // Copy the current inputs into the next row of the batch buffers.
+    void PyBindRegion::appendBatch_()
+    {
+        // If any input changed shape or type, finish what was collected so
+        // far and reallocate the batch buffers.
+        bool reshaped = false;
+        for (const auto &v : inputViews_)
+        {
+            const bool have = batchInputs_.contains(v.name);
+            if (v.count == 0) {
+                reshaped = reshaped || have;
+                continue;
+            }
+            if (!have) {
+                reshaped = true;
+                continue;
+            }
+            auto rows = batchInputs_[v.name.c_str()].cast<py::array>();
+            auto view = inputs_[v.name.c_str()].cast<py::array>();
+            reshaped = reshaped || static_cast<size_t>(rows.shape(1)) != v.count
+                                || rows.itemsize() != view.itemsize()
+                                || rows.dtype().kind() != view.dtype().kind();
+        }
+        if (reshaped)
+        {
+            flushBatch_();
+            batchInputs_ = py::dict();
+            for (const auto &v : inputViews_)
+            {
+                if (v.count == 0)
+                    continue;
+                auto view = inputs_[v.name.c_str()].cast<py::array>();
+                batchInputs_[v.name.c_str()] = py::array(view.dtype(),
+                    std::vector<ssize_t>{ static_cast<ssize_t>(batchSize_),
+                                          static_cast<ssize_t>(v.count) });
+            }
+        }
+
+        for (const auto &v : inputViews_)
+        {
+            if (v.count == 0)
+                continue;
+            const size_t bytes = v.count * BasicType::getSize(v.type);
+            auto rows = batchInputs_[v.name.c_str()].cast<py::array>();
+            std::memcpy(static_cast<char*>(rows.mutable_data()) + batchPending_ * bytes, v.buffer, bytes);
+        }
+        batchPending_++;
+    }
+
+    // Hand the collected iterations to the python region.  Inputs are passed
+    // as 2-D numpy arrays with one row per iteration.
+    void PyBindRegion::flushBatch_()
+    {
+        if (batchPending_ == 0)
+            return;
+        py::dict rows;
+        for (auto item : batchInputs_)
+            rows[item.first] = item.second[py::slice(0, static_cast<ssize_t>(batchPending_), 1)];
+        batchPending_ = 0;
+        node_.attr("guardedComputeBatch")(rows, outputs_);
+    }
+
+    void PyBindRegion::finishRun()
+    {
+        flushBatch_();
     }
 
 
@@ -993,7 +1115,11 @@ namespace py = pybind11;
 
     void PyBindRegion::initialize()
     {
+        flushBatch_();
         node_.attr("initialize")();
+        // Inputs and outputs may have been recreated, build new views on the
+        // next compute().
+        computeArgsValid_ = false;
     }
 
 
@@ -95,6 +95,7 @@ namespace htm
 
         void initialize() override;
         void compute() override;
+        void finishRun() override;
         std::string executeCommand(const std::vector<std::string>& args, Int64 index) override;
 
         size_t getParameterArrayCount(const std::string& name, Int64 index) const override;
@@ -140,6 +141,33 @@ namespace htm
 
         Spec nodeSpec_;   // locally cached version of spec.
 
+        // compute() arguments.  The dicts of numpy views are built once and
+        // a view is only recreated when its buffer, size or type changes.
+        struct BufferView {
+          std::string name;
+          const Array *array;
+          const void *buffer;
+          size_t count;
+          NTA_BasicType type;
+        };
+        std::vector<BufferView> inputViews_;
+        std::vector<BufferView> outputViews_;
+        pybind11::dict inputs_;
+        pybind11::dict outputs_;
+        bool computeArgsValid_ = false;
+
+        // Batched compute.  A python region without outgoing links may set
+        // 'computeBatchSize' to k > 1; its inputs are then collected for k
+        // iterations and handed to guardedComputeBatch() in one call.
+        size_t batchSize_ = 0;
+        size_t batchPending_ = 0;
+        pybind11::dict batchInputs_;  // name -> numpy array of (batchSize_ x count)
+
+        void buildComputeArgs_();
+        void refreshComputeArgs_();
+        void appendBatch_();
+        void flushBatch_();
+
         std::string pickleSerialize() const;
         std::string extraSerialize() const;
 				void pickleDeserialize(std::string p);
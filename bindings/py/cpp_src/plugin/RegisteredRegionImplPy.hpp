@@ -145,6 +145,9 @@ namespace htm
         }
       }
 
+      // Unpickling needs the GIL, so python regions are always deserialized on the calling thread.
+      bool canDeserializeConcurrently() override { return false; }
+
       Spec* createSpec() override
       {
           Spec* sp = new Spec();
@@ -199,6 +199,39 @@ class PyRegion(_PyRegionMeta):
     return self.compute(inputs, DictReadOnlyWrapper(outputs))
 
 
+  # Set to k > 1 in a sub-class to have the C++ engine call computeBatch()
+  # once every k iterations instead of compute() on every iteration.  This is
+  # only done when none of the region's outputs are linked to another region.
+  computeBatchSize = 0
+
+
+  def computeBatch(self, inputs, outputs):
+    """Perform the computation for several iterations at once.
+
+    Only called when ``computeBatchSize`` is greater than one.  The batch may
+    be shorter than ``computeBatchSize`` at the end of Network.run().  The
+    default implementation calls
+    :meth:`~nupic.bindings.regions.PyRegion.PyRegion.compute` once per row.
+
+    :param inputs: (dict) of 2-D numpy arrays (one per input) with one row
+                   per iteration, oldest first.
+    :param outputs: (dict) of numpy arrays (one per output), as for compute().
+    """
+    rows = min([len(v) for v in inputs.values()] or [0])
+    for i in range(rows):
+      self.compute({name: value[i] for name, value in inputs.items()}, outputs)
+
+
+  def guardedComputeBatch(self, inputs, outputs):
+    """The C++ entry point to computeBatch.
+    The subclass should not implement.
+
+    :param inputs: (dict) of 2-D numpy arrays (one per input)
+    :param outputs: (dict) of numpy arrays (one per output)
+    """
+    return self.computeBatch(inputs, DictReadOnlyWrapper(outputs))
+
+
   def getOutputElementCount(self, name):
     """
     Return the number of elements in this output.  i.e. its width.
@@ -38,6 +38,40 @@ class SpatialPoolerTest(unittest.TestCase):
     assert( active.getSum() > 0 )
 
 
+  def testComputeBatch(self):
+    """ Check that computeBatch matches calling compute once per row. """
+    batch = np.array([ SDR( 100 ).randomize( .05, i + 1 ).dense for i in range(10) ], dtype=np.uint8)
+    spA = SP( [100], [200], stimulusThreshold = 1, seed = 42 )
+    spB = SP( [100], [200], stimulusThreshold = 1, seed = 42 )
+
+    outputs = spA.computeBatch( batch, True )
+    self.assertEqual( outputs.shape, (10, 200) )
+
+    inp    = SDR( 100 )
+    active = SDR( 200 )
+    for row in range(len(batch)):
+      inp.dense = batch[row]
+      spB.compute( inp, True, active )
+      np.testing.assert_array_equal( outputs[row], active.dense )
+
+    # The list-of-SDR overload writes into the given output SDRs.
+    inputs = [ SDR( 100 ).randomize( .05, i + 1 ) for i in range(3) ]
+    outs   = [ SDR( 200 ) for i in range(3) ]
+    spA.computeBatch( inputs, outs, False )
+    for i in range(3):
+      spB.compute( inputs[i], False, active )
+      self.assertEqual( outs[i], active )
+
+    # learn defaults to True, and can be given by name.
+    spA.computeBatch( inputs, outs )
+    spA.computeBatch( inputs = inputs, outputs = outs, learn = False )
+    with pytest.raises(RuntimeError):
+      spA.computeBatch( inputs, outs[:2] )
+
+    with pytest.raises(ValueError):
+      spA.computeBatch( np.zeros((2, 99), dtype=np.uint8), True )
+
+
   def _runGetPermanenceTrial(self, float_type):
     """ 
     Check that getPermanence() returns values for a given float_type. 
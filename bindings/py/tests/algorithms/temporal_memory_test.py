@@ -60,6 +60,24 @@ class TemporalMemoryBindingsTest(unittest.TestCase):
     self.assertTrue( active.getSum() > 0 )
 
 
+  def testComputeBatch(self):
+    """ Check that computeBatch matches calling compute once per row. """
+    batch = np.array([ SDR( 100 ).randomize( .05, i + 1 ).dense for i in range(10) ], dtype=np.uint8)
+    tmA = TM( [100], seed = 42 )
+    tmB = TM( [100], seed = 42 )
+
+    cells, anomaly = tmA.computeBatch( batch, True )
+    self.assertEqual( cells.shape, (10, tmA.numberOfCells()) )
+    self.assertEqual( anomaly.shape, (10,) )
+
+    cols = SDR( 100 )
+    for row in range(len(batch)):
+      cols.dense = batch[row]
+      tmB.compute( cols, True )
+      np.testing.assert_array_equal( cells[row], tmB.getActiveCells().flatten().dense )
+      self.assertAlmostEqual( anomaly[row], tmB.anomaly, places = 5 )
+
+
   def testPerformanceLarge(self):
     LARGE = 9000
     ITERS = 100 # This is lowered for unittest. Try 1000, 5000,...
@@ -195,6 +213,20 @@ class TemporalMemoryBindingsTest(unittest.TestCase):
     _print("activeCells:"+str(len(tm.getActiveCells().sparse)))
     _print("predictiveCells:"+str(len(predictiveCellsSDR.sparse)))
 
+  def testCounters(self):
+    """ Counters are only present when built with HTM_COUNTERS. """
+    tm = TM( [100] )
+    inputs = SDR( 100 ).randomize( .05 )
+    for i in range(3):
+      tm.compute( inputs, True )
+    counters = tm.getCounters()
+    if counters:
+      self.assertEqual( counters["computeCalls"], 3 )
+      self.assertEqual( counters["connections.computeActivityCalls"], 3 )
+    tm.resetCounters()
+    self.assertTrue( all( value == 0 for value in tm.getCounters().values() ) )
+
+
   def testTMexposesConnections(self):
     """TM exposes internal connections as read-only object"""
     tm = TM(columnDimensions=[2048], connectedPermanence=0.42)
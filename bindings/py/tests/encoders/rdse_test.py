@@ -241,6 +241,19 @@ class RDSE_Test(unittest.TestCase):
         print( A )
         assert( A == GOLD )
 
+    def testEncodeBatch(self):
+        P = RDSE_Parameters()
+        P.size     = 1000
+        P.sparsity = .08
+        P.radius   = 12
+        P.seed     = 42
+        R = RDSE( P )
+        values = np.array([ -100, 0, 3.5, 987654 ])
+        batch  = R.encodeBatch( values )
+        assert( batch.shape == (len(values), P.size) )
+        for row, value in enumerate(values):
+            assert( (batch[row] == R.encode( value ).dense).all() )
+
     def testSeed(self):
         P = RDSE_Parameters()
         P.size     = 1000
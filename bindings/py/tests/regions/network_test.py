@@ -93,6 +93,42 @@ class LinkRegion(PyRegion):
       "parameters": { }
     }
 
+class BatchSinkRegion(PyRegion):
+  """
+  Test region used to test batched compute of a python sink region
+  """
+  computeBatchSize = 4
+
+  def __init__(self):
+    self.batches = []
+  def initialize(self): pass
+  def compute(self, inputs, outputs):
+    raise Exception("compute() should not be called on a batching sink.")
+  def computeBatch(self, inputs, outputs):
+    rows = inputs["UInt32"]
+    assert( all(np.array_equal(row, TEST_DATA) for row in rows) )
+    self.batches.append( len(rows) )
+
+  def GetBatches(self):
+    return str(self.batches)
+
+  @classmethod
+  def getSpec(cls):
+    return {
+      "description": BatchSinkRegion.__doc__,
+      "inputs": {
+        "UInt32": {
+          "description": "UInt32 Data",
+          "dataType": "UInt32",
+          "isDefaultInput": True,
+          "required": False,
+          "count": 0
+        },
+      },
+      "outputs": { },
+      "parameters": { }
+    }
+
 class NetworkTest(unittest.TestCase):
 
   def setUp(self):
@@ -288,6 +324,26 @@ class NetworkTest(unittest.TestCase):
 
     
 
+  def testPyRegionComputeBatch(self):
+    """
+    A python region without outgoing links gets its inputs in batches of
+    computeBatchSize, and the partial batch at the end of run().
+    """
+    engine.Network.registerPyRegion(BatchSinkRegion.__module__, BatchSinkRegion.__name__)
+    try:
+      network = engine.Network()
+      sink = network.addRegion("sink", "py.BatchSinkRegion", "")
+      network.link("INPUT", "sink", "", "{dim: [5]}", "UInt32_source", "UInt32")
+      network.initialize()
+      network.setInputData("UInt32_source", np.array(TEST_DATA))
+
+      network.run(10)
+      self.assertEqual(sink.executeCommand("GetBatches"), "[4, 4, 2]")
+      network.run(1)
+      self.assertEqual(sink.executeCommand("GetBatches"), "[4, 4, 2, 1]")
+    finally:
+      engine.Network.unregisterPyRegion(BatchSinkRegion.__name__)
+
   def testBuiltInRegions(self):
     """
     This sets up a network with built-in regions.
@@ -321,6 +377,100 @@ class NetworkTest(unittest.TestCase):
     #print(EXPECTED_RESULT3)
     self.assertTrue(np.array_equal(sdr.sparse, EXPECTED_RESULT3))
 
+  @pytest.mark.skipif(sys.platform.startswith("win"), reason="POSIX shared memory")
+  def testSharedMemoryOutputRegion(self):
+    """
+    Read the outputs published by a SharedMemoryOutputRegion.
+    """
+    net = engine.Network()
+    encoder = net.addRegion("encoder", "ScalarEncoderRegion", "{size: 100, activeBits: 10, minValue: 0, maxValue: 10}")
+    net.addRegion("tap", "SharedMemoryOutputRegion", "{name: 'htm.pytest.tap', slots: 4}")
+    net.link("encoder", "tap", "", "", "encoded", "sdrIn")
+    net.initialize()
+
+    reader = engine.SharedMemoryReader("htm.pytest.tap")
+    self.assertEqual(reader.channels, [("sdrIn", "SDR", 100)])
+    self.assertIsNone(reader.read(0))
+
+    encoder.setParameterReal64("sensedValue", 3.0)
+    net.run(1)
+    self.assertEqual(reader.frameCount, 1)
+    frame = reader.read(0)
+    dense = frame["sdrIn"]
+    self.assertFalse(dense.flags.writeable)
+    self.assertTrue(np.array_equal(dense, encoder.getOutputArray("encoded").getSDR().dense))
+    self.assertTrue(frame.isValid())
+
+    net.run(4)
+    self.assertFalse(frame.isValid())
+    self.assertIsNone(reader.read(0))
+    self.assertTrue(reader.isCurrent())
+    self.assertNotEqual(reader.generation, 0)
+
+    # A new writer with the same name replaces the ring.
+    net2 = engine.Network()
+    net2.addRegion("encoder", "ScalarEncoderRegion", "{size: 100, activeBits: 10, minValue: 0, maxValue: 10}")
+    net2.addRegion("tap", "SharedMemoryOutputRegion", "{name: 'htm.pytest.tap'}")
+    net2.link("encoder", "tap", "", "", "encoded", "sdrIn")
+    net2.initialize()
+    self.assertFalse(reader.isCurrent())
+    self.assertNotEqual(engine.SharedMemoryReader("htm.pytest.tap").generation, reader.generation)
+
+  @pytest.mark.skipif(sys.platform.startswith("win"), reason="POSIX shared memory")
+  def testSharedMemoryOutputRegionDefaultName(self):
+    """
+    The default ring names of two Networks differ.
+    """
+    names = []
+    nets = []
+    for i in range(2):
+      net = engine.Network()
+      net.addRegion("encoder", "ScalarEncoderRegion", "{size: 100, activeBits: 10, minValue: 0, maxValue: 10}")
+      tap = net.addRegion("tap", "SharedMemoryOutputRegion", "")
+      net.link("encoder", "tap", "", "", "encoded", "sdrIn")
+      net.initialize()
+      names.append(tap.getParameterString("name"))
+      nets.append(net)
+    self.assertNotEqual(names[0], names[1])
+    for name in names:
+      self.assertTrue(name.startswith("/htm.") and name.endswith(".tap"))
+      self.assertTrue(engine.SharedMemoryReader(name).isCurrent())
+
+  @pytest.mark.skipif(sys.platform.startswith("win"), reason="POSIX shared memory")
+  def testPartition(self):
+    """
+    A partition publishes the links to other partitions in shared memory rings.
+    """
+    config = """
+    network:
+      - addRegion: {name: "encoder", type: "RDSEEncoderRegion", params: {size: 400, sparsity: 0.1, radius: 1.0, seed: 42}, partition: "front"}
+      - addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 200, globalInhibition: true, seed: 42}, partition: "front"}
+      - addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 4, seed: 42}, partition: "back"}
+      - addLink:   {src: "INPUT.value", dest: "encoder.values", dim: [1]}
+      - addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}
+      - addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn", slots: 2}
+    """
+    front = engine.Network()
+    front.setPartition("front", "/htm.pytest.partition.")
+    front.configure(config)
+    self.assertEqual(front.getPartition(), "front")
+    self.assertEqual(front.getRegion("partition_sp_bottomUpOut_back").getType(), "SharedMemoryOutputRegion")
+
+    front.initialize()
+
+    # Read the ring as the back partition would.
+    reader = engine.SharedMemoryReader("/htm.pytest.partition.sp.bottomUpOut.back", True)
+    self.assertTrue(reader.isCurrent())
+    for i in range(3):
+      front.setInputData("value", np.array([float(i)]))
+      front.run(1)
+      self.assertTrue(reader.waitFor(i, 1000))
+      frame = reader.read(i)
+      expected = front.getRegion("sp").getOutputArray("bottomUpOut").getSDR().dense
+      self.assertTrue(np.array_equal(frame["sdrIn"], expected))
+      reader.acknowledge(i)
+    self.assertEqual(reader.acknowledgedCount, 3)
+
   def testExecuteCommand1(self):
     """
     Check to confirm that the ExecuteCommand( ) funtion works.
@@ -0,0 +1,88 @@
+# ----------------------------------------------------------------------
+# HTM Community Edition of NuPIC
+# Copyright (C) 2020, Numenta, Inc.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero Public License version 3 as
+# published by the Free Software Foundation.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU Affero Public License for more details.
+#
+# You should have received a copy of the GNU Affero Public License
+# along with this program.  If not, see http://www.gnu.org/licenses.
+# ----------------------------------------------------------------------
+
+"""Unit tests for SDRBatch."""
+
+import pickle
+import numpy as np
+import unittest
+import pytest
+
+from htm.bindings.sdr import SDR, SDRBatch
+from htm.algorithms import SpatialPooler as SP
+
+class SdrBatchTest(unittest.TestCase):
+    def testExampleUsage(self):
+        batch = SDRBatch( [10] )
+        A = SDR( 10 )
+        A.sparse = [ 4, 7 ]
+        batch.append( A )
+        batch.appendSparse( np.array([ 1, 2, 3 ], dtype=np.uint32) )
+        assert( len(batch) == 2 )
+        assert( batch[0] == A )
+        assert( batch[1].sparse.tolist() == [ 1, 2, 3 ] )
+        assert( batch.indices.tolist() == [ 4, 7, 1, 2, 3 ] )
+        assert( batch.offsets.tolist() == [ 0, 2, 5 ] )
+        with pytest.raises(IndexError):
+            batch[2]
+
+    def testCSR(self):
+        batch = SDRBatch( [2, 5], np.array([ 0, 9, 3 ]), np.array([ 0, 2, 2, 3 ]) )
+        assert( len(batch) == 3 )
+        assert( batch.sdrSize == 10 )
+        assert( batch[1].getSum() == 0 )
+        assert( batch[2].dimensions == [2, 5] )
+        with pytest.raises(RuntimeError):
+            SDRBatch( [10], np.array([ 3, 1 ]), np.array([ 0, 2 ]) )
+        with pytest.raises(RuntimeError):
+            SDRBatch( [10], np.array([ 3, 10 ]), np.array([ 0, 2 ]) )
+        # The index & offset views are read-only.
+        with pytest.raises(ValueError):
+            batch.indices[0] = 1
+
+    def testDense(self):
+        dense = np.zeros((4, 20), dtype=np.uint8)
+        dense[0, 3] = 1
+        dense[2, [0, 19]] = 1
+        batch = SDRBatch.fromDense( dense )
+        assert( batch.offsets.tolist() == [ 0, 1, 1, 3, 3 ] )
+        assert( (batch.dense == dense).all() )
+        batch = SDRBatch.fromDense( dense, [4, 5] )
+        assert( batch.dimensions == [4, 5] )
+        with pytest.raises(RuntimeError):
+            SDRBatch.fromDense( dense, [3, 5] )
+
+    def testPickle(self):
+        batch = SDRBatch( [100] )
+        for i in range(5):
+            batch.append( SDR( 100 ).randomize( .1, i + 1 ) )
+        C = pickle.loads( pickle.dumps( batch ))
+        assert( C == batch )
+
+    def testSpatialPoolerComputeBatch(self):
+        inputs = [ SDR( 100 ).randomize( .05, i + 1 ) for i in range(5) ]
+        batch  = SDRBatch( [100] )
+        for inp in inputs:
+            batch.append( inp )
+        spA = SP( [100], [200], stimulusThreshold = 1, seed = 42 )
+        spB = SP( [100], [200], stimulusThreshold = 1, seed = 42 )
+        outputs = spA.computeBatch( batch, True )
+        assert( len(outputs) == len(inputs) )
+        active = SDR( 200 )
+        for i, inp in enumerate(inputs):
+            spB.compute( inp, True, active )
+            assert( outputs[i] == active )
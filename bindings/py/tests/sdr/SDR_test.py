@@ -170,6 +170,31 @@ class SdrTest(unittest.TestCase):
         else:
             self.fail()
 
+    def testSparseNumpy(self):
+        A = SDR( 1000 )
+        # Contiguous uint32 arrays take the fast path.
+        A.sparse = np.array([ 1, 5, 999 ], dtype=np.uint32)
+        assert( A.sparse.tolist() == [ 1, 5, 999 ] )
+        # Unsorted data is sorted.
+        A.sparse = np.array([ 7, 3, 2 ], dtype=np.uint32)
+        assert( A.sparse.tolist() == [ 2, 3, 7 ] )
+        # Non-contiguous and other dtypes are converted.
+        A.sparse = np.array([ 1, 0, 5, 0, 9, 0 ], dtype=np.uint32)[::2]
+        assert( A.sparse.tolist() == [ 1, 5, 9 ] )
+        A.sparse = np.array([ 4, 8 ], dtype=np.int64)
+        assert( A.sparse.tolist() == [ 4, 8 ] )
+        # Assigning the SDR's own sparse array back to itself.
+        data = A.sparse
+        data[1] = 6
+        A.sparse = data
+        assert( A.sparse.tolist() == [ 4, 6 ] )
+        with pytest.raises(RuntimeError):
+            A.sparse = np.array([ 3, 3 ], dtype=np.uint32)
+        with pytest.raises(RuntimeError):
+            A.sparse = np.array([ 3, 1000 ], dtype=np.uint32)
+        with pytest.raises(RuntimeError):
+            A.sparse = np.array([ 1000, 3 ], dtype=np.uint32)
+
     def testCoordinates(self):
         A = SDR((103,))
         B = SDR((100, 100, 1))
@@ -34,6 +34,7 @@ execute_process(COMMAND ${CMAKE_COMMAND}
 	    -D CMAKE_INSTALL_PREFIX=. 
             -D NEEDS_BOOST:BOOL=${NEEDS_BOOST}
             -D BINDING_BUILD:STRING=${BINDING_BUILD}
+            -D BUILD_BENCHMARKS:BOOL=${BUILD_BENCHMARKS}
             -D CMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}
             -D REPOSITORY_DIR=${REPOSITORY_DIR}
 		../../external
@@ -0,0 +1,322 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Micro-benchmarks for Connections, SpatialPooler, TemporalMemory,
+ * Classifier and AnomalyLikelihood.
+ */
+
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include <htm/algorithms/AnomalyLikelihood.hpp>
+#include <htm/algorithms/Connections.hpp>
+#include <htm/algorithms/SDRClassifier.hpp>
+#include <htm/algorithms/SpatialPooler.hpp>
+#include <htm/algorithms/TemporalMemory.hpp>
+#include <htm/types/Sdr.hpp>
+#include <htm/utils/Random.hpp>
+
+namespace {
+
+using namespace std;
+using namespace htm;
+
+const UInt SEED = 42u;
+
+// Create numSegments segments on random cells, each with synapsesPerSegment
+// synapses to random presynaptic cells.
+void randomConnections(Connections &c, Random &rng, CellIdx numCells,
+                       UInt numSegments, UInt synapsesPerSegment) {
+  c.initialize(numCells, 0.5f);
+  for (UInt s = 0; s < numSegments; s++) {
+    const Segment seg = c.createSegment(rng.getUInt32(numCells));
+    for (UInt i = 0; i < synapsesPerSegment; i++) {
+      c.createSynapse(seg, rng.getUInt32(numCells), rng.getReal64() < 0.5 ? 0.4f : 0.6f);
+    }
+  }
+}
+
+// Arguments: number of cells, synapses per segment.
+void BM_ConnectionsComputeActivity(benchmark::State &state) {
+  const CellIdx numCells = static_cast<CellIdx>(state.range(0));
+  const UInt synapses = static_cast<UInt>(state.range(1));
+  Random rng(SEED);
+  Connections c;
+  randomConnections(c, rng, numCells, numCells / 2u, synapses);
+  SDR active({numCells});
+  active.randomize(0.02f, rng);
+  vector<SynapseIdx> potential(c.numSegments());
+
+  for (auto _ : state) {
+    auto connected = c.computeActivity(potential, active.getSparse(), false);
+    benchmark::DoNotOptimize(connected.data());
+  }
+  state.counters["synapses"] = static_cast<double>(c.numSynapses());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConnectionsComputeActivity)
+    ->Args({2048, 32})->Args({16384, 32})->Args({65536, 32})->Args({65536, 128});
+
+// Arguments: synapses per segment.
+void BM_ConnectionsAdaptSegment(benchmark::State &state) {
+  const CellIdx numCells = 4096u;
+  const UInt numSegments = 1024u;
+  Random rng(SEED);
+  Connections c;
+  randomConnections(c, rng, numCells, numSegments, static_cast<UInt>(state.range(0)));
+  SDR inputs({numCells});
+  inputs.randomize(0.1f, rng);
+
+  Segment seg = 0u;
+  for (auto _ : state) {
+    c.adaptSegment(seg, inputs, 0.01f, 0.01f);
+    seg = (seg + 1u) % numSegments;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConnectionsAdaptSegment)->Arg(16)->Arg(64)->Arg(255);
+
+// Arguments: synapses per segment.
+void BM_ConnectionsBumpSegment(benchmark::State &state) {
+  const CellIdx numCells = 4096u;
+  const UInt numSegments = 1024u;
+  Random rng(SEED);
+  Connections c;
+  randomConnections(c, rng, numCells, numSegments, static_cast<UInt>(state.range(0)));
+
+  Segment seg = 0u;
+  Permanence delta = 0.01f;
+  for (auto _ : state) {
+    c.bumpSegment(seg, delta);
+    seg = (seg + 1u) % numSegments;
+    if (seg == 0u) delta = -delta;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConnectionsBumpSegment)->Arg(16)->Arg(64)->Arg(255);
+
+// Arguments: number of growth candidates.  Each iteration grows synapses on
+// a new segment, so the iteration count is fixed to bound memory use.
+void BM_ConnectionsGrowSynapses(benchmark::State &state) {
+  const CellIdx numCells = 65536u;
+  Random rng(SEED);
+  Connections c(numCells);
+  vector<CellIdx> candidates;
+  for (Int64 i = 0; i < state.range(0); i++) {
+    candidates.push_back(rng.getUInt32(numCells));
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+  CellIdx cell = 0u;
+  for (auto _ : state) {
+    const Segment seg = c.createSegment(cell);
+    c.growSynapses(seg, candidates, 0.21f, rng, 20u, 255u);
+    cell = (cell + 1u) % numCells;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConnectionsGrowSynapses)->Arg(32)->Arg(256)->Arg(1024)->Iterations(20000);
+
+// Arguments: number of cells.  Times Connections::reorder() on connections
+// which have had a third of their segments destroyed.
+void BM_ConnectionsReorder(benchmark::State &state) {
+  const CellIdx numCells = static_cast<CellIdx>(state.range(0));
+  Random rng(SEED);
+  Connections c;
+  randomConnections(c, rng, numCells, numCells / 2u, 32u);
+  for (Segment seg = 0; seg < c.segmentFlatListLength(); seg += 3u) {
+    c.destroySegment(seg);
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    Connections copy = c;
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(copy.reorder());
+  }
+  state.counters["synapses"] = static_cast<double>(c.numSynapses());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConnectionsReorder)->Arg(16384)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+// Arguments: number of columns, global inhibition (1) or local (0).
+void BM_SpatialPoolerCompute(benchmark::State &state) {
+  const UInt numInputs = 1024u;
+  const UInt numColumns = static_cast<UInt>(state.range(0));
+  const bool global = state.range(1) != 0;
+  SpatialPooler sp({numInputs}, {numColumns},
+                   /* potentialRadius */ global ? numInputs : 16u,
+                   /* potentialPct */ 0.5f,
+                   /* globalInhibition */ global,
+                   /* localAreaDensity */ 0.02f);
+  Random rng(SEED);
+  vector<SDR> inputs(100, SDR({numInputs}));
+  for (auto &in : inputs) {
+    in.randomize(0.05f, rng);
+  }
+  SDR active({numColumns});
+
+  size_t i = 0u;
+  for (auto _ : state) {
+    sp.compute(inputs[i], true, active);
+    i = (i + 1u) % inputs.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpatialPoolerCompute)
+    ->Args({1024, 1})->Args({4096, 1})->Args({1024, 0})->Args({4096, 0})
+    ->Unit(benchmark::kMicrosecond);
+
+// Arguments: number of columns, input density in percent.  Dense inputs,
+// like MNIST at 20%, take the bitset overlap path.
+void BM_SpatialPoolerDenseInput(benchmark::State &state) {
+  const UInt numInputs = 784u;
+  const UInt numColumns = static_cast<UInt>(state.range(0));
+  SpatialPooler sp({numInputs}, {numColumns},
+                   /* potentialRadius */ numInputs,
+                   /* potentialPct */ 0.5f,
+                   /* globalInhibition */ true,
+                   /* localAreaDensity */ 0.02f);
+  Random rng(SEED);
+  vector<SDR> inputs(100, SDR({numInputs}));
+  for (auto &in : inputs) {
+    in.randomize(static_cast<Real>(state.range(1)) / 100.0f, rng);
+  }
+  SDR active({numColumns});
+
+  size_t i = 0u;
+  for (auto _ : state) {
+    sp.compute(inputs[i], false, active);
+    i = (i + 1u) % inputs.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpatialPoolerDenseInput)
+    ->Args({1024, 2})->Args({1024, 20})->Args({4096, 20})->Args({4096, 50})
+    ->Unit(benchmark::kMicrosecond);
+
+// Arguments: number of columns, learning threads.
+void BM_SpatialPoolerLearnThreads(benchmark::State &state) {
+  const UInt numInputs = 4096u;
+  const UInt numColumns = static_cast<UInt>(state.range(0));
+  SpatialPooler sp({numInputs}, {numColumns},
+                   /* potentialRadius */ numInputs,
+                   /* potentialPct */ 0.5f,
+                   /* globalInhibition */ true,
+                   /* localAreaDensity */ 0.02f);
+  sp.setNumThreads(static_cast<UInt>(state.range(1)));
+  Random rng(SEED);
+  vector<SDR> inputs(100, SDR({numInputs}));
+  for (auto &in : inputs) {
+    in.randomize(0.05f, rng);
+  }
+  SDR active({numColumns});
+
+  size_t i = 0u;
+  for (auto _ : state) {
+    sp.compute(inputs[i], true, active);
+    i = (i + 1u) % inputs.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpatialPoolerLearnThreads)
+    ->Args({4096, 1})->Args({4096, 2})->Args({4096, 4})->Args({16384, 1})->Args({16384, 4})
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Arguments: number of columns, cells per column.  Learns a repeating
+// sequence, so the timing includes a steady state of predicted columns.
+void BM_TemporalMemoryCompute(benchmark::State &state) {
+  const CellIdx numColumns = static_cast<CellIdx>(state.range(0));
+  TemporalMemory tm({numColumns}, static_cast<CellIdx>(state.range(1)));
+  Random rng(SEED);
+  vector<SDR> sequence(50, SDR({numColumns}));
+  for (auto &sdr : sequence) {
+    sdr.randomize(0.02f, rng);
+  }
+
+  size_t i = 0u;
+  for (auto _ : state) {
+    tm.compute(sequence[i], true);
+    i = (i + 1u) % sequence.size();
+  }
+  state.counters["segments"] = static_cast<double>(tm.connections.numSegments());
+  state.counters["synapses"] = static_cast<double>(tm.connections.numSynapses());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TemporalMemoryCompute)
+    ->Args({2048, 32})->Args({2048, 8})->Args({8192, 16})
+    ->Unit(benchmark::kMicrosecond);
+
+// Arguments: input size.
+void BM_ClassifierInfer(benchmark::State &state) {
+  const UInt size = static_cast<UInt>(state.range(0));
+  Random rng(SEED);
+  Classifier clsr;
+  SDR pattern({size});
+  for (UInt i = 0; i < 100u; i++) {
+    pattern.randomize(0.02f, rng);
+    clsr.learn(pattern, {i % 10u});
+  }
+
+  for (auto _ : state) {
+    auto pdf = clsr.infer(pattern);
+    benchmark::DoNotOptimize(pdf.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClassifierInfer)->Arg(2048)->Arg(16384);
+
+// Arguments: input size.
+void BM_ClassifierLearn(benchmark::State &state) {
+  const UInt size = static_cast<UInt>(state.range(0));
+  Random rng(SEED);
+  Classifier clsr;
+  vector<SDR> patterns(100, SDR({size}));
+  for (auto &p : patterns) {
+    p.randomize(0.02f, rng);
+  }
+
+  UInt i = 0u;
+  for (auto _ : state) {
+    clsr.learn(patterns[i % patterns.size()], {i % 10u});
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClassifierLearn)->Arg(2048)->Arg(16384);
+
+void BM_AnomalyLikelihood(benchmark::State &state) {
+  AnomalyLikelihood al;
+  Random rng(SEED);
+  vector<Real> scores(1000);
+  for (auto &s : scores) {
+    s = static_cast<Real>(rng.getReal64());
+  }
+
+  size_t i = 0u;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(al.anomalyProbability(scores[i]));
+    i = (i + 1u) % scores.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AnomalyLikelihood);
+
+} // namespace
@@ -0,0 +1,115 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Micro-benchmarks for the encoders.
+ */
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <htm/encoders/DateEncoder.hpp>
+#include <htm/encoders/RandomDistributedScalarEncoder.hpp>
+#include <htm/encoders/ScalarEncoder.hpp>
+#include <htm/encoders/SimHashDocumentEncoder.hpp>
+#include <htm/types/Sdr.hpp>
+
+namespace {
+
+using namespace std;
+using namespace htm;
+
+void BM_ScalarEncoder(benchmark::State &state) {
+  ScalarEncoderParameters p;
+  p.minimum    = 0.0;
+  p.maximum    = 100.0;
+  p.size       = 1000u;
+  p.activeBits = 21u;
+  ScalarEncoder enc(p);
+  SDR out(enc.dimensions);
+
+  Real64 x = 0.0;
+  for (auto _ : state) {
+    enc.encode(x, out);
+    x = x < 100.0 ? x + 0.37 : 0.0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScalarEncoder);
+
+// Arguments: output size.  Sparsity is 2%.
+void BM_RDSE(benchmark::State &state) {
+  RDSE_Parameters p;
+  p.size       = static_cast<UInt>(state.range(0));
+  p.sparsity   = 0.02f;
+  p.resolution = 0.1f;
+  p.seed       = 42u;
+  RandomDistributedScalarEncoder enc(p);
+  SDR out(enc.dimensions);
+
+  Real64 x = 0.0;
+  for (auto _ : state) {
+    enc.encode(x, out);
+    x += 0.37;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RDSE)->Arg(1000)->Arg(16384);
+
+void BM_DateEncoder(benchmark::State &state) {
+  DateEncoderParameters p;
+  p.season_width    = 5u;
+  p.dayOfWeek_width = 5u;
+  p.weekend_width   = 5u;
+  p.holiday_width   = 5u;
+  p.timeOfDay_width = 5u;
+  DateEncoder enc(p);
+  SDR out(enc.dimensions);
+
+  std::time_t t = 1577836800; // 2020-01-01 00:00:00 UTC
+  for (auto _ : state) {
+    enc.encode(t, out);
+    t += 3607;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateEncoder);
+
+// Arguments: number of tokens per document.
+void BM_SimHashDocumentEncoder(benchmark::State &state) {
+  SimHashDocumentEncoderParameters p;
+  p.size       = 400u;
+  p.activeBits = 21u;
+  SimHashDocumentEncoder enc(p);
+  SDR out(enc.dimensions);
+
+  vector<string> document;
+  for (Int64 i = 0; i < state.range(0); i++) {
+    document.push_back("token" + to_string(i % 97));
+  }
+
+  for (auto _ : state) {
+    enc.encode(document, out);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimHashDocumentEncoder)->Arg(8)->Arg(64);
+
+} // namespace
@@ -0,0 +1,73 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Micro-benchmarks for the Network engine: Link::compute and a full
+ * Network::run() iteration.
+ */
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <htm/engine/Network.hpp>
+#include <htm/engine/Region.hpp>
+
+namespace {
+
+using namespace std;
+using namespace htm;
+
+// Arguments: encoder output size.  Encoder -> SP, this times only the copy
+// of the encoder output into the SP's input buffer.
+void BM_LinkCompute(benchmark::State &state) {
+  const string size = to_string(state.range(0));
+  Network net;
+  net.addRegion("encoder", "RDSEEncoderRegion", "{size: " + size + ", sparsity: 0.02, radius: 0.03, seed: 42}");
+  auto sp = net.addRegion("sp", "SPRegion", "{columnCount: 2048, globalInhibition: true}");
+  net.link("encoder", "sp", "", "", "encoded", "bottomUpIn");
+  net.initialize();
+  net.run(1);
+
+  for (auto _ : state) {
+    sp->prepareInputs();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LinkCompute)->Arg(1000)->Arg(65536);
+
+// One iteration of the Encoder -> SP -> TM network from napi_hello.
+void BM_NetworkRun(benchmark::State &state) {
+  Network net;
+  auto encoder = net.addRegion("encoder", "RDSEEncoderRegion", "{size: 1000, sparsity: 0.2, radius: 0.03, seed: 2019}");
+  net.addRegion("sp", "SPRegion", "{columnCount: 2048, globalInhibition: true}");
+  net.addRegion("tm", "TMRegion", "{cellsPerColumn: 8, orColumnOutputs: true}");
+  net.link("encoder", "sp", "", "", "encoded", "bottomUpIn");
+  net.link("sp", "tm", "", "", "bottomUpOut", "bottomUpIn");
+  net.initialize();
+
+  Real64 x = 0.0;
+  for (auto _ : state) {
+    encoder->setParameterReal64("sensedValue", x);
+    net.run(1);
+    x += 0.01;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NetworkRun)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,31 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Entry point for the micro-benchmark suite.  Each *Benchmark.cpp file in
+ * this directory registers its benchmarks with BENCHMARK().
+ *
+ * Usage:
+ *   benchmarks --benchmark_filter=SpatialPooler
+ *   benchmarks --benchmark_out=results.json --benchmark_out_format=json
+ *
+ * See compare_benchmarks.py for comparing two JSON results.
+ */
+
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,138 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Micro-benchmarks for SDR format conversions and set operations.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <htm/types/Sdr.hpp>
+#include <htm/utils/Random.hpp>
+
+namespace {
+
+using namespace std;
+using namespace htm;
+
+const UInt SEED = 42u;
+
+// Arguments: SDR size.  Sparsity is 2%.
+void BM_SdrDenseToSparse(benchmark::State &state) {
+  const UInt size = static_cast<UInt>(state.range(0));
+  Random rng(SEED);
+  SDR A({size});
+  A.randomize(0.02f, rng);
+  SDR_dense_t dense = A.getDense();
+
+  for (auto _ : state) {
+    A.setDense(dense);
+    benchmark::DoNotOptimize(A.getSparse().data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdrDenseToSparse)->Arg(2048)->Arg(65536);
+
+void BM_SdrSparseToDense(benchmark::State &state) {
+  const UInt size = static_cast<UInt>(state.range(0));
+  Random rng(SEED);
+  SDR A({size});
+  A.randomize(0.02f, rng);
+  SDR_sparse_t sparse = A.getSparse();
+
+  for (auto _ : state) {
+    A.setSparse(sparse);
+    benchmark::DoNotOptimize(A.getDense().data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdrSparseToDense)->Arg(2048)->Arg(65536);
+
+void BM_SdrSparseToCoordinates(benchmark::State &state) {
+  Random rng(SEED);
+  SDR A({64u, 64u});
+  A.randomize(0.02f, rng);
+  SDR_sparse_t sparse = A.getSparse();
+
+  for (auto _ : state) {
+    A.setSparse(sparse);
+    benchmark::DoNotOptimize(A.getCoordinates().data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdrSparseToCoordinates);
+
+void BM_SdrGetOverlap(benchmark::State &state) {
+  const UInt size = static_cast<UInt>(state.range(0));
+  Random rng(SEED);
+  SDR A({size});
+  SDR B({size});
+  A.randomize(0.02f, rng);
+  B.randomize(0.02f, rng);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(A.getOverlap(B));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdrGetOverlap)->Arg(2048)->Arg(65536);
+
+void BM_SdrIntersection(benchmark::State &state) {
+  const UInt size = static_cast<UInt>(state.range(0));
+  Random rng(SEED);
+  SDR A({size});
+  SDR B({size});
+  SDR C({size});
+  A.randomize(0.1f, rng);
+  B.randomize(0.1f, rng);
+
+  for (auto _ : state) {
+    C.intersection(A, B);
+    benchmark::DoNotOptimize(C.getSparse().data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdrIntersection)->Arg(2048)->Arg(65536);
+
+void BM_SdrUnion(benchmark::State &state) {
+  const UInt size = static_cast<UInt>(state.range(0));
+  Random rng(SEED);
+  SDR A({size});
+  SDR B({size});
+  SDR C({size});
+  A.randomize(0.02f, rng);
+  B.randomize(0.02f, rng);
+
+  for (auto _ : state) {
+    C.set_union(A, B);
+    benchmark::DoNotOptimize(C.getSparse().data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdrUnion)->Arg(2048)->Arg(65536);
+
+void BM_SdrRandomize(benchmark::State &state) {
+  Random rng(SEED);
+  SDR A({2048u});
+  for (auto _ : state) {
+    A.randomize(0.02f, rng);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdrRandomize);
+
+} // namespace
@@ -0,0 +1,89 @@
+# ------------------------------------------------------------------------------
+# HTM Community Edition of NuPIC
+# Copyright (C) 2020, Numenta, Inc.
+#
+# This program is free software: you can redistribute it and/or modify it under
+# the terms of the GNU Affero Public License version 3 as published by the Free
+# Software Foundation.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU Affero Public License for more details.
+#
+# You should have received a copy of the GNU Affero Public License along with
+# this program.  If not, see http://www.gnu.org/licenses.
+# ------------------------------------------------------------------------------
+"""
+Compare two google-benchmark JSON results, for example from two commits:
+
+    git checkout master  && make benchmarks_json && cp benchmarks.json base.json
+    git checkout feature && make benchmarks_json
+    python compare_benchmarks.py base.json benchmarks.json --threshold 0.10
+
+Prints the time of every benchmark found in both files and the relative
+change.  When the results contain repetition aggregates the median is used.
+Exits with status 1 if any benchmark got slower by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    """ Returns dict of benchmark name -> time in nanoseconds. """
+    with open(path) as f:
+        data = json.load(f)
+    units = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    plain   = {}
+    medians = {}
+    for bm in data['benchmarks']:
+        time = bm[metric] * units[bm.get('time_unit', 'ns')]
+        if bm.get('run_type') == 'aggregate':
+            if bm.get('aggregate_name') == 'median':
+                medians[bm.get('run_name', bm['name'].rsplit('_', 1)[0])] = time
+        else:
+            # Without aggregates keep the fastest repetition.
+            name = bm.get('run_name', bm['name'])
+            plain[name] = min(time, plain.get(name, time))
+    plain.update(medians)
+    return plain
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__,
+                        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('baseline', help='JSON results of the reference build.')
+    parser.add_argument('contender', help='JSON results of the build to check.')
+    parser.add_argument('--metric', choices=['real_time', 'cpu_time'], default='cpu_time')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='Fail if a benchmark is slower by more than this fraction. Default 0.05')
+    args = parser.parse_args(argv)
+
+    base = load(args.baseline,  args.metric)
+    new  = load(args.contender, args.metric)
+
+    width = max([len(name) for name in base] + [len('Benchmark')])
+    print('%-*s %14s %14s %9s' % (width, 'Benchmark', 'baseline ns', 'contender ns', 'change'))
+    regressions = []
+    for name in sorted(set(base) & set(new)):
+        change = (new[name] - base[name]) / base[name] if base[name] else 0.0
+        flag = ''
+        if change > args.threshold:
+            regressions.append(name)
+            flag = '  SLOWER'
+        print('%-*s %14.1f %14.1f %+8.1f%%%s' % (width, name, base[name], new[name], 100 * change, flag))
+
+    for name in sorted(set(base) - set(new)):
+        print('%-*s only in baseline' % (width, name))
+    for name in sorted(set(new) - set(base)):
+        print('%-*s only in contender' % (width, name))
+
+    if regressions:
+        print('\n%d benchmark(s) slower by more than %.1f%%.' % (len(regressions), 100 * args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,120 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+// A client for the binary RPC server of the NetworkAPI.
+// Before running this client example, start rpc_server in the background.
+// USAGE:  rpc_client [address [--stop]]
+//         The default address is "/tmp/htm.sock".  With --stop the server is
+//         stopped afterwards.
+//
+// What should happen:
+//  1) client creates a Network on the server:   encoder -> SP -> TM
+//     with the encoder input linked to the application source "source".
+//  2) EPOCHS iterations, one request at a time: set the input, run,
+//     get the TM anomaly.  Each call waits for the server.
+//  3) the same EPOCHS iterations, pipelined: all requests are sent before
+//     the results are read.
+//  4) the same EPOCHS iterations in one RUN_BATCH request.
+//  The time per iteration is printed for each of these.
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <htm/engine/RPCclient.hpp>
+
+#define DEFAULT_ADDRESS "/tmp/htm.sock"
+#define EPOCHS 1000 // The number of iterations
+
+using namespace htm;
+
+static Array sample(size_t i) { return Array(std::vector<Real64>({std::sin(0.01 * (Real64)i)})); }
+
+// Microseconds per iteration since 'start'.
+static double perIteration(std::chrono::steady_clock::time_point start) {
+  const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / EPOCHS;
+}
+
+int main(int argc, char **argv) {
+  std::string address = DEFAULT_ADDRESS;
+  if (argc >= 2)
+    address = argv[1];
+  const bool stop = (argc == 3 && std::string(argv[2]) == "--stop");
+
+  // See Network.configure() for syntax.
+  const std::string config = R"(
+   {network: [
+       {addRegion: {name: "encoder", type: "RDSERegion", params: {size: 1000, sparsity: 0.2, radius: 0.03, seed: 2019}}},
+       {addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 2048, globalInhibition: true}}},
+       {addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 8, orColumnOutputs: true}}},
+       {addLink:   {src: "INPUT.source", dest: "encoder.values", dim: [1]}},
+       {addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}},
+       {addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn"}}
+    ]})";
+
+  try {
+    std::cout << "Connecting to server: " << address << std::endl;
+    RPCclient client(address);
+
+    // 2) one request at a time.
+    std::string id = client.createNetwork(config);
+    auto start = std::chrono::steady_clock::now();
+    Array anomaly;
+    for (size_t i = 0; i < EPOCHS; i++) {
+      client.setInput(id, "source", sample(i));
+      client.run(id);
+      anomaly = client.getOutput(id, "tm", "anomaly");
+    }
+    std::cout << "Synchronous: " << perIteration(start) << " us/iteration, anomaly "
+              << anomaly.asVector<Real32>()[0] << std::endl;
+    client.deleteNetwork(id);
+
+    // 3) pipelined.
+    id = client.createNetwork(config);
+    start = std::chrono::steady_clock::now();
+    UInt32 last = 0;
+    for (size_t i = 0; i < EPOCHS; i++) {
+      client.send(RPCop::SET_INPUT, RPCbuffer().putString(id).putString("source").putArray(sample(i)));
+      client.send(RPCop::RUN, RPCbuffer().putString(id).putUInt32(1u));
+      last = client.send(RPCop::GET_OUTPUT, RPCbuffer().putString(id).putString("tm").putString("anomaly"));
+    }
+    anomaly = client.receive(last).getArray();
+    std::cout << "Pipelined:   " << perIteration(start) << " us/iteration, anomaly "
+              << anomaly.asVector<Real32>()[0] << std::endl;
+    client.deleteNetwork(id);
+
+    // 4) one batch.
+    id = client.createNetwork(config);
+    start = std::chrono::steady_clock::now();
+    std::vector<Array> inputs;
+    for (size_t i = 0; i < EPOCHS; i++)
+      inputs.push_back(sample(i));
+    const auto results = client.runBatch(id, "source", inputs, {"tm.anomaly"});
+    std::cout << "Batch:       " << perIteration(start) << " us/iteration, anomaly "
+              << results.back()[0].asVector<Real32>()[0] << std::endl;
+    client.deleteNetwork(id);
+
+    if (stop)
+      client.stopServer();
+  } catch (Exception &e) {
+    std::cerr << e.getMessage() << std::endl;
+    return 1;
+  }
+  return 0;
+}
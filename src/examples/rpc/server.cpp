@@ -0,0 +1,47 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+// This runs the binary RPC server for the NetworkAPI.
+// USAGE:  rpc_server [address]
+//         address is the path of a Unix domain socket, default "/tmp/htm.sock",
+//         or "tcp://<host>:<port>".  An empty host is the loopback interface.
+// The server runs until a client sends STOP (RPCclient::stopServer()).
+
+#include <iostream>
+
+#include <htm/engine/RPCserver.hpp>
+
+#define DEFAULT_ADDRESS "/tmp/htm.sock"
+
+using namespace htm;
+
+int main(int argc, char **argv) {
+  std::string address = DEFAULT_ADDRESS;
+  if (argc == 2)
+    address = argv[1];
+
+  try {
+    RPCserver server;
+    std::cout << "Starting RPC server on " << address << std::endl;
+    server.listen(address);
+    std::cout << "Server stopped." << std::endl;
+  } catch (Exception &e) {
+    std::cerr << e.getMessage() << std::endl;
+    return 1;
+  }
+  return 0;
+}
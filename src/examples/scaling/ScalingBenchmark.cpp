@@ -0,0 +1,403 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the scaling benchmark.
+ */
+
+#include "ScalingBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#if defined(NTA_OS_WINDOWS)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <htm/algorithms/SpatialPooler.hpp>
+#include <htm/algorithms/TemporalMemory.hpp>
+#include <htm/engine/Network.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/engine/Spec.hpp>
+#include <htm/types/Sdr.hpp>
+#include <htm/utils/Log.hpp>
+#include <htm/utils/MemoryPolicy.hpp>
+#include <htm/utils/Random.hpp>
+#include <htm/utils/ThreadPool.hpp>
+
+namespace examples {
+
+using namespace std;
+using namespace htm;
+
+namespace {
+
+const UInt NUM_PATTERNS = 100u; // length of the repeating input sequence
+
+// A model instance which can be stepped.  step() must not share state with
+// other instances, they are stepped concurrently.
+class Model {
+public:
+  virtual ~Model() {}
+  virtual void step(UInt iteration) = 0;
+  virtual UInt64 numSynapses() const = 0;
+};
+
+vector<SDR> randomPatterns(UInt size, Real32 sparsity, Random &rng) {
+  vector<SDR> patterns(NUM_PATTERNS, SDR({size}));
+  for (auto &p : patterns) {
+    p.randomize(sparsity, rng);
+  }
+  return patterns;
+}
+
+class SPModel : public Model {
+public:
+  SPModel(const ScalingPoint &pt, UInt seed)
+      : sp_({pt.inputSize}, {pt.columns},
+            /* potentialRadius */ pt.inputSize,
+            /* potentialPct */ 0.5f,
+            /* globalInhibition */ true,
+            /* localAreaDensity */ 0.02f,
+            /* numActiveColumnsPerInhArea */ 0u,
+            /* stimulusThreshold */ 0u,
+            /* synPermInactiveDec */ 0.008f,
+            /* synPermActiveInc */ 0.05f,
+            /* synPermConnected */ 0.1f,
+            /* minPctOverlapDutyCycles */ 0.001f,
+            /* dutyCyclePeriod */ 1000u,
+            /* boostStrength */ 0.0f,
+            /* seed */ static_cast<Int>(seed)),
+        active_({pt.columns}) {
+    sp_.setMemoryPolicy(MemoryPolicy::parse(pt.memory));
+    Random rng(seed);
+    inputs_ = randomPatterns(pt.inputSize, pt.sparsity, rng);
+  }
+  void step(UInt iteration) override {
+    sp_.compute(inputs_[iteration % inputs_.size()], true, active_);
+  }
+  UInt64 numSynapses() const override { return sp_.connections.numSynapses(); }
+
+private:
+  SpatialPooler sp_;
+  vector<SDR> inputs_;
+  SDR active_;
+};
+
+class TMModel : public Model {
+public:
+  TMModel(const ScalingPoint &pt, UInt seed)
+      : tm_({pt.columns}, pt.cellsPerColumn,
+            /* activationThreshold */ 13u,
+            /* initialPermanence */ 0.21f,
+            /* connectedPermanence */ 0.5f,
+            /* minThreshold */ 10u,
+            /* maxNewSynapseCount */ 20u,
+            /* permanenceIncrement */ 0.1f,
+            /* permanenceDecrement */ 0.1f,
+            /* predictedSegmentDecrement */ 0.0f,
+            /* seed */ static_cast<Int>(seed)) {
+    tm_.setMemoryPolicy(MemoryPolicy::parse(pt.memory));
+    Random rng(seed);
+    inputs_ = randomPatterns(pt.columns, pt.sparsity, rng);
+  }
+  void step(UInt iteration) override {
+    tm_.compute(inputs_[iteration % inputs_.size()], true);
+  }
+  UInt64 numSynapses() const override { return tm_.connections.numSynapses(); }
+
+private:
+  TemporalMemory tm_;
+  vector<SDR> inputs_;
+};
+
+string replaceAll(string str, const string &from, const string &to) {
+  size_t pos = 0u;
+  while ((pos = str.find(from, pos)) != string::npos) {
+    str.replace(pos, from.size(), to);
+    pos += to.size();
+  }
+  return str;
+}
+
+class NetworkModel : public Model {
+public:
+  NetworkModel(const ScalingPoint &pt, UInt seed, const string &config) {
+    ostringstream sparsity;
+    sparsity << pt.sparsity;
+    string yaml = config;
+    yaml = replaceAll(yaml, "$COLUMNS",   to_string(pt.columns));
+    yaml = replaceAll(yaml, "$CELLS",     to_string(pt.cellsPerColumn));
+    yaml = replaceAll(yaml, "$INPUTSIZE", to_string(pt.inputSize));
+    yaml = replaceAll(yaml, "$SPARSITY",  sparsity.str());
+    yaml = replaceAll(yaml, "$SEED",      to_string(seed));
+    net_.configure(yaml);
+    net_.initialize();
+
+    const auto regions = net_.getRegions();
+    for (size_t i = 0; i < regions.getCount(); i++) {
+      auto region = regions.getByIndex(i).second;
+      if (region->getSpec()->parameters.contains("numSynapses"))
+        counted_.push_back(region);
+    }
+    if (regions.contains("encoder")) {
+      auto encoder = regions.getByName("encoder");
+      if (encoder->getSpec()->parameters.contains("sensedValue"))
+        encoder_ = encoder;
+    }
+    Random rng(seed);
+    for (UInt i = 0; i < NUM_PATTERNS; i++) {
+      values_.push_back(std::sin(i * 0.1) + 0.1 * rng.getReal64());
+    }
+  }
+  void step(UInt iteration) override {
+    if (encoder_)
+      encoder_->setParameterReal64("sensedValue", values_[iteration % values_.size()]);
+    net_.run(1);
+  }
+  UInt64 numSynapses() const override {
+    UInt64 n = 0u;
+    for (const auto &region : counted_)
+      n += region->getParameterUInt64("numSynapses");
+    return n;
+  }
+
+private:
+  Network net_;
+  shared_ptr<Region> encoder_;
+  vector<shared_ptr<Region>> counted_;
+  vector<Real64> values_;
+};
+
+Real64 percentile(vector<Real64> &sorted, Real64 p) {
+  if (sorted.empty())
+    return 0.0;
+  const size_t i = static_cast<size_t>(std::ceil(p * sorted.size())) - 1u;
+  return sorted[std::min(i, sorted.size() - 1u)];
+}
+
+// Reset the peak RSS counter (VmHWM) of this process, Linux only.
+void resetPeakRss() {
+#if defined(NTA_OS_LINUX)
+  ofstream clear("/proc/self/clear_refs");
+  if (clear.good())
+    clear << "5";
+#endif
+}
+
+} // namespace
+
+
+ScalingBenchmark::ScalingBenchmark(UInt steps, UInt warmup, UInt seed, const string &networkTemplate)
+    : steps_(steps), warmup_(warmup), seed_(seed),
+      networkTemplate_(networkTemplate.empty() ? defaultNetwork() : networkTemplate) {
+  NTA_CHECK(steps_ > 0u) << "ScalingBenchmark: steps must be > 0";
+}
+
+
+ScalingResult ScalingBenchmark::run(const ScalingPoint &point) const {
+  NTA_CHECK(point.threads > 0u) << "ScalingBenchmark: threads must be > 0";
+  resetPeakRss();
+
+  vector<unique_ptr<Model>> models;
+  for (UInt k = 0; k < point.threads; k++) {
+    const UInt seed = seed_ + k;
+    if (point.model == "sp")
+      models.emplace_back(new SPModel(point, seed));
+    else if (point.model == "tm")
+      models.emplace_back(new TMModel(point, seed));
+    else if (point.model == "network")
+      models.emplace_back(new NetworkModel(point, seed, networkTemplate_));
+    else
+      NTA_THROW << "ScalingBenchmark: unknown model '" << point.model << "', expected sp, tm or network.";
+  }
+
+  // Each instance records the latency of each of its own timed steps.
+  vector<vector<Real64>> latency(point.threads, vector<Real64>(steps_));
+  const MemoryPolicy policy = MemoryPolicy::parse(point.memory);
+  ThreadPool pool(point.threads, policy.placement == MemoryPolicy::Placement::NODE
+                                     ? cpusOfNumaNode(policy.node) : vector<int>());
+  // The warmup is not included in the wall clock time.
+  if (warmup_ > 0u) {
+    pool.parallelFor(models.size(), [&](size_t k) {
+      for (UInt i = 0; i < warmup_; i++)
+        models[k]->step(i);
+    });
+  }
+  const auto start = chrono::steady_clock::now();
+  pool.parallelFor(models.size(), [&](size_t k) {
+    Model &model = *models[k];
+    for (UInt i = 0; i < steps_; i++) {
+      const auto t0 = chrono::steady_clock::now();
+      model.step(warmup_ + i);
+      latency[k][i] = chrono::duration<Real64, milli>(chrono::steady_clock::now() - t0).count();
+    }
+  });
+  const Real64 seconds = chrono::duration<Real64>(chrono::steady_clock::now() - start).count();
+
+  vector<Real64> all;
+  all.reserve(static_cast<size_t>(point.threads) * steps_);
+  for (const auto &l : latency)
+    all.insert(all.end(), l.begin(), l.end());
+  std::sort(all.begin(), all.end());
+
+  ScalingResult result;
+  result.point       = point;
+  result.steps       = steps_;
+  result.seconds     = seconds;
+  result.stepsPerSec = seconds > 0.0 ? all.size() / seconds : 0.0;
+  result.p50Ms       = percentile(all, 0.50);
+  result.p99Ms       = percentile(all, 0.99);
+  result.peakRssKB   = peakRssKB();
+  result.synapses    = models.front()->numSynapses();
+  return result;
+}
+
+
+vector<ScalingPoint> ScalingBenchmark::sweep(const vector<string> &models,
+                                             const vector<UInt> &columns,
+                                             const vector<UInt> &cellsPerColumn,
+                                             const vector<UInt> &inputSize,
+                                             const vector<Real32> &sparsity,
+                                             const vector<UInt> &threads,
+                                             const vector<string> &memory) {
+  vector<ScalingPoint> points;
+  const auto same = [](const ScalingPoint &a, const ScalingPoint &b) {
+    return a.model == b.model && a.columns == b.columns && a.cellsPerColumn == b.cellsPerColumn &&
+           a.inputSize == b.inputSize && a.sparsity == b.sparsity && a.threads == b.threads &&
+           a.memory == b.memory;
+  };
+  for (const auto &model : models) {
+    for (const auto c : columns) {
+      for (const auto cells : cellsPerColumn) {
+        for (const auto in : inputSize) {
+          for (const auto s : sparsity) {
+            for (const auto t : threads) {
+              for (const auto &mem : memory) {
+                ScalingPoint pt;
+                pt.model          = model;
+                pt.columns        = c;
+                pt.cellsPerColumn = model == "sp" ? 0u : cells;
+                pt.inputSize      = model == "tm" ? c : in;
+                pt.sparsity       = s;
+                pt.threads        = t;
+                pt.memory         = model == "network" ? "default" : MemoryPolicy::parse(mem).toString();
+                bool duplicate = false;
+                for (const auto &p : points)
+                  duplicate = duplicate || same(p, pt);
+                if (!duplicate)
+                  points.push_back(pt);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return points;
+}
+
+
+string ScalingBenchmark::defaultNetwork() {
+  return R"(
+network:
+  - addRegion:
+      name: "encoder"
+      type: "RDSEEncoderRegion"
+      params: {size: $INPUTSIZE, sparsity: $SPARSITY, radius: 0.03, seed: $SEED}
+  - addRegion:
+      name: "sp"
+      type: "SPRegion"
+      params: {columnCount: $COLUMNS, globalInhibition: true, localAreaDensity: 0.02, seed: $SEED}
+  - addRegion:
+      name: "tm"
+      type: "TMRegion"
+      params: {cellsPerColumn: $CELLS, seed: $SEED}
+  - addLink:
+      src: "encoder.encoded"
+      dest: "sp.bottomUpIn"
+  - addLink:
+      src: "sp.bottomUpOut"
+      dest: "tm.bottomUpIn"
+)";
+}
+
+
+void ScalingBenchmark::writeCSVHeader(ostream &out) {
+  out << "model,columns,cellsPerColumn,inputSize,sparsity,threads,memory,"
+         "steps,seconds,stepsPerSec,p50Ms,p99Ms,peakRssKB,synapses\n";
+}
+
+void ScalingBenchmark::writeCSV(ostream &out, const ScalingResult &r) {
+  const ScalingPoint &p = r.point;
+  out << p.model << "," << p.columns << "," << p.cellsPerColumn << "," << p.inputSize << ","
+      << p.sparsity << "," << p.threads << "," << p.memory << "," << r.steps << "," << r.seconds << ","
+      << r.stepsPerSec << "," << r.p50Ms << "," << r.p99Ms << "," << r.peakRssKB << ","
+      << r.synapses << "\n";
+}
+
+void ScalingBenchmark::writeJSON(ostream &out, const vector<ScalingResult> &results) {
+  out << "[\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const ScalingResult &r = results[i];
+    const ScalingPoint &p = r.point;
+    out << "  {\"model\": \"" << p.model << "\", \"columns\": " << p.columns
+        << ", \"cellsPerColumn\": " << p.cellsPerColumn << ", \"inputSize\": " << p.inputSize
+        << ", \"sparsity\": " << p.sparsity << ", \"threads\": " << p.threads
+        << ", \"memory\": \"" << p.memory << "\""
+        << ", \"steps\": " << r.steps << ", \"seconds\": " << r.seconds
+        << ", \"stepsPerSec\": " << r.stepsPerSec << ", \"p50Ms\": " << r.p50Ms
+        << ", \"p99Ms\": " << r.p99Ms << ", \"peakRssKB\": " << r.peakRssKB
+        << ", \"synapses\": " << r.synapses << "}" << (i + 1u < results.size() ? ",\n" : "\n");
+  }
+  out << "]\n";
+}
+
+
+UInt64 ScalingBenchmark::peakRssKB() {
+#if defined(NTA_OS_WINDOWS)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return static_cast<UInt64>(pmc.PeakWorkingSetSize) / 1024u;
+  return 0u;
+#else
+#if defined(NTA_OS_LINUX)
+  ifstream status("/proc/self/status");
+  string line;
+  while (getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::stoull(line.substr(6)); // "VmHWM:   1234 kB"
+  }
+#endif
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#if defined(NTA_OS_DARWIN)
+  return static_cast<UInt64>(usage.ru_maxrss) / 1024u; // bytes on OSX
+#else
+  return static_cast<UInt64>(usage.ru_maxrss);         // KB on Linux
+#endif
+#endif
+}
+
+} // namespace examples
@@ -0,0 +1,131 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Scaling benchmark: measures throughput, step latency and memory of the
+ * SpatialPooler, TemporalMemory and a full Network over a sweep of model
+ * sizes and thread counts.  See scaling.cpp for the command line.
+ */
+
+#ifndef NTA_EXAMPLES_SCALING_BENCHMARK_
+#define NTA_EXAMPLES_SCALING_BENCHMARK_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <htm/types/Types.hpp>
+
+namespace examples {
+
+using htm::Real32;
+using htm::Real64;
+using htm::UInt;
+using htm::UInt64;
+
+/**
+ * One point of the sweep.
+ *
+ * model is "sp", "tm" or "network".  Parameters which do not apply to a
+ * model are ignored: the SP has no cellsPerColumn, and the TM input is one
+ * bit per column so it has no separate inputSize.
+ *
+ * threads is the number of independent model instances which are stepped
+ * concurrently, one per thread.  This is how the aggregate throughput of a
+ * machine scales for this model, none of the algorithms are multi-threaded
+ * internally.
+ *
+ * memory is a MemoryPolicy string such as "huge+interleave", applied to
+ * the Connections of the SP and TM models.  With a "node:N" policy the
+ * instances also run on threads pinned to the CPUs of node N.  It is
+ * ignored by the network model.
+ */
+struct ScalingPoint {
+  std::string model = "sp";
+  UInt   columns        = 2048u;
+  UInt   cellsPerColumn = 8u;
+  UInt   inputSize      = 1000u;
+  Real32 sparsity       = 0.02f;
+  UInt   threads        = 1u;
+  std::string memory    = "default";
+};
+
+struct ScalingResult {
+  ScalingPoint point;
+  UInt   steps       = 0u;   // timed steps per instance
+  Real64 seconds     = 0.0;  // wall clock time of the timed steps
+  Real64 stepsPerSec = 0.0;  // summed over all instances
+  Real64 p50Ms       = 0.0;  // step latency percentiles, in milliseconds
+  Real64 p99Ms       = 0.0;
+  UInt64 peakRssKB   = 0u;   // see ScalingBenchmark::peakRssKB()
+  UInt64 synapses    = 0u;   // per instance, after the last step
+};
+
+class ScalingBenchmark {
+public:
+  /**
+   * @param steps  Number of timed steps per instance.
+   * @param warmup Number of untimed steps before the timed steps, so that
+   *               the models reach a steady number of synapses.
+   * @param seed   Seed for the inputs and the models.  Instance k of a point
+   *               uses seed + k.  Results are reproducible for a given seed.
+   * @param networkTemplate JSON or YAML for Network::configure(), used for
+   *               model "network".  The strings $COLUMNS, $CELLS, $INPUTSIZE,
+   *               $SPARSITY and $SEED are replaced by the values of the point.
+   *               If a region named "encoder" has a "sensedValue" parameter it
+   *               is fed a deterministic signal.  Empty means defaultNetwork().
+   */
+  ScalingBenchmark(UInt steps = 1000u, UInt warmup = 100u, UInt seed = 42u,
+                   const std::string &networkTemplate = "");
+
+  ScalingResult run(const ScalingPoint &point) const;
+
+  /**
+   * The cartesian product of the given values, without points which only
+   * differ in a parameter that does not apply to the model.
+   */
+  static std::vector<ScalingPoint> sweep(const std::vector<std::string> &models,
+                                         const std::vector<UInt> &columns,
+                                         const std::vector<UInt> &cellsPerColumn,
+                                         const std::vector<UInt> &inputSize,
+                                         const std::vector<Real32> &sparsity,
+                                         const std::vector<UInt> &threads,
+                                         const std::vector<std::string> &memory = {"default"});
+
+  /** Encoder -> SPRegion -> TMRegion, like napi_hello. */
+  static std::string defaultNetwork();
+
+  static void writeCSVHeader(std::ostream &out);
+  static void writeCSV(std::ostream &out, const ScalingResult &result);
+  static void writeJSON(std::ostream &out, const std::vector<ScalingResult> &results);
+
+  /**
+   * Peak resident set size of this process, in KB.  On Linux this is VmHWM,
+   * which run() resets before every point.  Elsewhere it is the high-water
+   * mark of the whole process, so sweep from small to large models.
+   */
+  static UInt64 peakRssKB();
+
+private:
+  UInt steps_;
+  UInt warmup_;
+  UInt seed_;
+  std::string networkTemplate_;
+};
+
+} // namespace examples
+#endif // NTA_EXAMPLES_SCALING_BENCHMARK_
@@ -0,0 +1,141 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Command line driver for the scaling benchmark.
+ *
+ *  scaling [options]
+ *    --models   sp,tm,network  which models to run (default sp,tm,network)
+ *    --columns  1024,2048      number of mini-columns (default 2048)
+ *    --cells    8,32           TM cells per column (default 8)
+ *    --inputs   1000           SP / encoder input size (default 1000)
+ *    --sparsity 0.02,0.05      input sparsity (default 0.02)
+ *    --threads  1,2,4          concurrent model instances (default 1)
+ *    --memory   default,huge   Connections MemoryPolicy of the SP & TM, such as
+ *                              huge, interleave, node:0 or huge+interleave (default default)
+ *    --steps    1000           timed steps per point (default 1000)
+ *    --warmup   100            untimed steps per point (default 100)
+ *    --seed     42             (default 42)
+ *    --network  file           Network::configure() template, see ScalingBenchmark.hpp
+ *    --csv      file           write results as CSV
+ *    --json     file           write results as JSON
+ *
+ *  Every point is printed to stdout as CSV while the sweep runs.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ScalingBenchmark.hpp"
+#include <htm/utils/Log.hpp>
+
+using namespace std;
+using namespace examples;
+
+namespace {
+
+template <typename T> vector<T> parseList(const string &arg) {
+  vector<T> values;
+  stringstream ss(arg);
+  string item;
+  while (getline(ss, item, ',')) {
+    stringstream is(item);
+    T v;
+    is >> v;
+    NTA_CHECK(!is.fail()) << "scaling: cannot parse '" << item << "'";
+    values.push_back(v);
+  }
+  return values;
+}
+
+string readFile(const string &path) {
+  ifstream in(path);
+  NTA_CHECK(in.good()) << "scaling: cannot open " << path;
+  stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  vector<string> models   = {"sp", "tm", "network"};
+  vector<UInt>   columns  = {2048u};
+  vector<UInt>   cells    = {8u};
+  vector<UInt>   inputs   = {1000u};
+  vector<Real32> sparsity = {0.02f};
+  vector<UInt>   threads  = {1u};
+  vector<string> memory   = {"default"};
+  UInt steps  = 1000u;
+  UInt warmup = 100u;
+  UInt seed   = 42u;
+  string network, csvFile, jsonFile;
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const string opt = argv[i];
+      NTA_CHECK(i + 1 < argc) << "scaling: missing value for " << opt;
+      const string val = argv[++i];
+      if      (opt == "--models")   models   = parseList<string>(val);
+      else if (opt == "--columns")  columns  = parseList<UInt>(val);
+      else if (opt == "--cells")    cells    = parseList<UInt>(val);
+      else if (opt == "--inputs")   inputs   = parseList<UInt>(val);
+      else if (opt == "--sparsity") sparsity = parseList<Real32>(val);
+      else if (opt == "--threads")  threads  = parseList<UInt>(val);
+      else if (opt == "--memory")   memory   = parseList<string>(val);
+      else if (opt == "--steps")    steps    = parseList<UInt>(val).at(0);
+      else if (opt == "--warmup")   warmup   = parseList<UInt>(val).at(0);
+      else if (opt == "--seed")     seed     = parseList<UInt>(val).at(0);
+      else if (opt == "--network")  network  = readFile(val);
+      else if (opt == "--csv")      csvFile  = val;
+      else if (opt == "--json")     jsonFile = val;
+      else NTA_THROW << "scaling: unknown option " << opt;
+    }
+
+    const ScalingBenchmark bench(steps, warmup, seed, network);
+    const auto points = ScalingBenchmark::sweep(models, columns, cells, inputs, sparsity, threads, memory);
+
+    ofstream csv;
+    if (!csvFile.empty()) {
+      csv.open(csvFile);
+      ScalingBenchmark::writeCSVHeader(csv);
+    }
+    ScalingBenchmark::writeCSVHeader(cout);
+
+    vector<ScalingResult> results;
+    for (const auto &point : points) {
+      results.push_back(bench.run(point));
+      ScalingBenchmark::writeCSV(cout, results.back());
+      if (csv.is_open()) {
+        ScalingBenchmark::writeCSV(csv, results.back());
+        csv.flush(); // keep partial results if a large point runs out of memory
+      }
+    }
+
+    if (!jsonFile.empty()) {
+      ofstream json(jsonFile);
+      ScalingBenchmark::writeJSON(json, results);
+    }
+  } catch (const std::exception &e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+// This runs a hyperparameter sweep of a Network, see htm/engine/ParameterSweep.hpp.
+// USAGE:  sweep <network.yaml> <sweep.yaml> <dataset.csv>
+//         network.yaml  the Network::configure() YAML to sweep.
+//         sweep.yaml    the search, metric and parameters, see ParameterSweep::configure().
+//         dataset.csv   one row of numbers per iteration.
+// Prints one CSV line per configuration, then the best one.
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <htm/engine/ParameterSweep.hpp>
+
+using namespace htm;
+
+static std::string readFile(const std::string &path) {
+  std::ifstream f(path.c_str());
+  NTA_CHECK(f.is_open()) << "Cannot open '" << path << "'.";
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+static void print(const ParameterSweep::Result &r) {
+  std::cout << r.index;
+  for (const auto &p : r.parameters)
+    std::cout << "," << p.second;
+  std::cout << "," << r.score << "," << r.seconds;
+  if (!r.error.empty())
+    std::cout << ",\"" << r.error << "\"";
+  std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 4) {
+    std::cerr << "USAGE: sweep <network.yaml> <sweep.yaml> <dataset.csv>" << std::endl;
+    return 1;
+  }
+  try {
+    ParameterSweep sweep(readFile(argv[1]));
+    sweep.configure(readFile(argv[2]));
+    sweep.loadDataset(argv[3]);
+
+    const auto configs = sweep.configurations();
+    std::cerr << "Evaluating " << configs.size() << " configurations over "
+              << sweep.getDatasetSize() << " rows." << std::endl;
+    if (configs.empty())
+      return 0;
+
+    std::cout << "index";
+    for (const auto &p : configs[0])
+      std::cout << "," << p.first;
+    std::cout << ",score,seconds" << std::endl;
+    const auto results = sweep.run();
+    for (const auto &r : results)
+      print(r);
+
+    std::cout << "best: ";
+    print(sweep.best(results));
+  } catch (Exception &e) {
+    std::cerr << e.getMessage() << std::endl;
+    return 1;
+  }
+  return 0;
+}
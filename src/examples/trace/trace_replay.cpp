@@ -0,0 +1,91 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Replays a trace recorded with htm::TraceRecorder and reports the timing.
+ *
+ *  trace_replay <trace file> [--no-verify] [--repeat N]
+ *
+ * The network is restored from the snapshot in the trace and driven with
+ * the recorded inputs as fast as possible.  If the trace contains outputs
+ * they are compared to the recording; the exit code is 1 on a mismatch.
+ * With --repeat the trace is replayed N times, each time from the snapshot,
+ * and the fastest run is reported.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <htm/engine/Network.hpp>
+#include <htm/engine/Trace.hpp>
+
+using namespace htm;
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: trace_replay <trace file> [--no-verify] [--repeat N]\n";
+    return 2;
+  }
+  bool verify = true;
+  int repeat = 1;
+  for (int i = 2; i < argc; i++) {
+    const std::string opt = argv[i];
+    if (opt == "--no-verify") {
+      verify = false;
+    } else if (opt == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::stoi(argv[++i]));
+    } else {
+      std::cerr << "trace_replay: unknown option " << opt << "\n";
+      return 2;
+    }
+  }
+
+  try {
+    TraceReplayer replayer(argv[1]);
+    std::cout << "trace:      " << argv[1] << "\n"
+              << "inputs:     " << replayer.getInputNames().size() << "\n"
+              << "outputs:    " << replayer.getOutputNames().size()
+              << (replayer.hasOutputs() ? "" : " (not recorded, nothing to verify)") << "\n";
+
+    TraceReplayReport best;
+    for (int r = 0; r < repeat; r++) {
+      Network net;
+      const TraceReplayReport report = replayer.replay(net, verify);
+      if (r == 0 || report.runSeconds < best.runSeconds)
+        best = report;
+    }
+
+    std::cout << std::fixed << std::setprecision(4)
+              << "iterations: " << best.iterations << "\n"
+              << "run time:   " << best.runSeconds << " s ("
+              << (best.runSeconds > 0.0 ? best.iterations / best.runSeconds : 0.0) << " iterations/s)\n"
+              << "total time: " << best.totalSeconds << " s\n";
+    if (verify && replayer.hasOutputs()) {
+      std::cout << "mismatches: " << best.mismatches << "\n";
+      if (best.mismatches > 0u) {
+        std::cout << "first:      " << best.firstMismatch << "\n";
+        return 1;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
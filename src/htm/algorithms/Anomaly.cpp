@@ -42,4 +42,25 @@ Real computeRawAnomalyScore(const SDR& active,
   return score;
 }
 
+Real computeRawAnomalyScore(const SDR& active,
+                            const SDR_sparse_t& predicted) {
+
+  NTA_ASSERT(std::is_sorted(predicted.begin(), predicted.end()));
+
+  // Return 0 if no active columns are present
+  if (active.getSum() == 0) {
+    return static_cast<Real>(0);
+  }
+
+  size_t both = 0;
+  for (const auto column : active.getSparse()) {
+    if (std::binary_search(predicted.begin(), predicted.end(), column))
+      both++;
+  }
+
+  const Real score = (active.getSum() - both) / static_cast<Real>(active.getSum());
+  NTA_ASSERT(score >= 0.0f and score <= 1.0f) << "Anomaly score out of bounds!";
+  return score;
+}
+
 } // End namespace
@@ -38,6 +38,13 @@ namespace htm {
 Real32 computeRawAnomalyScore(const SDR& active, 
                               const SDR& predicted);
 
+/**
+ * As above, with the predicted columns given as sorted sparse indices, for
+ * example TM.getPredictiveColumnsSparse().  Gives the same score.
+ */
+Real32 computeRawAnomalyScore(const SDR& active,
+                              const SDR_sparse_t& predicted);
+
 } //end-ns
 
 #endif // HTM_ALGORITHMS_ANOMALY_HPP
@@ -26,6 +26,7 @@
 #include <set>
 
 #include <htm/algorithms/Connections.hpp>
+#include <htm/utils/ThreadPool.hpp>
 
 using std::endl;
 using std::string;
@@ -33,6 +34,20 @@ using std::vector;
 using std::set;
 using namespace htm;
 
+namespace {
+// A synapse which got connected or disconnected during adaptSegments().
+struct ConnectedChange {
+  Synapse synapse;
+  bool    connect;
+};
+
+// Set on the worker threads of adaptSegments(), which record the changes of
+// the presynaptic maps here instead of applying them.
+thread_local vector<ConnectedChange> *deferredChanges = nullptr;
+}
+
+const Segment ConnectionsRemap::INVALID;
+
 Connections::Connections(const CellIdx numCells, 
 		         const Permanence connectedThreshold, 
 			 const bool timeseries) {
@@ -40,7 +55,7 @@ Connections::Connections(const CellIdx numCells,
 }
 
 void Connections::initialize(CellIdx numCells, Permanence connectedThreshold, bool timeseries) {
-  cells_ = vector<CellData>(numCells);
+  cells_.assign(numCells, CellData());
   segments_.clear();
   synapses_.clear();
   potentialSynapsesForPresynapticCell_.clear();
@@ -59,6 +74,21 @@ void Connections::initialize(CellIdx numCells, Permanence connectedThreshold, bo
   reset();
 }
 
+void Connections::setMemoryPolicy(const MemoryPolicy &policy) {
+  if (policy == getMemoryPolicy()) return;
+  PolicyVector<CellData> cells(std::make_move_iterator(cells_.begin()),
+                               std::make_move_iterator(cells_.end()),
+                               PolicyAllocator<CellData>(policy));
+  PolicyVector<SegmentData> segments(std::make_move_iterator(segments_.begin()),
+                                     std::make_move_iterator(segments_.end()),
+                                     PolicyAllocator<SegmentData>(policy));
+  PolicyVector<SynapseData> synapses(synapses_.cbegin(), synapses_.cend(),
+                                     PolicyAllocator<SynapseData>(policy));
+  cells_    = std::move(cells);
+  segments_ = std::move(segments);
+  synapses_ = std::move(synapses);
+}
+
 UInt32 Connections::subscribe(ConnectionsEventHandler *handler) {
   UInt32 token = nextEventToken_++;
   eventHandlers_[token] = handler;
@@ -94,6 +124,7 @@ void Connections::pruneLRUSegment_(const CellIdx& cell) {
   }
 #endif
   destroySegment(*leastRecentlyUsedSegment);
+  HTM_COUNT(counters_.segmentsEvicted, 1);
   NTA_ASSERT(destroyCandidates.size() < numBefore) << "A segment should have been pruned, but wasn't!";
 }
 
@@ -117,6 +148,7 @@ Segment Connections::createSegment(const CellIdx cell,
 
   CellData &cellData = cells_[cell];
   cellData.segments.push_back(segment); //assign the new segment to its mother-cell
+  HTM_COUNT(counters_.segmentsCreated, 1);
 
   for (auto h : eventHandlers_) {
     h.second->onCreateSegment(segment);
@@ -158,8 +190,11 @@ Synapse Connections::createSynapse(Segment segment,
   } //else: the new synapse is not duplicit, so keep creating it. 
 
   // Get an index into the synapses_ list, for the new synapse to reside at.
-  NTA_ASSERT(synapses_.size() < std::numeric_limits<Synapse>::max()) << "Add synapse failed: Range of Synapse (data-type) insufficient size."
-	    << synapses_.size() << " < " << (size_t)std::numeric_limits<Synapse>::max();
+  NTA_CHECK(synapses_.size() < std::numeric_limits<Synapse>::max()
+            && nextSynapseOrdinal_ < std::numeric_limits<Synapse>::max())
+      << "Add synapse failed: Range of Synapse (data-type) insufficient size. "
+      << synapses_.size() << " < " << (size_t)std::numeric_limits<Synapse>::max()
+      << ", call reorder() to reclaim destroyed synapses or build with HTM_64BIT_INDICES.";
   const Synapse synapse = static_cast<Synapse>(synapses_.size()); //TODO work on cache locality. Have all Synapse, SynapseData on Segment in continuous mem block ?
   synapses_.emplace_back(SynapseData());
 
@@ -177,7 +212,7 @@ Synapse Connections::createSynapse(Segment segment,
 
   SegmentData &segmentData = segments_[segment];
   segmentData.synapses.push_back(synapse);
-
+  HTM_COUNT(counters_.synapsesCreated, 1);
 
   for (auto h : eventHandlers_) {
     h.second->onCreateSynapse(synapse);
@@ -244,6 +279,44 @@ void Connections::removeSynapseFromPresynapticMap_(
 }
 
 
+void Connections::rebuildPresynapticMaps_() {
+  potentialSynapsesForPresynapticCell_.clear();
+  connectedSynapsesForPresynapticCell_.clear();
+  potentialSegmentsForPresynapticCell_.clear();
+  connectedSegmentsForPresynapticCell_.clear();
+
+  const Synapse unset = std::numeric_limits<Synapse>::max();
+  for (Synapse synapse = 0; synapse < static_cast<Synapse>(synapses_.size()); synapse++) {
+    const SynapseData &synData = synapses_[synapse];
+    if (not synapseExists_(synapse, true)) continue; //destroyed synapses are not in the maps
+
+    const bool connected = synData.permanence >= connectedThreshold_;
+    auto &preSynapses = connected ? connectedSynapsesForPresynapticCell_[synData.presynapticCell]
+                                  : potentialSynapsesForPresynapticCell_[synData.presynapticCell];
+    auto &preSegments = connected ? connectedSegmentsForPresynapticCell_[synData.presynapticCell]
+                                  : potentialSegmentsForPresynapticCell_[synData.presynapticCell];
+    const auto index = synData.presynapticMapIndex_;
+    if (index >= preSynapses.size()) {
+      preSynapses.resize(index + 1, unset);
+      preSegments.resize(index + 1);
+    }
+    NTA_CHECK(preSynapses[index] == unset)
+        << "Connections: synapses " << preSynapses[index] << " and " << synapse
+        << " have the same presynaptic map index " << index;
+    preSynapses[index] = synapse;
+    preSegments[index] = synData.segment;
+  }
+
+  for (const auto &cell : potentialSynapsesForPresynapticCell_) {
+    NTA_CHECK(std::find(cell.second.cbegin(), cell.second.cend(), unset) == cell.second.cend())
+        << "Connections: gap in potential presynaptic map of cell " << cell.first;
+  }
+  for (const auto &cell : connectedSynapsesForPresynapticCell_) {
+    NTA_CHECK(std::find(cell.second.cbegin(), cell.second.cend(), unset) == cell.second.cend())
+        << "Connections: gap in connected presynaptic map of cell " << cell.first;
+  }
+}
+
 void Connections::destroySegment(const Segment segment) {
   if(not segmentExists_(segment)) return;
 
@@ -266,6 +339,7 @@ void Connections::destroySegment(const Segment segment) {
 
   cellData.segments.erase(segmentOnCell);
   destroyedSegments_++;
+  HTM_COUNT(counters_.segmentsDestroyed, 1);
 
   NTA_ASSERT(not segmentExists_(segment));
 }
@@ -277,6 +351,7 @@ void Connections::destroySynapse(const Synapse synapse) {
   for (auto h : eventHandlers_) {
     h.second->onDestroySynapse(synapse);
   }
+  HTM_COUNT(counters_.synapsesDestroyed, 1);
 
   SynapseData& synapseData = synapses_[synapse]; //like dataForSynapse() but here we need writeable access
   SegmentData &segmentData = segments_[synapseData.segment];
@@ -338,20 +413,37 @@ void Connections::updateSynapsePermanence(const Synapse synapse,
   // update the permanence
   synData.permanence = permanence;
 
-  if( before == after ) { //no change in dis/connected status
-      return;
+  if( before != after ) { //change in dis/connected status
+    updateConnectedStatus_(synapse, after);
+  }
+}
+
+
+void Connections::updateConnectedStatus_(const Synapse synapse, const bool connect) {
+  auto &segmentData = segments_[synapses_[synapse].segment];
+  if( connect ) {
+    segmentData.numConnected++;
+  } else {
+    segmentData.numConnected--;
+  }
+  if( deferredChanges != nullptr ) { // adaptSegments() applies it later.
+    deferredChanges->push_back({synapse, connect});
+    return;
   }
+  updatePresynapticMaps_(synapse, connect);
+}
+
+
+void Connections::updatePresynapticMaps_(const Synapse synapse, const bool connect) {
+    auto &synData = synapses_[synapse];
     const auto &presyn    = synData.presynapticCell;
     auto &potentialPresyn = potentialSynapsesForPresynapticCell_[presyn];
     auto &potentialPreseg = potentialSegmentsForPresynapticCell_[presyn];
     auto &connectedPresyn = connectedSynapsesForPresynapticCell_[presyn];
     auto &connectedPreseg = connectedSegmentsForPresynapticCell_[presyn];
     const auto &segment   = synData.segment;
-    auto &segmentData     = segments_[segment];
     
-    if( after ) { //connect
-      segmentData.numConnected++;
-
+    if( connect ) {
       // Remove this synapse from presynaptic potential synapses.
       removeSynapseFromPresynapticMap_( synData.presynapticMapIndex_,
                                         potentialPresyn, potentialPreseg );
@@ -362,8 +454,6 @@ void Connections::updateSynapsePermanence(const Synapse synapse,
       connectedPreseg.push_back( segment );
     }
     else { //disconnected
-      segmentData.numConnected--;
-
       // Remove this synapse from presynaptic connected synapses.
       removeSynapseFromPresynapticMap_( synData.presynapticMapIndex_,
                                         connectedPresyn, connectedPreseg );
@@ -375,11 +465,52 @@ void Connections::updateSynapsePermanence(const Synapse synapse,
     }
 
     for (auto h : eventHandlers_) { //TODO handle callbacks in performance-critical method only in Debug?
-      h.second->onUpdateSynapsePermanence(synapse, permanence);
+      h.second->onUpdateSynapsePermanence(synapse, synData.permanence);
     }
 }
 
 
+void Connections::updatePermanences_(const Segment segment, const Permanence *deltas) {
+  // Scratch memory per thread, so that segments can be updated concurrently.
+  static thread_local vector<Permanence> permanences;
+  static thread_local vector<unsigned char> crossed;
+
+  const auto &synapses = segments_[segment].synapses;
+  const size_t numSynapses = synapses.size();
+  permanences.resize(numSynapses);
+  crossed.resize(numSynapses);
+  for (size_t i = 0; i < numSynapses; i++) {
+    permanences[i] = synapses_[synapses[i]].permanence;
+  }
+
+  // Update, clamp and find the threshold crossings in contiguous arrays.
+  // The loop is branch free so that the compiler vectorizes it, and it does
+  // the same arithmetic as updateSynapsePermanence().
+  Permanence *perm = permanences.data();
+  unsigned char *cross = crossed.data();
+  const Permanence threshold = connectedThreshold_;
+  for (size_t i = 0; i < numSynapses; i++) {
+    const Permanence before = perm[i];
+    Permanence after = before + deltas[i];
+    after = (maxPermanence < after) ? maxPermanence : after;
+    after = (after < minPermanence) ? minPermanence : after;
+    cross[i] = static_cast<unsigned char>((before >= threshold) != (after >= threshold));
+    perm[i] = after;
+  }
+
+  // Store the permanences, then fix the presynaptic maps of the few synapses
+  // which got connected or disconnected.  Same order as the scalar updates.
+  for (size_t i = 0; i < numSynapses; i++) {
+    synapses_[synapses[i]].permanence = perm[i];
+  }
+  for (size_t i = 0; i < numSynapses; i++) {
+    if (cross[i]) {
+      updateConnectedStatus_(synapses[i], perm[i] >= threshold);
+    }
+  }
+}
+
+
 SegmentIdx Connections::idxOnCellForSegment(const Segment segment) const {
   const vector<Segment> &segments = segmentsForCell(cellForSegment(segment));
   const auto it = std::find(segments.begin(), segments.end(), segment);
@@ -425,10 +556,107 @@ void Connections::reset() noexcept
   currentUpdates_.clear();
 }
 
+ConnectionsRemap Connections::reorder() {
+  ConnectionsRemap remap;
+  remap.segments.assign(segments_.size(), ConnectionsRemap::INVALID);
+  remap.synapses.assign(synapses_.size(), ConnectionsRemap::INVALID);
+
+  // Segments by cell, then by ordinal.  Destroyed segments are not on any cell.
+  // Stable, so that segments with equal ids keep their order on the cell.
+  PolicyVector<SegmentData> segments(segments_.get_allocator());
+  segments.reserve(numSegments());
+  for (auto &cellData : cells_) {
+    std::stable_sort(cellData.segments.begin(), cellData.segments.end(),
+              [&](const Segment a, const Segment b) { return segments_[a].id < segments_[b].id; });
+    for (auto &segment : cellData.segments) {
+      const Segment newSegment = static_cast<Segment>(segments.size());
+      remap.segments[segment] = newSegment;
+      segments.push_back(std::move(segments_[segment]));
+      segment = newSegment;
+    }
+  }
+
+  // Synapses by segment, then by presynaptic cell.  The segment's list of
+  // synapses stays sorted by synapse id, destroySynapse() relies on it.
+  PolicyVector<SynapseData> synapses(synapses_.get_allocator());
+  synapses.reserve(numSynapses());
+  vector<Synapse> order;
+  for (Segment segment = 0; segment < static_cast<Segment>(segments.size()); segment++) {
+    auto &segmentSynapses = segments[segment].synapses;
+    order.assign(segmentSynapses.cbegin(), segmentSynapses.cend());
+    std::sort(order.begin(), order.end(), [&](const Synapse a, const Synapse b) {
+      return synapses_[a].presynapticCell < synapses_[b].presynapticCell; });
+    for (const auto synapse : order) {
+      remap.synapses[synapse] = static_cast<Synapse>(synapses.size());
+      synapses.push_back(synapses_[synapse]);
+      synapses.back().segment = segment;
+    }
+    for (auto &synapse : segmentSynapses) {
+      synapse = remap.synapses[synapse];
+    }
+  }
+
+  // Renumber the synapse ids 0..n-1 in their old order, which keeps every
+  // segment's list sorted and reclaims the ids of the destroyed synapses.
+  vector<std::pair<Synapse, Synapse>> ids; // (old id, new index)
+  ids.reserve(synapses.size());
+  for (Synapse synapse = 0; synapse < static_cast<Synapse>(synapses.size()); synapse++) {
+    ids.emplace_back(synapses[synapse].id, synapse);
+  }
+  std::sort(ids.begin(), ids.end());
+  for (size_t rank = 0; rank < ids.size(); rank++) {
+    synapses[ids[rank].second].id = static_cast<Synapse>(rank);
+  }
+  nextSynapseOrdinal_ = static_cast<Synapse>(ids.size());
+
+  if( timeseries_ ) {
+    for (auto updates : {&previousUpdates_, &currentUpdates_}) {
+      if (updates->empty()) continue;
+      vector<Permanence> remapped(synapses.size(), minPermanence);
+      for (size_t s = 0; s < updates->size() && s < remap.synapses.size(); s++) {
+        if (remap.synapses[s] != ConnectionsRemap::INVALID)
+          remapped[remap.synapses[s]] = (*updates)[s];
+      }
+      updates->swap(remapped);
+    }
+  }
+
+  segments_ = std::move(segments);
+  synapses_ = std::move(synapses);
+  destroyedSegments_ = 0;
+  destroyedSynapses_ = 0;
+
+  // Presynaptic maps in the new order, so that computeActivity() visits
+  // the segments of each presynaptic cell in increasing order.
+  potentialSynapsesForPresynapticCell_.clear();
+  connectedSynapsesForPresynapticCell_.clear();
+  potentialSegmentsForPresynapticCell_.clear();
+  connectedSegmentsForPresynapticCell_.clear();
+  for (Synapse synapse = 0; synapse < static_cast<Synapse>(synapses_.size()); synapse++) {
+    SynapseData &synData = synapses_[synapse];
+    const bool connected = synData.permanence >= connectedThreshold_;
+    auto &preSynapses = connected ? connectedSynapsesForPresynapticCell_[synData.presynapticCell]
+                                  : potentialSynapsesForPresynapticCell_[synData.presynapticCell];
+    auto &preSegments = connected ? connectedSegmentsForPresynapticCell_[synData.presynapticCell]
+                                  : potentialSegmentsForPresynapticCell_[synData.presynapticCell];
+    synData.presynapticMapIndex_ = static_cast<Synapse>(preSynapses.size());
+    preSynapses.push_back(synapse);
+    preSegments.push_back(synData.segment);
+  }
+
+  for (auto h : eventHandlers_) {
+    h.second->onReorder(remap);
+  }
+  return remap;
+}
+
+
 vector<SynapseIdx> Connections::computeActivity(const vector<CellIdx> &activePresynapticCells, const bool learn) {
 
   vector<SynapseIdx> numActiveConnectedSynapsesForSegment(segments_.size(), 0);
   if(learn) iteration_++;
+  HTM_COUNT(counters_.computeActivityCalls, 1);
+  HTM_COUNT(counters_.cellsTouched, activePresynapticCells.size());
 
   if( timeseries_ ) {
     // Before each cycle of computation move the currentUpdates to the previous
@@ -440,7 +668,9 @@ vector<SynapseIdx> Connections::computeActivity(const vector<CellIdx> &activePre
   // Iterate through all connected synapses.
   for (const auto& cell : activePresynapticCells) {
     if (connectedSegmentsForPresynapticCell_.count(cell)) {
-      for(const auto& segment : connectedSegmentsForPresynapticCell_.at(cell)) {
+      const auto &segments = connectedSegmentsForPresynapticCell_.at(cell);
+      HTM_COUNT(counters_.segmentsTouched, segments.size());
+      for(const auto& segment : segments) {
         ++numActiveConnectedSynapsesForSegment[segment];
       }
     }
@@ -466,7 +696,9 @@ vector<SynapseIdx> Connections::computeActivity(
 
   for (const auto& cell : activePresynapticCells) {
     if (potentialSegmentsForPresynapticCell_.count(cell)) {
-      for(const auto& segment : potentialSegmentsForPresynapticCell_.at(cell)) {
+      const auto &segments = potentialSegmentsForPresynapticCell_.at(cell);
+      HTM_COUNT(counters_.segmentsTouched, segments.size());
+      for(const auto& segment : segments) {
         ++numActivePotentialSynapsesForSegment[segment];
       }
     }
@@ -489,8 +721,13 @@ void Connections::adaptSegment(const Segment segment,
     currentUpdates_.resize(  synapses_.size(), minPermanence );
   }
 
+  HTM_COUNT(counters_.synapsesAdapted, synapsesForSegment(segment).size());
+  static thread_local vector<Permanence> deltas;
   vector<Synapse> destroyLater;
-  for(const auto synapse: synapsesForSegment(segment)) {
+  const auto &synapses = synapsesForSegment(segment);
+  deltas.resize(synapses.size());
+  for(size_t i = 0; i < synapses.size(); i++) {
+      const Synapse synapse = synapses[i];
       const SynapseData &synapseData = dataForSynapse(synapse);
 
       Permanence update;
@@ -499,25 +736,26 @@ void Connections::adaptSegment(const Segment segment,
       } else {
         update = -decrement;
       }
+      deltas[i] = update;
 
     //prune permanences that reached zero
     if (pruneZeroSynapses and 
         synapseData.permanence + update < htm::minPermanence + htm::Epsilon) { //new value will disconnect the synapse
       destroyLater.push_back(synapse);
       prunedSyns_++; //for statistics
+      deltas[i] = 0.0f; //destroyed below, leave it as is
       continue;
     }
 
     //update synapse, but for TS only if changed
     if(timeseries_) {
-      if( update != previousUpdates_[synapse] ) {
-        updateSynapsePermanence(synapse, synapseData.permanence + update);
+      if( update == previousUpdates_[synapse] ) {
+        deltas[i] = 0.0f;
       }
       currentUpdates_[ synapse ] = update;
-    } else {
-      updateSynapsePermanence(synapse, synapseData.permanence + update);
     }
   }
+  updatePermanences_(segment, deltas.data());
 
   //destroy synapses accumulated for pruning
   for(const auto pruneSyn : destroyLater) {
@@ -537,6 +775,58 @@ void Connections::adaptSegment(const Segment segment,
 }
 
 
+void Connections::adaptSegments(const vector<Segment> &segments,
+                                const SDR &inputs,
+                                const Permanence increment,
+                                const Permanence decrement,
+                                const UInt segmentThreshold,
+                                ThreadPool *pool)
+{
+  if( pool == nullptr or pool->size() < 2u or timeseries_ or segments.size() < 2u ) {
+    for( const auto segment : segments ) {
+      adaptSegment(segment, inputs, increment, decrement);
+      raisePermanencesToThreshold(segment, segmentThreshold);
+    }
+    return;
+  }
+
+  const auto &inputArray = inputs.getDense(); // Not thread safe, get it before the workers do.
+  for( const auto segment : segments ) {
+    HTM_COUNT(counters_.synapsesAdapted, synapsesForSegment(segment).size());
+  }
+
+  // Each worker takes a contiguous range of the segments and records its
+  // changes to the presynaptic maps.  The permanences and the connected
+  // counts are private to each segment, so these are updated in place.
+  const size_t numChunks = std::min(segments.size(), 4u * pool->size());
+  vector<vector<ConnectedChange>> changes(numChunks);
+  pool->parallelFor(numChunks, [&](const size_t chunk) {
+    struct Reset { ~Reset() { deferredChanges = nullptr; } } reset;
+    deferredChanges = &changes[chunk];
+    vector<Permanence> deltas;
+    const size_t end = (chunk + 1u) * segments.size() / numChunks;
+    for( size_t i = chunk * segments.size() / numChunks; i < end; i++ ) {
+      const Segment segment = segments[i];
+      const auto &synapses = synapsesForSegment(segment);
+      deltas.resize(synapses.size());
+      for( size_t s = 0; s < synapses.size(); s++ ) {
+        deltas[s] = inputArray[synapses_[synapses[s]].presynapticCell] ? increment : -decrement;
+      }
+      updatePermanences_(segment, deltas.data());
+      raisePermanencesToThreshold(segment, segmentThreshold);
+    }
+  });
+
+  // Apply the map changes in the order of the serial loop, so that the
+  // presynaptic maps are identical to it.
+  for( const auto &chunkChanges : changes ) {
+    for( const auto &change : chunkChanges ) {
+      updatePresynapticMaps_(change.synapse, change.connect);
+    }
+  }
+}
+
+
 /**
  * Called for under-performing Segments (can have synapses pruned, etc.). After
  * the call, Segment will have at least segmentThreshold synapses connected, so
@@ -647,10 +937,9 @@ void Connections::synapseCompetition(
 
 
 void Connections::bumpSegment(const Segment segment, const Permanence delta) {
-  // TODO: vectorize?
-  for( const auto syn : synapsesForSegment(segment) ) {
-    updateSynapsePermanence(syn, synapses_[syn].permanence + delta);
-  }
+  static thread_local vector<Permanence> deltas;
+  deltas.assign(synapsesForSegment(segment).size(), delta);
+  updatePermanences_(segment, deltas.data());
 }
 
 
@@ -700,12 +989,13 @@ void Connections::destroyMinPermanenceSynapses(
 
 
 void Connections::growSynapses(const Segment segment, 
-		                          const vector<Synapse>& growthCandidates, 
+		                          const vector<CellIdx>& growthCandidates, 
 					  const Permanence initialPermanence,
 					  Random& rng,
 					  const size_t maxNew,
 					  const size_t maxSynapsesPerSegment) {
 
+  HTM_COUNT(counters_.growCalls, 1);
   //0. copy input vector - candidate cells on input
   vector<CellIdx> candidates(growthCandidates.begin(), growthCandidates.end());
 
@@ -737,6 +1027,24 @@ void Connections::growSynapses(const Segment segment,
 }
 
 
+CounterMap Connections::getCounters() const {
+  CounterMap counters;
+  if (HTM_COUNTERS_ENABLED) {
+    counters["computeActivityCalls"] = counters_.computeActivityCalls;
+    counters["cellsTouched"]         = counters_.cellsTouched;
+    counters["segmentsTouched"]      = counters_.segmentsTouched;
+    counters["synapsesAdapted"]      = counters_.synapsesAdapted;
+    counters["growCalls"]            = counters_.growCalls;
+    counters["segmentsCreated"]      = counters_.segmentsCreated;
+    counters["segmentsDestroyed"]    = counters_.segmentsDestroyed;
+    counters["segmentsEvicted"]      = counters_.segmentsEvicted;
+    counters["synapsesCreated"]      = counters_.synapsesCreated;
+    counters["synapsesDestroyed"]    = counters_.synapsesDestroyed;
+  }
+  return counters;
+}
+
+
 namespace htm {
 /**
  * print statistics in human readable form
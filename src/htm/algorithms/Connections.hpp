@@ -22,10 +22,13 @@
 #ifndef NTA_CONNECTIONS_HPP
 #define NTA_CONNECTIONS_HPP
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <map>
 #include <unordered_map>
 #include <set>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <deque>
@@ -33,15 +36,24 @@
 #include <htm/types/Types.hpp>
 #include <htm/types/Serializable.hpp>
 #include <htm/types/Sdr.hpp>
+#include <htm/utils/Counters.hpp>
+#include <htm/utils/MemoryPolicy.hpp>
 
 namespace htm {
 
+class ThreadPool;
+
 //TODO instead of typedefs, use templates for proper type-checking?
 using CellIdx   = htm::ElemSparse; // CellIdx must match with ElemSparse, defined in Sdr.hpp
 using SegmentIdx= UInt16; /** Index of segment in cell. */
 using SynapseIdx= UInt16; /** Index of synapse in segment. */
+#ifdef HTM_64BIT_INDICES
+using Segment   = UInt64;    /** Index of segment's data. */
+using Synapse   = UInt64;    /** Index of synapse's data. */
+#else
 using Segment   = UInt32;    /** Index of segment's data. */
 using Synapse   = UInt32;    /** Index of synapse's data. */
+#endif
 using Permanence= Real32; //TODO experiment with half aka float16
 constexpr const Permanence minPermanence = 0.0f;
 constexpr const Permanence maxPermanence = 1.0f;
@@ -204,6 +216,48 @@ struct CellData : public Serializable {
 };
 
 
+/**
+ * The index changes made by Connections::reorder().
+ *
+ * segments[s] is the new index of the segment which had index s, and
+ * synapses[s] likewise for synapses.  Segments and synapses which had been
+ * destroyed before the reorder are removed by it, and map to INVALID.
+ */
+struct ConnectionsRemap {
+  static const Segment INVALID = std::numeric_limits<Segment>::max();
+
+  std::vector<Segment> segments;
+  std::vector<Synapse> synapses;
+
+  /**
+   * Replace every segment in the list by its new index, and drop the
+   * segments which no longer exist.  The relative order is kept.
+   */
+  void remapSegments(std::vector<Segment> &list) const {
+    size_t kept = 0;
+    for (const auto segment : list) {
+      const Segment newSegment = segment < segments.size() ? segments[segment] : INVALID;
+      if (newSegment != INVALID)
+        list[kept++] = newSegment;
+    }
+    list.resize(kept);
+  }
+
+  /**
+   * Move the values of a vector indexed by segment to the new indices.
+   * Values of removed segments are dropped.
+   */
+  template<class T>
+  void permuteSegmentValues(std::vector<T> &values, size_t newLength) const {
+    std::vector<T> permuted(newLength, T());
+    for (size_t s = 0; s < values.size() && s < segments.size(); s++) {
+      if (segments[s] != INVALID)
+        permuted[segments[s]] = values[s];
+    }
+    values.swap(permuted);
+  }
+};
+
 /**
  * A base class for Connections event handlers.
  *
@@ -239,6 +293,11 @@ public:
    */
   virtual void onUpdateSynapsePermanence(Synapse synapse,
                                          Permanence permanence) {}
+
+  /**
+   * Called after Connections::reorder() renumbered the segments and synapses.
+   */
+  virtual void onReorder(const ConnectionsRemap &remap) {}
 };
 
 /**
@@ -381,7 +440,7 @@ public:
    *
    **/
   void growSynapses(const Segment segment, 
-		                    const std::vector<Synapse>& growthCandidates, 
+		                    const std::vector<CellIdx>& growthCandidates, 
 				    const Permanence initialPermanence,
 				    Random& rng,
 				    const size_t maxNew = 0,
@@ -547,6 +606,30 @@ public:
    */
   void reset() noexcept;
 
+  /**
+   * Renumber the segments and synapses for locality of memory access.
+   *
+   * Segments and synapses get their index in creation order, so after long
+   * learning the segments of a cell and the synapses of a segment are
+   * scattered over the whole arrays.  This stores the segments ordered by
+   * (cell, ordinal) and the synapses ordered by (segment, presynaptic cell),
+   * removes the records of destroyed segments & synapses, and rebuilds the
+   * presynaptic maps in the new order.  The data of every segment and
+   * synapse is unchanged, and so is the order of compareSegments(), except
+   * that the synapse ids are renumbered densely in their old order.  This
+   * also reclaims the ids of destroyed synapses, which otherwise only grow.
+   *
+   * All Segment and Synapse indices held outside of this class become
+   * invalid.  Translate them with the returned remap table; subscribed event
+   * handlers are given it in onReorder().  Call it at a point where nothing
+   * else uses this Connections, for example between two compute() calls.
+   * It takes time linear in the number of synapses, so run it periodically,
+   * see TemporalMemory::setReorderPeriod().
+   *
+   * @returns The map from old to new indices.
+   */
+  ConnectionsRemap reorder();
+
   /**
    * Compute the segment excitations for a vector of active presynaptic
    * cells.
@@ -612,6 +695,27 @@ public:
   void raisePermanencesToThreshold(const Segment    segment,
                                    const UInt       segmentThreshold);
 
+  /**
+   * Learns on many segments, with exactly the same result as calling
+   * adaptSegment(segment, inputs, increment, decrement) followed by
+   * raisePermanencesToThreshold(segment, segmentThreshold) for each segment
+   * in the given order.  This is the learning step of the SpatialPooler.
+   *
+   * With a pool the permanences of the segments are updated concurrently, and
+   * the resulting changes to the presynaptic maps are applied afterwards in
+   * the order of the segments.  Event handlers are notified during that last
+   * step.  The segments must be distinct.  Timeseries mode always runs serially.
+   *
+   * @param segments  Segments to learn on, in order.
+   * @param pool  (optional) Worker threads, nullptr runs serially.
+   */
+  void adaptSegments(const std::vector<Segment> &segments,
+                     const SDR &inputs,
+                     const Permanence increment,
+                     const Permanence decrement,
+                     const UInt segmentThreshold,
+                     ThreadPool *pool = nullptr);
+
 
   /**
    *  iteration: ever increasing step count. 
@@ -623,6 +727,33 @@ public:
 //!  const UInt32& iteration = iteration_; //FIXME cannot construct iteration like this?
   UInt32 iteration() const noexcept { return iteration_; }
 
+  /**
+   * Hot-path counters, see htm/utils/Counters.hpp.  Only counted when built
+   * with HTM_COUNTERS, otherwise getCounters() returns an empty map.
+   * Counters are not serialized.
+   *
+   * computeActivityCalls, cellsTouched (active presynaptic cells looked up),
+   * segmentsTouched (segment activity increments), synapsesAdapted,
+   * growCalls, segmentsCreated, segmentsDestroyed, segmentsEvicted (least
+   * recently used segments removed to make room), synapsesCreated,
+   * synapsesDestroyed.
+   */
+  CounterMap getCounters() const;
+  void resetCounters() noexcept { counters_ = ConnectionsCounters_(); }
+
+  /**
+   * Select the page size and NUMA placement of the core arrays (the cell,
+   * segment and synapse records), see MemoryPolicy.  This matters for
+   * models of many GB, where random access into the synapses suffers TLB
+   * misses and, on NUMA machines, the first-touch policy scatters the
+   * arrays over the nodes.  The current contents are moved to the new
+   * storage, so this can be called at any time.
+   *
+   * The policy is a property of this process, it is not serialized.
+   */
+  void setMemoryPolicy(const MemoryPolicy &policy);
+  MemoryPolicy getMemoryPolicy() const { return synapses_.get_allocator().policy; }
+
 
   /**
    * Ensures that the number of connected synapses is sane.  This method
@@ -673,9 +804,36 @@ public:
 
 
   // Serialization
+  //
+  // Text archives (JSON, XML) store every SynapseData/SegmentData/CellData
+  // record as a nested object, and also store the four presynaptic maps.
+  // Binary archives (BINARY, PORTABLE) instead store the core arrays as
+  // columns; one contiguous block per field. Each block is a cereal size tag
+  // followed by the raw elements, which PORTABLE writes little-endian.
+  // The presynaptic maps are not stored, they are rebuilt on load from
+  // SynapseData::presynapticMapIndex_.  The binary layout starts with
+  // BINARY_MAGIC, a version and the index width.  Binary data without this
+  // header is from an older version, which stored the records as the text
+  // archives still do; it is loaded with that layout.
   CerealAdapter;
   template<class Archive>
   void save_ar(Archive & ar) const {
+    save_ar_(ar, std::integral_constant<bool, !cereal::traits::is_text_archive<Archive>::value>());
+  }
+
+  template<class Archive>
+  void load_ar(Archive & ar) {
+    load_ar_(ar, std::integral_constant<bool, !cereal::traits::is_text_archive<Archive>::value>());
+  }
+
+private:
+  // Header of the binary layout.  As a float the magic is far outside the
+  // range of connectedThreshold_, the first field of the old layout.
+  enum : UInt32 { BINARY_MAGIC = 0x434E4E48u };  // "HNNC" little-endian
+  enum : unsigned char { BINARY_VERSION = 1u };
+
+  template<class Archive>
+  void save_ar_(Archive & ar, std::false_type) const {
     ar(CEREAL_NVP(connectedThreshold_));
     ar(CEREAL_NVP(iteration_));
     ar(CEREAL_NVP(cells_));
@@ -702,8 +860,15 @@ public:
   }
 
   template<class Archive>
-  void load_ar(Archive & ar) {
+  void load_ar_(Archive & ar, std::false_type) {
     ar(CEREAL_NVP(connectedThreshold_));
+    loadRecords_(ar);
+  }
+
+  // The record layout after connectedThreshold_.  Also the binary layout
+  // of Connections saved before the binary layout had a header.
+  template<class Archive>
+  void loadRecords_(Archive & ar) {
     ar(CEREAL_NVP(iteration_));
     //!initialize(numCells, connectedThreshold_); //initialize Connections //Note: we actually don't call Connections
     //initialize() as all the members are de/serialized. 
@@ -730,6 +895,176 @@ public:
     ar(CEREAL_NVP(prunedSegs_));
   }
 
+  template<class Archive>
+  void save_ar_(Archive & ar, std::true_type) const {
+    const UInt32 magic = BINARY_MAGIC;
+    const unsigned char version = BINARY_VERSION;
+    const unsigned char indexBytes = static_cast<unsigned char>(sizeof(Synapse));
+    ar(magic, version, indexBytes);
+    ar(connectedThreshold_, iteration_, timeseries_);
+    ar(destroyedSynapses_, destroyedSegments_);
+    ar(nextSegmentOrdinal_, nextSynapseOrdinal_);
+    ar(prunedSyns_, prunedSegs_);
+    ar(previousUpdates_, currentUpdates_);
+
+    // The blocks are written straight from the live vectors, so that a save
+    // does not need a second copy of the model in memory.
+
+    // cells_: number of segments on each cell, then all segments concatenated.
+    saveColumn_<SegmentIdx>(ar, cells_, [](const CellData &c) { return c.segments.size(); });
+    saveConcatenated_(ar, cells_, &CellData::segments);
+
+    // segments_: one block per SegmentData field, then all synapses concatenated.
+    saveColumn_<CellIdx>   (ar, segments_, [](const SegmentData &s) { return s.cell; });
+    saveColumn_<SynapseIdx>(ar, segments_, [](const SegmentData &s) { return s.numConnected; });
+    saveColumn_<UInt32>    (ar, segments_, [](const SegmentData &s) { return s.lastUsed; });
+    saveColumn_<Segment>   (ar, segments_, [](const SegmentData &s) { return s.id; });
+    saveColumn_<UInt32>    (ar, segments_, [](const SegmentData &s) { return s.synapses.size(); });
+    saveConcatenated_(ar, segments_, &SegmentData::synapses);
+
+    // synapses_: one block per SynapseData field.
+    saveColumn_<CellIdx>   (ar, synapses_, [](const SynapseData &s) { return s.presynapticCell; });
+    saveColumn_<Permanence>(ar, synapses_, [](const SynapseData &s) { return s.permanence; });
+    saveColumn_<Segment>   (ar, synapses_, [](const SynapseData &s) { return s.segment; });
+    saveColumn_<Synapse>   (ar, synapses_, [](const SynapseData &s) { return s.presynapticMapIndex_; });
+    saveColumn_<Synapse>   (ar, synapses_, [](const SynapseData &s) { return s.id; });
+  }
+
+  template<class Archive>
+  void load_ar_(Archive & ar, std::true_type) {
+    UInt32 magic = 0;
+    ar(magic);
+    if (magic != BINARY_MAGIC) {
+      // No header, so this is the record layout of an older version, which
+      // starts with connectedThreshold_ and always used 32 bit indices.
+      static_assert(sizeof(Permanence) == sizeof(magic), "Connections load: Permanence must be 32 bits.");
+      std::memcpy(&connectedThreshold_, &magic, sizeof(magic));
+      NTA_CHECK(connectedThreshold_ >= 0.0f && connectedThreshold_ <= 1.0f)
+          << "Connections load: the binary data is not a Connections.";
+      NTA_CHECK(sizeof(Synapse) == 4u)
+          << "Connections load: saved by an older version with 32 bit indices, this build uses "
+          << 8 * sizeof(Synapse) << " bit indices (HTM_64BIT_INDICES).  "
+          << "Load it with a 32 bit build and save it as JSON to convert.";
+      loadRecords_(ar);
+      return;
+    }
+    unsigned char version = 0;
+    ar(version);
+    NTA_CHECK(version == BINARY_VERSION)
+        << "Connections load: binary layout version " << static_cast<UInt>(version)
+        << " is not supported, this build reads version " << static_cast<UInt>(BINARY_VERSION) << ".";
+    unsigned char indexBytes = 0;
+    ar(indexBytes);
+    NTA_CHECK(indexBytes == sizeof(Synapse))
+        << "Connections load: saved with " << 8 * static_cast<UInt>(indexBytes)
+        << " bit indices, this build uses " << 8 * sizeof(Synapse)
+        << " bit indices (HTM_64BIT_INDICES).  Use the JSON format to convert.";
+    ar(connectedThreshold_, iteration_, timeseries_);
+    ar(destroyedSynapses_, destroyedSegments_);
+    ar(nextSegmentOrdinal_, nextSynapseOrdinal_);
+    ar(prunedSyns_, prunedSegs_);
+    ar(previousUpdates_, currentUpdates_);
+
+    // The blocks are read straight into the live vectors.  The count blocks
+    // size the nested vectors, which the concatenated blocks then fill.
+    cells_.clear();
+    cells_.resize(static_cast<size_t>(loadSize_(ar)));
+    loadColumn_<SegmentIdx>(ar, cells_, [](CellData &c, SegmentIdx n) { c.segments.resize(n); }, false);
+    loadConcatenated_(ar, cells_, &CellData::segments);
+
+    const size_t numSegs = static_cast<size_t>(loadSize_(ar));
+    segments_.clear();
+    segments_.resize(numSegs);
+    loadColumn_<CellIdx>   (ar, segments_, [](SegmentData &s, CellIdx v)    { s.cell = v; }, false);
+    loadColumn_<SynapseIdx>(ar, segments_, [](SegmentData &s, SynapseIdx v) { s.numConnected = v; });
+    loadColumn_<UInt32>    (ar, segments_, [](SegmentData &s, UInt32 v)     { s.lastUsed = v; });
+    loadColumn_<Segment>   (ar, segments_, [](SegmentData &s, Segment v)    { s.id = v; });
+    loadColumn_<UInt32>    (ar, segments_, [](SegmentData &s, UInt32 n)     { s.synapses.resize(n); });
+    loadConcatenated_(ar, segments_, &SegmentData::synapses);
+
+    const size_t numSyns = static_cast<size_t>(loadSize_(ar));
+    synapses_.clear();
+    synapses_.resize(numSyns);
+    loadColumn_<CellIdx>   (ar, synapses_, [](SynapseData &s, CellIdx v)    { s.presynapticCell = v; }, false);
+    loadColumn_<Permanence>(ar, synapses_, [](SynapseData &s, Permanence v) { s.permanence = v; });
+    loadColumn_<Segment>   (ar, synapses_, [](SynapseData &s, Segment v)    { s.segment = v; });
+    loadColumn_<Synapse>   (ar, synapses_, [](SynapseData &s, Synapse v)    { s.presynapticMapIndex_ = v; });
+    loadColumn_<Synapse>   (ar, synapses_, [](SynapseData &s, Synapse v)    { s.id = v; });
+
+    rebuildPresynapticMaps_();
+  }
+
+  // Column blocks are written through a small buffer, in pieces.  A binary
+  // archive writes the same bytes as one std::vector<T> of the whole column.
+  static constexpr size_t COLUMN_CHUNK = 1024u;
+
+  template<class T, class Archive, class Records, class Field>
+  static void saveColumn_(Archive & ar, const Records &records, Field field) {
+    ar(cereal::make_size_tag(static_cast<cereal::size_type>(records.size())));
+    T chunk[COLUMN_CHUNK];
+    size_t n = 0u;
+    for (const auto &r : records) {
+      chunk[n++] = static_cast<T>(field(r));
+      if (n == COLUMN_CHUNK) {
+        ar(cereal::binary_data(static_cast<const T *>(chunk), n * sizeof(T)));
+        n = 0u;
+      }
+    }
+    if (n > 0u)
+      ar(cereal::binary_data(static_cast<const T *>(chunk), n * sizeof(T)));
+  }
+
+  // The nested vectors of all records, as one block.
+  template<class Archive, class Records, class Record, class T>
+  static void saveConcatenated_(Archive & ar, const Records &records, const std::vector<T> Record::*member) {
+    cereal::size_type total = 0u;
+    for (const auto &r : records)
+      total += (r.*member).size();
+    ar(cereal::make_size_tag(total));
+    for (const auto &r : records) {
+      const std::vector<T> &v = r.*member;
+      if (!v.empty())
+        ar(cereal::binary_data(v.data(), v.size() * sizeof(T)));
+    }
+  }
+
+  template<class Archive>
+  static cereal::size_type loadSize_(Archive & ar) {
+    cereal::size_type size = 0u;
+    ar(cereal::make_size_tag(size));
+    return size;
+  }
+
+  // Read a column into the records, which are already sized.  The size tag
+  // was read by the caller if readSize is false.
+  template<class T, class Archive, class Records, class Field>
+  static void loadColumn_(Archive & ar, Records &records, Field field, bool readSize = true) {
+    if (readSize) {
+      NTA_CHECK(loadSize_(ar) == records.size()) << "Connections load: corrupt data";
+    }
+    T chunk[COLUMN_CHUNK];
+    for (size_t i = 0u; i < records.size(); i += COLUMN_CHUNK) {
+      const size_t n = std::min(COLUMN_CHUNK, records.size() - i);
+      ar(cereal::binary_data(static_cast<T *>(chunk), n * sizeof(T)));
+      for (size_t j = 0u; j < n; j++)
+        field(records[i + j], chunk[j]);
+    }
+  }
+
+  template<class Archive, class Records, class Record, class T>
+  static void loadConcatenated_(Archive & ar, Records &records, std::vector<T> Record::*member) {
+    cereal::size_type total = 0u;
+    for (const auto &r : records)
+      total += (r.*member).size();
+    NTA_CHECK(loadSize_(ar) == total) << "Connections load: corrupt data";
+    for (auto &r : records) {
+      std::vector<T> &v = r.*member;
+      if (!v.empty())
+        ar(cereal::binary_data(v.data(), v.size() * sizeof(T)));
+    }
+  }
+
+public:
   /**
    * Gets the number of cells.
    *
@@ -854,17 +1189,47 @@ protected:
                               std::vector<Synapse> &synapsesForPresynapticCell,
                               std::vector<Segment> &segmentsForPresynapticCell);
 
+  /**
+   * Updates the connected count of the synapse's segment after its
+   * permanence crossed the connected threshold, and moves the synapse between
+   * the potential and connected presynaptic maps, unless adaptSegments()
+   * defers that.
+   */
+  void updateConnectedStatus_(const Synapse synapse, const bool connect);
+
+  /**
+   * Moves the synapse between the potential and connected presynaptic maps,
+   * and notifies the event handlers.
+   */
+  void updatePresynapticMaps_(const Synapse synapse, const bool connect);
+
+  /**
+   * Adds deltas[i] to the permanence of the i-th synapse on the segment, with
+   * the same result as calling updateSynapsePermanence() for each of them.
+   * The permanences are updated in one vectorizable pass, and only the
+   * synapses which crossed the connected threshold get the scalar map update.
+   */
+  void updatePermanences_(const Segment segment, const Permanence *deltas);
+
   /** 
    *  Remove least recently used Segment from cell. 
    */
   void pruneLRUSegment_(const CellIdx& cell);
 
+  /**
+   * Rebuild the four presynaptic maps from synapses_, placing every existing
+   * synapse at its SynapseData::presynapticMapIndex_. The result is identical
+   * to the maps as they were when the synapses were saved.
+   * Used by the binary deserialization, which does not store the maps.
+   */
+  void rebuildPresynapticMaps_();
+
 private:
-  std::vector<CellData>    cells_;
-  std::vector<SegmentData> segments_;
-  size_t                   destroyedSegments_ = 0;
-  std::vector<SynapseData> synapses_;
-  size_t                   destroyedSynapses_ = 0;
+  PolicyVector<CellData>    cells_;
+  PolicyVector<SegmentData> segments_;
+  size_t                    destroyedSegments_ = 0;
+  PolicyVector<SynapseData> synapses_;
+  size_t                    destroyedSynapses_ = 0;
   Permanence               connectedThreshold_; //TODO make const
   UInt32 iteration_ = 0;
 
@@ -890,6 +1255,20 @@ private:
   Synapse prunedSyns_ = 0; //how many synapses have been removed?
   Segment prunedSegs_ = 0;
 
+  //for hot-path counters, only incremented with HTM_COUNTERS
+  struct ConnectionsCounters_ {
+    UInt64 computeActivityCalls = 0;
+    UInt64 cellsTouched         = 0;
+    UInt64 segmentsTouched      = 0;
+    UInt64 synapsesAdapted      = 0;
+    UInt64 growCalls            = 0;
+    UInt64 segmentsCreated      = 0;
+    UInt64 segmentsDestroyed    = 0;
+    UInt64 segmentsEvicted      = 0;
+    UInt64 synapsesCreated      = 0;
+    UInt64 synapsesDestroyed    = 0;
+  } counters_;
+
   //for listeners //TODO listeners are not serialized, nor included in equals ==
   UInt32 nextEventToken_;
   std::map<UInt32, ConnectionsEventHandler *> eventHandlers_;
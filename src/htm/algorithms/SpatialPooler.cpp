@@ -26,12 +26,25 @@
 #include <numeric> //iota
 
 #include <htm/algorithms/SpatialPooler.hpp>
+#include <htm/utils/ThreadPool.hpp>
 #include <htm/utils/Topology.hpp>
 #include <htm/utils/VectorHelpers.hpp>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 using namespace std;
 using namespace htm;
 
+static inline UInt popCount_(const UInt64 bits) {
+#if defined(_MSC_VER)
+  return static_cast<UInt>(__popcnt64(bits));
+#else
+  return static_cast<UInt>(__builtin_popcountll(bits));
+#endif
+}
+
 class CoordinateConverterND {
 
 public:
@@ -71,6 +84,49 @@ SpatialPooler::SpatialPooler() {
   version_ = 2;
 }
 
+// The public reference connections is not copied, its default member
+// initializer binds it to connections_ of this copy.
+SpatialPooler::SpatialPooler(const SpatialPooler &other)
+    : Serializable(other),
+      numInputs_(other.numInputs_),
+      numColumns_(other.numColumns_),
+      columnDimensions_(other.columnDimensions_),
+      inputDimensions_(other.inputDimensions_),
+      potentialRadius_(other.potentialRadius_),
+      potentialPct_(other.potentialPct_),
+      initConnectedPct_(other.initConnectedPct_),
+      globalInhibition_(other.globalInhibition_),
+      numActiveColumnsPerInhArea_(other.numActiveColumnsPerInhArea_),
+      localAreaDensity_(other.localAreaDensity_),
+      stimulusThreshold_(other.stimulusThreshold_),
+      inhibitionRadius_(other.inhibitionRadius_),
+      dutyCyclePeriod_(other.dutyCyclePeriod_),
+      boostStrength_(other.boostStrength_),
+      iterationNum_(other.iterationNum_),
+      iterationLearnNum_(other.iterationLearnNum_),
+      spVerbosity_(other.spVerbosity_),
+      wrapAround_(other.wrapAround_),
+      updatePeriod_(other.updatePeriod_),
+      synPermInactiveDec_(other.synPermInactiveDec_),
+      synPermActiveInc_(other.synPermActiveInc_),
+      synPermBelowStimulusInc_(other.synPermBelowStimulusInc_),
+      synPermConnected_(other.synPermConnected_),
+      boostFactors_(other.boostFactors_),
+      overlapDutyCycles_(other.overlapDutyCycles_),
+      activeDutyCycles_(other.activeDutyCycles_),
+      minOverlapDutyCycles_(other.minOverlapDutyCycles_),
+      minActiveDutyCycles_(other.minActiveDutyCycles_),
+      minPctOverlapDutyCycles_(other.minPctOverlapDutyCycles_),
+      connections_(other.connections_),
+      boostedOverlaps_(other.boostedOverlaps_),
+      counters_(other.counters_),
+      learningPool_(other.learningPool_),
+      connectedBits_(other.connectedBits_),
+      connectedWords_(other.connectedWords_),
+      version_(other.version_),
+      rng_(other.rng_),
+      neighborMap_(other.neighborMap_) {}
+
 SpatialPooler::SpatialPooler(
     const vector<UInt> inputDimensions, const vector<UInt> columnDimensions,
     UInt potentialRadius, Real potentialPct, bool globalInhibition,
@@ -312,6 +368,7 @@ void SpatialPooler::setPotential(UInt column, const UInt potential[]) {
     if( potential[i] )
       connections_.createSynapse( column, i, perm[i] );
   }
+  updateConnectedBits_( column );
 }
 
 vector<Real> SpatialPooler::getPermanence(const UInt column, 
@@ -349,6 +406,7 @@ void SpatialPooler::setPermanence(UInt column, const Real permanences[]) {
     check_data[presyn] = minPermanence;
 #endif
   }
+  updateConnectedBits_( column );
 
 #ifndef NDEBUG
   for(UInt i = 0; i < numInputs_; i++) {
@@ -448,6 +506,7 @@ void SpatialPooler::initialize(
   inhibitionRadius_ = 0;
 
   connections_.initialize(numColumns_, synPermConnected_);
+  connectedBits_.clear();
   for (Size i = 0; i < numColumns_; ++i) {
     connections_.createSegment( static_cast<CellIdx>(i) , 1 /* max segments per cell is fixed for SP to 1 */);
 
@@ -476,7 +535,7 @@ const vector<SynapseIdx> SpatialPooler::compute(const SDR &input, const bool lea
   active.reshape( columnDimensions_ );
   updateBookeepingVars_(learn);
 
-  const auto& overlaps = connections_.computeActivity(input.getSparse(), learn);
+  const auto& overlaps = calculateOverlap_(input, learn);
 
   boostOverlaps_(overlaps, boostedOverlaps_);
 
@@ -486,8 +545,11 @@ const vector<SynapseIdx> SpatialPooler::compute(const SDR &input, const bool lea
   // inplace.
   sort( activeVector.begin(), activeVector.end() );
   active.setSparse( activeVector );
+  HTM_COUNT(counters_.computeCalls, 1);
+  HTM_COUNT(counters_.activeColumns, activeVector.size());
 
   if (learn) {
+    HTM_COUNT(counters_.learnCalls, 1);
     adaptSynapses_(input, active);
     updateDutyCycles_(overlaps, active);
     bumpUpWeakColumns_();
@@ -502,6 +564,95 @@ const vector<SynapseIdx> SpatialPooler::compute(const SDR &input, const bool lea
 }
 
 
+vector<SynapseIdx> SpatialPooler::calculateOverlap_(const SDR &input, const bool learn) {
+  const auto &sparse = input.getSparse();
+  const size_t words = (numInputs_ + 63u) / 64u;
+
+  // The scatter visits each connected synapse of the active inputs, the
+  // bitsets visit every word of every column.
+  size_t connected = 0u;
+  for(size_t column = 0; column < numColumns_; column++) {
+    connected += connections_.dataForSegment( static_cast<Segment>(column) ).numConnected;
+  }
+  const Real scatterWork = static_cast<Real>(sparse.size()) * connected / numInputs_;
+  const Real bitsetWork  = static_cast<Real>(numColumns_) * words;
+  if( scatterWork <= bitsetWork ) {
+    return connections_.computeActivity(sparse, learn);
+  }
+
+  if( connectedBits_.empty() ) {
+    connectedWords_ = words;
+    connectedBits_.assign(numColumns_ * words, 0u);
+    for(UInt column = 0; column < numColumns_; column++) {
+      updateConnectedBits_( column );
+    }
+  }
+
+  // Zeros, and counts the iteration like the scatter does.
+  vector<SynapseIdx> overlaps = connections_.computeActivity(vector<CellIdx>(), learn);
+  vector<UInt64> inputBits(words, 0u);
+  for(const auto bit : sparse) {
+    inputBits[bit / 64u] |= UInt64(1u) << (bit % 64u);
+  }
+  for(size_t column = 0; column < numColumns_; column++) {
+    const UInt64 *row = &connectedBits_[column * words];
+    UInt count = 0u;
+    for(size_t w = 0; w < words; w++) {
+      count += popCount_( row[w] & inputBits[w] );
+    }
+    overlaps[column] = static_cast<SynapseIdx>(count);
+  }
+  return overlaps;
+}
+
+
+void SpatialPooler::updateConnectedBits_(const UInt column) {
+  if( connectedBits_.empty() )
+    return;
+  UInt64 *row = &connectedBits_[column * connectedWords_];
+  std::fill(row, row + connectedWords_, UInt64(0u));
+  const Permanence threshold = connections_.getConnectedThreshold();
+  for(const auto syn : connections_.synapsesForSegment( column )) {
+    const auto &synData = connections_.dataForSynapse( syn );
+    if( synData.permanence >= threshold ) {
+      row[synData.presynapticCell / 64u] |= UInt64(1u) << (synData.presynapticCell % 64u);
+    }
+  }
+}
+
+
+void SpatialPooler::setNumThreads(const UInt numThreads) {
+  if( numThreads <= 1u )
+    learningPool_.reset();
+  else if( numThreads != getNumThreads() )
+    learningPool_ = std::make_shared<ThreadPool>(numThreads);
+}
+
+
+UInt SpatialPooler::getNumThreads() const {
+  return learningPool_ ? static_cast<UInt>(learningPool_->size()) : 1u;
+}
+
+
+CounterMap SpatialPooler::getCounters() const {
+  CounterMap counters;
+  if (HTM_COUNTERS_ENABLED) {
+    counters["computeCalls"]  = counters_.computeCalls;
+    counters["learnCalls"]    = counters_.learnCalls;
+    counters["activeColumns"] = counters_.activeColumns;
+    counters["columnsBumped"] = counters_.columnsBumped;
+    mergeCounters(counters, connections_.getCounters(), "connections.");
+  }
+  return counters;
+}
+
+
+void SpatialPooler::resetCounters() noexcept {
+  counters_ = SpatialPoolerCounters_();
+  connections_.resetCounters();
+}
+
+
 void SpatialPooler::updateLearning(vector<SynapseIdx> &overlaps, SDR &active) {  
     updateDutyCycles_(overlaps, active);
     bumpUpWeakColumns_();
@@ -708,9 +859,19 @@ Real SpatialPooler::avgConnectedSpanForColumnND_(const UInt column) const {
 
 void SpatialPooler::adaptSynapses_(const SDR &input,
                                    const SDR &active) {
+  if( learningPool_ ) {
+    const auto &columns = active.getSparse();
+    const vector<Segment> segments(columns.begin(), columns.end());
+    connections_.adaptSegments(segments, input, synPermActiveInc_, synPermInactiveDec_,
+                               stimulusThreshold_, learningPool_.get());
+  } else {
+    for(const auto &column : active.getSparse()) {
+      connections_.adaptSegment(column, input, synPermActiveInc_, synPermInactiveDec_);
+      connections_.raisePermanencesToThreshold( column, stimulusThreshold_ );
+    }
+  }
   for(const auto &column : active.getSparse()) {
-    connections_.adaptSegment(column, input, synPermActiveInc_, synPermInactiveDec_);
-    connections_.raisePermanencesToThreshold( column, stimulusThreshold_ );
+    updateConnectedBits_( column );
   }
 }
 
@@ -721,6 +882,8 @@ void SpatialPooler::bumpUpWeakColumns_() {
       continue;
     }
     connections_.bumpSegment( static_cast<Segment>(i), synPermBelowStimulusInc_ );
+    updateConnectedBits_( static_cast<UInt>(i) );
+    HTM_COUNT(counters_.columnsBumped, 1);
   }
 }
 
@@ -26,6 +26,7 @@
 #include <vector>
 #include <unordered_map>
 #include <iomanip> // std::setprecision
+#include <memory>
 #include <htm/algorithms/Connections.hpp>
 #include <htm/types/Types.hpp>
 #include <htm/types/Serializable.hpp>
@@ -79,6 +80,14 @@ public:
     UInt spVerbosity = 0u, 
     bool wrapAround = true);
 
+  /**
+   * Deep copy, independent of the original.  The public member connections
+   * refers to the Connections of the copy.  Copy assignment is not
+   * available, construct a new copy instead.
+   */
+  SpatialPooler(const SpatialPooler &other);
+  SpatialPooler &operator=(const SpatialPooler &other) = delete;
+
   virtual ~SpatialPooler() {}
 
   // equals operators
@@ -351,6 +360,7 @@ public:
     ar(CEREAL_NVP(rng_));
     ar(CEREAL_NVP(minActiveDutyCycles_));
     ar(CEREAL_NVP(boostedOverlaps_));
+    connectedBits_.clear();
 
     //re-initialize map
     neighborMap_ = Neighborhood::updateAllNeighbors(inhibitionRadius_, columnDimensions_, wrapAround_, /*skip_center=*/true);
@@ -533,6 +543,39 @@ public:
   */
   UInt getIterationLearnNum() const;
 
+  /**
+  Returns the hot-path counters of the SP and of its Connections, whose names
+  start with "connections.".  Only counted when built with HTM_COUNTERS,
+  otherwise the map is empty.  See htm/utils/Counters.hpp.
+
+  SP counters: computeCalls, learnCalls, activeColumns (total over all
+  calls), columnsBumped (weak columns raised by bumpUpWeakColumns).
+  */
+  CounterMap getCounters() const;
+
+  /**
+  Zero the counters of the SP and of its Connections.
+  */
+  void resetCounters() noexcept;
+
+  /**
+  Select the page size and NUMA placement of this SP's Connections, see
+  Connections::setMemoryPolicy().
+
+  @param policy the MemoryPolicy to use from now on.
+  */
+  void setMemoryPolicy(const MemoryPolicy &policy) { connections_.setMemoryPolicy(policy); }
+
+  /**
+  Learn with the given number of worker threads, which update the active
+  columns concurrently, see Connections::adaptSegments().  The learned model
+  is identical to learning on one thread.  The thread count is not saved.
+
+  @param numThreads 0 or 1 learns on the calling thread, which is the default.
+  */
+  void setNumThreads(const UInt numThreads);
+  UInt getNumThreads() const;
+
   /**
   Sets the learning iteration number.
 
@@ -991,6 +1034,23 @@ public:
   */
   void bumpUpWeakColumns_();
 
+  /**
+      Computes the overlap of every column with the input, like
+      connections_.computeActivity().  Dense inputs are instead ANDed with
+      packed bitsets of each column's connected synapses and popcounted,
+      which is faster when most inputs have many connected synapses.  The
+      method is picked per call by an estimate of the work of both, and the
+      results are identical.
+  */
+  vector<SynapseIdx> calculateOverlap_(const SDR &input, const bool learn);
+
+  /**
+      Rewrites the column's row of connectedBits_ from its synapses.  Called
+      after the column's permanences changed, does nothing while the bitsets
+      are not in use.
+  */
+  void updateConnectedBits_(const UInt column);
+
   /**
       Update the inhibition radius. The inhibition radius is a meausre of the
       square (or hypersquare) of columns that each a column is "connected to"
@@ -1221,6 +1281,19 @@ protected:
 
   vector<Real> boostedOverlaps_;
 
+  struct SpatialPoolerCounters_ {
+    UInt64 computeCalls  = 0;
+    UInt64 learnCalls    = 0;
+    UInt64 activeColumns = 0;
+    UInt64 columnsBumped = 0;
+  } counters_;
+
+  std::shared_ptr<ThreadPool> learningPool_; // Not serialized, see setNumThreads().
+
+  // Connected synapses of each column as rows of connectedWords_ 64-bit
+  // words, bit i is input i.  Built on the first dense input, not serialized.
+  vector<UInt64> connectedBits_;
+  size_t connectedWords_ = 0;
 
   UInt version_;
   Random rng_;
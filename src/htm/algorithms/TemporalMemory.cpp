@@ -77,6 +77,41 @@ TemporalMemory::TemporalMemory(
              maxSynapsesPerSegment, checkInputs, externalPredictiveInputs, anomalyMode);
 }
 
+// The public reference members (connections, externalPredictiveInputs,
+// anomaly) are not copied, their default member initializers bind them to
+// the members of this copy.
+TemporalMemory::TemporalMemory(const TemporalMemory &other)
+    : Serializable(other),
+      numColumns_(other.numColumns_),
+      columnDimensions_(other.columnDimensions_),
+      cellsPerColumn_(other.cellsPerColumn_),
+      activationThreshold_(other.activationThreshold_),
+      minThreshold_(other.minThreshold_),
+      maxNewSynapseCount_(other.maxNewSynapseCount_),
+      checkInputs_(other.checkInputs_),
+      initialPermanence_(other.initialPermanence_),
+      connectedPermanence_(other.connectedPermanence_),
+      permanenceIncrement_(other.permanenceIncrement_),
+      permanenceDecrement_(other.permanenceDecrement_),
+      predictedSegmentDecrement_(other.predictedSegmentDecrement_),
+      externalPredictiveInputs_(other.externalPredictiveInputs_),
+      reorderPeriod_(other.reorderPeriod_),
+      maxSegmentsPerCell_(other.maxSegmentsPerCell_),
+      maxSynapsesPerSegment_(other.maxSynapsesPerSegment_),
+      activeCells_(other.activeCells_),
+      winnerCells_(other.winnerCells_),
+      segmentsValid_(other.segmentsValid_),
+      activeSegments_(other.activeSegments_),
+      matchingSegments_(other.matchingSegments_),
+      numActiveConnectedSynapsesForSegment_(other.numActiveConnectedSynapsesForSegment_),
+      numActivePotentialSynapsesForSegment_(other.numActivePotentialSynapsesForSegment_),
+      predictiveCells_(other.predictiveCells_),
+      predictiveColumns_(other.predictiveColumns_),
+      rng_(other.rng_),
+      counters_(other.counters_),
+      connections_(other.connections_),
+      tmAnomaly_(other.tmAnomaly_) {}
+
 TemporalMemory::~TemporalMemory() {}
 
 void TemporalMemory::initialize(
@@ -239,6 +274,7 @@ void TemporalMemory::burstColumn_(
       if (nGrowExact > 0) {
         const Segment segment =
             connections_.createSegment(winnerCell, maxSegmentsPerCell_);
+        HTM_COUNT(counters_.segmentsGrown, 1);
 
         connections_.growSynapses(segment, prevWinnerCells, initialPermanence_, rng_, nGrowExact, maxSynapsesPerSegment_);
         NTA_ASSERT(connections.numSynapses(segment) == nGrowExact);
@@ -272,6 +308,8 @@ void TemporalMemory::activateCells(const SDR &activeColumns, const bool learn) {
       NTA_CHECK(static_cast<size_t>(activeColumns.dimensions[i]) == static_cast<size_t>(columnDimensions_[i])) << "Dimensions must be the same.";
     }
     auto &sparse = activeColumns.getSparse();
+    HTM_COUNT(counters_.computeCalls, 1);
+    HTM_COUNT(counters_.activeColumns, sparse.size());
 
   SDR prevActiveCells({static_cast<CellIdx>(numberOfCells() + externalPredictiveInputs_)});
   prevActiveCells.setSparse(activeCells_);
@@ -300,9 +338,9 @@ void TemporalMemory::activateCells(const SDR &activeColumns, const bool learn) {
            activeSegments_,   toColumns,
            matchingSegments_, toColumns)) {
 
-    Segment column; //we say "column", but it's the first segment of n-segments/cells that belong to the column
-    vector<Segment>::const_iterator activeColumnsBegin, activeColumnsEnd, 
-	                            columnActiveSegmentsBegin, columnActiveSegmentsEnd, 
+    CellIdx column; //we say "column", but it's the first segment of n-segments/cells that belong to the column
+    vector<CellIdx>::const_iterator activeColumnsBegin, activeColumnsEnd;
+    vector<Segment>::const_iterator columnActiveSegmentsBegin, columnActiveSegmentsEnd, 
                                     columnMatchingSegmentsBegin, columnMatchingSegmentsEnd;
 
     // for column in activeColumns (the 'sparse' above):
@@ -318,11 +356,13 @@ void TemporalMemory::activateCells(const SDR &activeColumns, const bool learn) {
     if (isActiveColumn) { //current active column...
       if (columnActiveSegmentsBegin != columnActiveSegmentsEnd) {
 	//...was also predicted -> learn :o)
+        HTM_COUNT(counters_.predictedColumns, 1);
         activatePredictedColumn_(
             columnActiveSegmentsBegin, columnActiveSegmentsEnd,
             prevActiveCells, prevWinnerCells, learn);
       } else {
 	//...has not been predicted -> 
+        HTM_COUNT(counters_.burstingColumns, 1);
         burstColumn_(column,
                      columnMatchingSegmentsBegin, columnMatchingSegmentsEnd,
                      prevActiveCells, prevWinnerCells, 
@@ -331,6 +371,7 @@ void TemporalMemory::activateCells(const SDR &activeColumns, const bool learn) {
 
     } else { // predicted but not active column -> unlearn
       if (learn) {
+        HTM_COUNT(counters_.punishedColumns, 1);
         punishPredictedColumn_(columnMatchingSegmentsBegin, columnMatchingSegmentsEnd, prevActiveCells);
       }
     } //else: not predicted & not active -> no activity -> does not show up at all
@@ -385,7 +426,7 @@ void TemporalMemory::activateDendrites(const bool learn,
   activeSegments_.clear();
   for (size_t segment = 0; segment < numActiveConnectedSynapsesForSegment_.size(); segment++) {
     if (numActiveConnectedSynapsesForSegment_[segment] >= activationThreshold_) { //TODO move to SegmentData.numConnected?
-      activeSegments_.push_back(static_cast<UInt>(segment));
+      activeSegments_.push_back(static_cast<Segment>(segment));
     }
   }
   const auto compareSegments = [&](const Segment a, const Segment b) { return connections.compareSegments(a, b); };
@@ -401,15 +442,34 @@ void TemporalMemory::activateDendrites(const bool learn,
   matchingSegments_.clear();
   for (size_t segment = 0; segment < numActivePotentialSynapsesForSegment_.size(); segment++) {
     if (numActivePotentialSynapsesForSegment_[segment] >= minThreshold_) {
-      matchingSegments_.push_back(static_cast<UInt>(segment));
+      matchingSegments_.push_back(static_cast<Segment>(segment));
     }
   }
   std::sort( matchingSegments_.begin(), matchingSegments_.end(), compareSegments);
 
+  updatePredictiveCells_();
   segmentsValid_ = true;
 }
 
 
+void TemporalMemory::updatePredictiveCells_() {
+  // activeSegments_ are sorted by cell, so are the cells and their columns.
+  predictiveCells_.clear();
+  predictiveColumns_.clear();
+  for (const auto segment : activeSegments_) {
+    const CellIdx cell = connections.cellForSegment(segment);
+    if (predictiveCells_.empty() or predictiveCells_.back() != cell) {
+      predictiveCells_.push_back(cell);
+      const CellIdx column = cell / cellsPerColumn_;
+      if (predictiveColumns_.empty() or predictiveColumns_.back() != column) {
+        predictiveColumns_.push_back(column);
+      }
+    }
+  }
+  NTA_ASSERT(std::is_sorted(predictiveCells_.begin(), predictiveCells_.end()));
+}
+
+
 void TemporalMemory::compute(const SDR &activeColumns, 
                              const bool learn,
                              const SDR &externalPredictiveInputsActive,
@@ -420,6 +480,20 @@ void TemporalMemory::compute(const SDR &activeColumns,
   calculateAnomalyScore_(activeColumns);
 
   activateCells(activeColumns, learn);
+
+  if (learn and reorderPeriod_ > 0u and connections.iteration() % reorderPeriod_ == 0u) {
+    reorder();
+  }
+}
+
+
+void TemporalMemory::reorder() {
+  const auto remap = connections_.reorder();
+  remap.remapSegments(activeSegments_);
+  remap.remapSegments(matchingSegments_);
+  const size_t length = connections.segmentFlatListLength();
+  remap.permuteSegmentValues(numActiveConnectedSynapsesForSegment_, length);
+  remap.permuteSegmentValues(numActivePotentialSynapsesForSegment_, length);
 }
 
 void TemporalMemory::calculateAnomalyScore_(const SDR &activeColumns){
@@ -436,20 +510,20 @@ void TemporalMemory::calculateAnomalyScore_(const SDR &activeColumns){
 	case ANMode::RAW: {
 	  tmAnomaly_.anomaly_ = computeRawAnomalyScore(
 							 activeColumns,
-							 cellsToColumns( getPredictiveCells() ));
+							 getPredictiveColumnsSparse());
 			  } break;
 
 	case ANMode::LIKELIHOOD: {
 	  const Real raw = computeRawAnomalyScore(
 						 activeColumns,
-						 cellsToColumns( getPredictiveCells() ));
+						 getPredictiveColumnsSparse());
 	  tmAnomaly_.anomaly_ = tmAnomaly_.anomalyLikelihood_.anomalyProbability(raw);
 				 } break;
 
 	case ANMode::LOGLIKELIHOOD: {
 	  const Real raw = computeRawAnomalyScore(
 						 activeColumns,
-						 cellsToColumns( getPredictiveCells() ));
+						 getPredictiveColumnsSparse());
 	  const Real like = tmAnomaly_.anomalyLikelihood_.anomalyProbability(raw);
 	  const Real log  = tmAnomaly_.anomalyLikelihood_.computeLogLikelihood(like);
 	  tmAnomaly_.anomaly_ = log;
@@ -467,11 +541,34 @@ void TemporalMemory::compute(const SDR &activeColumns, const bool learn) {
   compute( activeColumns, learn, externalPredictiveInputsActive, externalPredictiveInputsWinners );
 }
 
+CounterMap TemporalMemory::getCounters() const {
+  CounterMap counters;
+  if (HTM_COUNTERS_ENABLED) {
+    counters["computeCalls"]     = counters_.computeCalls;
+    counters["activeColumns"]    = counters_.activeColumns;
+    counters["predictedColumns"] = counters_.predictedColumns;
+    counters["burstingColumns"]  = counters_.burstingColumns;
+    counters["punishedColumns"]  = counters_.punishedColumns;
+    counters["segmentsGrown"]    = counters_.segmentsGrown;
+    mergeCounters(counters, connections_.getCounters(), "connections.");
+  }
+  return counters;
+}
+
+
+void TemporalMemory::resetCounters() noexcept {
+  counters_ = TemporalMemoryCounters_();
+  connections_.resetCounters();
+}
+
+
 void TemporalMemory::reset(void) {
   activeCells_.clear();
   winnerCells_.clear();
   activeSegments_.clear();
   matchingSegments_.clear();
+  predictiveCells_.clear();
+  predictiveColumns_.clear();
   segmentsValid_ = false;
   tmAnomaly_.anomaly_ = -1.0f; //TODO reset rather to 0.5 as default (undecided) anomaly
 }
@@ -535,18 +632,30 @@ SDR TemporalMemory::getPredictiveCells() const {
   auto correctDims = getColumnDimensions();
   correctDims.push_back(static_cast<CellIdx>(getCellsPerColumn()));
   SDR predictive(correctDims);
+  predictive.setSparse(predictiveCells_);
+  return predictive;
+}
 
-  std::set<CellIdx> uniqueCells;
-  //uniqueCells.reserve(activeSegments_.size());
+void TemporalMemory::getPredictiveCells(SDR &predictiveCells) const {
+  NTA_CHECK( predictiveCells.size == numberOfCells() );
+  predictiveCells.setSparse( getPredictiveCellsSparse() );
+}
 
-  for (const auto segment : activeSegments_) {
-    const CellIdx cell = connections.cellForSegment(segment);
-    uniqueCells.insert(cell); //set keeps the cells unique
-  }
+void TemporalMemory::getPredictiveColumns(SDR &predictiveColumns) const {
+  NTA_CHECK( predictiveColumns.size == numColumns_ );
+  predictiveColumns.setSparse( getPredictiveColumnsSparse() );
+}
 
-  vector<CellIdx> predictiveCells(uniqueCells.begin(), uniqueCells.end());
-  predictive.setSparse(predictiveCells);
-  return predictive;
+const vector<CellIdx> &TemporalMemory::getPredictiveCellsSparse() const {
+  NTA_CHECK( segmentsValid_ )
+    << "Call TM.activateDendrites() before TM.getPredictiveCells()!";
+  return predictiveCells_;
+}
+
+const vector<CellIdx> &TemporalMemory::getPredictiveColumnsSparse() const {
+  NTA_CHECK( segmentsValid_ )
+    << "Call TM.activateDendrites() before TM.getPredictiveColumns()!";
+  return predictiveColumns_;
 }
 
 
@@ -172,6 +172,14 @@ public:
     ANMode        anomalyMode                 = ANMode::RAW
     );
 
+  /**
+   * Deep copy, independent of the original.  The public reference members
+   * (connections, anomaly, ...) refer to the state of the copy.  Copy
+   * assignment is not available, construct a new copy instead.
+   */
+  TemporalMemory(const TemporalMemory &other);
+  TemporalMemory &operator=(const TemporalMemory &other) = delete;
+
   virtual ~TemporalMemory();
 
   //----------------------------------------------------------------------
@@ -191,6 +199,22 @@ public:
    */
   virtual void reset();
 
+  /**
+   * Renumber the segments and synapses of the TM's Connections for locality
+   * of memory access, see Connections::reorder(), and translate the TM's own
+   * segment state to the new indices.  The TM's output is not affected.
+   */
+  void reorder();
+
+  /**
+   * Call reorder() automatically at the end of every 'period'-th learning
+   * compute() call, so that learning throughput does not degrade as the
+   * segments and synapses get scattered over a long run.  Zero, the
+   * default, disables it.  This setting is not serialized.
+   */
+  void setReorderPeriod(UInt period) { reorderPeriod_ = period; }
+  UInt getReorderPeriod() const { return reorderPeriod_; }
+
   /**
    * Calculate the active cells, using the current active columns and
    * dendrite segments. Grow and reinforce synapses.
@@ -327,6 +351,21 @@ public:
    */
   SDR getPredictiveCells() const;
 
+  /**
+   * Copies the predictive cells, or the columns which contain them, into the
+   * given SDR.  These are computed once by activateDendrites(), so this does
+   * not allocate.
+   */
+  void getPredictiveCells(SDR &predictiveCells) const;
+  void getPredictiveColumns(SDR &predictiveColumns) const;
+
+  /**
+   * @return sorted indices of the predictive cells, or columns.  The
+   * reference is valid until the next activateDendrites() or compute().
+   */
+  const vector<CellIdx> &getPredictiveCellsSparse() const;
+  const vector<CellIdx> &getPredictiveColumnsSparse() const;
+
   /**
    * Returns the indices of the winner cells.
    *
@@ -352,6 +391,29 @@ public:
    */
   size_t numberOfColumns() const { return numColumns_; }
 
+  /**
+   * Returns the hot-path counters of the TM and of its Connections, whose
+   * names start with "connections.".  Only counted when built with
+   * HTM_COUNTERS, otherwise the map is empty.  See htm/utils/Counters.hpp.
+   *
+   * TM counters: computeCalls (calls to activateCells), activeColumns,
+   * predictedColumns, burstingColumns, punishedColumns (inactive columns
+   * with matching segments, while learning), segmentsGrown (new segments on bursting columns).
+   */
+  CounterMap getCounters() const;
+
+  /**
+   * Zero the counters of the TM and of its Connections.
+   */
+  void resetCounters() noexcept;
+
+  /**
+   * Select the page size and NUMA placement of this TM's Connections,
+   * see Connections::setMemoryPolicy().  Call after construction, the
+   * constructor replaces the Connections.
+   */
+  void setMemoryPolicy(const MemoryPolicy &policy) { connections_.setMemoryPolicy(policy); }
+
   /**
    * Returns the number of cells per column.
    *
@@ -504,8 +566,8 @@ public:
       ar( cereal::make_size_tag(numActiveSegments));
       for (Segment segment : activeSegments_) {
         struct container_ar c;
-        c.cell = connections.cellForSegment(segment);
-        const vector<Segment> &segments = connections.segmentsForCell(c.cell);
+        c.cell = connections_.cellForSegment(segment);
+        const vector<Segment> &segments = connections_.segmentsForCell(c.cell);
 
         c.idx = (SegmentIdx)std::distance(
                             segments.begin(), 
@@ -523,8 +585,8 @@ public:
       ar(cereal::make_size_tag(numMatchingSegments));
       for (Segment segment : matchingSegments_) {
         struct container_ar c;
-        c.cell = connections.cellForSegment(segment);
-        const vector<Segment> &segments = connections.segmentsForCell(c.cell);
+        c.cell = connections_.cellForSegment(segment);
+        const vector<Segment> &segments = connections_.segmentsForCell(c.cell);
 
         c.idx = (SegmentIdx)std::distance(segments.begin(), std::find(segments.begin(), segments.end(), segment));
         c.syn = numActivePotentialSynapsesForSegment_[segment];
@@ -562,14 +624,14 @@ public:
     size_t activeSize;
     ar(CEREAL_NVP(activeSize));
     if (activeSize > 0) {
-      numActiveConnectedSynapsesForSegment_.assign(connections.segmentFlatListLength(), 0);
+      numActiveConnectedSynapsesForSegment_.assign(connections_.segmentFlatListLength(), 0);
       cereal::size_type numActiveSegments;
       ar(cereal::make_size_tag(numActiveSegments));
       activeSegments_.resize(static_cast<size_t>(numActiveSegments));
       for (size_t i = 0; i < static_cast<size_t>(numActiveSegments); i++) {
         struct container_ar c;
         ar(c);  
-        Segment segment = connections.getSegment(c.cell, c.idx);
+        Segment segment = connections_.getSegment(c.cell, c.idx);
         activeSegments_[i] = segment;
         numActiveConnectedSynapsesForSegment_[segment] = c.syn;
       }
@@ -577,18 +639,19 @@ public:
     size_t matchSize;
     ar(CEREAL_NVP(matchSize));
     if (matchSize > 0) {
-      numActivePotentialSynapsesForSegment_.assign(connections.segmentFlatListLength(), 0);
+      numActivePotentialSynapsesForSegment_.assign(connections_.segmentFlatListLength(), 0);
       cereal::size_type numMatchingSegments;
       ar(cereal::make_size_tag(numMatchingSegments));
       matchingSegments_.resize(static_cast<size_t>(numMatchingSegments));
       for (size_t i = 0; i < static_cast<size_t>(numMatchingSegments); i++) {
         struct container_ar c;
         ar(c);
-        Segment segment = connections.getSegment(c.cell, c.idx);
+        Segment segment = connections_.getSegment(c.cell, c.idx);
         matchingSegments_[i] = segment;
         numActivePotentialSynapsesForSegment_[segment] = c.syn;
       }
     }
+    updatePredictiveCells_();
   }
 
 
@@ -664,6 +727,9 @@ private:
 
   void calculateAnomalyScore_(const SDR &activeColumns);
 
+  // Fills predictiveCells_ and predictiveColumns_ from activeSegments_.
+  void updatePredictiveCells_();
+
 protected:
   //all these could be const
   CellIdx numColumns_;
@@ -679,6 +745,7 @@ protected:
   Permanence permanenceDecrement_;
   Permanence predictedSegmentDecrement_;
   UInt externalPredictiveInputs_;
+  UInt reorderPeriod_ = 0;
   SegmentIdx maxSegmentsPerCell_;
   SynapseIdx maxSynapsesPerSegment_;
 
@@ -690,9 +757,20 @@ private:
   vector<Segment> matchingSegments_;
   vector<SynapseIdx> numActiveConnectedSynapsesForSegment_;
   vector<SynapseIdx> numActivePotentialSynapsesForSegment_;
+  vector<CellIdx> predictiveCells_;   // Sorted, valid while segmentsValid_.
+  vector<CellIdx> predictiveColumns_; // Sorted, valid while segmentsValid_.
 
   Random rng_;
 
+  struct TemporalMemoryCounters_ {
+    UInt64 computeCalls     = 0;
+    UInt64 activeColumns    = 0;
+    UInt64 predictedColumns = 0;
+    UInt64 burstingColumns  = 0;
+    UInt64 punishedColumns  = 0;
+    UInt64 segmentsGrown    = 0;
+  } counters_;
+
   /**
    * holds logic and data for TM's anomaly
    */
@@ -19,10 +19,14 @@
 Implementation of the Network class
 */
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 #include <htm/engine/Input.hpp>
 #include <htm/engine/Link.hpp>
@@ -33,8 +37,10 @@ Implementation of the Network class
 #include <htm/engine/Spec.hpp>
 #include <htm/os/Directory.hpp>
 #include <htm/os/Path.hpp>
+#include <htm/os/SharedMemory.hpp>
 #include <htm/ntypes/BasicType.hpp>
 #include <htm/utils/Log.hpp>
+#include <htm/utils/ThreadPool.hpp>
 #include <htm/ntypes/Value.hpp>
 
 namespace htm {
@@ -56,6 +62,10 @@ Network::Network(Network &&n) noexcept {
   phaseInfo_ = std::move(n.phaseInfo_);
   callbacks_ = n.callbacks_;
   iteration_ = n.iteration_;
+  batchSize_ = n.batchSize_;
+  partition_ = std::move(n.partition_);
+  linkPrefix_ = std::move(n.linkPrefix_);
+  checkpointWriter_ = std::move(n.checkpointWriter_);
 }
 
 Network::Network(const std::string& filename) {
@@ -97,6 +107,51 @@ Network::~Network() {
 }
 
 
+namespace {
+  // The regions which carry a link between partitions, see Network::setPartition().
+  std::string partitionReader(const std::string &src, const std::string &output) {
+    return "partition_" + src + "_" + output;
+  }
+  std::string partitionWriter(const std::string &src, const std::string &output,
+                              const std::string &destPartition) {
+    return "partition_" + src + "_" + output + "_" + destPartition;
+  }
+
+  // 8 hex digits of the FNV-1a hash of s, which is stable across processes.
+  std::string hash8(const std::string &s) {
+    UInt32 hash = 2166136261u;
+    for (const char c : s) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 16777619u;
+    }
+    char hex[9];
+    std::snprintf(hex, sizeof(hex), "%08x", static_cast<unsigned int>(hash));
+    return hex;
+  }
+
+  // The name of the ring of a link between partitions.  The partitions of
+  // one run agree on it without talking to each other.  The default prefix
+  // holds a hash of the configuration, so runs of other configurations get
+  // other rings; if the name is then too long for shm_open() (31 characters
+  // on macOS), the rest of it is hashed too.
+  std::string linkRing(const std::string &linkPrefix, const std::string &yaml,
+                       const std::string &src, const std::string &output,
+                       const std::string &partition) {
+    const std::string link = src + "." + output + "." + partition;
+    if (!linkPrefix.empty())
+      return linkPrefix + link;
+    const std::string prefix = "/htm.link." + hash8(yaml) + ".";
+    if (prefix.size() + link.size() <= SharedMemoryWriter::maxNameLength())
+      return prefix + link;
+    return prefix + hash8(link);
+  }
+} // namespace
+
+void Network::setPartition(const std::string &partition, const std::string &linkPrefix) {
+  partition_  = partition;
+  linkPrefix_ = linkPrefix;
+}
+
 void Network::configure(const std::string &yaml) {
   ValueMap vm;
   vm.parse(yaml);
@@ -104,6 +159,49 @@ void Network::configure(const std::string &yaml) {
   NTA_CHECK(vm.isMap() && vm.contains("network")) << "Expected yaml string to start with 'network:'.";
   Value &v1 = vm["network"];
   NTA_CHECK(v1.isSequence()) << "Expected a sequence of entries starting with a command.";
+
+  // With a partition, find the regions of other partitions, and the sources
+  // in other partitions of each local region.
+  std::map<std::string, std::pair<std::string, std::string>> remote; // name -> type, partition
+  std::map<std::string, std::vector<std::pair<std::string, std::string>>> remoteSources;
+  if (!partition_.empty()) {
+    for (size_t i = 0; i < v1.size(); i++) {
+      NTA_CHECK(v1[i].isMap()) << "Expcted a command";
+      for (auto cmd : v1[i]) {
+        if (cmd.first == "addRegion") {
+          std::string partition = "0";
+          if (cmd.second.contains("partition"))
+            partition = cmd.second["partition"].str();
+          if (partition != partition_)
+            remote[cmd.second["name"].str()] = std::make_pair(cmd.second["type"].str(), partition);
+        }
+      }
+    }
+    for (size_t i = 0; i < v1.size(); i++) {
+      for (auto cmd : v1[i]) {
+        if (cmd.first == "addLink") {
+          std::vector<std::string> vsrc = Path::split(cmd.second["src"].str(), '.');
+          std::vector<std::string> vdest = Path::split(cmd.second["dest"].str(), '.');
+          if (vsrc.size() == 2 && vdest.size() == 2 && remote.count(vsrc[0]) && !remote.count(vdest[0])) {
+            auto &sources = remoteSources[vdest[0]];
+            auto source = std::make_pair(vsrc[0], vsrc[1]);
+            if (std::find(sources.begin(), sources.end(), source) == sources.end())
+              sources.push_back(source);
+          }
+        }
+      }
+    }
+  }
+  // The type of an output of a local or remote region.
+  auto outputType = [&](const std::string &region, const std::string &output) {
+    auto itr = remote.find(region);
+    std::shared_ptr<Spec> spec = (itr == remote.end())
+        ? getRegion(region)->getSpec()
+        : RegionImplFactory::getInstance().getSpec(itr->second.first);
+    NTA_CHECK(spec->outputs.contains(output)) << "Region '" << region << "' has no output '" << output << "'";
+    return spec->outputs.getByName(output).dataType;
+  };
+
   for (size_t i = 0; i < v1.size(); i++) {
     NTA_CHECK(v1[i].isMap()) << "Expcted a command";
     for (auto cmd : v1[i]) {
@@ -116,6 +214,16 @@ void Network::configure(const std::string &yaml) {
       } else if (cmd.first == "addRegion") {
         std::string name = cmd.second["name"].str();
         std::string type = cmd.second["type"].str();
+        if (remote.count(name))
+          continue;
+        // Sources in other partitions are read before this region computes.
+        for (const auto &source : remoteSources[name]) {
+          const std::string reader = partitionReader(source.first, source.second);
+          if (regions_.find(reader) == regions_.end()) {
+            const std::string ring = linkRing(linkPrefix_, yaml, source.first, source.second, partition_);
+            addRegion(reader, "SharedMemoryInputRegion", "{name: '" + ring + "'}");
+          }
+        }
         ValueMap params;
         if (cmd.second.contains("params")) params = cmd.second["params"];
         addRegion(name, type, params);
@@ -127,6 +235,12 @@ void Network::configure(const std::string &yaml) {
           phases.insert(phase);
           setPhases(name, phases);
         }
+        if (cmd.second.contains("period")) {
+          UInt32 offset = 0;
+          if (cmd.second.contains("offset"))
+            offset = cmd.second["offset"].as<UInt32>();
+          setComputePeriod(name, cmd.second["period"].as<UInt32>(), offset);
+        }
       } else if (cmd.first == "addLink") {
         std::string src = cmd.second["src"].str();
         std::string dest = cmd.second["dest"].str();
@@ -142,7 +256,29 @@ void Network::configure(const std::string &yaml) {
         NTA_CHECK(vsrc.size() == 2) << "Expecting source domain name '.' output name.";
         NTA_CHECK(vdest.size() == 2) << "Expecting destination domain name '.' input name.";
 
-        link(vsrc[0], vdest[0], "", dim, vsrc[1], vdest[1], propagationDelay);
+        const bool destRemote = remote.count(vdest[0]) > 0;
+        const bool srcRemote = (vsrc[0] == "INPUT") ? destRemote : remote.count(vsrc[0]) > 0;
+        if (srcRemote && destRemote) {
+          // neither end is in this partition
+        } else if (destRemote) {
+          // Publish the output for the partition of the destination.
+          const std::string &partition = remote[vdest[0]].second;
+          const std::string writer = partitionWriter(vsrc[0], vsrc[1], partition);
+          const bool sdr = outputType(vsrc[0], vsrc[1]) == NTA_BasicType_SDR;
+          if (regions_.find(writer) == regions_.end()) {
+            const UInt32 slots = cmd.second.contains("slots") ? cmd.second["slots"].as<UInt32>() : 4u;
+            const std::string ring = linkRing(linkPrefix_, yaml, vsrc[0], vsrc[1], partition);
+            addRegion(writer, "SharedMemoryOutputRegion",
+                      "{name: '" + ring + "', slots: " + std::to_string(slots) + ", flowControl: true}");
+            link(vsrc[0], writer, "", "", vsrc[1], sdr ? "sdrIn" : "dataIn");
+          }
+        } else if (srcRemote) {
+          const bool sdr = outputType(vsrc[0], vsrc[1]) == NTA_BasicType_SDR;
+          link(partitionReader(vsrc[0], vsrc[1]), vdest[0], "", dim,
+               sdr ? "sdrOut" : "dataOut", vdest[1], propagationDelay);
+        } else {
+          link(vsrc[0], vdest[0], "", dim, vsrc[1], vdest[1], propagationDelay);
+        }
       }
     }
   }
@@ -267,6 +403,32 @@ std::set<UInt32> Network::getPhases(const std::string &name) const {
   return phases;
 }
 
+void Network::setComputePeriod(const std::string &name, UInt32 period, UInt32 offset) {
+  auto itr = regions_.find(name);
+  if (itr == regions_.end())
+    NTA_THROW << "setComputePeriod -- no region exists with name '" << name << "'";
+  NTA_CHECK(period > 0) << "setComputePeriod -- period must be at least 1.";
+  NTA_CHECK(offset < period) << "setComputePeriod -- offset " << offset
+                             << " must be less than the period " << period;
+
+  itr->second->computePeriod_ = period;
+  itr->second->computeOffset_ = offset;
+}
+
+UInt32 Network::getComputePeriod(const std::string &name) const {
+  auto itr = regions_.find(name);
+  if (itr == regions_.end())
+    NTA_THROW << "getComputePeriod -- no region exists with name '" << name << "'";
+  return itr->second->getComputePeriod();
+}
+
+UInt32 Network::getComputeOffset(const std::string &name) const {
+  auto itr = regions_.find(name);
+  if (itr == regions_.end())
+    NTA_THROW << "getComputeOffset -- no region exists with name '" << name << "'";
+  return itr->second->getComputeOffset();
+}
+
 void Network::removeRegion(const std::string &name) {
   auto itr = regions_.find(name);
   if (itr == regions_.end())
@@ -490,17 +652,44 @@ void Network::run(int n) {
   NTA_CHECK(maxEnabledPhase_ < phaseInfo_.size())
       << "maxphase: " << maxEnabledPhase_ << " size: " << phaseInfo_.size();
 
+  // saveToFileAsync() called from a callback is deferred to the end of the iteration.
+  struct RunningGuard {
+    bool &running;
+    explicit RunningGuard(bool &r) : running(r) { running = true; }
+    ~RunningGuard() { running = false; }
+  } guard(running_);
+
+  const std::set<Region *> batched = (batchSize_ > 1u) ? batchedRegions_() : std::set<Region *>();
+  size_t row = 0u;
+  size_t rows = 0u;
+
   for (int iter = 0; iter < n; iter++) {
-    iteration_++;
+    const UInt64 current = iteration_++;
+
+    if (!batched.empty() && row == rows) {
+      row = 0u;
+      rows = std::min(static_cast<size_t>(batchSize_), static_cast<size_t>(n - iter));
+      computeBatch_(batched, rows);
+    }
 
     // compute on all enabled regions in phase order
     for (UInt32 phase = minEnabledPhase_; phase <= maxEnabledPhase_; phase++) {
       for (auto r : phaseInfo_[phase]) {
+        if (!batched.empty() && batched.count(r)) {
+          r->emitBatchRow_(row); // computed by computeBatch_()
+          continue;
+        }
+        if (!r->isScheduled_(current))
+          continue; // decimated, see setComputePeriod()
         r->prepareInputs();
+        if (r->isUnchanged_())
+          continue; // pure region with the same inputs, see RegionImpl::isPure()
         r->compute();
       }
     }
 
+    row++;
+
     // invoke callbacks
     for (UInt32 i = 0; i < callbacks_.getCount(); i++) {
       const std::pair<std::string, callbackItem> &callback = callbacks_.getByIndex(i);
@@ -519,9 +708,91 @@ void Network::run(int n) {
       }
     }
 
+    // checkpoints requested by the callbacks of this iteration
+    for (const auto &c : pendingCheckpoints_) {
+      startCheckpoint_(c.filePath, c.fmt, c.done);
+    }
+    pendingCheckpoints_.clear();
+
   } // End of outer run-loop
 
-  return;
+  finishRun_();
+}
+
+void Network::finishRun_() {
+  // Let regions complete work they deferred across iterations.
+  for (UInt32 phase = minEnabledPhase_; phase <= maxEnabledPhase_; phase++) {
+    for (auto r : phaseInfo_[phase]) {
+      r->finishRun();
+    }
+  }
+}
+
+void Network::setBatchSize(UInt32 k) {
+  NTA_CHECK(k > 0) << "setBatchSize -- the batch size must be at least 1.";
+  batchSize_ = k;
+}
+
+std::set<Region *> Network::batchedRegions_() const {
+  std::map<Region *, UInt32> phaseOf;
+  std::set<Region *> multiPhase;
+  for (UInt32 phase = 0; phase < phaseInfo_.size(); phase++) {
+    for (auto r : phaseInfo_[phase]) {
+      if (phaseOf.count(r))
+        multiPhase.insert(r);
+      phaseOf[r] = phase;
+    }
+  }
+
+  std::set<Region *> batched;
+  for (UInt32 phase = minEnabledPhase_; phase <= maxEnabledPhase_; phase++) {
+    for (auto r : phaseInfo_[phase]) {
+      if (multiPhase.count(r) || r->getComputePeriod() != 1u || !r->isBatchable_())
+        continue;
+      bool fromBatched = true;
+      for (const auto &input : r->getInputs()) {
+        for (const auto &link : input.second->getLinks()) {
+          Region *src = link->getSrc()->getRegion();
+          if (link->getPropagationDelay() != 0u || !batched.count(src) || phaseOf[src] >= phase)
+            fromBatched = false;
+        }
+      }
+      if (fromBatched)
+        batched.insert(r);
+    }
+  }
+  return batched;
+}
+
+void Network::computeBatch_(const std::set<Region *> &batched, size_t k) {
+  // The outputs are used to pass the rows between batched regions. Until
+  // they emit their first row, regions in earlier phases must still see the
+  // outputs of the previous iteration.
+  for (auto r : batched)
+    r->holdOutputs_();
+
+  // In phase order, so that the rows of the sources are ready.
+  for (UInt32 phase = minEnabledPhase_; phase <= maxEnabledPhase_; phase++) {
+    for (auto r : phaseInfo_[phase]) {
+      if (!batched.count(r))
+        continue;
+      std::set<Region *> sources;
+      for (const auto &input : r->getInputs()) {
+        for (const auto &link : input.second->getLinks())
+          sources.insert(link->getSrc()->getRegion());
+      }
+      for (size_t row = 0u; row < k; row++) {
+        for (auto src : sources)
+          src->emitBatchRow_(row);
+        r->prepareInputs();
+        r->saveBatchRow_(row);
+      }
+      r->computeBatch_(k);
+    }
+  }
+
+  for (auto r : batched)
+    r->restoreOutputs_();
 }
 
 void Network::initialize() {
@@ -719,7 +990,18 @@ std::string Network::phasesToString() const {
     }
     ss << "]";
   }
-  ss << "]}";
+  ss << "]";
+  // Optional, only regions which do not compute every iteration.
+  bool decimated = false;
+  for (const auto &p : regions_) {
+    if (p.second->getComputePeriod() == 1u)
+      continue;
+    ss << (decimated ? "" : ", schedule: [");
+    ss << "[" << p.first << " " << p.second->getComputePeriod() << " "
+       << p.second->getComputeOffset() << "]";
+    decimated = true;
+  }
+  ss << (decimated ? "]}" : "}");
   return ss.str();
 }
 void Network::phasesFromString(const std::string& phaseString) {
@@ -762,6 +1044,287 @@ void Network::phasesFromString(const std::string& phaseString) {
   }
   ss >> std::ws;
   ss.ignore(1); // ']'
+
+  // Optional region decimation, absent in older files.
+  ss >> std::ws;
+  if (ss.peek() == 's') {
+    ss >> tag;
+    NTA_CHECK(tag == "schedule:") << "Invalid phase deserialization";
+    ss >> std::ws;
+    NTA_CHECK(ss.peek() == '[') << "Invalid phase deserialization";
+    ss.ignore(1);
+    ss >> std::ws;
+    while (ss.peek() == '[') {
+      ss.ignore(1);
+      UInt32 period, offset;
+      ss >> tag >> period >> offset >> std::ws;
+      NTA_CHECK(ss.peek() == ']') << "Invalid phase deserialization";
+      ss.ignore(1);
+      setComputePeriod(tag, period, offset);
+      ss >> std::ws;
+    }
+  }
+}
+
+
+/////////////////////////////////////////////////////////
+//      Sectioned snapshots
+/////////////////////////////////////////////////////////
+
+namespace {
+const char SECTIONED_MAGIC[8] = {'H', 'T', 'M', 'S', 'E', 'C', 'T', '1'};
+const std::string NETWORK_SECTION = "network";
+const std::string SHELL_PREFIX = "shell:";
+const std::string IMPL_PREFIX = "impl:";
+
+// The network level part of a sectioned snapshot; everything except the regions.
+class NetworkSection : public Serializable {
+public:
+  UInt64 iteration = 0;
+  std::vector<std::shared_ptr<Link>> links;
+  std::string phases;
+
+  CerealAdapter;
+  template<class Archive>
+  void save_ar(Archive& ar) const {
+    ar(cereal::make_nvp("iteration", iteration));
+    ar(cereal::make_nvp("links", links));
+    ar(cereal::make_nvp("phases", phases));
+  }
+  template<class Archive>
+  void load_ar(Archive& ar) {
+    ar(cereal::make_nvp("iteration", iteration));
+    ar(cereal::make_nvp("links", links));
+    ar(cereal::make_nvp("phases", phases));
+  }
+};
+
+struct SectionEntry {
+  std::string name;
+  UInt64 offset;
+  UInt64 length;
+};
+
+// The table of contents is written byte by byte so the layout does not
+// depend on the endianness of the machine that wrote it.
+void writeLE_(std::ostream &f, UInt64 value, size_t bytes) {
+  for (size_t i = 0; i < bytes; i++) {
+    f.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+UInt64 readLE_(std::istream &f, size_t bytes) {
+  UInt64 value = 0;
+  for (size_t i = 0; i < bytes; i++) {
+    int c = f.get();
+    NTA_CHECK(c != EOF) << "Sectioned snapshot: unexpected end of file.";
+    value |= static_cast<UInt64>(static_cast<unsigned char>(c)) << (8 * i);
+  }
+  return value;
+}
+
+std::string readSection_(std::istream &f, const SectionEntry &entry) {
+  std::string data(static_cast<size_t>(entry.length), '\0');
+  f.seekg(static_cast<std::streamoff>(entry.offset));
+  f.read(&data[0], static_cast<std::streamsize>(entry.length));
+  NTA_CHECK(f.good()) << "Sectioned snapshot: could not read section '" << entry.name << "'";
+  return data;
+}
+} // namespace
+
+
+std::vector<Network::Section> Network::captureSections_(SerializableFormat fmt, bool snapshots) const {
+  std::vector<Section> sections;
+
+  NetworkSection net;
+  net.iteration = iteration_;
+  net.links = getLinks();
+  net.phases = phasesToString();
+  std::ostringstream ns(std::ios_base::out | std::ios_base::binary);
+  net.save(ns, fmt);
+  sections.push_back(Section{NETWORK_SECTION, ns.str(), nullptr});
+
+  for (const auto &p : regions_) {
+    std::ostringstream shell(std::ios_base::out | std::ios_base::binary);
+    shell.precision(std::numeric_limits<double>::digits10 + 1);
+    p.second->saveShellSection(shell, fmt);
+    sections.push_back(Section{SHELL_PREFIX + p.first, shell.str(), nullptr});
+
+    std::shared_ptr<const RegionImpl> snapshot;
+    if (snapshots)
+      snapshot = p.second->snapshotImpl();
+    if (snapshot) {
+      sections.push_back(Section{IMPL_PREFIX + p.first, std::string(), snapshot});
+    } else {
+      std::ostringstream impl(std::ios_base::out | std::ios_base::binary);
+      impl.precision(std::numeric_limits<double>::digits10 + 1);
+      p.second->saveImplSection(impl, fmt);
+      sections.push_back(Section{IMPL_PREFIX + p.first, impl.str(), nullptr});
+    }
+  }
+  return sections;
+}
+
+namespace {
+template <class Sections>
+void writeSections_(const std::string &filePath, SerializableFormat fmt, Sections &sections) {
+  // Serialize the RegionImpl snapshots, if any.
+  for (auto &s : sections) {
+    if (s.snapshot) {
+      std::ostringstream impl(std::ios_base::out | std::ios_base::binary);
+      impl.precision(std::numeric_limits<double>::digits10 + 1);
+      Region::saveImplSnapshot(*s.snapshot, impl, fmt);
+      s.data = impl.str();
+      s.snapshot.reset();
+    }
+  }
+
+  // Size of the table of contents determines where the first section starts.
+  UInt64 offset = sizeof(SECTIONED_MAGIC) + 4 + 4;
+  for (const auto &s : sections)
+    offset += 4 + s.name.size() + 8 + 8;
+
+  Directory::create(Path::getParent(filePath), true, true);
+  std::ofstream out(filePath, std::ios_base::out | std::ios_base::binary);
+  NTA_CHECK(out.is_open()) << "Sectioned snapshot: unable to open '" << filePath << "'";
+  out.write(SECTIONED_MAGIC, sizeof(SECTIONED_MAGIC));
+  writeLE_(out, sections.size(), 4);
+  writeLE_(out, static_cast<UInt64>(fmt), 4);
+  for (const auto &s : sections) {
+    writeLE_(out, s.name.size(), 4);
+    out.write(s.name.data(), static_cast<std::streamsize>(s.name.size()));
+    writeLE_(out, offset, 8);
+    writeLE_(out, s.data.size(), 8);
+    offset += s.data.size();
+  }
+  for (const auto &s : sections) {
+    out.write(s.data.data(), static_cast<std::streamsize>(s.data.size()));
+  }
+  NTA_CHECK(out.good()) << "Sectioned snapshot: error writing '" << filePath << "'";
+  out.close();
+}
+} // namespace
+
+
+void Network::saveToFileSectioned(const std::string &filePath, SerializableFormat fmt) const {
+  std::vector<Section> sections = captureSections_(fmt);
+  writeSections_(filePath, fmt, sections);
+}
+
+
+std::shared_future<void> Network::saveToFileAsync(const std::string &filePath, SerializableFormat fmt) {
+  std::shared_ptr<std::promise<void>> done = std::make_shared<std::promise<void>>();
+  std::shared_future<void> result = done->get_future().share();
+  if (running_) {
+    // Called from a run callback. The iteration is not complete until the
+    // delayed links have been shifted, so run() takes the capture after that.
+    pendingCheckpoints_.push_back(PendingCheckpoint{filePath, fmt, done});
+  } else {
+    startCheckpoint_(filePath, fmt, done);
+  }
+  return result;
+}
+
+void Network::startCheckpoint_(const std::string &filePath, SerializableFormat fmt,
+                               std::shared_ptr<std::promise<void>> done) {
+  // The capture happens here, on the caller's thread, at an iteration boundary.
+  // Only the captured bytes and RegionImpl copies are shared with the writer
+  // thread, never the Network.
+  std::shared_ptr<std::vector<Section>> sections;
+  try {
+    // Serialization is const, so deferred work is completed first.  A
+    // checkpoint requested in a run callback thus includes the iterations
+    // that a batching region has not computed yet.
+    finishRun_();
+    sections = std::make_shared<std::vector<Section>>(captureSections_(fmt, true));
+  } catch (...) {
+    done->set_exception(std::current_exception());
+    return;
+  }
+
+  if (!checkpointWriter_)
+    checkpointWriter_.reset(new ThreadPool(1));
+  checkpointWriter_->submit([filePath, fmt, sections, done]() {
+    try {
+      writeSections_(filePath, fmt, *sections);
+      done->set_value();
+    } catch (...) {
+      done->set_exception(std::current_exception());
+    }
+  });
+}
+
+
+void Network::loadFromFileSectioned(const std::string &filePath, UInt32 numThreads, bool lazy) {
+  NTA_CHECK(regions_.empty()) << "loadFromFileSectioned: the Network must be empty.";
+
+  std::ifstream in(filePath, std::ios_base::in | std::ios_base::binary);
+  NTA_CHECK(in.is_open()) << "loadFromFileSectioned: unable to open '" << filePath << "'";
+
+  // Table of contents.
+  char magic[sizeof(SECTIONED_MAGIC)];
+  in.read(magic, sizeof(magic));
+  NTA_CHECK(in.good() && std::equal(magic, magic + sizeof(magic), SECTIONED_MAGIC))
+      << "loadFromFileSectioned: '" << filePath << "' is not a sectioned Network snapshot.";
+  size_t count = static_cast<size_t>(readLE_(in, 4));
+  SerializableFormat fmt = static_cast<SerializableFormat>(readLE_(in, 4));
+  std::map<std::string, SectionEntry> toc;
+  std::vector<std::string> regionNames;
+  for (size_t i = 0; i < count; i++) {
+    SectionEntry entry;
+    entry.name.resize(static_cast<size_t>(readLE_(in, 4)));
+    in.read(&entry.name[0], static_cast<std::streamsize>(entry.name.size()));
+    entry.offset = readLE_(in, 8);
+    entry.length = readLE_(in, 8);
+    if (entry.name.compare(0, SHELL_PREFIX.size(), SHELL_PREFIX) == 0)
+      regionNames.push_back(entry.name.substr(SHELL_PREFIX.size()));
+    toc[entry.name] = entry;
+  }
+  NTA_CHECK(toc.find(NETWORK_SECTION) != toc.end())
+      << "loadFromFileSectioned: missing '" << NETWORK_SECTION << "' section.";
+
+  // 1. Region shells. These are small; they create the Inputs and Outputs
+  //    that the links need and restore the output buffers.
+  std::vector<std::shared_ptr<Region>> regions;
+  for (const auto &name : regionNames) {
+    std::istringstream ss(readSection_(in, toc[SHELL_PREFIX + name]));
+    auto r = std::make_shared<Region>(this);
+    r->loadShellSection(ss, fmt);
+    regions_[r->getName()] = r;
+    regions.push_back(r);
+  }
+
+  // 2. Region impls, which hold the algorithm state.
+  RegionImplFactory &factory = RegionImplFactory::getInstance(); // registers built-ins on this thread.
+  std::vector<std::shared_ptr<Region>> concurrent;
+  for (size_t i = 0; i < regions.size(); i++) {
+    const SectionEntry &entry = toc.at(IMPL_PREFIX + regionNames[i]);
+    if (lazy) {
+      regions[i]->deferImplSection(std::make_shared<const std::string>(readSection_(in, entry)), fmt);
+    } else if (!factory.canDeserializeConcurrently(regions[i]->getType())) {
+      std::istringstream ss(readSection_(in, entry));
+      regions[i]->loadImplSection(ss, fmt);
+    } else {
+      concurrent.push_back(regions[i]);
+    }
+  }
+  if (!concurrent.empty()) {
+    size_t threads = (numThreads == 0) ? std::thread::hardware_concurrency() : numThreads;
+    ThreadPool pool(std::max<size_t>(1, std::min<size_t>(threads, concurrent.size())));
+    pool.parallelFor(concurrent.size(), [&](size_t i) {
+      // Each worker has its own stream so reads can overlap as well.
+      std::ifstream f(filePath, std::ios_base::in | std::ios_base::binary);
+      std::istringstream ss(readSection_(f, toc.at(IMPL_PREFIX + concurrent[i]->getName())));
+      concurrent[i]->loadImplSection(ss, fmt);
+    });
+  }
+
+  // 3. Network level state, then re-create the links.
+  NetworkSection net;
+  std::istringstream ns(readSection_(in, toc[NETWORK_SECTION]));
+  net.load(ns, fmt);
+  iteration_ = net.iteration;
+  post_load(net.links);
+  phasesFromString(net.phases);
 }
 
 
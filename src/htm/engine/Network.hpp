@@ -22,8 +22,10 @@
 #ifndef NTA_NETWORK_HPP
 #define NTA_NETWORK_HPP
 
+#include <future>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -42,6 +44,8 @@ class Region;
 class Dimensions;
 class RegisteredRegionImpl;
 class Link;
+class ThreadPool;
+class RegionImpl;
 
 /**
  * Represents an HTM network. A network is a collection of regions.
@@ -92,11 +96,16 @@ public:
    *             type: <region type>
    *             params: <list of parameters>  (optional)
    *             phase:  <optonal phase number> (optional)
+   *             period: <compute every period iterations> (optional, default=1)
+   *             offset: <iteration of the first compute> (optional, default=0)
+   *
+   *             partition: <partition name> (optional, default="0", see setPartition())
    *
    *         - addLink:
    *             src: <Name of the source region "." Output name>
    *             dest: <Name of the destination region "." Input name>
    *             delay: <iterations to delay> (optional, default=0)
+   *             slots: <frames in flight between partitions> (optional, default=4)
    *
    *
    * JSON syntax:
@@ -117,6 +126,40 @@ public:
    *  On errors it throws an exception.
    */
   void configure(const std::string &yaml);
+
+  /**
+   * Run one partition of a network, so that the regions of a configuration
+   * can be spread over several processes on the same machine.
+   *
+   * Each process calls setPartition() with its own partition name, and then
+   * configure() with the same configuration.  configure() adds only the
+   * regions whose 'partition' is this one (regions without one are in
+   * partition "0").  A link from a region of another partition is carried
+   * through a shared memory ring: the source partition publishes the output
+   * with a SharedMemoryOutputRegion, and this partition reads it back with a
+   * SharedMemoryInputRegion, which computes before the destination region.
+   *
+   * Each process then calls run() as usual.  The ring of a link holds
+   * 'slots' frames (addLink option, default 4): the source partition may run
+   * that many iterations ahead before it waits, 1 keeps the partitions in
+   * lock step.  The partitions must not feed each other in a cycle.
+   * A partition which stops or fails makes the others throw after the
+   * 'timeout' of the shared memory regions.
+   *
+   * With no partition set (the default), configure() adds all regions.
+   *
+   * @param partition   The name of the partition of this process.
+   * @param linkPrefix  The names of the shared memory rings start with this,
+   *                    followed by "<region>.<output>.<partition>".  The
+   *                    default, "", is "/htm.link." and a hash of the
+   *                    configuration, so runs of different configurations do
+   *                    not share rings; the rest of a default name is hashed
+   *                    too if it exceeds the shm_open() limit of the system
+   *                    (31 characters on macOS).  Choose a prefix to run the
+   *                    same configuration more than once at a time.
+   */
+  void setPartition(const std::string &partition, const std::string &linkPrefix = "");
+  const std::string &getPartition() const { return partition_; }
   
   /**
    * Return the Spec for the region type as a JSON string.
@@ -195,6 +238,70 @@ public:
     phasesFromString(phases);
   }
 
+  /**
+   * Sectioned snapshots.
+   *
+   *    saveToFileSectioned(path [, fmt])
+   *    loadFromFileSectioned(path [, numThreads [, lazy]])
+   *
+   * A sectioned snapshot stores each region in its own byte range of the
+   * file and starts with a table of contents, so that on restore the regions
+   * can be deserialized in parallel rather than one after the other.
+   * Restore time is then bounded by the largest region rather than by
+   * the sum of all regions.
+   *
+   * Layout (all integers are little-endian):
+   *    char[8]  magic "HTMSECT1"
+   *    UInt32   number of sections
+   *    UInt32   SerializableFormat used for every section
+   *    for each section:
+   *       UInt32 name length, name, UInt64 offset, UInt64 length
+   *    section data...
+   *
+   * Sections are "network" (iteration, links and phases),
+   * "shell:<region>" (dimensions and output buffers) and
+   * "impl:<region>" (the RegionImpl and its algorithm).
+   *
+   * @param numThreads Number of threads used to deserialize the impl
+   *        sections. 0 means one per hardware thread.
+   * @param lazy If true the impl sections are not deserialized on load.
+   *        Each region is deserialized the first time it is needed,
+   *        normally on its first compute().
+   *
+   * Regions implemented in Python are always deserialized on the calling
+   * thread.  loadFromFileSectioned() must be called on an empty Network.
+   */
+  void saveToFileSectioned(const std::string &filePath,
+                           SerializableFormat fmt = SerializableFormat::BINARY) const;
+  void loadFromFileSectioned(const std::string &filePath, UInt32 numThreads = 0,
+                             bool lazy = false);
+
+  /**
+   * Background checkpoint.
+   *
+   * Captures the state of the network in memory and writes it to filePath
+   * as a sectioned snapshot (see above) on a background thread, so the
+   * caller can continue with run() while the file is being written.
+   * Only the in-memory capture blocks the caller.  Regions with large state
+   * (SPRegion, TMRegion) are captured as a copy of their arrays, which the
+   * background thread then serializes; see RegionImpl::snapshot().  Other
+   * regions are serialized during the capture.
+   *
+   * The captured state is always a consistent cut at an iteration boundary.
+   * Between calls to run() it is captured immediately. When called from a
+   * run callback (see getCallbacks()) the capture is taken at the end of
+   * that iteration, once the delayed links have been updated, and run()
+   * then continues with the next iteration.
+   *
+   * Checkpoints are written one at a time in the order they were requested.
+   * The Network destructor waits for the pending ones to finish.
+   *
+   * @returns a future which becomes ready when the file has been written.
+   *          get() rethrows any error that occurred while writing.
+   */
+  std::shared_future<void> saveToFileAsync(const std::string &filePath,
+                                           SerializableFormat fmt = SerializableFormat::BINARY);
+
   /**
    * @}
    *
@@ -332,6 +439,24 @@ public:
    */
   std::set<UInt32> getPhases(const std::string &name) const;
 
+  /**
+   * Region decimation.  Run the named region only on every period'th
+   * iteration of run(), starting with iteration number offset (counting the
+   * first iteration as 0).  On the other iterations the region is skipped:
+   * its inputs are not prepared and its outputs keep their last value.
+   *
+   * The inputs are sampled when the region runs, so a region with a period
+   * sees the current value of its links, not an aggregate of the skipped
+   * iterations.  Delayed links are still shifted every iteration.
+   *
+   * @param name   Name of the region
+   * @param period Compute every period iterations, 1 computes every iteration.
+   * @param offset Iteration of the first compute, must be less than period.
+   */
+  void setComputePeriod(const std::string &name, UInt32 period, UInt32 offset = 0);
+  UInt32 getComputePeriod(const std::string &name) const;
+  UInt32 getComputeOffset(const std::string &name) const;
+
   /**
    * Get minimum phase for regions in this network. If no regions, then min = 0.
    *
@@ -392,6 +517,24 @@ public:
    */
   void run(int n);
 
+  /**
+   * Batched execution.  With a batch size k > 1, run() computes the regions
+   * which support RegionImpl::computeBatch() k iterations at a time, and
+   * then runs the other regions iteration by iteration, handing them one
+   * row of the batched outputs on each iteration.
+   *
+   * A region is batched if it is batchable, runs in a single phase, computes
+   * every iteration, and all of its inputs are linked without delay from
+   * batched regions in earlier phases.  Typically these are the encoders and
+   * an SPRegion at the start of the network.  The results and callbacks are
+   * the same as without batching, except that parameters of batched regions
+   * must not be changed by a callback during run().
+   *
+   * @param k Number of iterations per batch, 1 disables batching (default).
+   */
+  void setBatchSize(UInt32 k);
+  UInt32 getBatchSize() const { return batchSize_; }
+
   /**
    * The type of run callback function.
    *
@@ -511,6 +654,13 @@ private:
   // default phase assignment for a new region
   void setDefaultPhase_(Region *region);
 
+  // the regions which run() computes in batches, see setBatchSize()
+  std::set<Region *> batchedRegions_() const;
+  // compute k iterations of the batched regions
+  void computeBatch_(const std::set<Region *> &batched, size_t k);
+  // let the regions complete the work they deferred, see RegionImpl::finishRun()
+  void finishRun_();
+
   // whenever we modify a network or change phase
   // information, we set enabled phases to min/max for
   // the network
@@ -518,6 +668,24 @@ private:
   std::string phasesToString() const;
   void phasesFromString(const std::string& phaseString);
 
+  // A named section of a sectioned snapshot.  With snapshots, the impl
+  // section of a region may be a copy of the RegionImpl instead of bytes,
+  // to be serialized by the checkpoint writer thread.
+  struct Section {
+    std::string name;
+    std::string data;
+    std::shared_ptr<const RegionImpl> snapshot;
+  };
+
+  // capture the network and each region into named in-memory sections,
+  // in the layout used by saveToFileSectioned().
+  std::vector<Section> captureSections_(SerializableFormat fmt, bool snapshots = false) const;
+
+  // capture the sections now and queue serializing the snapshots and
+  // writing the file to the checkpoint writer thread.
+  void startCheckpoint_(const std::string &filePath, SerializableFormat fmt,
+                        std::shared_ptr<std::promise<void>> done);
+
   bool initialized_;
 	
 	/**
@@ -540,6 +708,27 @@ private:
 
   // number of elapsed iterations
   UInt64 iteration_;
+
+  // iterations per batch for batchable regions, see setBatchSize()
+  UInt32 batchSize_ = 1u;
+
+  // the partition configure() adds, see setPartition()
+  std::string partition_;
+  std::string linkPrefix_;
+
+  // true while inside run()
+  bool running_ = false;
+
+  // checkpoints requested by a run callback, taken at the end of the iteration
+  struct PendingCheckpoint {
+    std::string filePath;
+    SerializableFormat fmt;
+    std::shared_ptr<std::promise<void>> done;
+  };
+  std::vector<PendingCheckpoint> pendingCheckpoints_;
+
+  // writes the checkpoints requested by saveToFileAsync(), created on first use.
+  std::unique_ptr<ThreadPool> checkpointWriter_;
 };
 
 } // namespace htm
@@ -0,0 +1,313 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the ParameterSweep class
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <htm/engine/ParameterSweep.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/engine/RegionImplFactory.hpp>
+#include <htm/os/Path.hpp>
+#include <htm/utils/Log.hpp>
+#include <htm/utils/Random.hpp>
+#include <htm/utils/ThreadPool.hpp>
+
+namespace htm {
+
+namespace {
+  std::string formatReal(Real64 value, bool integer) {
+    std::ostringstream ss;
+    if (integer)
+      ss << static_cast<Int64>(std::floor(value + 0.5));
+    else
+      ss << value;
+    return ss.str();
+  }
+
+  // Split "<region>.<param>".
+  std::pair<std::string, std::string> splitName(const std::string &parameter) {
+    const size_t dot = parameter.find('.');
+    NTA_CHECK(dot != std::string::npos && dot > 0u && dot + 1u < parameter.size())
+        << "ParameterSweep: expected <region>.<param> for parameter '" << parameter << "'.";
+    return std::make_pair(parameter.substr(0u, dot), parameter.substr(dot + 1u));
+  }
+} // namespace
+
+ParameterSweep::ParameterSweep(const std::string &baseConfig) {
+  base_.parse(baseConfig);
+  NTA_CHECK(base_.isMap() && base_.contains("network") && base_["network"].isSequence())
+      << "ParameterSweep: expected a Network configuration starting with 'network:'.";
+  setMetric("tm.anomaly");
+}
+
+void ParameterSweep::configure(const std::string &spec) {
+  ValueMap vm;
+  vm.parse(spec);
+  NTA_CHECK(vm.isMap()) << "ParameterSweep: expected a map of sweep settings.";
+
+  const std::string search = vm.getString("search", "grid");
+  NTA_CHECK(search == "grid" || search == "random") << "ParameterSweep: unknown search '" << search << "'.";
+  if (search == "random")
+    setRandomSearch(vm.getScalarT<UInt32>("samples", 10u), vm.getScalarT<UInt64>("seed", 42u));
+  else
+    setRandomSearch(0u);
+  threads_ = vm.getScalarT<UInt32>("threads", 0u);
+  source_ = vm.getString("source", source_);
+
+  if (vm.contains("metric")) {
+    const Value &m = vm["metric"];
+    const std::string goal = m.getString("goal", "minimize");
+    NTA_CHECK(goal == "minimize" || goal == "maximize") << "ParameterSweep: unknown goal '" << goal << "'.";
+    setMetric(m.getString("output", "tm.anomaly"), m.getScalarT<UInt32>("skip", 0u), goal == "minimize");
+  }
+
+  if (vm.contains("parameters")) {
+    Value &params = vm["parameters"];
+    NTA_CHECK(params.isMap()) << "ParameterSweep: expected a map of parameters.";
+    for (auto itr : params) {
+      const Value &p = itr.second;
+      if (p.isSequence()) {
+        addChoices(itr.first, p.asVector<std::string>());
+      } else {
+        NTA_CHECK(p.isMap() && p.contains("min") && p.contains("max"))
+            << "ParameterSweep: expected a list of choices or {min: x, max: y} for parameter '" << itr.first << "'.";
+        addRange(itr.first, p["min"].as<Real64>(), p["max"].as<Real64>(),
+                 p.getScalarT<bool>("integer", false), p.getScalarT<UInt32>("steps", 0u));
+      }
+    }
+  }
+}
+
+void ParameterSweep::addChoices(const std::string &parameter, const std::vector<std::string> &values) {
+  splitName(parameter);
+  NTA_CHECK(!values.empty()) << "ParameterSweep: no choices for parameter '" << parameter << "'.";
+  Parameter p = {parameter, values, 0.0, 0.0, false, 0u};
+  parameters_.push_back(p);
+}
+
+void ParameterSweep::addRange(const std::string &parameter, Real64 low, Real64 high, bool integer, UInt32 steps) {
+  splitName(parameter);
+  NTA_CHECK(low <= high) << "ParameterSweep: empty range for parameter '" << parameter << "'.";
+  Parameter p = {parameter, std::vector<std::string>(), low, high, integer, steps};
+  parameters_.push_back(p);
+}
+
+void ParameterSweep::setRandomSearch(UInt32 samples, UInt64 seed) {
+  samples_ = samples;
+  seed_ = seed;
+}
+
+void ParameterSweep::setDataset(const std::vector<std::vector<Real64>> &rows, const std::string &source) {
+  dataset_.clear();
+  for (const auto &row : rows) {
+    NTA_CHECK(row.size() == rows[0].size()) << "ParameterSweep: rows of the dataset differ in length.";
+    dataset_.push_back(Array(row));
+  }
+  source_ = source;
+}
+
+void ParameterSweep::loadDataset(const std::string &path, const std::string &source) {
+  std::ifstream f(path.c_str());
+  NTA_CHECK(f.is_open()) << "ParameterSweep: cannot open dataset '" << path << "'.";
+
+  std::vector<std::vector<Real64>> rows;
+  std::string line;
+  size_t lineNumber = 0u;
+  while (std::getline(f, line)) {
+    lineNumber++;
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::vector<Real64> row;
+    bool numeric = true;
+    for (const auto &field : Path::split(line, ',')) {
+      char *end = nullptr;
+      row.push_back(std::strtod(field.c_str(), &end));
+      while (*end == ' ' || *end == '\t')
+        end++;
+      numeric = numeric && end != field.c_str() && *end == '\0';
+    }
+    if (!numeric && rows.empty() && lineNumber == 1u)
+      continue; // header
+    NTA_CHECK(numeric) << "ParameterSweep: not a number on line " << lineNumber << " of '" << path << "'.";
+    rows.push_back(row);
+  }
+  setDataset(rows, source);
+}
+
+void ParameterSweep::setMetric(const std::string &output, UInt32 skip, bool minimize) {
+  const std::pair<std::string, std::string> name = splitName(output);
+  setMetric([name](Network &net, size_t) {
+    const std::vector<Real64> v = net.getRegion(name.first)->getOutputData(name.second).asVector<Real64>();
+    Real64 sum = 0.0;
+    for (const Real64 x : v)
+      sum += x;
+    return v.empty() ? 0.0 : sum / static_cast<Real64>(v.size());
+  }, skip, minimize);
+}
+
+void ParameterSweep::setMetric(Metric metric, UInt32 skip, bool minimize) {
+  metric_ = metric;
+  skip_ = skip;
+  minimize_ = minimize;
+}
+
+std::vector<std::map<std::string, std::string>> ParameterSweep::configurations() const {
+  std::vector<std::map<std::string, std::string>> configs;
+
+  if (samples_ > 0u) {
+    Random rng(seed_);
+    for (UInt32 s = 0u; s < samples_; s++) {
+      std::map<std::string, std::string> config;
+      for (const auto &p : parameters_) {
+        if (!p.choices.empty()) {
+          config[p.name] = p.choices[rng.getUInt32(static_cast<UInt32>(p.choices.size()))];
+        } else if (p.integer) {
+          const Int64 low = static_cast<Int64>(std::ceil(p.low));
+          const Int64 high = static_cast<Int64>(std::floor(p.high));
+          NTA_CHECK(low <= high) << "ParameterSweep: no integer in the range of '" << p.name << "'.";
+          config[p.name] = formatReal(static_cast<Real64>(low + rng.getUInt32(static_cast<UInt32>(high - low + 1))), true);
+        } else {
+          config[p.name] = formatReal(p.low + (p.high - p.low) * rng.getReal64(), false);
+        }
+      }
+      configs.push_back(config);
+    }
+    return configs;
+  }
+
+  // Grid search: the values of each parameter, then all their combinations.
+  std::vector<std::vector<std::string>> values;
+  for (const auto &p : parameters_) {
+    if (!p.choices.empty()) {
+      values.push_back(p.choices);
+      continue;
+    }
+    NTA_CHECK(p.steps > 0u) << "ParameterSweep: a grid search needs the steps of range '" << p.name << "'.";
+    std::vector<std::string> v;
+    for (UInt32 i = 0u; i < p.steps; i++) {
+      const Real64 x = (p.steps == 1u) ? p.low : p.low + (p.high - p.low) * i / (p.steps - 1u);
+      const std::string s = formatReal(x, p.integer);
+      if (v.empty() || v.back() != s) // integer steps may repeat
+        v.push_back(s);
+    }
+    values.push_back(v);
+  }
+  std::vector<size_t> digit(parameters_.size(), 0u);
+  while (true) {
+    std::map<std::string, std::string> config;
+    for (size_t i = 0u; i < parameters_.size(); i++)
+      config[parameters_[i].name] = values[i][digit[i]];
+    configs.push_back(config);
+
+    size_t i = 0u;
+    for (; i < digit.size(); i++) {
+      if (++digit[i] < values[i].size())
+        break;
+      digit[i] = 0u;
+    }
+    if (i == digit.size())
+      break;
+  }
+  return configs;
+}
+
+std::string ParameterSweep::networkConfig(const std::map<std::string, std::string> &parameters) const {
+  ValueMap config = base_.copy();
+  Value &commands = config["network"];
+  for (const auto &param : parameters) {
+    const std::pair<std::string, std::string> name = splitName(param.first);
+    bool found = false;
+    for (size_t i = 0u; i < commands.size(); i++) {
+      if (commands[i].contains("addRegion") && commands[i]["addRegion"]["name"].str() == name.first) {
+        commands[i]["addRegion"]["params"][name.second] = param.second;
+        found = true;
+      }
+    }
+    NTA_CHECK(found) << "ParameterSweep: no addRegion for region '" << name.first << "' of parameter '"
+                     << param.first << "'.";
+  }
+  return config.to_yaml();
+}
+
+ParameterSweep::Result ParameterSweep::evaluate_(size_t index,
+                                                 const std::map<std::string, std::string> &parameters) const {
+  Result result;
+  result.index = index;
+  result.parameters = parameters;
+  result.score = std::numeric_limits<Real64>::quiet_NaN();
+  result.seconds = 0.0;
+
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    Network net;
+    net.configure(networkConfig(parameters));
+    Real64 sum = 0.0;
+    for (size_t i = 0u; i < dataset_.size(); i++) {
+      // The INPUT buffer shares the row; regions only read their inputs.
+      net.setInputData(source_, dataset_[i]);
+      net.run(1);
+      if (i >= skip_)
+        sum += metric_(net, i);
+    }
+    result.score = sum / static_cast<Real64>(dataset_.size() - skip_);
+  } catch (Exception &e) {
+    result.error = e.getMessage();
+  } catch (std::exception &e) {
+    result.error = e.what();
+  }
+  result.seconds = std::chrono::duration<Real64>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+std::vector<ParameterSweep::Result> ParameterSweep::run() {
+  NTA_CHECK(dataset_.size() > skip_) << "ParameterSweep: the dataset has " << dataset_.size()
+                                     << " rows, not more than the " << skip_ << " skipped.";
+  const std::vector<std::map<std::string, std::string>> configs = configurations();
+
+  // Register the built-in regions before the workers create Networks.
+  RegionImplFactory::getInstance();
+
+  std::vector<Result> results(configs.size());
+  ThreadPool pool(std::min<size_t>(threads_ == 0u ? std::thread::hardware_concurrency() : threads_,
+                                   std::max<size_t>(configs.size(), 1u)));
+  pool.parallelFor(configs.size(), [&](size_t i) { results[i] = evaluate_(i, configs[i]); });
+  return results;
+}
+
+ParameterSweep::Result ParameterSweep::best(const std::vector<Result> &results) const {
+  const Result *best = nullptr;
+  for (const auto &r : results) {
+    if (!r.error.empty() || std::isnan(r.score))
+      continue;
+    if (best == nullptr || (minimize_ ? r.score < best->score : r.score > best->score))
+      best = &r;
+  }
+  NTA_CHECK(best != nullptr) << "ParameterSweep: no configuration succeeded.";
+  return *best;
+}
+
+} // namespace htm
@@ -0,0 +1,163 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Parallel hyperparameter sweep over Networks
+ *
+ * Evaluates many parameter sets of one Network::configure() YAML in a
+ * single process.  Each configuration gets its own Network, which runs on a
+ * ThreadPool over a dataset that is loaded once and shared by all of them.
+ * This replaces launching a process per parameter set, as the Python
+ * optimizers in py/htm/optimization do.
+ */
+
+#ifndef NTA_PARAMETER_SWEEP_HPP
+#define NTA_PARAMETER_SWEEP_HPP
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <htm/engine/Network.hpp>
+#include <htm/ntypes/Array.hpp>
+#include <htm/ntypes/Value.hpp>
+
+namespace htm {
+
+/**
+ * @b Description
+ * A sweep varies parameters of the addRegion commands of a base config.
+ * A parameter is named "<region>.<param>" and has either a list of choices
+ * or a numeric range.  The configurations are the grid of all combinations
+ * (a range then needs a number of steps), or a number of random samples.
+ *
+ * For each configuration, the dataset is fed one row per iteration to the
+ * INPUT source of the Network and the metric is averaged over the
+ * iterations after a warm up.
+ *
+ * Example Usage:
+ *      ParameterSweep sweep(baseConfig);
+ *      sweep.configure(R"({search: random, samples: 32,
+ *                          metric: {output: tm.anomaly, skip: 100},
+ *                          parameters: {sp.columnCount: [1024, 2048],
+ *                                       sp.potentialPct: {min: 0.5, max: 0.9}}})");
+ *      sweep.loadDataset("data.csv");
+ *      std::vector<ParameterSweep::Result> results = sweep.run();
+ *      ParameterSweep::Result best = sweep.best(results);
+ */
+class ParameterSweep {
+public:
+  // Metric of one iteration, called after Network::run(1).
+  typedef std::function<Real64(Network &net, size_t iteration)> Metric;
+
+  struct Result {
+    size_t index;                                  // in configurations()
+    std::map<std::string, std::string> parameters; // "<region>.<param>" -> value
+    Real64 score;                                  // NaN if the configuration failed
+    Real64 seconds;
+    std::string error;                             // empty unless it failed
+  };
+
+  /**
+   * @param baseConfig  A Network::configure() YAML or JSON string.  Swept
+   *                    parameters replace the params of its addRegion commands.
+   */
+  explicit ParameterSweep(const std::string &baseConfig);
+
+  /**
+   * Set up the sweep from a YAML or JSON specification.  All keys are optional:
+   *
+   *     search:     grid | random            (default grid)
+   *     samples:    configurations of a random search (default 10)
+   *     seed:       seed of the random search (default 42)
+   *     threads:    worker threads, 0 for all cores (default 0)
+   *     source:     name of the INPUT source (default "source")
+   *     metric:     {output: <region>.<output>, skip: <warm up iterations>,
+   *                  goal: minimize | maximize}
+   *     parameters: {<region>.<param>: [choice, ...],
+   *                  <region>.<param>: {min: x, max: y, integer: false, steps: n}, ...}
+   */
+  void configure(const std::string &spec);
+
+  void addChoices(const std::string &parameter, const std::vector<std::string> &values);
+  // steps is the number of values of the range in a grid search.
+  void addRange(const std::string &parameter, Real64 low, Real64 high,
+                bool integer = false, UInt32 steps = 0u);
+
+  // A random search of the given number of samples; 0 for a grid search.
+  void setRandomSearch(UInt32 samples, UInt64 seed = 42u);
+  void setThreads(size_t threads) { threads_ = threads; }
+
+  /**
+   * The dataset, one row per iteration.  It is shared, read only, by the
+   * Networks of all configurations.
+   */
+  void setDataset(const std::vector<std::vector<Real64>> &rows, const std::string &source = "source");
+  // Load a CSV file of numbers, one row per line.  A non numeric first line is a header.
+  void loadDataset(const std::string &path, const std::string &source = "source");
+  size_t getDatasetSize() const { return dataset_.size(); }
+
+  /**
+   * The score is the mean over the iterations from skip on of the metric.
+   * With an output name, the metric is the mean of the elements of that output.
+   */
+  void setMetric(const std::string &output, UInt32 skip = 0u, bool minimize = true);
+  void setMetric(Metric metric, UInt32 skip = 0u, bool minimize = true);
+
+  // The parameter sets to evaluate.
+  std::vector<std::map<std::string, std::string>> configurations() const;
+  // The configure() YAML of one parameter set.
+  std::string networkConfig(const std::map<std::string, std::string> &parameters) const;
+
+  /**
+   * Evaluate all configurations.  A configuration that throws is reported
+   * in its Result rather than stopping the sweep.
+   * @retval  One Result per configuration, in the order of configurations().
+   */
+  std::vector<Result> run();
+
+  // The Result with the best score.  Throws if all of them failed.
+  Result best(const std::vector<Result> &results) const;
+
+private:
+  struct Parameter {
+    std::string name;
+    std::vector<std::string> choices; // empty for a range
+    Real64 low;
+    Real64 high;
+    bool integer;
+    UInt32 steps;
+  };
+
+  Result evaluate_(size_t index, const std::map<std::string, std::string> &parameters) const;
+
+  ValueMap base_;
+  std::vector<Parameter> parameters_;
+  UInt32 samples_ = 0u;
+  UInt64 seed_ = 42u;
+  size_t threads_ = 0u;
+  std::string source_ = "source";
+  std::vector<Array> dataset_;
+  Metric metric_;
+  UInt32 skip_ = 0u;
+  bool minimize_ = true;
+};
+
+} // namespace htm
+
+#endif // NTA_PARAMETER_SWEEP_HPP
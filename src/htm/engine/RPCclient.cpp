@@ -0,0 +1,198 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the RPCclient class
+ */
+
+#include <cerrno>
+
+#if !defined(NTA_OS_WINDOWS)
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+#include <htm/engine/RPCclient.hpp>
+#include <htm/utils/Log.hpp>
+
+namespace htm {
+
+RPCclient::RPCclient() {}
+
+RPCclient::RPCclient(const std::string &address) { connect(address); }
+
+RPCclient::~RPCclient() { close(); }
+
+void RPCclient::connect(const std::string &address) {
+  close();
+  fd_ = rpc::connectTo(address);
+}
+
+void RPCclient::close() {
+  rpc::closeSocket(fd_);
+  fd_ = -1;
+  out_.clear();
+  in_.clear();
+  received_.clear();
+}
+
+UInt32 RPCclient::send(RPCop op, const RPCbuffer &args) {
+  NTA_CHECK(isConnected()) << "RPCclient: not connected.";
+  const UInt32 sequence = nextSequence_++;
+  args.appendFrame(out_, sequence, static_cast<std::uint8_t>(op));
+  return sequence;
+}
+
+void RPCclient::flush() {
+  if (out_.empty())
+    return;
+  NTA_CHECK(isConnected()) << "RPCclient: not connected.";
+#if defined(NTA_OS_WINDOWS)
+  out_.clear();
+  NTA_THROW << "RPCclient: not implemented on Windows.";
+#else
+  // The server stops reading while its responses are not read, so receive
+  // them while sending, or both sides would wait for the other.
+  std::vector<char> out;
+  out.swap(out_);
+  size_t sent = 0u;
+  while (sent < out.size()) {
+    pollfd p = {fd_, POLLIN | POLLOUT, 0};
+    if (poll(&p, 1, -1) < 0) {
+      NTA_CHECK(errno == EINTR) << "RPCclient: poll failed.";
+      continue;
+    }
+    if (p.revents & POLLIN) {
+      receiveSome_();
+    } else if (p.revents & POLLOUT) {
+      const Int64 n = rpc::writeSome(fd_, out.data() + sent, out.size() - sent);
+      NTA_CHECK(n >= 0) << "RPCclient: connection closed by the server.";
+      sent += static_cast<size_t>(n);
+    } else {
+      NTA_THROW << "RPCclient: connection closed by the server.";
+    }
+  }
+#endif
+}
+
+void RPCclient::receiveSome_() {
+#if defined(NTA_OS_WINDOWS)
+  NTA_THROW << "RPCclient: not implemented on Windows.";
+#else
+  char chunk[64 * 1024];
+  ssize_t n;
+  do {
+    n = recv(fd_, chunk, sizeof(chunk), 0);
+  } while (n < 0 && errno == EINTR);
+  NTA_CHECK(n > 0) << "RPCclient: connection closed by the server.";
+  in_.insert(in_.end(), chunk, chunk + n);
+
+  size_t offset = 0u;
+  UInt32 seq;
+  std::uint8_t code;
+  RPCbuffer payload;
+  while (rpc::takeFrame(in_, offset, seq, code, payload))
+    received_[seq] = std::make_pair(code, std::move(payload));
+  in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(offset));
+#endif
+}
+
+RPCbuffer RPCclient::receive(UInt32 sequence) {
+  flush();
+  // Results arrive in the order of the requests; keep the ones before ours.
+  auto itr = received_.find(sequence);
+  while (itr == received_.end()) {
+    receiveSome_();
+    itr = received_.find(sequence);
+  }
+
+  // Report the first error of the requests up to this one.
+  for (auto e = received_.begin(); e != received_.end() && e->first <= sequence;) {
+    if (e->second.first != static_cast<std::uint8_t>(RPCstatus::OK)) {
+      const std::string message = e->second.second.getString();
+      received_.erase(received_.begin(), ++itr);
+      NTA_THROW << message;
+    }
+    ++e;
+  }
+  RPCbuffer result = std::move(itr->second.second);
+  received_.erase(received_.begin(), ++itr);
+  return result;
+}
+
+std::string RPCclient::createNetwork(const std::string &config, const std::string &id) {
+  return receive(send(RPCop::CREATE_NETWORK, RPCbuffer().putString(id).putString(config))).getString();
+}
+
+void RPCclient::deleteNetwork(const std::string &id) {
+  receive(send(RPCop::DELETE_NETWORK, RPCbuffer().putString(id)));
+}
+
+void RPCclient::setInput(const std::string &id, const std::string &sourceName, const Array &data) {
+  receive(send(RPCop::SET_INPUT, RPCbuffer().putString(id).putString(sourceName).putArray(data)));
+}
+
+Array RPCclient::getInput(const std::string &id, const std::string &region, const std::string &input) {
+  return receive(send(RPCop::GET_INPUT, RPCbuffer().putString(id).putString(region).putString(input))).getArray();
+}
+
+Array RPCclient::getOutput(const std::string &id, const std::string &region, const std::string &output) {
+  return receive(send(RPCop::GET_OUTPUT, RPCbuffer().putString(id).putString(region).putString(output))).getArray();
+}
+
+void RPCclient::setParameter(const std::string &id, const std::string &region,
+                             const std::string &param, const std::string &json) {
+  receive(send(RPCop::SET_PARAM, RPCbuffer().putString(id).putString(region).putString(param).putString(json)));
+}
+
+std::string RPCclient::getParameter(const std::string &id, const std::string &region, const std::string &param) {
+  return receive(send(RPCop::GET_PARAM, RPCbuffer().putString(id).putString(region).putString(param))).getString();
+}
+
+void RPCclient::run(const std::string &id, UInt32 iterations) {
+  receive(send(RPCop::RUN, RPCbuffer().putString(id).putUInt32(iterations)));
+}
+
+std::string RPCclient::command(const std::string &id, const std::string &region, const std::string &command) {
+  return receive(send(RPCop::COMMAND, RPCbuffer().putString(id).putString(region).putString(command))).getString();
+}
+
+std::vector<std::vector<Array>> RPCclient::runBatch(const std::string &id, const std::string &sourceName,
+                                                    const std::vector<Array> &inputs,
+                                                    const std::vector<std::string> &outputs) {
+  RPCbuffer args;
+  args.putString(id).putString(sourceName).putUInt32(static_cast<UInt32>(inputs.size()));
+  for (const auto &a : inputs)
+    args.putArray(a);
+  args.putUInt32(static_cast<UInt32>(outputs.size()));
+  for (const auto &name : outputs)
+    args.putString(name);
+
+  RPCbuffer result = receive(send(RPCop::RUN_BATCH, args));
+  std::vector<std::vector<Array>> batch(inputs.size());
+  for (auto &row : batch) {
+    for (size_t i = 0u; i < outputs.size(); i++)
+      row.push_back(result.getArray());
+  }
+  return batch;
+}
+
+void RPCclient::stopServer() {
+  receive(send(RPCop::STOP, RPCbuffer()));
+}
+
+} // namespace htm
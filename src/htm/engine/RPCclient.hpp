@@ -0,0 +1,120 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Client for the binary RPC server of the NetworkAPI, see RPCserver.hpp
+ */
+
+#ifndef NTA_RPC_CLIENT_HPP
+#define NTA_RPC_CLIENT_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <htm/engine/RPCprotocol.hpp>
+
+namespace htm {
+
+/**
+ * @b Description
+ * Each operation of the server has a method which sends the request and
+ * waits for the result.  Errors reported by the server are thrown as
+ * htm::Exception.
+ *
+ * To pipeline requests, use send() for each request, which does not wait,
+ * and then receive() for the results:
+ *
+ *     RPCclient client("/tmp/htm.sock");
+ *     std::string id = client.createNetwork(config);
+ *     for (auto &sample : samples) {
+ *       client.send(RPCop::SET_INPUT, RPCbuffer().putString(id).putString("source").putArray(sample));
+ *       client.send(RPCop::RUN, RPCbuffer().putString(id).putUInt32(1u));
+ *       UInt32 last = client.send(RPCop::GET_OUTPUT, RPCbuffer().putString(id).putString("tm").putString("anomaly"));
+ *       ...
+ *     }
+ *     Array anomaly = client.receive(last).getArray();
+ *
+ * A client is not thread safe; use one client per thread.
+ */
+class RPCclient {
+public:
+  RPCclient();
+  // Connect to "tcp://<host>:<port>" or the path of a Unix domain socket.
+  explicit RPCclient(const std::string &address);
+  ~RPCclient();
+
+  void connect(const std::string &address);
+  void close();
+  bool isConnected() const { return fd_ >= 0; }
+
+  /**
+   * Queue a request, without waiting.  Returns its sequence number.  The
+   * request is sent by flush() or receive().  flush() keeps the results
+   * that arrive while it sends, for receive().
+   */
+  UInt32 send(RPCop op, const RPCbuffer &args);
+  void flush();
+
+  /**
+   * Wait for the result of the request with the given sequence number.
+   * Results of earlier requests which were not received yet are kept; the
+   * first error among them is thrown when they are received.
+   */
+  RPCbuffer receive(UInt32 sequence);
+
+  // Operations, see RPCprotocol.hpp.  All of them wait for the server.
+  std::string createNetwork(const std::string &config, const std::string &id = "");
+  void deleteNetwork(const std::string &id);
+  void setInput(const std::string &id, const std::string &sourceName, const Array &data);
+  Array getInput(const std::string &id, const std::string &region, const std::string &input);
+  Array getOutput(const std::string &id, const std::string &region, const std::string &output);
+  void setParameter(const std::string &id, const std::string &region,
+                    const std::string &param, const std::string &json);
+  std::string getParameter(const std::string &id, const std::string &region, const std::string &param);
+  void run(const std::string &id, UInt32 iterations = 1u);
+  std::string command(const std::string &id, const std::string &region, const std::string &command);
+
+  /**
+   * Run one iteration for each input, in a single request.
+   * @param outputs  Outputs to return after each iteration, as "region.output".
+   * @retval         result[iteration][output]
+   */
+  std::vector<std::vector<Array>> runBatch(const std::string &id, const std::string &sourceName,
+                                           const std::vector<Array> &inputs,
+                                           const std::vector<std::string> &outputs);
+
+  // Make the server return from RPCserver::listen().
+  void stopServer();
+
+private:
+  RPCclient(const RPCclient &) = delete;
+  RPCclient &operator=(const RPCclient &) = delete;
+
+  // Read what the server has sent and keep the complete results.
+  void receiveSome_();
+
+  int fd_ = -1;
+  UInt32 nextSequence_ = 1u;
+  std::vector<char> out_;
+  std::vector<char> in_;
+  std::map<UInt32, std::pair<std::uint8_t, RPCbuffer>> received_;
+};
+
+} // namespace htm
+
+#endif // NTA_RPC_CLIENT_HPP
@@ -0,0 +1,331 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the binary RPC protocol
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#if !defined(NTA_OS_WINDOWS)
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <htm/engine/RPCprotocol.hpp>
+#include <htm/ntypes/BasicType.hpp>
+#include <htm/utils/Log.hpp>
+
+namespace htm {
+
+const size_t RPCbuffer::HEADER_SIZE;
+const size_t RPCbuffer::MAX_FRAME;
+const size_t RPCbuffer::MAX_ELEMENTS;
+const size_t RPCbuffer::MIN_ARRAY_SIZE;
+
+void RPCbuffer::put_(const void *src, size_t n) {
+  const char *p = static_cast<const char *>(src);
+  data_.insert(data_.end(), p, p + n);
+}
+
+void RPCbuffer::get_(void *dst, size_t n) {
+  NTA_CHECK(pos_ + n <= data_.size()) << "RPC: truncated message.";
+  std::memcpy(dst, data_.data() + pos_, n);
+  pos_ += n;
+}
+
+RPCbuffer &RPCbuffer::putUInt32(UInt32 value) {
+  put_(&value, sizeof(value));
+  return *this;
+}
+
+RPCbuffer &RPCbuffer::putString(const std::string &value) {
+  putUInt32(static_cast<UInt32>(value.size()));
+  put_(value.data(), value.size());
+  return *this;
+}
+
+RPCbuffer &RPCbuffer::putArray(const Array &value, const std::vector<UInt> &dimensions) {
+  const NTA_BasicType type = value.getType();
+  NTA_CHECK(type != NTA_BasicType_Str) << "RPC: string arrays are not supported.";
+  const std::uint8_t t = static_cast<std::uint8_t>(type);
+  put_(&t, 1u);
+
+  std::vector<UInt> dims = dimensions;
+  if (type == NTA_BasicType_SDR)
+    dims = value.getSDR().dimensions;
+  else if (dims.empty())
+    dims.push_back(static_cast<UInt>(value.getCount()));
+  putUInt32(static_cast<UInt32>(dims.size()));
+  put_(dims.data(), dims.size() * sizeof(UInt));
+
+  if (type == NTA_BasicType_SDR) {
+    const SDR_sparse_t &sparse = value.getSDR().getSparse();
+    putUInt32(static_cast<UInt32>(sparse.size()));
+    put_(sparse.data(), sparse.size() * sizeof(ElemSparse));
+  } else {
+    putUInt32(static_cast<UInt32>(value.getCount()));
+    put_(value.getBuffer(), value.getCount() * BasicType::getSize(type));
+  }
+  return *this;
+}
+
+UInt32 RPCbuffer::getUInt32() {
+  UInt32 value;
+  get_(&value, sizeof(value));
+  return value;
+}
+
+UInt32 RPCbuffer::getCount(size_t minBytes) {
+  const UInt32 count = getUInt32();
+  NTA_CHECK(count <= remaining() / minBytes)
+      << "RPC: truncated message, " << count << " items do not fit in " << remaining() << " bytes.";
+  return count;
+}
+
+std::string RPCbuffer::getString() {
+  const UInt32 n = getCount(1u);
+  std::string value(data_.data() + pos_, n);
+  pos_ += n;
+  return value;
+}
+
+Array RPCbuffer::getArray(std::vector<UInt> *dimensions) {
+  std::uint8_t t;
+  get_(&t, 1u);
+  const NTA_BasicType type = static_cast<NTA_BasicType>(t);
+  // A Handle is a pointer, meaningless in another process.
+  NTA_CHECK(BasicType::isValid(type) && type != NTA_BasicType_Str && type != NTA_BasicType_Handle)
+      << "RPC: invalid array type " << (int)t;
+
+  std::vector<UInt> dims(getCount(sizeof(UInt)));
+  NTA_CHECK(!dims.empty()) << "RPC: an array needs at least one dimension.";
+  get_(dims.data(), dims.size() * sizeof(UInt));
+  size_t size = 1u;
+  for (const UInt d : dims) {
+    NTA_CHECK(d == 0u || size <= MAX_ELEMENTS / d) << "RPC: array dimensions are too large.";
+    size *= d;
+  }
+
+  if (type == NTA_BasicType_SDR) {
+    const size_t count = getCount(sizeof(ElemSparse));
+    NTA_CHECK(count <= size) << "RPC: " << count << " active bits in an SDR of size " << size;
+    SDR_sparse_t sparse(count);
+    get_(sparse.data(), count * sizeof(ElemSparse));
+    // Check here, SDR::setSparse() checks only with NTA_ASSERTIONS_ON.
+    for (size_t i = 0u; i < count; i++) {
+      NTA_CHECK(sparse[i] < size) << "RPC: SDR index " << sparse[i] << " is out of range.";
+      NTA_CHECK(i == 0u || sparse[i - 1u] < sparse[i]) << "RPC: SDR indices must be sorted and unique.";
+    }
+    Array value(type);
+    value.allocateBuffer(dims);
+    value.getSDR().setSparse(sparse);
+    if (dimensions != nullptr)
+      *dimensions = dims;
+    return value;
+  }
+  const size_t count = getCount(BasicType::getSize(type));
+  NTA_CHECK(count == size) << "RPC: an array of " << count << " elements with dimensions of size " << size;
+  Array value(type, data_.data() + pos_, count);
+  pos_ += count * BasicType::getSize(type);
+  if (dimensions != nullptr)
+    *dimensions = dims;
+  return value;
+}
+
+void RPCbuffer::appendFrame(std::vector<char> &out, UInt32 sequence, std::uint8_t code) const {
+  const UInt32 length = static_cast<UInt32>(HEADER_SIZE - sizeof(UInt32) + data_.size());
+  const size_t start = out.size();
+  out.resize(start + HEADER_SIZE);
+  std::memcpy(&out[start], &length, sizeof(length));
+  std::memcpy(&out[start + 4u], &sequence, sizeof(sequence));
+  out[start + 8u] = static_cast<char>(code);
+  out.insert(out.end(), data_.begin(), data_.end());
+}
+
+
+namespace rpc {
+
+#if defined(NTA_OS_WINDOWS)
+
+int listenOn(const std::string &address) {
+  NTA_THROW << "RPC: sockets are not implemented on Windows.";
+}
+int connectTo(const std::string &address) {
+  NTA_THROW << "RPC: sockets are not implemented on Windows.";
+}
+Int64 writeSome(int fd, const char *data, size_t size) { return -1; }
+void closeSocket(int fd) {}
+
+#else
+
+namespace {
+  const std::string TCP_PREFIX  = "tcp://";
+  const std::string UNIX_PREFIX = "unix://";
+
+  bool isTcp(const std::string &address) {
+    return address.compare(0, TCP_PREFIX.size(), TCP_PREFIX) == 0;
+  }
+
+  std::string unixPath(const std::string &address) {
+    std::string path = address;
+    if (path.compare(0, UNIX_PREFIX.size(), UNIX_PREFIX) == 0)
+      path = path.substr(UNIX_PREFIX.size());
+    NTA_CHECK(!path.empty() && path.size() < sizeof(sockaddr_un::sun_path))
+        << "RPC: invalid socket path '" << address << "'";
+    return path;
+  }
+
+  // Resolve "tcp://host:port", calling 'use' on each address until it returns a socket.
+  template <typename F>
+  int withTcpAddress(const std::string &address, F use) {
+    const std::string hostPort = address.substr(TCP_PREFIX.size());
+    const size_t colon = hostPort.rfind(':');
+    NTA_CHECK(colon != std::string::npos) << "RPC: expected tcp://<host>:<port>, found '" << address << "'";
+    const std::string host = hostPort.substr(0, colon);
+    const std::string port = hostPort.substr(colon + 1u);
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    // Without AI_PASSIVE an empty host is the loopback interface, for
+    // listenOn() too.  Listening on all interfaces takes an explicit host.
+    addrinfo *found = nullptr;
+    const int err = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found);
+    NTA_CHECK(err == 0) << "RPC: cannot resolve '" << address << "': " << gai_strerror(err);
+    int fd = -1;
+    for (addrinfo *ai = found; ai != nullptr && fd < 0; ai = ai->ai_next)
+      fd = use(ai);
+    freeaddrinfo(found);
+    NTA_CHECK(fd >= 0) << "RPC: cannot use '" << address << "': " << std::strerror(errno);
+    return fd;
+  }
+
+  void noDelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+} // namespace
+
+int listenOn(const std::string &address) {
+  if (isTcp(address)) {
+    return withTcpAddress(address, [](const addrinfo *ai) {
+      int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd < 0)
+        return -1;
+      int one = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+      }
+      return fd;
+    });
+  }
+  const std::string path = unixPath(address);
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1u);
+  unlink(path.c_str()); // a stale socket file of an earlier server
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  NTA_CHECK(fd >= 0) << "RPC: socket: " << std::strerror(errno);
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+    const int err = errno;
+    close(fd);
+    NTA_THROW << "RPC: cannot listen on '" << path << "': " << std::strerror(err);
+  }
+  return fd;
+}
+
+int connectTo(const std::string &address) {
+  if (isTcp(address)) {
+    return withTcpAddress(address, [](const addrinfo *ai) {
+      int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd < 0)
+        return -1;
+      if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+        close(fd);
+        return -1;
+      }
+      noDelay(fd);
+      return fd;
+    });
+  }
+  const std::string path = unixPath(address);
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1u);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  NTA_CHECK(fd >= 0) << "RPC: socket: " << std::strerror(errno);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    const int err = errno;
+    close(fd);
+    NTA_THROW << "RPC: cannot connect to '" << path << "': " << std::strerror(err);
+  }
+  return fd;
+}
+
+Int64 writeSome(int fd, const char *data, size_t size) {
+  ssize_t n;
+  do {
+    n = send(fd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+  } while (n < 0 && errno == EINTR);
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    return 0;
+  if (n <= 0 && size > 0u)
+    return -1;
+  return static_cast<Int64>(n);
+}
+
+void closeSocket(int fd) {
+  if (fd >= 0)
+    close(fd);
+}
+
+#endif // NTA_OS_WINDOWS
+
+bool takeFrame(const std::vector<char> &buffer, size_t &offset,
+               UInt32 &sequence, std::uint8_t &code, RPCbuffer &payload) {
+  if (buffer.size() - offset < RPCbuffer::HEADER_SIZE)
+    return false;
+  UInt32 length;
+  std::memcpy(&length, &buffer[offset], sizeof(length));
+  NTA_CHECK(length >= RPCbuffer::HEADER_SIZE - sizeof(UInt32) && length <= RPCbuffer::MAX_FRAME)
+      << "RPC: invalid frame length " << length;
+  if (buffer.size() - offset < sizeof(UInt32) + length)
+    return false;
+  std::memcpy(&sequence, &buffer[offset + 4u], sizeof(sequence));
+  code = static_cast<std::uint8_t>(buffer[offset + 8u]);
+  const auto begin = buffer.begin() + static_cast<std::ptrdiff_t>(offset + RPCbuffer::HEADER_SIZE);
+  const auto end   = buffer.begin() + static_cast<std::ptrdiff_t>(offset + sizeof(UInt32) + length);
+  payload = RPCbuffer(std::vector<char>(begin, end));
+  offset += sizeof(UInt32) + length;
+  return true;
+}
+
+} // namespace rpc
+} // namespace htm
@@ -0,0 +1,162 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Binary RPC protocol for the NetworkAPI, see RPCserver and RPCclient.
+ *
+ * A message is a frame:
+ *     UInt32 length    number of bytes after this field
+ *     UInt32 sequence  chosen by the client, echoed in the response
+ *     std::uint8_t  code      the RPCop of a request, the RPCstatus of a response
+ *     payload          the arguments or results, encoded by RPCbuffer
+ * Integers are in the byte order of the host; both ends are on one machine.
+ *
+ * A client may send several requests without waiting (pipelining).  The
+ * server answers the requests of a connection in order.
+ *
+ * Operations, with their arguments -> results:
+ *     CREATE_NETWORK  id, config                    -> id  (an empty id picks one)
+ *     DELETE_NETWORK  id                            ->
+ *     SET_INPUT       id, source name, Array        ->
+ *     GET_INPUT       id, region, input             -> Array
+ *     GET_OUTPUT      id, region, output            -> Array
+ *     SET_PARAM       id, region, param, JSON value ->
+ *     GET_PARAM       id, region, param             -> JSON value
+ *     RUN             id, UInt32 iterations         ->
+ *     COMMAND         id, region, command           -> result string
+ *     RUN_BATCH       id, source name, UInt32 k, k Arrays,
+ *                     UInt32 m, m "region.output"   -> k * m Arrays, by iteration
+ *     STOP                                          ->  (stops the server)
+ * An error response carries the error message as a string.
+ */
+
+#ifndef NTA_RPC_PROTOCOL_HPP
+#define NTA_RPC_PROTOCOL_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <htm/ntypes/Array.hpp>
+#include <htm/types/Types.hpp>
+
+namespace htm {
+
+enum class RPCop : std::uint8_t {
+  CREATE_NETWORK = 1,
+  DELETE_NETWORK,
+  SET_INPUT,
+  GET_INPUT,
+  GET_OUTPUT,
+  SET_PARAM,
+  GET_PARAM,
+  RUN,
+  COMMAND,
+  RUN_BATCH,
+  STOP
+};
+
+enum class RPCstatus : std::uint8_t { OK = 0, FAILED = 1 };
+
+/**
+ * Encodes and decodes the payload of a frame.
+ *
+ * Strings are a UInt32 length and the bytes.  Arrays are the type, the
+ * dimensions and the data; SDRs are sent as sparse indices.
+ *
+ * The payload comes from another process, so the get methods check every
+ * count against the bytes which are left before they allocate, and throw
+ * on malformed data.
+ */
+class RPCbuffer {
+public:
+  static const size_t HEADER_SIZE = 9u; // length, sequence, code
+  static const size_t MAX_FRAME   = 1u << 30;
+  // Largest number of elements of an Array, the product of its dimensions.
+  // This bounds the memory of a received SDR, whose dense form is allocated
+  // from its dimensions and not from the size of the message.
+  static const size_t MAX_ELEMENTS = 1u << 26;
+  // Smallest encoded Array: type, number of dimensions and count.
+  static const size_t MIN_ARRAY_SIZE = 9u;
+
+  RPCbuffer() {}
+  explicit RPCbuffer(std::vector<char> &&data) : data_(std::move(data)) {}
+
+  RPCbuffer &putUInt32(UInt32 value);
+  RPCbuffer &putString(const std::string &value);
+  // dimensions are optional, the default is one dimension of getCount().
+  RPCbuffer &putArray(const Array &value, const std::vector<UInt> &dimensions = {});
+
+  UInt32 getUInt32();
+  std::string getString();
+  // Throws if the SDR indices are not sorted, not unique or out of range.
+  Array getArray(std::vector<UInt> *dimensions = nullptr);
+
+  /**
+   * Read the number of items which follow, each at least minBytes long.
+   * Throws if the rest of the payload is too short for that many items, so
+   * the result is safe to allocate with.
+   */
+  UInt32 getCount(size_t minBytes);
+
+  const std::vector<char> &data() const { return data_; }
+  bool atEnd() const { return pos_ == data_.size(); }
+  size_t remaining() const { return data_.size() - pos_; }
+
+  // Append a frame with this buffer as its payload to 'out'.
+  void appendFrame(std::vector<char> &out, UInt32 sequence, std::uint8_t code) const;
+
+private:
+  void put_(const void *src, size_t n);
+  void get_(void *dst, size_t n);
+
+  std::vector<char> data_;
+  size_t pos_ = 0u;
+};
+
+namespace rpc {
+  /**
+   * Addresses are either "tcp://<host>:<port>" or the path of a Unix domain
+   * socket, optionally prefixed with "unix://".
+   * An empty host, as in "tcp://:8051", is the loopback interface.  The
+   * protocol has no authentication, so listen on another interface, for
+   * example "tcp://0.0.0.0:8051", only on a trusted network.
+   * Both return a socket file descriptor, or throw.
+   */
+  int listenOn(const std::string &address);
+  int connectTo(const std::string &address);
+
+  /**
+   * Write as many bytes as the socket takes without blocking.  Returns the
+   * number of bytes written, which is 0 if the socket buffer is full, or
+   * -1 if the connection was closed.
+   */
+  Int64 writeSome(int fd, const char *data, size_t size);
+  void closeSocket(int fd);
+
+  /**
+   * If a complete frame starts at 'offset' in 'buffer', decode it, advance
+   * 'offset' past it and return true.  Throws if the frame is larger than
+   * RPCbuffer::MAX_FRAME.
+   */
+  bool takeFrame(const std::vector<char> &buffer, size_t &offset,
+                 UInt32 &sequence, std::uint8_t &code, RPCbuffer &payload);
+} // namespace rpc
+
+} // namespace htm
+
+#endif // NTA_RPC_PROTOCOL_HPP
@@ -0,0 +1,288 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the RPCserver class
+ */
+
+#include <cerrno>
+#include <list>
+#include <thread>
+#include <vector>
+
+#if !defined(NTA_OS_WINDOWS)
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <htm/engine/RPCserver.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/os/Path.hpp>
+#include <htm/utils/Log.hpp>
+
+namespace htm {
+
+namespace {
+  const int POLL_MS = 100; // how often idle loops check for stop()
+
+  // Dimensions to send with an array, if they describe it.
+  std::vector<UInt> dimsOf(const Dimensions &d, const Array &a) {
+    if (d.getCount() == a.getCount())
+      return d.asVector();
+    return std::vector<UInt>();
+  }
+} // namespace
+
+RPCserver::RPCserver() : stopping_(false), listening_(false) {}
+
+RPCserver::~RPCserver() {}
+
+void RPCserver::stop() { stopping_ = true; }
+
+std::shared_ptr<RPCserver::Resource> RPCserver::resource_(const std::string &id) {
+  std::lock_guard<std::mutex> lock(resourcesMutex_);
+  auto itr = resources_.find(id);
+  NTA_CHECK(itr != resources_.end()) << "Context for resource '" + id + "' not found.";
+  return itr->second;
+}
+
+RPCbuffer RPCserver::handle(RPCop op, RPCbuffer &args) {
+  RPCbuffer result;
+  if (op == RPCop::STOP) {
+    stop();
+    return result;
+  }
+  std::string id = args.getString();
+
+  if (op == RPCop::CREATE_NETWORK) {
+    const std::string config = args.getString();
+    auto res = std::make_shared<Resource>();
+    res->net = std::make_shared<Network>();
+    res->net->configure(config);
+
+    std::lock_guard<std::mutex> lock(resourcesMutex_);
+    while (id.empty()) {
+      std::string candidate = std::to_string(nextId_++);
+      if (resources_.find(candidate) == resources_.end())
+        id = candidate;
+    }
+    resources_[id] = res; // replaces any previous Network with this id
+    result.putString(id);
+    return result;
+  }
+  if (op == RPCop::DELETE_NETWORK) {
+    std::lock_guard<std::mutex> lock(resourcesMutex_);
+    NTA_CHECK(resources_.erase(id) == 1u) << "Context for resource '" + id + "' not found.";
+    return result;
+  }
+
+  std::shared_ptr<Resource> res = resource_(id);
+  std::lock_guard<std::mutex> lock(res->mutex);
+  Network &net = *res->net;
+
+  switch (op) {
+  case RPCop::SET_INPUT: {
+    const std::string source = args.getString();
+    net.setInputData(source, args.getArray());
+    break;
+  }
+  case RPCop::GET_INPUT: {
+    const std::string region = args.getString();
+    const std::string input = args.getString();
+    auto r = net.getRegion(region);
+    const Array &a = r->getInputData(input);
+    result.putArray(a, dimsOf(r->getInputDimensions(input), a));
+    break;
+  }
+  case RPCop::GET_OUTPUT: {
+    const std::string region = args.getString();
+    const std::string output = args.getString();
+    auto r = net.getRegion(region);
+    const Array &a = r->getOutputData(output);
+    result.putArray(a, dimsOf(r->getOutputDimensions(output), a));
+    break;
+  }
+  case RPCop::SET_PARAM: {
+    const std::string region = args.getString();
+    const std::string param = args.getString();
+    net.getRegion(region)->setParameterJSON(param, args.getString());
+    break;
+  }
+  case RPCop::GET_PARAM: {
+    const std::string region = args.getString();
+    const std::string param = args.getString();
+    result.putString(net.getRegion(region)->getParameterJSON(param));
+    break;
+  }
+  case RPCop::RUN:
+    net.run(static_cast<int>(args.getUInt32()));
+    break;
+  case RPCop::COMMAND: {
+    const std::string region = args.getString();
+    const std::vector<std::string> command = Path::split(args.getString(), ' ');
+    result.putString(net.getRegion(region)->executeCommand(command));
+    break;
+  }
+  case RPCop::RUN_BATCH: {
+    const std::string source = args.getString();
+    std::vector<Array> inputs(args.getCount(RPCbuffer::MIN_ARRAY_SIZE));
+    for (auto &a : inputs)
+      a = args.getArray();
+    std::vector<std::pair<std::shared_ptr<Region>, std::string>> outputs(args.getCount(sizeof(UInt32)));
+    for (auto &out : outputs) {
+      const std::vector<std::string> name = Path::split(args.getString(), '.');
+      NTA_CHECK(name.size() == 2u) << "Expected syntax <region>.<output> for output name.";
+      out.first = net.getRegion(name[0]);
+      out.second = name[1];
+    }
+    for (const auto &a : inputs) {
+      net.setInputData(source, a);
+      net.run(1);
+      for (const auto &out : outputs) {
+        const Array &data = out.first->getOutputData(out.second);
+        result.putArray(data, dimsOf(out.first->getOutputDimensions(out.second), data));
+      }
+    }
+    break;
+  }
+  default:
+    NTA_THROW << "RPC: unknown operation " << static_cast<int>(op);
+  }
+  return result;
+}
+
+#if defined(NTA_OS_WINDOWS)
+
+void RPCserver::listen(const std::string &address) {
+  NTA_THROW << "RPCserver: not implemented on Windows.";
+}
+void RPCserver::serve_(int fd) {}
+
+#else
+
+void RPCserver::listen(const std::string &address) {
+  const int fd = rpc::listenOn(address);
+  stopping_ = false;
+  listening_ = true;
+
+  struct Connection {
+    std::thread thread;
+    std::atomic<bool> done{false};
+  };
+  std::list<std::unique_ptr<Connection>> connections;
+  while (!stopping_) {
+    // Join the threads of closed connections as they end, so that a long
+    // running server does not accumulate them.
+    for (auto itr = connections.begin(); itr != connections.end();) {
+      if ((*itr)->done) {
+        (*itr)->thread.join();
+        itr = connections.erase(itr);
+      } else {
+        ++itr;
+      }
+    }
+
+    pollfd p = {fd, POLLIN, 0};
+    if (poll(&p, 1, POLL_MS) <= 0)
+      continue;
+    const int conn = accept(fd, nullptr, nullptr);
+    if (conn >= 0) {
+      connections.emplace_back(new Connection());
+      Connection *c = connections.back().get();
+      c->thread = std::thread([this, conn, c]() {
+        serve_(conn);
+        c->done = true;
+      });
+    }
+  }
+  for (auto &c : connections)
+    c->thread.join();
+
+  rpc::closeSocket(fd);
+  if (address.compare(0, 6, "tcp://") != 0)
+    unlink(address.compare(0, 7, "unix://") == 0 ? address.substr(7).c_str() : address.c_str());
+  listening_ = false;
+}
+
+void RPCserver::serve_(int fd) {
+  std::vector<char> in;
+  std::vector<char> out;
+  size_t sent = 0u; // bytes of 'out' already written
+  char chunk[64 * 1024];
+  bool open = true; // false after an invalid frame, close once 'out' is written
+
+  // Either read requests or write responses, never block on both.  While
+  // responses are pending the requests wait in the socket, which stops a
+  // client that does not read its results from growing 'out' without bound.
+  // After stop() the pending responses, such as the reply to STOP, are still
+  // written, unless the client takes none of them for POLL_MS.
+  while (open || !out.empty()) {
+    const bool writing = !out.empty();
+    if (!writing && stopping_)
+      break;
+    pollfd p = {fd, static_cast<short>(writing ? POLLOUT : POLLIN), 0};
+    if (poll(&p, 1, POLL_MS) <= 0) {
+      if (writing && stopping_)
+        break;
+      continue;
+    }
+    if (writing) {
+      const Int64 n = rpc::writeSome(fd, out.data() + sent, out.size() - sent);
+      if (n < 0)
+        break; // closed by the client
+      sent += static_cast<size_t>(n);
+      if (sent == out.size()) {
+        out.clear();
+        sent = 0u;
+      }
+      continue;
+    }
+    ssize_t n;
+    do {
+      n = recv(fd, chunk, sizeof(chunk), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0)
+      break; // closed by the client
+    in.insert(in.end(), chunk, chunk + n);
+
+    // Answer all complete requests, then send the responses together.
+    size_t offset = 0u;
+    UInt32 sequence;
+    std::uint8_t code;
+    RPCbuffer args;
+    try {
+      while (rpc::takeFrame(in, offset, sequence, code, args)) {
+        try {
+          handle(static_cast<RPCop>(code), args).appendFrame(out, sequence, static_cast<std::uint8_t>(RPCstatus::OK));
+        } catch (Exception &e) {
+          RPCbuffer().putString(e.getMessage()).appendFrame(out, sequence, static_cast<std::uint8_t>(RPCstatus::FAILED));
+        } catch (std::exception &e) {
+          RPCbuffer().putString(e.what()).appendFrame(out, sequence, static_cast<std::uint8_t>(RPCstatus::FAILED));
+        }
+      }
+    } catch (std::exception &) {
+      open = false; // not a valid frame, drop the connection
+    }
+    in.erase(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(offset));
+  }
+  rpc::closeSocket(fd);
+}
+
+#endif // NTA_OS_WINDOWS
+
+} // namespace htm
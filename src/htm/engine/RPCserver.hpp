@@ -0,0 +1,96 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Binary RPC server for the NetworkAPI
+ *
+ * This is the local, low overhead alternative to the RESTapi.  It offers
+ * the same operations on Network objects, addressed by id, but over a Unix
+ * domain socket (or a TCP socket on the local host) with the binary frames
+ * of RPCprotocol.hpp instead of HTTP and JSON.  Array data is sent as raw
+ * bytes, SDRs as sparse indices.
+ *
+ * Each connection is served by its own thread.  Requests on one Network
+ * are serialized; different Networks may run concurrently.
+ *
+ * Not available on Windows.
+ */
+
+#ifndef NTA_RPC_SERVER_HPP
+#define NTA_RPC_SERVER_HPP
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <htm/engine/Network.hpp>
+#include <htm/engine/RPCprotocol.hpp>
+
+namespace htm {
+
+class RPCserver {
+public:
+  RPCserver();
+  ~RPCserver();
+
+  /**
+   * Serve requests on the given address until stop() is called or a STOP
+   * request is received.  This blocks.
+   *
+   * @param address  "tcp://<host>:<port>" or the path of a Unix domain socket.
+   *                 The socket file is removed when the server stops.  An
+   *                 empty host listens on the loopback interface only.
+   */
+  void listen(const std::string &address);
+
+  /**
+   * Make listen() return.  May be called from any thread.
+   */
+  void stop();
+
+  /**
+   * True from the moment listen() has bound its socket until it returns.
+   */
+  bool isListening() const { return listening_; }
+
+  /**
+   * Execute one request and return the encoded results.  Throws on error.
+   * listen() calls this for each request it receives.
+   */
+  RPCbuffer handle(RPCop op, RPCbuffer &args);
+
+private:
+  struct Resource {
+    std::shared_ptr<Network> net;
+    std::mutex mutex;  // one request at a time on a Network
+  };
+
+  void serve_(int fd);
+  std::shared_ptr<Resource> resource_(const std::string &id);
+
+  std::map<std::string, std::shared_ptr<Resource>> resources_;
+  std::mutex resourcesMutex_;
+  UInt64 nextId_ = 1u;
+  std::atomic<bool> stopping_;
+  std::atomic<bool> listening_;
+};
+
+} // namespace htm
+
+#endif // NTA_RPC_SERVER_HPP
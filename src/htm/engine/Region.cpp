@@ -23,8 +23,10 @@ Methods related to inputs and outputs are in Region_io.cpp
 
 */
 
+#include <cstring> // memcmp
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -159,7 +161,7 @@ void Region::initialize() {
     }
   }
 
-  impl_->initialize();
+  impl()->initialize();
   initialized_ = true;
 }
 
@@ -175,7 +177,8 @@ std::string Region::executeCommand(const std::vector<std::string> &args) {
   if (profilingEnabled_)
     executeTimer_.start();
 
-  retVal = impl_->executeCommand(args, (UInt64)(-1));
+  lastInputsValid_ = false; // a command may change the state
+  retVal = impl()->executeCommand(args, (UInt64)(-1));
 
   if (profilingEnabled_)
     executeTimer_.stop();
@@ -191,7 +194,7 @@ void Region::compute() {
   if (profilingEnabled_)
     computeTimer_.start();
 
-  impl_->compute();
+  impl()->compute();
 
   if (profilingEnabled_)
     computeTimer_.stop();
@@ -199,6 +202,19 @@ void Region::compute() {
   return;
 }
 
+void Region::finishRun() {
+  if (!initialized_ || !isImplLoaded())
+    return;
+
+  if (profilingEnabled_)
+    computeTimer_.start();
+
+  impl_->finishRun();
+
+  if (profilingEnabled_)
+    computeTimer_.stop();
+}
+
 /**
  * These internal methods are called by Network as
  * part of initialization.
@@ -211,11 +227,11 @@ void Region::evaluateLinks() {
 }
 
 size_t Region::getNodeInputElementCount(const std::string &name) {
-  size_t count = impl_->getNodeInputElementCount(name);
+  size_t count = impl()->getNodeInputElementCount(name);
   return count;
 }
 size_t Region::getNodeOutputElementCount(const std::string &name) {
-  size_t count = impl_->getNodeOutputElementCount(name);
+  size_t count = impl()->getNodeOutputElementCount(name);
   return count;
 }
 
@@ -223,7 +239,7 @@ size_t Region::getNodeOutputElementCount(const std::string &name) {
 Dimensions Region::askImplForInputDimensions(const std::string &name) const {
   Dimensions dim;
   try {
-    dim = impl_->askImplForInputDimensions(name);
+    dim = impl()->askImplForInputDimensions(name);
   } catch (Exception &e) {
       NTA_THROW << "Internal error -- the dimensions for the input " << name
                 << "is unknown. : " << e.what();
@@ -233,7 +249,7 @@ Dimensions Region::askImplForInputDimensions(const std::string &name) const {
 Dimensions Region::askImplForOutputDimensions(const std::string &name) const {
   Dimensions dim;
   try {
-    dim = impl_->askImplForOutputDimensions(name);
+    dim = impl()->askImplForOutputDimensions(name);
   } catch (Exception &e) {
       NTA_THROW << "Internal error -- the dimensions for the input " << name
                 << "is unknown. : " << e.what();
@@ -284,9 +300,11 @@ void Region::setOutputDimensions(std::string name, const Dimensions& dim) {
 // This sets a global dimension.
 void Region::setDimensions(Dimensions dim) {
   NTA_CHECK(!initialized_) << "Cannot set region dimensions after initialization.";
-  impl_->setDimensions(dim);
+  impl()->setDimensions(dim);
 }
 Dimensions Region::getDimensions() const {
+  if (!impl_ && deferredImpl_)
+    return shellDim_;  // do not force a deferred load just to get dimensions.
   return impl_->getDimensions();
 }
 
@@ -380,9 +398,11 @@ bool Region::operator==(const Region &o) const {
     return false;
   }
 
-  if (impl_ && !o.impl_) return false;
-  if (!impl_ && o.impl_) return false;
-  if (impl_ && *impl_.get() != *o.impl_.get()) return false;
+  RegionImpl *impl1 = impl();
+  RegionImpl *impl2 = o.impl();
+  if (impl1 && !impl2) return false;
+  if (!impl1 && impl2) return false;
+  if (impl1 && *impl1 != *impl2) return false;
 
   return true;
 }
@@ -450,38 +470,200 @@ void Region::prepareInputs() {
   }
 }
 
+bool Region::isUnchanged_() {
+  if (!impl()->isPure()) {
+    lastInputsValid_ = false;
+    return false;
+  }
+
+  // Compare the inputs against the saved copy while overwriting it.  Each
+  // input is prefixed by its size so that a change of size is a change.
+  bool same = lastInputsValid_;
+  size_t pos = 0u;
+  auto compareAndSave = [&](const void *data, size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    if (same && pos + size <= lastInputs_.size() &&
+        (size == 0u || std::memcmp(&lastInputs_[pos], bytes, size) == 0)) {
+      pos += size;
+      return;
+    }
+    same = false;
+    if (lastInputs_.size() < pos + size)
+      lastInputs_.resize(pos + size);
+    if (size > 0u)
+      std::memcpy(&lastInputs_[pos], bytes, size);
+    pos += size;
+  };
+
+  for (const auto &in : inputs_) {
+    const Array &a = in.second->getData();
+    const void *data = nullptr;
+    size_t size = 0u;
+    if (a.getType() == NTA_BasicType_Str) {
+      same = false; // not comparable as bytes
+    } else if (a.has_buffer()) {
+      if (a.getType() == NTA_BasicType_SDR) {
+        // The sparse form is usually much smaller than the dense buffer.
+        const SDR_sparse_t &sparse = a.getSDR().getSparse();
+        data = sparse.data();
+        size = sparse.size() * sizeof(ElemSparse);
+      } else {
+        data = a.getBuffer();
+        size = a.getCount() * BasicType::getSize(a.getType());
+      }
+    }
+    compareAndSave(&size, sizeof(size));
+    compareAndSave(data, size);
+  }
+  if (pos != lastInputs_.size()) {
+    same = false;
+    lastInputs_.resize(pos);
+  }
+  lastInputsValid_ = true;
+  return same;
+}
+
+namespace {
+// Deep copy the value, reusing the buffer of "to" when it has the same type
+// and size.  Writing in place keeps any Input which shares the buffer valid.
+void copyValue_(const Array &from, Array &to) {
+  const NTA_BasicType type = from.getType();
+  if (from.has_buffer() && to.has_buffer() && to.getType() == type) {
+    if (type == NTA_BasicType_SDR) {
+      if (to.getSDR().dimensions == from.getSDR().dimensions) {
+        to.getSDR().setSDR(from.getSDR());
+        return;
+      }
+    } else if (type != NTA_BasicType_Str && to.getCount() == from.getCount()) {
+      std::memcpy(to.getBuffer(), from.getBuffer(), from.getCount() * BasicType::getSize(type));
+      return;
+    }
+  }
+  to = from.copy();
+}
+} // namespace
+
+bool Region::isBatchable_() const {
+  return impl()->isBatchable();
+}
+
+void Region::saveBatchRow_(size_t row) {
+  for (const auto &in : inputs_) {
+    std::vector<Array> &rows = batchInputs_[in.first];
+    if (rows.size() <= row)
+      rows.resize(row + 1u);
+    copyValue_(in.second->getData(), rows[row]);
+  }
+}
+
+void Region::computeBatch_(size_t k) {
+  if (!initialized_)
+    NTA_THROW << "Region " << getName()
+              << " unable to compute because not initialized";
+
+  for (auto &in : batchInputs_) {
+    NTA_CHECK(in.second.size() >= k) << "computeBatch: missing input rows for " << in.first;
+    in.second.resize(k);
+  }
+  for (const auto &out : outputs_) {
+    std::vector<Array> &rows = batchOutputs_[out.first];
+    rows.resize(k);
+    for (auto &row : rows) {
+      if (!row.has_buffer())
+        row = out.second->getData().copy(); // same type and dimensions as the output
+    }
+  }
+
+  if (profilingEnabled_)
+    computeTimer_.start();
+
+  impl()->computeBatch(k);
+
+  if (profilingEnabled_)
+    computeTimer_.stop();
+}
+
+void Region::emitBatchRow_(size_t row) {
+  for (const auto &out : outputs_) {
+    copyValue_(batchOutputs_[out.first][row], out.second->getData());
+  }
+}
+
+void Region::holdOutputs_() {
+  for (const auto &out : outputs_) {
+    copyValue_(out.second->getData(), heldOutputs_[out.first]);
+  }
+}
+
+void Region::restoreOutputs_() {
+  for (const auto &out : outputs_) {
+    copyValue_(heldOutputs_[out.first], out.second->getData());
+  }
+}
+
+std::vector<Array> &Region::getBatchInput(const std::string &inputName) {
+  auto it = batchInputs_.find(inputName);
+  if (it == batchInputs_.end())
+    NTA_THROW << "getBatchInput -- unknown input '" << inputName << "' on region " << getName();
+  return it->second;
+}
+
+std::vector<Array> &Region::getBatchOutput(const std::string &outputName) {
+  auto it = batchOutputs_.find(outputName);
+  if (it == batchOutputs_.end())
+    NTA_THROW << "getBatchOutput -- unknown output '" << outputName << "' on region " << getName();
+  return it->second;
+}
+
+void Region::parameterSet_(const std::string &name, const void *value, size_t size) {
+  const char *bytes = static_cast<const char *>(value);
+  std::vector<char> &last = lastParameters_[name];
+  if (last.size() == size && (size == 0u || std::memcmp(last.data(), bytes, size) == 0))
+    return;
+  last.assign(bytes, bytes + size);
+  lastInputsValid_ = false;
+}
+
 
 // setParameter
 void Region::setParameterByte(const std::string &name, Byte value) {
-  impl_->setParameterByte(name, (Int64)-1, value);
+  impl()->setParameterByte(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterInt32(const std::string &name, Int32 value) {
-  impl_->setParameterInt32(name, (Int64)-1, value);
+  impl()->setParameterInt32(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterUInt32(const std::string &name, UInt32 value) {
-  impl_->setParameterUInt32(name, (Int64)-1, value);
+  impl()->setParameterUInt32(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterInt64(const std::string &name, Int64 value) {
-  impl_->setParameterInt64(name, (Int64)-1, value);
+  impl()->setParameterInt64(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterUInt64(const std::string &name, UInt64 value) {
-  impl_->setParameterUInt64(name, (Int64)-1, value);
+  impl()->setParameterUInt64(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterReal32(const std::string &name, Real32 value) {
-  impl_->setParameterReal32(name, (Int64)-1, value);
+  impl()->setParameterReal32(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterReal64(const std::string &name, Real64 value) {
-  impl_->setParameterReal64(name, (Int64)-1, value);
+  impl()->setParameterReal64(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterBool(const std::string &name, bool value) {
-impl_->setParameterBool(name, (Int64)-1, value);
+  impl()->setParameterBool(name, (Int64)-1, value);
+  parameterSet_(name, &value, sizeof(value));
 }
 
 void Region::setParameterJSON(const std::string &name, const std::string &value) {
@@ -546,21 +728,21 @@ std::string Region::getParameters() const {
 }
 
 // getParameter
-Byte Region::getParameterByte(const std::string &name) const { return impl_->getParameterByte(name, (Int64)-1); }
+Byte Region::getParameterByte(const std::string &name) const { return impl()->getParameterByte(name, (Int64)-1); }
 
-Int32 Region::getParameterInt32(const std::string &name) const { return impl_->getParameterInt32(name, (Int64)-1); }
+Int32 Region::getParameterInt32(const std::string &name) const { return impl()->getParameterInt32(name, (Int64)-1); }
 
-Int64 Region::getParameterInt64(const std::string &name) const { return impl_->getParameterInt64(name, (Int64)-1); }
+Int64 Region::getParameterInt64(const std::string &name) const { return impl()->getParameterInt64(name, (Int64)-1); }
 
-UInt32 Region::getParameterUInt32(const std::string &name) const { return impl_->getParameterUInt32(name, (Int64)-1); }
+UInt32 Region::getParameterUInt32(const std::string &name) const { return impl()->getParameterUInt32(name, (Int64)-1); }
 
-UInt64 Region::getParameterUInt64(const std::string &name) const { return impl_->getParameterUInt64(name, (Int64)-1); }
+UInt64 Region::getParameterUInt64(const std::string &name) const { return impl()->getParameterUInt64(name, (Int64)-1); }
 
-Real32 Region::getParameterReal32(const std::string &name) const { return impl_->getParameterReal32(name, (Int64)-1); }
+Real32 Region::getParameterReal32(const std::string &name) const { return impl()->getParameterReal32(name, (Int64)-1); }
 
-Real64 Region::getParameterReal64(const std::string &name) const { return impl_->getParameterReal64(name, (Int64)-1); }
+Real64 Region::getParameterReal64(const std::string &name) const { return impl()->getParameterReal64(name, (Int64)-1); }
 
-bool Region::getParameterBool(const std::string &name) const { return impl_->getParameterBool(name, (Int64)-1); }
+bool Region::getParameterBool(const std::string &name) const { return impl()->getParameterBool(name, (Int64)-1); }
 
 std::string Region::getParameterJSON(const std::string &name, bool withType) const {
   // NOTE: if withType is not given or false, it just returns the JSON encoded value.
@@ -658,23 +840,25 @@ std::string Region::getParameterJSON(const std::string &name, bool withType) con
 // array parameters
 
 void Region::getParameterArray(const std::string &name, Array &array) const {
-  impl_->getParameterArray(name, (Int64)-1, array);
+  impl()->getParameterArray(name, (Int64)-1, array);
 }
 
 void Region::setParameterArray(const std::string &name, const Array &array) {
-  impl_->setParameterArray(name, (Int64)-1, array);
+  impl()->setParameterArray(name, (Int64)-1, array);
+  lastInputsValid_ = false;
 }
 
 size_t Region::getParameterArrayCount(const std::string &name) const {
-  return impl_->getParameterArrayCount(name, (Int64)-1);
+  return impl()->getParameterArrayCount(name, (Int64)-1);
 }
 
 void Region::setParameterString(const std::string &name, const std::string &s) {
-  impl_->setParameterString(name, (Int64)-1, s);
+  impl()->setParameterString(name, (Int64)-1, s);
+  parameterSet_(name, s.data(), s.size());
 }
 
 std::string Region::getParameterString(const std::string &name) const {
-  return impl_->getParameterString(name, (Int64)-1);
+  return impl()->getParameterString(name, (Int64)-1);
 }
 
 bool Region::isParameter(const std::string &name) const {
@@ -727,13 +911,131 @@ void Region::restoreOutputBuffers_(const std::map<std::string, Array>& buffers)
 
 
 void Region::serializeImpl(ArWrapper& arw) const{
-    impl_->cereal_adapter_save(arw);
+    impl()->cereal_adapter_save(arw);
 }
 void Region::deserializeImpl(ArWrapper& arw) {
     RegionImplFactory &factory = RegionImplFactory::getInstance();
     impl_.reset(factory.deserializeRegionImpl(type_, arw, this));
 }
 
+void Region::applyShellDimensions_() {
+  initialized_ = false; // setDimensions requires initialization off.
+  setDimensions(shellDim_);
+  initialized_ = shellInitialized_;
+}
+
+RegionImpl *Region::impl() const {
+  if (!impl_ && deferredImpl_) {
+    // Complete a deferred load.  This is logically const; the Region looks the
+    // same to the caller whether or not the impl was already deserialized.
+    Region *self = const_cast<Region *>(this);
+    std::shared_ptr<const std::string> data = std::move(self->deferredImpl_);
+    self->deferredImpl_.reset();
+    std::istringstream in(*data);
+    self->loadImplSection(in, deferredFmt_);
+  }
+  return impl_.get();
+}
+
+
+// The two halves of a sectioned region serialization.
+// See Region::saveShellSection() and Network::saveToFileSectioned().
+class Region::ShellSection : public Serializable {
+public:
+  explicit ShellSection(Region *region) : region_(region) {}
+
+  CerealAdapter;
+  template<class Archive>
+  void save_ar(Archive& ar) const {
+    region_->saveShell_(ar);
+  }
+  template<class Archive>
+  void load_ar(Archive& ar) {
+    region_->loadShell_(ar);
+  }
+private:
+  Region *region_;
+};
+
+class Region::ImplSection : public Serializable {
+public:
+  explicit ImplSection(Region *region) : region_(region) {}
+
+  CerealAdapter;
+  template<class Archive>
+  void save_ar(Archive& ar) const {
+    ArWrapper arw(&ar);
+    region_->serializeImpl(arw);
+  }
+  template<class Archive>
+  void load_ar(Archive& ar) {
+    ArWrapper arw(&ar);
+    region_->deserializeImpl(arw);
+  }
+private:
+  Region *region_;
+};
+
+namespace {
+// The impl section of a region, from a RegionImpl::snapshot().
+class ImplSnapshotSection : public Serializable {
+public:
+  explicit ImplSnapshotSection(const RegionImpl *impl) : impl_(impl) {}
+
+  CerealAdapter;
+  template<class Archive>
+  void save_ar(Archive& ar) const {
+    ArWrapper arw(&ar);
+    impl_->cereal_adapter_save(arw);
+  }
+  template<class Archive>
+  void load_ar(Archive& ar) {
+    NTA_THROW << "ImplSnapshotSection: save only.";
+  }
+private:
+  const RegionImpl *impl_;
+};
+} // namespace
+
+void Region::saveShellSection(std::ostream &f, SerializableFormat fmt) const {
+  ShellSection(const_cast<Region *>(this)).save(f, fmt);
+}
+
+void Region::saveImplSection(std::ostream &f, SerializableFormat fmt) const {
+  if (!impl_ && deferredImpl_ && deferredFmt_ == fmt) {
+    // Never loaded; the bytes we were given are still current.
+    f.write(deferredImpl_->data(), static_cast<std::streamsize>(deferredImpl_->size()));
+    return;
+  }
+  ImplSection(const_cast<Region *>(this)).save(f, fmt);
+}
+
+std::shared_ptr<const RegionImpl> Region::snapshotImpl() const {
+  if (!impl_)
+    return nullptr;
+  return impl_->snapshot();
+}
+
+void Region::saveImplSnapshot(const RegionImpl &impl, std::ostream &f, SerializableFormat fmt) {
+  ImplSnapshotSection(&impl).save(f, fmt);
+}
+
+void Region::loadShellSection(std::istream &f, SerializableFormat fmt) {
+  ShellSection(this).load(f, fmt);
+}
+
+void Region::loadImplSection(std::istream &f, SerializableFormat fmt) {
+  ImplSection(this).load(f, fmt);
+  applyShellDimensions_();
+}
+
+void Region::deferImplSection(std::shared_ptr<const std::string> data, SerializableFormat fmt) {
+  NTA_CHECK(data != nullptr);
+  deferredImpl_ = std::move(data);
+  deferredFmt_ = fmt;
+  initialized_ = shellInitialized_;
+}
+
 std::ostream &operator<<(std::ostream &f, const Region &r) {
   f << "Region: {\n";
   f << "name: " << r.name_ << "\n";
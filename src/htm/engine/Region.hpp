@@ -338,6 +338,13 @@ public:
    */
   virtual const Array &getOutputData(const std::string &outputName) const;
 
+  /**
+   * The rows of a batched input or output, one Array per iteration.  These
+   * are used by RegionImpl::computeBatch(), see Network::setBatchSize().
+   */
+  std::vector<Array> &getBatchInput(const std::string &inputName);
+  std::vector<Array> &getBatchOutput(const std::string &outputName);
+
 
   /**
    * @}
@@ -367,6 +374,11 @@ public:
    */
   void compute();
 
+  /**
+   * Complete any work the region deferred during Network::run().
+   */
+  void finishRun();
+
   /**
    * @}
    *
@@ -430,6 +442,10 @@ public:
 
   bool isInitialized() const { return initialized_; }
 
+  // See Network::setComputePeriod()
+  UInt32 getComputePeriod() const { return computePeriod_; }
+  UInt32 getComputeOffset() const { return computeOffset_; }
+
   // Used by RegionImpl to get inputs/outputs
   bool hasOutput(const std::string &name) const;
   bool hasInput(const std::string &name) const;
@@ -480,6 +496,68 @@ public:
   // FOR Cereal Serialization
   template<class Archive>
   void save_ar(Archive& ar) const {
+    saveShell_(ar);
+
+    // Now serialize the RegionImpl plugin.
+    ArWrapper arw(&ar);
+    serializeImpl(arw);
+  }
+
+
+  // FOR Cereal Deserialization
+  // Note: custom region implementations must be registered
+  //       before deserializing a region.
+  template<class Archive>
+  void load_ar(Archive& ar) {
+    loadShell_(ar);
+
+    // deserialize the RegionImpl plugin and its algorithm
+    ArWrapper arw(&ar);
+    deserializeImpl(arw);
+    applyShellDimensions_();
+  }
+
+  /**
+   * Sectioned serialization, used by Network::saveToFileSectioned().
+   *
+   * The region "shell" (name, type, dimensions and output buffers) and the
+   * state of the RegionImpl are written as two independent archives so that
+   * the impl sections, which hold the algorithm state and are by far the
+   * largest, can be deserialized in parallel or deferred.
+   *
+   * loadShellSection() must be called before loadImplSection() or
+   * deferImplSection().  A deferred impl is deserialized the first time
+   * the implementation is needed, normally on the first compute().
+   */
+  void saveShellSection(std::ostream &f, SerializableFormat fmt) const;
+  void saveImplSection(std::ostream &f, SerializableFormat fmt) const;
+  void loadShellSection(std::istream &f, SerializableFormat fmt);
+  void loadImplSection(std::istream &f, SerializableFormat fmt);
+  void deferImplSection(std::shared_ptr<const std::string> data, SerializableFormat fmt);
+
+  /**
+   * For Network::saveToFileAsync(): a copy of the RegionImpl, which
+   * saveImplSnapshot() can serialize later on another thread with the same
+   * result as saveImplSection() now.  nullptr if the RegionImpl does not
+   * support this (see RegionImpl::snapshot()) or is waiting for a deferred load.
+   */
+  std::shared_ptr<const RegionImpl> snapshotImpl() const;
+  static void saveImplSnapshot(const RegionImpl &impl, std::ostream &f, SerializableFormat fmt);
+
+  /**
+   * @returns false if the RegionImpl is still waiting for a deferred load.
+   */
+  bool isImplLoaded() const { return impl_ != nullptr; }
+
+  friend class Network;  // so Network can set Network* network_; during addRegion( ).
+  friend std::ostream &operator<<(std::ostream &f, const Region &r);
+
+
+private:
+  //Region(Region &){}  // copy not allowed
+
+  template<class Archive>
+  void saveShell_(Archive& ar) const {
     ar(cereal::make_nvp("name", name_),
        cereal::make_nvp("nodeType", type_),
        cereal::make_nvp("initialized", initialized_));
@@ -495,24 +573,14 @@ public:
     std::map<std::string, Array> buffers;
     getOutputBuffers_(buffers);
 	  ar(cereal::make_nvp("outputs", buffers));
-
-    // Now serialize the RegionImpl plugin.
-    ArWrapper arw(&ar);
-    serializeImpl(arw);
   }
 
-
-  // FOR Cereal Deserialization
-  // Note: custom region implementations must be registered
-  //       before deserializing a region.
   template<class Archive>
-  void load_ar(Archive& ar) {
-    Dimensions dim;
-    bool init;
+  void loadShell_(Archive& ar) {
     ar(cereal::make_nvp("name", name_));
     ar(cereal::make_nvp("nodeType", type_));
-    ar(cereal::make_nvp("initialized", init));
-    ar(cereal::make_nvp("dim", dim));
+    ar(cereal::make_nvp("initialized", shellInitialized_));
+    ar(cereal::make_nvp("dim", shellDim_));
 
     std::map<std::string, Dimensions> outDims;
     std::map<std::string, Dimensions> inDims;
@@ -524,23 +592,16 @@ public:
     ar(cereal::make_nvp("outputs", buffers));
     restoreOutputBuffers_(buffers);
     loadDims_(outDims, inDims);
-
-    // deserialize the RegionImpl plugin and its algorithm
-    ArWrapper arw(&ar);
-    deserializeImpl(arw);
-
-    // set the region dimensions.
-    initialized_ = false; // setDimensions requires initialization off.
-    setDimensions(dim);
-    initialized_ = init;
   }
 
-  friend class Network;  // so Network can set Network* network_; during addRegion( ).
-  friend std::ostream &operator<<(std::ostream &f, const Region &r);
+  // set the region dimensions once the impl has been deserialized.
+  void applyShellDimensions_();
 
+  // The RegionImpl, completing a deferred load first if there is one.
+  RegionImpl *impl() const;
 
-private:
-  //Region(Region &){}  // copy not allowed
+  class ShellSection;
+  class ImplSection;
 
   // local functions
   void createInputsAndOutputs_();
@@ -553,6 +614,32 @@ private:
   void serializeImpl(ArWrapper& ar) const;
   void deserializeImpl(ArWrapper& ar);
 
+  // Used by Network::run() to skip pure regions, see RegionImpl::isPure().
+  // Returns true if the inputs and parameters are the same as for the last
+  // compute(), and saves them for the next call.
+  bool isUnchanged_();
+  // Records a parameter value; a new value forces the next compute().
+  void parameterSet_(const std::string &name, const void *value, size_t size);
+
+  // Batched compute, used by Network::run().  For each iteration of the
+  // batch, prepareInputs() and then saveBatchRow_() copy the inputs into the
+  // batch rows.  computeBatch_() computes all rows, and emitBatchRow_() later
+  // copies one row of the results into the outputs.  holdOutputs_() and
+  // restoreOutputs_() keep the outputs of the previous iteration meanwhile.
+  bool isBatchable_() const;
+  void saveBatchRow_(size_t row);
+  void computeBatch_(size_t k);
+  void emitBatchRow_(size_t row);
+  void holdOutputs_();
+  void restoreOutputs_();
+
+  // true if Network::run() computes this region on the given iteration,
+  // numbered from 0.
+  bool isScheduled_(UInt64 iteration) const {
+    return computePeriod_ == 1u ||
+           (iteration >= computeOffset_ && (iteration - computeOffset_) % computePeriod_ == 0u);
+  }
+
   std::string name_;
 
   // pointer to the "plugin"; owned by Region
@@ -567,12 +654,35 @@ private:
   InputMap inputs_;
   bool initialized_;
 
+  // The inputs of the last compute() of a pure region, and the parameters
+  // set since.  Not serialized, so the first compute() after a load runs.
+  std::vector<char> lastInputs_;
+  bool lastInputsValid_ = false;
+  std::map<std::string, std::vector<char>> lastParameters_;
+
+  // Rows of the batched inputs and outputs, see computeBatch_().
+  std::map<std::string, std::vector<Array>> batchInputs_;
+  std::map<std::string, std::vector<Array>> batchOutputs_;
+  std::map<std::string, Array> heldOutputs_;
+
+  // Decimation, set by Network::setComputePeriod()
+  UInt32 computePeriod_ = 1u;
+  UInt32 computeOffset_ = 0u;
+
   // Region contains a backpointer to network_ only to be able
   // to retrieve the containing network via getNetwork() for inspectors.
   // The implementation should not use network_ in any other methods.
   // This cannot be a shared_ptr.
   Network *network_;
 
+  // Values restored by loadShell_() that are applied after the impl is loaded.
+  Dimensions shellDim_;
+  bool shellInitialized_ = false;
+
+  // A serialized RegionImpl waiting to be loaded. See deferImplSection().
+  std::shared_ptr<const std::string> deferredImpl_;
+  SerializableFormat deferredFmt_ = SerializableFormat::BINARY;
+
   // Profiling related methods and variables.
   bool profilingEnabled_;
   Timer computeTimer_;
@@ -212,6 +212,10 @@ std::string RegionImpl::executeCommand(const std::vector<std::string> &args, Int
   return "";
 }
 
+void RegionImpl::computeBatch(size_t k) {
+  NTA_THROW << "Region " << getName() << " does not implement computeBatch().";
+}
+
 // Provide data access for subclasses
 
 std::shared_ptr<Input> RegionImpl::getInput(const std::string &name) const { return region_->getInput(name); }
@@ -223,6 +227,8 @@ std::shared_ptr<Output> RegionImpl::getOutput(const std::string &name) const {
 }
 Dimensions RegionImpl::getInputDimensions(const std::string &name) const { return region_->getInputDimensions(name); }
 Dimensions RegionImpl::getOutputDimensions(const std::string &name) const { return region_->getOutputDimensions(name); }
+std::vector<Array> &RegionImpl::getBatchInput(const std::string &name) const { return region_->getBatchInput(name); }
+std::vector<Array> &RegionImpl::getBatchOutput(const std::string &name) const { return region_->getBatchOutput(name); }
 
 /**
  * Checks the parameters in the ValueMap and gives an error if it
@@ -249,6 +249,41 @@ public:
   // Compute outputs from inputs and internal state
   virtual void compute() = 0;
 
+  // Called by Network::run() after its last iteration, and by
+  // Network::saveToFileAsync() before it captures the regions.  Regions which
+  // defer work across iterations (for example a batching python sink region)
+  // must complete it here.  Serialization is const and must not do that work
+  // itself; a region saved with save() from a run callback is saved without
+  // its deferred iterations, which are completed later as usual.
+  virtual void finishRun() {}
+
+  // Return true if compute() is a pure function of the inputs and of the
+  // parameters set through the Region.  Network::run() then skips compute()
+  // while these are unchanged, and the outputs keep their previous value.
+  // A region with internal state which changes in compute(), such as a
+  // random number generator, learning or an iteration counter, must return
+  // false.
+  virtual bool isPure() const { return false; }
+
+  // Return a copy of the state of this region for Network::saveToFileAsync(),
+  // or nullptr.  The copy is serialized with cereal_adapter_save() on the
+  // checkpoint writer thread while compute() continues, so it must not share
+  // mutable state with this region.  Regions with large state (SP, TM) copy
+  // their arrays here, which is much cheaper than serializing them.  Regions
+  // which return nullptr are serialized during the capture.
+  virtual std::shared_ptr<const RegionImpl> snapshot() const { return nullptr; }
+
+  // Batch protocol.  A region which returns true from isBatchable() can
+  // compute k iterations in one call of computeBatch(k).  Row i of
+  // getBatchInput(name) holds the input of iteration i, and computeBatch()
+  // must fill row i of every getBatchOutput(name) with what compute() would
+  // have written on iteration i.  Only regions whose outputs depend on
+  // nothing but their own inputs and state may be batchable.
+  // Network::run() uses this when a batch size is set, see
+  // Network::setBatchSize().
+  virtual bool isBatchable() const { return false; }
+  virtual void computeBatch(size_t k);
+
   /* -------- Methods that may be overridden by subclasses -------- */
 
   // Execute a command
@@ -332,6 +367,10 @@ protected:
   Dimensions getInputDimensions(const std::string &name="") const;
   Dimensions getOutputDimensions(const std::string &name="") const;
 
+  // The k rows of an input or output, valid during computeBatch(k).
+  std::vector<Array> &getBatchInput(const std::string &name) const;
+  std::vector<Array> &getBatchOutput(const std::string &name) const;
+
 };
 
 } // namespace htm
@@ -39,6 +39,8 @@
 #include <htm/regions/FileOutputRegion.hpp>
 #include <htm/regions/FileInputRegion.hpp>
 #include <htm/regions/DatabaseRegion.hpp>
+#include <htm/regions/SharedMemoryInputRegion.hpp>
+#include <htm/regions/SharedMemoryOutputRegion.hpp>
 #include <htm/regions/SPRegion.hpp>
 #include <htm/regions/TMRegion.hpp>
 #include <htm/regions/ClassifierRegion.hpp>
@@ -112,6 +114,8 @@ RegionImplFactory &RegionImplFactory::getInstance() {
     instance.addRegionType("FileOutputRegion",   new RegisteredRegionImplCpp<FileOutputRegion>());
     instance.addRegionType("FileInputRegion",    new RegisteredRegionImplCpp<FileInputRegion>());
     instance.addRegionType("DatabaseRegion",     new RegisteredRegionImplCpp<DatabaseRegion>());
+    instance.addRegionType("SharedMemoryInputRegion", new RegisteredRegionImplCpp<SharedMemoryInputRegion>());
+    instance.addRegionType("SharedMemoryOutputRegion", new RegisteredRegionImplCpp<SharedMemoryOutputRegion>());
     instance.addRegionType("SPRegion",           new RegisteredRegionImplCpp<SPRegion>());
     instance.addRegionType("TMRegion",           new RegisteredRegionImplCpp<TMRegion>());
     instance.addRegionType("ClassifierRegion",   new RegisteredRegionImplCpp<ClassifierRegion>());
@@ -197,14 +201,24 @@ RegionImpl *RegionImplFactory::deserializeRegionImpl(const std::string nodeType,
                                                      ArWrapper &wrapper,
                                                      Region *region) {
   RegionImpl *impl = nullptr;
-  if (regionTypeMap.find(nodeType) != regionTypeMap.end()) {
-    impl = regionTypeMap[nodeType]->deserializeRegionImpl(wrapper, region);
+  // Note: may be called from several threads at once (see Network::loadFromFileSectioned)
+  //       so only read from the map.
+  auto itr = regionTypeMap.find(nodeType);
+  if (itr != regionTypeMap.end()) {
+    impl = itr->second->deserializeRegionImpl(wrapper, region);
   } else {
     NTA_THROW << "Unsupported node type '" << nodeType << "'";
   }
   return impl;
 }
 
+bool RegionImplFactory::canDeserializeConcurrently(const std::string nodeType) {
+  auto itr = regionTypeMap.find(nodeType);
+  if (itr == regionTypeMap.end())
+    NTA_THROW << "Unsupported node type '" << nodeType << "'";
+  return itr->second->canDeserializeConcurrently();
+}
+
 
 
 std::shared_ptr<Spec> RegionImplFactory::getSpec(const std::string nodeType) {
@@ -59,6 +59,9 @@ public:
                                     ArWrapper &wrapper, Region *region);
 
 
+  // True if RegionImpls of this type may be deserialized on a worker thread.
+  bool canDeserializeConcurrently(const std::string nodeType);
+
   // Returns node spec for a specific node type as a shared pointer.
   std::shared_ptr<Spec> getSpec(const std::string nodeType);
 
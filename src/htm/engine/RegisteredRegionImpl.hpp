@@ -84,6 +84,11 @@ namespace htm
 
     virtual Spec* createSpec() = 0;
 
+    // True if deserializeRegionImpl() may be called on a worker thread
+    // while other regions are being deserialized.
+    // See Network::loadFromFileSectioned().
+    virtual bool canDeserializeConcurrently() { return true; }
+
 	  virtual std::string className() { return classname_; }
 	  virtual std::string moduleName() { return module_; }
 
@@ -0,0 +1,311 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the TraceRecorder and TraceReplayer classes
+ */
+
+#include <cstring>
+#include <sstream>
+
+#include <htm/engine/Network.hpp>
+#include <htm/engine/Output.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/engine/Trace.hpp>
+#include <htm/ntypes/BasicType.hpp>
+#include <htm/os/Directory.hpp>
+#include <htm/os/Path.hpp>
+#include <htm/os/Timer.hpp>
+#include <htm/types/Sdr.hpp>
+#include <htm/utils/Log.hpp>
+
+namespace htm {
+
+namespace {
+const char TRACE_MAGIC[8] = {'H', 'T', 'M', 'T', 'R', 'A', 'C', 'E'};
+const UInt32 TRACE_VERSION = 1u;
+const UInt32 FLAG_OUTPUTS = 1u;
+const char FRAME_TAG = 'F';
+const char END_TAG = 'E';
+const std::string INPUT_REGION = "INPUT";
+
+// Integers are written byte by byte so the layout does not depend on the
+// endianness of the machine that wrote it.
+void writeLE_(std::ostream &f, UInt64 value, size_t bytes) {
+  for (size_t i = 0; i < bytes; i++) {
+    f.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+UInt64 readLE_(std::istream &f, size_t bytes) {
+  UInt64 value = 0;
+  for (size_t i = 0; i < bytes; i++) {
+    int c = f.get();
+    NTA_CHECK(c != EOF) << "Trace: unexpected end of file.";
+    value |= static_cast<UInt64>(static_cast<unsigned char>(c)) << (8 * i);
+  }
+  return value;
+}
+
+void writeString_(std::ostream &f, const std::string &s) {
+  writeLE_(f, s.size(), 4);
+  f.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+std::string readString_(std::istream &f) {
+  std::string s(static_cast<size_t>(readLE_(f, 4)), '\0');
+  f.read(&s[0], static_cast<std::streamsize>(s.size()));
+  NTA_CHECK(f.good()) << "Trace: unexpected end of file.";
+  return s;
+}
+
+void writeArray_(std::ostream &f, const Array &a) {
+  const NTA_BasicType type = a.getType();
+  NTA_CHECK(type != NTA_BasicType_Str) << "Trace: string arrays cannot be recorded.";
+  writeLE_(f, static_cast<UInt64>(type), 4);
+  if (type == NTA_BasicType_SDR) {
+    const SDR &sdr = a.getSDR();
+    writeLE_(f, sdr.dimensions.size(), 4);
+    for (const auto d : sdr.dimensions)
+      writeLE_(f, d, 4);
+    const SDR_sparse_t &sparse = sdr.getSparse();
+    writeLE_(f, sparse.size(), 8);
+    f.write(reinterpret_cast<const char *>(sparse.data()),
+            static_cast<std::streamsize>(sparse.size() * sizeof(ElemSparse)));
+  } else {
+    writeLE_(f, a.getCount(), 8);
+    f.write(static_cast<const char *>(a.getBuffer()),
+            static_cast<std::streamsize>(a.getCount() * BasicType::getSize(type)));
+  }
+}
+Array readArray_(std::istream &f) {
+  const NTA_BasicType type = static_cast<NTA_BasicType>(readLE_(f, 4));
+  NTA_CHECK(BasicType::isValid(type) && type != NTA_BasicType_Str) << "Trace: invalid array type " << type;
+  if (type == NTA_BasicType_SDR) {
+    std::vector<UInt> dimensions(static_cast<size_t>(readLE_(f, 4)));
+    for (auto &d : dimensions)
+      d = static_cast<UInt>(readLE_(f, 4));
+    SDR_sparse_t sparse(static_cast<size_t>(readLE_(f, 8)));
+    f.read(reinterpret_cast<char *>(sparse.data()),
+           static_cast<std::streamsize>(sparse.size() * sizeof(ElemSparse)));
+    NTA_CHECK(f.good()) << "Trace: unexpected end of file.";
+    SDR sdr(dimensions);
+    sdr.setSparse(sparse);
+    return Array(sdr);
+  }
+  Array a(type);
+  a.allocateBuffer(static_cast<size_t>(readLE_(f, 8)));
+  f.read(static_cast<char *>(a.getBuffer()),
+         static_cast<std::streamsize>(a.getCount() * BasicType::getSize(type)));
+  NTA_CHECK(f.good()) << "Trace: unexpected end of file.";
+  return a;
+}
+} // namespace
+
+
+/////////////////////////////////////////////////////////////////////
+//      TraceRecorder
+/////////////////////////////////////////////////////////////////////
+
+TraceRecorder::TraceRecorder(const std::string &filePath, bool recordOutputs)
+    : filePath_(filePath), recordOutputs_(recordOutputs) {}
+
+TraceRecorder::~TraceRecorder() {
+  try {
+    close();
+  } catch (...) {
+    // destructors must not throw
+  }
+}
+
+void TraceRecorder::attachToNetwork(Network &net) {
+  NTA_CHECK(!out_.is_open()) << "Trace: '" << filePath_ << "' is already recording.";
+  net.initialize();
+
+  Directory::create(Path::getParent(filePath_), true, true);
+  out_.open(filePath_, std::ios::out | std::ios::binary | std::ios::trunc);
+  NTA_CHECK(out_.is_open()) << "Trace: unable to open '" << filePath_ << "'";
+
+  std::stringstream snapshot;
+  net.save(snapshot, SerializableFormat::BINARY);
+  const std::string data = snapshot.str();
+
+  out_.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+  writeLE_(out_, TRACE_VERSION, 4);
+  writeLE_(out_, recordOutputs_ ? FLAG_OUTPUTS : 0u, 4);
+  writeLE_(out_, data.size(), 8);
+  out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+  inputNames_.clear();
+  previous_.clear();
+  outputs_.clear();
+  const auto regions = net.getRegions();
+  if (regions.contains(INPUT_REGION)) {
+    for (const auto &output : regions.getByName(INPUT_REGION)->getOutputs()) {
+      inputNames_.push_back(output.first);
+      previous_.push_back(Array());
+    }
+  }
+  if (recordOutputs_) {
+    for (size_t i = 0; i < regions.getCount(); i++) {
+      const auto &region = regions.getByIndex(i);
+      if (region.first == INPUT_REGION)
+        continue;
+      for (const auto &output : region.second->getOutputs())
+        outputs_.push_back(std::make_pair(region.first, output.first));
+    }
+  }
+
+  writeLE_(out_, inputNames_.size(), 4);
+  for (const auto &name : inputNames_)
+    writeString_(out_, name);
+  writeLE_(out_, outputs_.size(), 4);
+  for (const auto &output : outputs_)
+    writeString_(out_, output.first + "." + output.second);
+  NTA_CHECK(out_.good()) << "Trace: error writing '" << filePath_ << "'";
+
+  Collection<Network::callbackItem> &callbacks = net.getCallbacks();
+  Network::callbackItem callback(traceCallback, (void *)this);
+  callbacks.add("TraceRecorder: " + filePath_, callback);
+}
+
+void TraceRecorder::detachFromNetwork(Network &net) {
+  Collection<Network::callbackItem> &callbacks = net.getCallbacks();
+  callbacks.remove("TraceRecorder: " + filePath_);
+  out_.flush();
+}
+
+void TraceRecorder::close() {
+  if (!out_.is_open())
+    return;
+  out_.put(END_TAG);
+  out_.close();
+}
+
+void TraceRecorder::traceCallback(Network *net, UInt64 iteration, void *dataIn) {
+  static_cast<TraceRecorder *>(dataIn)->record_(*net, iteration);
+}
+
+void TraceRecorder::record_(Network &net, UInt64 iteration) {
+  NTA_CHECK(out_.is_open()) << "Trace: '" << filePath_ << "' is closed.";
+  out_.put(FRAME_TAG);
+  writeLE_(out_, iteration, 8);
+
+  if (!inputNames_.empty()) {
+    std::shared_ptr<Region> input = net.getRegion(INPUT_REGION);
+    for (size_t i = 0; i < inputNames_.size(); i++) {
+      const Array &data = input->getOutput(inputNames_[i])->getData();
+      // The first frame always has every input.
+      const bool changed = frames_ == 0u || !(data == previous_[i]);
+      out_.put(changed ? 1 : 0);
+      if (changed) {
+        writeArray_(out_, data);
+        previous_[i] = data.copy();
+      }
+    }
+  }
+  for (const auto &output : outputs_) {
+    writeArray_(out_, net.getRegion(output.first)->getOutput(output.second)->getData());
+  }
+  NTA_CHECK(out_.good()) << "Trace: error writing '" << filePath_ << "'";
+  frames_++;
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//      TraceReplayer
+/////////////////////////////////////////////////////////////////////
+
+TraceReplayer::TraceReplayer(const std::string &filePath) : filePath_(filePath) {
+  std::ifstream in(filePath_, std::ios::in | std::ios::binary);
+  NTA_CHECK(in.is_open()) << "Trace: unable to open '" << filePath_ << "'";
+
+  char magic[sizeof(TRACE_MAGIC)];
+  in.read(magic, sizeof(magic));
+  NTA_CHECK(in.good() && std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0)
+      << "Trace: '" << filePath_ << "' is not a trace file.";
+  const UInt32 version = static_cast<UInt32>(readLE_(in, 4));
+  NTA_CHECK(version == TRACE_VERSION) << "Trace: unsupported version " << version;
+  hasOutputs_ = (readLE_(in, 4) & FLAG_OUTPUTS) != 0u;
+
+  snapshot_.resize(static_cast<size_t>(readLE_(in, 8)));
+  in.read(&snapshot_[0], static_cast<std::streamsize>(snapshot_.size()));
+  NTA_CHECK(in.good()) << "Trace: unexpected end of file.";
+
+  inputNames_.resize(static_cast<size_t>(readLE_(in, 4)));
+  for (auto &name : inputNames_)
+    name = readString_(in);
+  outputNames_.resize(static_cast<size_t>(readLE_(in, 4)));
+  for (auto &name : outputNames_)
+    name = readString_(in);
+  firstFrame_ = in.tellg();
+}
+
+TraceReplayReport TraceReplayer::replay(Network &net, bool verify) {
+  TraceReplayReport report;
+  Timer total(true);
+  Timer run;
+
+  {
+    std::stringstream snapshot(snapshot_);
+    net.load(snapshot, SerializableFormat::BINARY);
+  }
+  net.initialize();
+
+  std::vector<std::shared_ptr<Output>> outputs;
+  for (const auto &name : outputNames_) {
+    const size_t dot = name.find('.');
+    outputs.push_back(net.getRegion(name.substr(0, dot))->getOutput(name.substr(dot + 1)));
+  }
+
+  std::ifstream in(filePath_, std::ios::in | std::ios::binary);
+  NTA_CHECK(in.is_open()) << "Trace: unable to open '" << filePath_ << "'";
+  in.seekg(firstFrame_);
+
+  while (true) {
+    const int tag = in.get();
+    if (tag == END_TAG || tag == EOF) // EOF: the recorder was not closed
+      break;
+    NTA_CHECK(tag == FRAME_TAG) << "Trace: corrupt frame in '" << filePath_ << "'";
+    const UInt64 iteration = readLE_(in, 8);
+
+    for (const auto &name : inputNames_) {
+      if (in.get() != 0)
+        net.setInputData(name, readArray_(in));
+    }
+    run.start();
+    net.run(1);
+    run.stop();
+    report.iterations++;
+
+    bool mismatch = false;
+    for (size_t i = 0; i < outputs.size(); i++) {
+      const Array expected = readArray_(in);
+      if (verify && !mismatch && !(outputs[i]->getData() == expected)) {
+        mismatch = true;
+        if (report.firstMismatch.empty())
+          report.firstMismatch = "iteration " + std::to_string(iteration) + ": " + outputNames_[i];
+      }
+    }
+    if (mismatch)
+      report.mismatches++;
+  }
+
+  report.runSeconds = run.getElapsed();
+  report.totalSeconds = total.getElapsed();
+  return report;
+}
+
+} // namespace htm
@@ -0,0 +1,159 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Interface for the TraceRecorder and TraceReplayer classes
+ */
+
+#ifndef NTA_TRACE_HPP
+#define NTA_TRACE_HPP
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <htm/ntypes/Array.hpp>
+#include <htm/types/Types.hpp>
+
+namespace htm {
+class Network;
+
+/*
+ * Records the input stream of a Network into a compact binary trace file,
+ * so that a workload can be replayed offline with TraceReplayer.
+ *
+ * The trace starts with a snapshot of the network (Network::save, BINARY)
+ * taken when the recorder is attached.  After each iteration it records the
+ * value of every "INPUT" source, i.e. the data given to Network::setInputData().
+ * An input is only written when it changed since the previous iteration.
+ * With recordOutputs the outputs of every region are recorded as well, so
+ * that a replay can verify it reproduces the same results.
+ *
+ * Parameters set directly on regions (for example an encoder's sensedValue)
+ * are not recorded; feed such values through an INPUT link when tracing.
+ *
+ * Sample usage:
+ *
+ * Network net;
+ * ...
+ * TraceRecorder trace("workload.trace", true);
+ * trace.attachToNetwork(net);
+ * for (...) {
+ *   net.setInputData("source", data);
+ *   net.run(1);
+ * }
+ * trace.detachFromNetwork(net);
+ *
+ * The recorder is a run callback, see Network::getCallbacks().  Callbacks
+ * run in the order they were added, so attach it before any callback which
+ * calls setInputData() for the next iteration.
+ *
+ * File layout (integers are little-endian, array data is in native order):
+ *    char[8]  magic "HTMTRACE"
+ *    UInt32   version, UInt32 flags (bit 0: outputs recorded)
+ *    UInt64   snapshot length, snapshot
+ *    UInt32   number of inputs, for each: UInt32 length, source name
+ *    UInt32   number of outputs, for each: UInt32 length, "region.output"
+ *    for each iteration:
+ *       'F', UInt64 iteration,
+ *       for each input: UInt8 changed, array if changed
+ *       for each output: array
+ *    'E'
+ *    array: UInt32 type, then for SDR: UInt32 number of dimensions,
+ *           dimensions, UInt64 number of active bits, sparse indices;
+ *           otherwise UInt64 count, count elements.
+ */
+class TraceRecorder {
+public:
+  TraceRecorder(const std::string &filePath, bool recordOutputs = false);
+
+  // calls close()
+  ~TraceRecorder();
+
+  // Writes the header and the snapshot, and starts recording every
+  // iteration.  Initializes the network if needed.
+  void attachToNetwork(Network &net);
+
+  // Stops recording.  The file stays open until close().
+  void detachFromNetwork(Network &net);
+
+  // Writes the end marker and closes the file.
+  void close();
+
+  // Number of iterations recorded so far.
+  UInt64 getFrameCount() const { return frames_; }
+
+  // callback function that will be called every time network is run
+  static void traceCallback(Network *net, UInt64 iteration, void *dataIn);
+
+private:
+  void record_(Network &net, UInt64 iteration);
+
+  std::string filePath_;
+  bool recordOutputs_;
+  std::ofstream out_;
+  std::vector<std::string> inputNames_;
+  std::vector<Array> previous_; // last recorded value of each input
+  std::vector<std::pair<std::string, std::string>> outputs_;
+  UInt64 frames_ = 0u;
+};
+
+
+struct TraceReplayReport {
+  UInt64 iterations = 0u;
+  UInt64 mismatches = 0u;    // iterations with at least one output that differs
+  Real64 runSeconds = 0.0;   // time spent in Network::run()
+  Real64 totalSeconds = 0.0; // including reading the trace and verification
+  std::string firstMismatch; // "iteration N: region.output", empty if none
+};
+
+/*
+ * Replays a trace written by TraceRecorder.
+ *
+ * Sample usage:
+ *
+ * TraceReplayer replay("workload.trace");
+ * Network net;
+ * TraceReplayReport report = replay.replay(net);
+ */
+class TraceReplayer {
+public:
+  // Reads the header of the trace.
+  TraceReplayer(const std::string &filePath);
+
+  // Restores the snapshot into net, which must be empty, then for every
+  // recorded iteration sets the inputs and runs the network once, as fast
+  // as possible.  With verify, and if the trace has outputs, the outputs
+  // are compared to the recording after each iteration.
+  TraceReplayReport replay(Network &net, bool verify = true);
+
+  const std::vector<std::string> &getInputNames() const { return inputNames_; }
+  const std::vector<std::string> &getOutputNames() const { return outputNames_; }
+  bool hasOutputs() const { return hasOutputs_; }
+
+private:
+  std::string filePath_;
+  std::string snapshot_;
+  std::vector<std::string> inputNames_;
+  std::vector<std::string> outputNames_;
+  bool hasOutputs_ = false;
+  std::streampos firstFrame_;
+};
+
+} // namespace htm
+
+#endif // NTA_TRACE_HPP
@@ -0,0 +1,370 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the shared memory ring buffer
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <random>
+#include <thread>
+
+#if !defined(NTA_OS_WINDOWS)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <htm/ntypes/BasicType.hpp>
+#include <htm/os/SharedMemory.hpp>
+#include <htm/utils/Log.hpp>
+
+namespace htm {
+
+using namespace std;
+
+namespace {
+
+// Layout of the shared memory object:
+//   RingHeader, then 'slots' times { SlotHeader, frame }.
+// Every part starts on a cache line.
+const UInt32 RING_MAGIC   = 0x48544d52u; // "HTMR"
+const UInt32 RING_VERSION = 3u;
+const size_t MAX_CHANNELS = 16u;
+const size_t MAX_NAME     = 48u;
+const size_t LINE         = 64u;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared memory needs lock free 64 bit atomics");
+
+struct ChannelHeader {
+  char   name[MAX_NAME];
+  UInt32 type;
+  UInt32 reserved;
+  UInt64 count;
+  UInt64 offset;
+};
+
+struct alignas(64) RingHeader {
+  UInt32 magic;
+  UInt32 version;
+  UInt32 slots;
+  UInt32 channelCount;
+  UInt64 frameBytes; // size of a frame
+  UInt64 slotBytes;  // distance between slots
+  UInt64 generation; // random, identifies the writer
+  UInt64 writerPid;  // process of the writer
+  ChannelHeader channels[MAX_CHANNELS];
+  alignas(64) atomic<UInt64> frames;   // number of published frames
+  alignas(64) atomic<UInt64> consumed; // number of acknowledged frames
+};
+
+// A slot holding frame f has sequence 2f+2, or 2f+1 while it is written.
+struct alignas(64) SlotHeader {
+  atomic<UInt64> sequence;
+};
+
+size_t roundUp(size_t n) { return (n + LINE - 1u) / LINE * LINE; }
+
+string shmName(const string &name) {
+  NTA_CHECK(!name.empty()) << "SharedMemory: a name is required.";
+  const string shm = name[0] == '/' ? name : "/" + name;
+  NTA_CHECK(shm.size() <= SharedMemoryWriter::maxNameLength())
+      << "SharedMemory: the name '" << shm << "' is longer than "
+      << SharedMemoryWriter::maxNameLength() << " characters, the limit of shm_open() on this system.";
+  return shm;
+}
+
+// Wait until done() returns true, or the timeout in milliseconds (0: never)
+// expires.  Spins briefly, then sleeps, since the other side is usually a
+// Network iteration away.
+template <typename F>
+bool waitUntil(F done, UInt32 timeout) {
+  const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout);
+  for (UInt32 spin = 0u; !done(); spin++) {
+    if (spin < 100u) {
+      this_thread::yield();
+      continue;
+    }
+    if (timeout > 0u && chrono::steady_clock::now() >= deadline)
+      return false;
+    this_thread::sleep_for(chrono::microseconds(50));
+  }
+  return true;
+}
+
+#if !defined(NTA_OS_WINDOWS)
+// The generation of the ring which the name refers to now, 0 if none.
+UInt64 generationOf(const string &name) {
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    return 0u;
+  UInt64 generation = 0u;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(RingHeader)) {
+    void *map = mmap(nullptr, sizeof(RingHeader), PROT_READ, MAP_SHARED, fd, 0);
+    if (map != MAP_FAILED) {
+      generation = static_cast<const RingHeader *>(map)->generation;
+      munmap(map, sizeof(RingHeader));
+    }
+  }
+  close(fd);
+  return generation;
+}
+#endif
+
+inline const SlotHeader *slotOf(const Byte *map, UInt32 slots, size_t slotBytes, UInt64 frame) {
+  return reinterpret_cast<const SlotHeader *>(map + sizeof(RingHeader) + (frame % slots) * slotBytes);
+}
+
+} // namespace
+
+
+size_t SharedMemoryWriter::maxNameLength() {
+#if defined(__APPLE__)
+  return 31u; // PSHMNAMLEN
+#else
+  return 255u; // NAME_MAX
+#endif
+}
+
+SharedMemoryWriter::SharedMemoryWriter(const string &name,
+                                       const vector<SharedMemoryChannel> &channels,
+                                       UInt32 slots, bool flowControl)
+    : name_(shmName(name)), channels_(channels), slots_(slots), flowControl_(flowControl) {
+#if defined(NTA_OS_WINDOWS)
+  NTA_THROW << "SharedMemoryWriter: POSIX shared memory is not available on Windows.";
+#else
+  NTA_CHECK(slots_ > 0u) << "SharedMemoryWriter: slots must be > 0.";
+  NTA_CHECK(channels_.size() <= MAX_CHANNELS)
+      << "SharedMemoryWriter: at most " << MAX_CHANNELS << " channels.";
+
+  size_t frameBytes = 0u;
+  for (auto &ch : channels_) {
+    NTA_CHECK(ch.name.size() < MAX_NAME) << "SharedMemoryWriter: channel name too long '" << ch.name << "'";
+    NTA_CHECK(BasicType::isValid(ch.type) && ch.type != NTA_BasicType_Str)
+        << "SharedMemoryWriter: unsupported type for channel '" << ch.name << "'";
+    ch.offset = frameBytes;
+    frameBytes += roundUp(ch.count * BasicType::getSize(ch.type));
+  }
+  const size_t slotBytes = sizeof(SlotHeader) + roundUp(frameBytes);
+  size_ = sizeof(RingHeader) + slots_ * slotBytes;
+
+  // Replace any stale object, readers of it keep their mapping.
+  shm_unlink(name_.c_str());
+  const int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  NTA_CHECK(fd >= 0) << "SharedMemoryWriter: cannot create '" << name_ << "': " << strerror(errno);
+  if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+    const int err = errno;
+    close(fd);
+    shm_unlink(name_.c_str());
+    NTA_THROW << "SharedMemoryWriter: cannot size '" << name_ << "': " << strerror(err);
+  }
+  void *map = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    shm_unlink(name_.c_str());
+    NTA_THROW << "SharedMemoryWriter: cannot map '" << name_ << "': " << strerror(errno);
+  }
+  map_ = static_cast<Byte *>(map);
+
+  random_device entropy;
+  do {
+    generation_ = (static_cast<UInt64>(entropy()) << 32u) ^ entropy() ^
+                  static_cast<UInt64>(chrono::steady_clock::now().time_since_epoch().count());
+  } while (generation_ == 0u);
+
+  // ftruncate() zero filled the object, so all slots are empty.
+  RingHeader *header = new (map_) RingHeader;
+  header->version      = RING_VERSION;
+  header->generation   = generation_;
+  header->writerPid    = static_cast<UInt64>(getpid());
+  header->slots        = slots_;
+  header->channelCount = static_cast<UInt32>(channels_.size());
+  header->frameBytes   = frameBytes;
+  header->slotBytes    = slotBytes;
+  for (size_t i = 0u; i < channels_.size(); i++) {
+    ChannelHeader &ch = header->channels[i];
+    strncpy(ch.name, channels_[i].name.c_str(), MAX_NAME - 1u);
+    ch.type   = static_cast<UInt32>(channels_[i].type);
+    ch.count  = channels_[i].count;
+    ch.offset = channels_[i].offset;
+  }
+  header->frames.store(0u, memory_order_relaxed);
+  header->consumed.store(0u, memory_order_relaxed);
+  // The magic number is written last, readers check it first.
+  atomic_thread_fence(memory_order_release);
+  header->magic = RING_MAGIC;
+#endif
+}
+
+SharedMemoryWriter::~SharedMemoryWriter() {
+#if !defined(NTA_OS_WINDOWS)
+  if (map_ != nullptr) {
+    munmap(map_, size_);
+    // Unless a new writer replaced the ring.
+    if (generationOf(name_) == generation_)
+      shm_unlink(name_.c_str());
+  }
+#endif
+}
+
+void SharedMemoryWriter::publish(const vector<const void *> &data) {
+  NTA_CHECK(data.size() == channels_.size())
+      << "SharedMemoryWriter::publish: expected " << channels_.size() << " channels.";
+  RingHeader *header = reinterpret_cast<RingHeader *>(map_);
+  const UInt64 frame = frames_;
+  if (flowControl_ && frame >= slots_) {
+    const bool free = waitUntil([header, frame, this]() {
+      return frame - header->consumed.load(memory_order_acquire) < slots_;
+    }, timeout_);
+    NTA_CHECK(free) << "SharedMemoryWriter: no reader consumed the frames of '" << name_
+                    << "' within " << timeout_ << " ms.";
+  }
+  SlotHeader *slot = const_cast<SlotHeader *>(slotOf(map_, slots_, header->slotBytes, frame));
+  Byte *payload = reinterpret_cast<Byte *>(slot) + sizeof(SlotHeader);
+
+  slot->sequence.store(2u * frame + 1u, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  for (size_t i = 0u; i < channels_.size(); i++) {
+    const auto &ch = channels_[i];
+    memcpy(payload + ch.offset, data[i], ch.count * BasicType::getSize(ch.type));
+  }
+  slot->sequence.store(2u * frame + 2u, memory_order_release);
+
+  frames_ = frame + 1u;
+  header->frames.store(frames_, memory_order_release);
+}
+
+
+const void *SharedMemoryFrame::getChannel(size_t i) const {
+  NTA_CHECK(reader_ != nullptr) << "SharedMemoryFrame: not read.";
+  NTA_CHECK(i < reader_->channels_.size()) << "SharedMemoryFrame: no channel " << i;
+  return data_ + reader_->channels_[i].offset;
+}
+
+
+SharedMemoryReader::SharedMemoryReader(const string &name, bool acknowledging)
+    : name_(shmName(name)), acknowledging_(acknowledging) {
+#if defined(NTA_OS_WINDOWS)
+  NTA_THROW << "SharedMemoryReader: POSIX shared memory is not available on Windows.";
+#else
+  const int fd = shm_open(name_.c_str(), acknowledging_ ? O_RDWR : O_RDONLY, 0);
+  NTA_CHECK(fd >= 0) << "SharedMemoryReader: cannot open '" << name_ << "': " << strerror(errno);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RingHeader)) {
+    close(fd);
+    NTA_THROW << "SharedMemoryReader: '" << name_ << "' is not a ring buffer.";
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  const int protection = acknowledging_ ? PROT_READ | PROT_WRITE : PROT_READ;
+  void *map = mmap(nullptr, size_, protection, MAP_SHARED, fd, 0);
+  close(fd);
+  NTA_CHECK(map != MAP_FAILED) << "SharedMemoryReader: cannot map '" << name_ << "': " << strerror(errno);
+  map_ = static_cast<const Byte *>(map);
+
+  const RingHeader *header = reinterpret_cast<const RingHeader *>(map_);
+  bool valid = header->magic == RING_MAGIC;
+  atomic_thread_fence(memory_order_acquire); // pairs with the writer, see the magic number
+  valid = valid && header->version == RING_VERSION && header->channelCount <= MAX_CHANNELS &&
+          sizeof(RingHeader) + header->slots * header->slotBytes <= size_;
+  if (!valid) {
+    munmap(const_cast<Byte *>(map_), size_);
+    map_ = nullptr;
+    NTA_THROW << "SharedMemoryReader: '" << name_ << "' is not a ring buffer, or not ready.";
+  }
+  slots_ = header->slots;
+  for (UInt32 i = 0u; i < header->channelCount; i++) {
+    const ChannelHeader &ch = header->channels[i];
+    channels_.push_back({string(ch.name, strnlen(ch.name, MAX_NAME)),
+                         static_cast<NTA_BasicType>(ch.type),
+                         static_cast<size_t>(ch.count),
+                         static_cast<size_t>(ch.offset)});
+  }
+#endif
+}
+
+SharedMemoryReader::~SharedMemoryReader() {
+#if !defined(NTA_OS_WINDOWS)
+  if (map_ != nullptr)
+    munmap(const_cast<Byte *>(map_), size_);
+#endif
+}
+
+UInt64 SharedMemoryReader::getGeneration() const {
+  return reinterpret_cast<const RingHeader *>(map_)->generation;
+}
+
+bool SharedMemoryReader::isCurrent() const {
+#if defined(NTA_OS_WINDOWS)
+  return false;
+#else
+  const RingHeader *header = reinterpret_cast<const RingHeader *>(map_);
+  // Signal 0 only checks that the process exists.
+  if (kill(static_cast<pid_t>(header->writerPid), 0) != 0 && errno != EPERM)
+    return false;
+
+  // A new writer unlinks the name and creates another object.
+  return generationOf(name_) == header->generation;
+#endif
+}
+
+UInt64 SharedMemoryReader::getFrameCount() const {
+  return reinterpret_cast<const RingHeader *>(map_)->frames.load(memory_order_acquire);
+}
+
+UInt64 SharedMemoryReader::getAcknowledgedCount() const {
+  return reinterpret_cast<const RingHeader *>(map_)->consumed.load(memory_order_acquire);
+}
+
+bool SharedMemoryReader::read(UInt64 frame, SharedMemoryFrame &out) const {
+  const RingHeader *header = reinterpret_cast<const RingHeader *>(map_);
+  const SlotHeader *slot = slotOf(map_, slots_, header->slotBytes, frame);
+  if (slot->sequence.load(memory_order_acquire) != 2u * frame + 2u)
+    return false;
+  out.reader_ = this;
+  out.data_   = reinterpret_cast<const Byte *>(slot) + sizeof(SlotHeader);
+  out.frame_  = frame;
+  return true;
+}
+
+bool SharedMemoryReader::isValid(const SharedMemoryFrame &frame) const {
+  NTA_CHECK(frame.reader_ == this) << "SharedMemoryReader::isValid: frame of another reader.";
+  const RingHeader *header = reinterpret_cast<const RingHeader *>(map_);
+  const SlotHeader *slot = slotOf(map_, slots_, header->slotBytes, frame.frame_);
+  // Order the reads of the frame data before the second sequence check.
+  atomic_thread_fence(memory_order_acquire);
+  return slot->sequence.load(memory_order_relaxed) == 2u * frame.frame_ + 2u;
+}
+
+bool SharedMemoryReader::waitFor(UInt64 frame, UInt32 milliseconds) const {
+  return waitUntil([this, frame]() { return getFrameCount() > frame; }, milliseconds);
+}
+
+void SharedMemoryReader::acknowledge(UInt64 frame) {
+  NTA_CHECK(acknowledging_) << "SharedMemoryReader::acknowledge: '" << name_
+                            << "' was not opened for acknowledging.";
+  RingHeader *header = reinterpret_cast<RingHeader *>(const_cast<Byte *>(map_));
+  header->consumed.store(frame + 1u, memory_order_release);
+}
+
+} // namespace htm
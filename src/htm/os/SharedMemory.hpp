@@ -0,0 +1,234 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Shared memory ring buffer, for publishing data to other processes
+ */
+
+#ifndef NTA_SHARED_MEMORY_HPP
+#define NTA_SHARED_MEMORY_HPP
+
+#include <htm/types/Types.hpp>
+#include <string>
+#include <vector>
+
+namespace htm {
+
+/**
+ * Describes one channel of a shared memory frame: a fixed size array of
+ * one basic type.  SDRs are published in their dense format, one Byte per
+ * bit.
+ */
+struct SharedMemoryChannel {
+  std::string name;
+  NTA_BasicType type;
+  size_t count;   // number of elements
+  size_t offset;  // byte offset of the channel in the frame, set by the writer
+};
+
+/**
+ * @Responsibility
+ * Publish frames of data into a POSIX shared memory ring buffer.
+ *
+ * @Description
+ * The shared memory object holds a header, which describes the channels,
+ * followed by a ring of 'slots' frames.  Every frame has the same layout:
+ * the channels, one after the other.  Each slot is guarded by a sequence
+ * number (a seqlock) so a reader can detect a frame which was overwritten
+ * while it was reading it.
+ *
+ * By default the writer never waits for readers.  With flow control, a
+ * single reader acknowledges the frames it consumed, and publish() waits
+ * while the ring holds 'slots' unacknowledged frames.  No frame is lost
+ * then, and the writer runs at most 'slots' frames ahead of the reader.
+ *
+ * The writer creates the shared memory object, replacing any old object
+ * with the same name, and removes it when destroyed, unless a newer writer
+ * replaced it by then.  The header records
+ * a random generation number and the process of the writer, so a reader
+ * can tell a ring left over from a writer which crashed, or replaced by a
+ * new writer, see SharedMemoryReader::isCurrent().  Not available on
+ * Windows.
+ *
+ * Example:
+ *     SharedMemoryWriter writer("/htm.anomaly", {{"score", NTA_BasicType_Real64, 1u, 0u}});
+ *     writer.publish({ &score });
+ */
+class SharedMemoryWriter {
+public:
+  /**
+   * @param name      Name of the shared memory object, "/" is prepended if missing.
+   * @param channels  The layout of a frame.  The offsets are assigned here.
+   * @param slots     Number of frames kept in the ring.
+   * @param flowControl  Wait for a reader to acknowledge frames, see above.
+   */
+  SharedMemoryWriter(const std::string &name,
+                     const std::vector<SharedMemoryChannel> &channels,
+                     UInt32 slots = 16u, bool flowControl = false);
+  ~SharedMemoryWriter();
+
+  /**
+   * Longest name shm_open() takes on this system, with the leading "/":
+   * 31 characters on macOS, 255 elsewhere.  Longer names throw.
+   */
+  static size_t maxNameLength();
+
+  /**
+   * Copy one frame into the next slot of the ring.  With flow control this
+   * waits for a free slot, and throws if none frees up within the timeout.
+   * @param data  One pointer per channel, to count elements of its type.
+   */
+  void publish(const std::vector<const void *> &data);
+
+  // How long publish() waits for the reader, in milliseconds; 0 waits forever.
+  void setTimeout(UInt32 milliseconds) { timeout_ = milliseconds; }
+
+  const std::string &getName() const { return name_; }
+  const std::vector<SharedMemoryChannel> &getChannels() const { return channels_; }
+  UInt32 getSlots() const { return slots_; }
+  // Random number which identifies this writer, never 0.
+  UInt64 getGeneration() const { return generation_; }
+  // Number of frames published so far.
+  UInt64 getFrameCount() const { return frames_; }
+
+private:
+  SharedMemoryWriter(const SharedMemoryWriter &) = delete;
+  SharedMemoryWriter &operator=(const SharedMemoryWriter &) = delete;
+
+  std::string name_;
+  std::vector<SharedMemoryChannel> channels_;
+  UInt32 slots_;
+  bool flowControl_;
+  UInt32 timeout_ = 10000u;
+  UInt64 frames_ = 0u;
+  UInt64 generation_ = 0u;
+  size_t size_ = 0u;
+  Byte *map_ = nullptr;
+};
+
+class SharedMemoryReader;
+
+/**
+ * A frame in the ring of a SharedMemoryReader, see SharedMemoryReader::read().
+ */
+class SharedMemoryFrame {
+public:
+  // Frame number, counting from 0.
+  UInt64 getFrame() const { return frame_; }
+  // Pointer to the data of channel number i.
+  const void *getChannel(size_t i) const;
+
+private:
+  friend class SharedMemoryReader;
+  const SharedMemoryReader *reader_ = nullptr;
+  const Byte *data_ = nullptr;
+  UInt64 frame_ = 0u;
+};
+
+/**
+ * @Responsibility
+ * Read frames from a ring buffer created by a SharedMemoryWriter.
+ *
+ * @Description
+ * The reader maps the shared memory read-only and hands out pointers into
+ * it, nothing is copied.  After using a frame, check that it is still
+ * valid: the writer may have reused its slot in the meantime, in which
+ * case the data read from it must be discarded.
+ *
+ * Example:
+ *     SharedMemoryReader reader("/htm.anomaly");
+ *     SharedMemoryFrame frame;
+ *     if (reader.read(reader.getFrameCount() - 1u, frame)) {
+ *       Real64 score = *(const Real64 *)frame.getChannel(0);
+ *       if (reader.isValid(frame))
+ *         std::cout << score << std::endl;
+ *     }
+ */
+class SharedMemoryReader {
+public:
+  /**
+   * @param name  Name of the shared memory object, "/" is prepended if missing.
+   * @param acknowledging  Map the ring writable, to call acknowledge().
+   * Throws if the object does not exist or was not made by a SharedMemoryWriter.
+   */
+  explicit SharedMemoryReader(const std::string &name, bool acknowledging = false);
+  ~SharedMemoryReader();
+
+  const std::string &getName() const { return name_; }
+  const std::vector<SharedMemoryChannel> &getChannels() const { return channels_; }
+  UInt32 getSlots() const { return slots_; }
+  // The generation of the writer of the ring, see SharedMemoryWriter.
+  UInt64 getGeneration() const;
+
+  /**
+   * Returns false if the writer of this ring is gone: its process ended, or
+   * the name now refers to another ring, or to nothing.  Such a ring gets
+   * no more frames.  This opens the name again, so call it while waiting
+   * rather than for every frame.
+   */
+  bool isCurrent() const;
+
+  /**
+   * Number of frames the writer published so far.  The newest frame is
+   * getFrameCount() - 1, the oldest one still in the ring is at most
+   * getSlots() frames older.
+   */
+  UInt64 getFrameCount() const;
+
+  // Number of frames acknowledged so far, see acknowledge().
+  UInt64 getAcknowledgedCount() const;
+
+  /**
+   * Look up a frame.  Returns false if it was not published yet or its
+   * slot was already reused.
+   */
+  bool read(UInt64 frame, SharedMemoryFrame &out) const;
+
+  /**
+   * Returns true if the frame was not overwritten since read().  Call this
+   * after using the data of the frame.
+   */
+  bool isValid(const SharedMemoryFrame &frame) const;
+
+  /**
+   * Wait until the given frame was published.  Returns false if it was not
+   * published within the timeout, in milliseconds; 0 waits forever.
+   */
+  bool waitFor(UInt64 frame, UInt32 milliseconds) const;
+
+  /**
+   * Tell a writer with flow control that all frames up to and including
+   * this one were consumed, so their slots may be reused.
+   */
+  void acknowledge(UInt64 frame);
+
+private:
+  friend class SharedMemoryFrame;
+  SharedMemoryReader(const SharedMemoryReader &) = delete;
+  SharedMemoryReader &operator=(const SharedMemoryReader &) = delete;
+
+  std::string name_;
+  std::vector<SharedMemoryChannel> channels_;
+  UInt32 slots_ = 0u;
+  size_t size_ = 0u;
+  bool acknowledging_;
+  const Byte *map_ = nullptr;
+};
+
+} // namespace htm
+
+#endif // NTA_SHARED_MEMORY_HPP
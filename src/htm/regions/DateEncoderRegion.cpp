@@ -144,11 +144,24 @@ Dimensions DateEncoderRegion::askImplForOutputDimensions(const std::string &name
 }
 
 void DateEncoderRegion::compute() {
-  if (hasInput("values")) {
-    Array &a = getInput("values")->getData();
-    sensedTime_ = (time_t)((Int64 *)(a.getBuffer()))[0];
+  const Array *values = hasInput("values") ? &getInput("values")->getData() : nullptr;
+  encode_(values, getOutput("encoded")->getData().getSDR(), getOutput("bucket")->getData());
+}
+
+void DateEncoderRegion::computeBatch(size_t k) {
+  // The rows are encoded in order, so the noise is the same as with compute().
+  std::vector<Array> *values = hasInput("values") ? &getBatchInput("values") : nullptr;
+  std::vector<Array> &encoded = getBatchOutput("encoded");
+  std::vector<Array> &bucket  = getBatchOutput("bucket");
+  for (size_t i = 0; i < k; i++) {
+    encode_(values ? &(*values)[i] : nullptr, encoded[i].getSDR(), bucket[i]);
+  }
+}
+
+void DateEncoderRegion::encode_(const Array *values, SDR &output, Array &bucket_array) {
+  if (values != nullptr) {
+    sensedTime_ = (time_t)((const Int64 *)(values->getBuffer()))[0];
   }
-  SDR &output = getOutput("encoded")->getData().getSDR();
   encoder_->encode(sensedTime_, output);
 
   // Add some noise.
@@ -157,7 +170,6 @@ void DateEncoderRegion::compute() {
     output.addNoise(noise_, rnd_);
 
   // get the bucket values for each attribute configured.
-  Array &bucket_array = getOutput("bucket")->getData();
   Real64 *ptr = reinterpret_cast<Real64*>(bucket_array.getBuffer());
   for (size_t i = 0; i < encoder_->buckets.size(); i++) {
     ptr[i] = encoder_->buckets[i];
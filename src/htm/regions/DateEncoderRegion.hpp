@@ -62,6 +62,9 @@ public:
   virtual void initialize() override;
 
   void compute() override;
+  bool isPure() const override { return noise_ == 0.0f; } // noise uses the rng
+  bool isBatchable() const override { return true; }
+  void computeBatch(size_t k) override;
 
   virtual Dimensions askImplForOutputDimensions(const std::string &name) override;
 
@@ -95,6 +98,9 @@ public:
   }
 
 private:
+  // Encodes the values input, or sensedTime if values is null.
+  void encode_(const Array *values, SDR &encoded, Array &bucket);
+
   time_t sensedTime_;
   Real32 noise_;
   Random rnd_;
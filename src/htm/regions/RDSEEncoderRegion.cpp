@@ -103,15 +103,28 @@ Dimensions RDSEEncoderRegion::askImplForOutputDimensions(const std::string &name
 }
 
 void RDSEEncoderRegion::compute() {
-  if (hasInput("values")) {
-    Array &a = getInput("values")->getData();
-    sensedValue_ = ((Real64 *)(a.getBuffer()))[0];
+  const Array *values = hasInput("values") ? &getInput("values")->getData() : nullptr;
+  encode_(values, getOutput("encoded")->getData().getSDR(), getOutput("bucket")->getData());
+}
+
+void RDSEEncoderRegion::computeBatch(size_t k) {
+  // The rows are encoded in order, so the noise is the same as with compute().
+  std::vector<Array> *values = hasInput("values") ? &getBatchInput("values") : nullptr;
+  std::vector<Array> &encoded = getBatchOutput("encoded");
+  std::vector<Array> &bucket  = getBatchOutput("bucket");
+  for (size_t i = 0; i < k; i++) {
+    encode_(values ? &(*values)[i] : nullptr, encoded[i].getSDR(), bucket[i]);
+  }
+}
+
+void RDSEEncoderRegion::encode_(const Array *values, SDR &output, Array &bucket) {
+  if (values != nullptr) {
+    sensedValue_ = ((const Real64 *)(values->getBuffer()))[0];
   }
   if (!std::isfinite(sensedValue_))
     sensedValue_ = 0;  // prevents an exception in case of nan or inf
   //std::cout << "RDSEEncoderRegion compute() sensedValue=" << sensedValue_ << std::endl;
 
-  SDR &output = getOutput("encoded")->getData().getSDR();
   encoder_->encode((Real64)sensedValue_, output);
 
   // Add some noise.
@@ -123,7 +136,7 @@ void RDSEEncoderRegion::compute() {
   // This is a quantification of the data being encoded (the sample) 
   // and becomes the title in the Classifier.
   if (encoder_->parameters.radius != 0.0f) {
-    Real64 *buf = (Real64 *)getOutput("bucket")->getData().getBuffer();
+    Real64 *buf = (Real64 *)bucket.getBuffer();
     buf[0] = sensedValue_ - std::fmod(sensedValue_, encoder_->parameters.radius);
     //std::cout << "RDSEEncoderRegion compute() bucket=" << buf[0] << std::endl;
   }
@@ -31,6 +31,7 @@
 #include <htm/ntypes/Array.hpp>
 #include <htm/ntypes/ArrayBase.hpp>
 #include <htm/regions/SPRegion.hpp>
+#include <htm/utils/Counters.hpp>
 #include <htm/utils/Log.hpp>
 
 #define VERSION 1 // version for streaming serialization format
@@ -81,6 +82,16 @@ SPRegion::SPRegion(ArWrapper &wrapper, Region *region)
 }
 
 
+SPRegion::SPRegion(const SPRegion &other)
+  : RegionImpl(other), args_(other.args_), computeCallback_(nullptr),
+    spatialImp_(other.spatialImp_),
+    sp_(other.sp_ ? new SpatialPooler(*other.sp_) : nullptr) {}
+
+std::shared_ptr<const RegionImpl> SPRegion::snapshot() const {
+  return std::shared_ptr<const RegionImpl>(new SPRegion(*this));
+}
+
+
 SPRegion::~SPRegion() {}
 
 void SPRegion::initialize() {
@@ -164,6 +175,18 @@ void SPRegion::compute() {
 
 }
 
+void SPRegion::computeBatch(size_t k) {
+  NTA_ASSERT(sp_) << "SP not initialized";
+
+  std::vector<Array> &input  = getBatchInput("bottomUpIn");
+  std::vector<Array> &output = getBatchOutput("bottomUpOut");
+  for (size_t i = 0; i < k; i++) {
+    if (computeCallback_ != nullptr)
+      computeCallback_(getName());
+    sp_->compute(input[i].getSDR(), args_.learningMode, output[i].getSDR());
+  }
+}
+
 std::string SPRegion::executeCommand(const std::vector<std::string> &args, Int64 index) {
 
   UInt32 argCount = (UInt32)args.size();
@@ -184,6 +207,15 @@ std::string SPRegion::executeCommand(const std::vector<std::string> &args, Int64
 
     return "done";
   }
+  if (command == "getCounters") {
+    NTA_CHECK(sp_) << "SPRegion: " << command << " before initialization";
+    return countersToJSON(sp_->getCounters());
+  }
+  if (command == "resetCounters") {
+    NTA_CHECK(sp_) << "SPRegion: " << command << " before initialization";
+    sp_->resetCounters();
+    return "done";
+  }
   NTA_THROW << "SPRegion - Unknown command:" << command;
 }
 
@@ -522,6 +554,15 @@ Spec *SPRegion::createSpec() {
           "0",                             // defaultValue
           ParameterSpec::ReadOnlyAccess)); // access
 
+  ns->parameters.add(
+      "numSynapses",
+      ParameterSpec("Number of synapses in the spatial pooler. 0 before initialization.",
+          NTA_BasicType_UInt64,            // type
+          1,                               // elementCount
+          "",                              // constraints
+          "",                              // defaultValue
+          ParameterSpec::ReadOnlyAccess)); // access
+
 
   ns->parameters.add("spatialImp",
       ParameterSpec("SpatialPooler type or option. not used.",
@@ -558,7 +599,12 @@ Spec *SPRegion::createSpec() {
 
 
   /* ----- commands ------ */
-  // commands TBD
+  ns->commands.add("saveConnectionsToFile",
+                   CommandSpec("Save the Connections to the file <path>.dump"));
+  ns->commands.add("getCounters",
+                   CommandSpec("Returns the hot-path counters as a JSON object. "
+                               "Empty unless built with HTM_COUNTERS."));
+  ns->commands.add("resetCounters", CommandSpec("Zero the hot-path counters."));
 
   return ns;
 }
@@ -652,6 +698,9 @@ UInt64 SPRegion::getParameterUInt64(const std::string &name, Int64 index) const
   if (name == "computeCallback") {
     return (UInt64)computeCallback_;
   }
+  if (name == "numSynapses") {
+    return (sp_) ? (UInt64)sp_->connections.numSynapses() : 0u;
+  }
   return this->RegionImpl::getParameterUInt64(name, index); // default
 }
 
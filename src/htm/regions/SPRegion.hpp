@@ -56,6 +56,13 @@ class SPRegion  : public RegionImpl, Serializable
 
     // Compute outputs from inputs and internal state
     void compute() override;
+    // Not pure, even without learning: compute() advances the iteration
+    // counter of the SP and calls computeCallback_.
+    bool isPure() const override { return false; }
+    // The SP depends only on its input, so learning works in batches too.
+    bool isBatchable() const override { return true; }
+    std::shared_ptr<const RegionImpl> snapshot() const override;
+    void computeBatch(size_t k) override;
     std::string executeCommand(const std::vector<std::string>& args, Int64 index) override;
 
     /**
@@ -158,6 +165,7 @@ class SPRegion  : public RegionImpl, Serializable
 	
 private:
     SPRegion() = delete;  // empty constructor not allowed
+    SPRegion(const SPRegion &other); // deep copy, for snapshot()
 
     struct {
       UInt inputWidth;
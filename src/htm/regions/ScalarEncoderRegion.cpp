@@ -101,19 +101,33 @@ std::string ScalarEncoderRegion::executeCommand(const std::vector<std::string> &
 
 void ScalarEncoderRegion::compute()
 {
-  if (hasInput("values")) {
-    Array &a = getInput("values")->getData();
-    sensedValue_ = ((Real64 *)(a.getBuffer()))[0];
+  const Array *values = hasInput("values") ? &getInput("values")->getData() : nullptr;
+  encode_(values, getOutput("encoded")->getData().getSDR(), getOutput("bucket")->getData());
+
+  // trace facility
+  NTA_DEBUG << "compute " << getOutput("encoded") << std::endl;
+}
+
+void ScalarEncoderRegion::computeBatch(size_t k)
+{
+  std::vector<Array> *values = hasInput("values") ? &getBatchInput("values") : nullptr;
+  std::vector<Array> &encoded = getBatchOutput("encoded");
+  std::vector<Array> &bucket  = getBatchOutput("bucket");
+  for (size_t i = 0; i < k; i++) {
+    encode_(values ? &(*values)[i] : nullptr, encoded[i].getSDR(), bucket[i]);
   }
-  SDR &output = getOutput("encoded")->getData().getSDR();
-  encoder_->encode((Real64)sensedValue_, output);
+}
+
+void ScalarEncoderRegion::encode_(const Array *values, SDR &encoded, Array &bucket)
+{
+  if (values != nullptr) {
+    sensedValue_ = ((const Real64 *)(values->getBuffer()))[0];
+  }
+  encoder_->encode((Real64)sensedValue_, encoded);
 
   // create the quantized sample or bucket. This becomes the title in the ClassifierRegion.
-  Real64 *quantizedSample = (Real64*)getOutput("bucket")->getData().getBuffer();
+  Real64 *quantizedSample = (Real64*)bucket.getBuffer();
   quantizedSample[0] = sensedValue_ - std::fmod(sensedValue_, encoder_->parameters.radius);
-
-  // trace facility
-  NTA_DEBUG << "compute " << getOutput("encoded") << std::endl;
 }
 
 ScalarEncoderRegion::~ScalarEncoderRegion() {}
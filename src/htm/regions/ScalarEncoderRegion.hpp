@@ -57,6 +57,9 @@ public:
   virtual void initialize() override;
 
   void compute() override;
+  bool isPure() const override { return true; }
+  bool isBatchable() const override { return true; }
+  void computeBatch(size_t k) override;
   virtual std::string executeCommand(const std::vector<std::string> &args,
                                      Int64 index) override;
 
@@ -107,6 +110,9 @@ public:
   }
 
 private:
+  // Encodes the values input, or sensedValue if values is null.
+  void encode_(const Array *values, SDR &encoded, Array &bucket);
+
   Real64 sensedValue_;
   ScalarEncoderParameters params_;
 
@@ -0,0 +1,274 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation for SharedMemoryInputRegion class
+ */
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <htm/engine/Output.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/engine/Spec.hpp>
+#include <htm/regions/SharedMemoryInputRegion.hpp>
+#include <htm/utils/Log.hpp>
+
+namespace htm {
+
+namespace {
+  // How often compute() checks, while it waits, that the writer is running.
+  const UInt32 CHECK_MS = 100u;
+
+  // The output which receives each channel of a SharedMemoryOutputRegion.
+  std::string outputOf(const std::string &channel) {
+    if (channel == "dataIn") return "dataOut";
+    if (channel == "sdrIn")  return "sdrOut";
+    return "";
+  }
+} // namespace
+
+SharedMemoryInputRegion::SharedMemoryInputRegion(const ValueMap &params, Region *region)
+    : RegionImpl(region), next_(0u) {
+  name_    = params.getString("name", "");
+  timeout_ = params.getScalarT<UInt32>("timeout", 10000u);
+}
+
+SharedMemoryInputRegion::SharedMemoryInputRegion(ArWrapper &wrapper, Region *region)
+    : RegionImpl(region), timeout_(10000u), next_(0u) {
+  cereal_adapter_load(wrapper);
+}
+
+SharedMemoryInputRegion::~SharedMemoryInputRegion() {}
+
+void SharedMemoryInputRegion::open_() {
+  if (reader_)
+    return;
+  NTA_CHECK(!name_.empty()) << "SharedMemoryInputRegion " << getName() << ": parameter 'name' is required.";
+  // The writer may not have created the ring yet, and a ring left by a
+  // writer which is no longer running, such as a crashed run, is skipped
+  // until a new writer replaces it.
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_);
+  std::string error = "its writer is not running";
+  while (!reader_) {
+    try {
+      std::unique_ptr<SharedMemoryReader> reader(new SharedMemoryReader(name_, true));
+      if (reader->isCurrent())
+        reader_ = std::move(reader);
+    } catch (Exception &e) {
+      error = e.getMessage();
+    }
+    if (!reader_) {
+      NTA_CHECK(timeout_ == 0u || std::chrono::steady_clock::now() < deadline)
+          << "SharedMemoryInputRegion " << getName() << ": cannot read '" << name_
+          << "' within " << timeout_ << " ms, " << error;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  // Continue after the frames consumed by an earlier reader.
+  next_ = reader_->getAcknowledgedCount();
+}
+
+void SharedMemoryInputRegion::reopen_() {
+  std::unique_ptr<SharedMemoryReader> reader;
+  try {
+    reader.reset(new SharedMemoryReader(name_, true));
+  } catch (Exception &) {
+    return; // not created again yet
+  }
+  if (!reader->isCurrent())
+    return;
+  // The outputs were sized by the old writer.
+  const auto &before = reader_->getChannels();
+  const auto &after = reader->getChannels();
+  bool same = before.size() == after.size();
+  for (size_t i = 0u; same && i < before.size(); i++) {
+    same = before[i].name == after[i].name && before[i].type == after[i].type &&
+           before[i].count == after[i].count;
+  }
+  NTA_CHECK(same) << "SharedMemoryInputRegion " << getName() << ": the writer of '" << name_
+                  << "' was restarted with other channels.";
+  reader_ = std::move(reader);
+  next_ = reader_->getAcknowledgedCount();
+}
+
+Dimensions SharedMemoryInputRegion::askImplForOutputDimensions(const std::string &name) {
+  open_();
+  for (const auto &ch : reader_->getChannels()) {
+    if (outputOf(ch.name) == name)
+      return Dimensions(static_cast<UInt>(ch.count));
+  }
+  return Dimensions(1u); // not published by the writer, never written
+}
+
+void SharedMemoryInputRegion::initialize() {
+  open_();
+}
+
+void SharedMemoryInputRegion::compute() {
+  NTA_CHECK(reader_) << "SharedMemoryInputRegion: not initialized";
+  // Wait in steps, to follow a writer which was restarted and so replaced
+  // the ring; its frames count from 0 again.
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_);
+  const UInt32 step = (timeout_ > 0u && timeout_ < CHECK_MS) ? timeout_ : CHECK_MS;
+  while (!reader_->waitFor(next_, step)) {
+    if (!reader_->isCurrent())
+      reopen_();
+    NTA_CHECK(timeout_ == 0u || std::chrono::steady_clock::now() < deadline)
+        << "SharedMemoryInputRegion " << getName() << ": no frame " << next_ << " from '"
+        << name_ << "' within " << timeout_ << " ms.";
+  }
+  SharedMemoryFrame frame;
+  NTA_CHECK(reader_->read(next_, frame))
+      << "SharedMemoryInputRegion " << getName() << ": frame " << next_ << " of '" << name_
+      << "' was overwritten; use a writer with flowControl.";
+
+  const auto &channels = reader_->getChannels();
+  for (size_t i = 0u; i < channels.size(); i++) {
+    const std::string output = outputOf(channels[i].name);
+    if (output.empty())
+      continue;
+    Array &data = getOutput(output)->getData();
+    if (data.getType() == NTA_BasicType_SDR) {
+      SDR &sdr = data.getSDR();
+      const Byte *dense = static_cast<const Byte *>(frame.getChannel(i));
+      SDR_dense_t &buffer = sdr.getDense();
+      buffer.assign(dense, dense + sdr.size);
+      sdr.setDense(buffer);
+    } else {
+      std::memcpy(data.getBuffer(), frame.getChannel(i), data.getCount() * sizeof(Real64));
+    }
+  }
+  NTA_CHECK(reader_->isValid(frame))
+      << "SharedMemoryInputRegion " << getName() << ": frame " << next_ << " of '" << name_
+      << "' was overwritten while reading; use a writer with flowControl.";
+  reader_->acknowledge(next_);
+  next_++;
+}
+
+void SharedMemoryInputRegion::setParameterString(const std::string &paramName,
+                                                 Int64 index, const std::string &s) {
+  if (paramName == "name") {
+    NTA_CHECK(!reader_) << "SharedMemoryInputRegion: 'name' cannot be changed after initialize.";
+    name_ = s;
+  } else {
+    NTA_THROW << "SharedMemoryInputRegion -- Unknown string parameter " << paramName;
+  }
+}
+
+std::string SharedMemoryInputRegion::getParameterString(const std::string &paramName,
+                                                        Int64 index) const {
+  if (paramName == "name") {
+    return name_;
+  }
+  NTA_THROW << "SharedMemoryInputRegion -- unknown parameter " << paramName;
+}
+
+void SharedMemoryInputRegion::setParameterUInt32(const std::string &paramName,
+                                                 Int64 index, UInt32 value) {
+  if (paramName == "timeout") {
+    timeout_ = value;
+  } else {
+    RegionImpl::setParameterUInt32(paramName, index, value);
+  }
+}
+
+UInt32 SharedMemoryInputRegion::getParameterUInt32(const std::string &paramName,
+                                                   Int64 index) const {
+  if (paramName == "timeout") {
+    return timeout_;
+  }
+  return RegionImpl::getParameterUInt32(paramName, index);
+}
+
+UInt64 SharedMemoryInputRegion::getParameterUInt64(const std::string &paramName,
+                                                   Int64 index) const {
+  if (paramName == "frameCount") {
+    return next_;
+  }
+  return RegionImpl::getParameterUInt64(paramName, index);
+}
+
+Spec *SharedMemoryInputRegion::createSpec() {
+
+  auto ns = new Spec;
+  ns->name = "SharedMemoryInputRegion";
+  ns->description =
+      "SharedMemoryInputRegion reads the frames of a SharedMemoryOutputRegion "
+      "in another process, one per compute, in order.  The pair carries a "
+      "Link between the partitions of a Network.\n";
+
+  ns->outputs.add("dataOut",
+              OutputSpec("The channel 'dataIn' of the writer.",
+                         NTA_BasicType_Real64,
+                         0,     // count is determined by the writer
+                         false, // isRegionLevel
+                         true   // isDefaultOutput
+                         ));
+
+  ns->outputs.add("sdrOut",
+              OutputSpec("The channel 'sdrIn' of the writer.",
+                         NTA_BasicType_SDR,
+                         0,     // count is determined by the writer
+                         false, // isRegionLevel
+                         false  // isDefaultOutput
+                         ));
+
+  ns->parameters.add("name",
+              ParameterSpec("Name of the shared memory object of the writer.",
+                            NTA_BasicType_Byte,
+                            0,  // elementCount
+                            "", // constraints
+                            "", // defaultValue
+                            ParameterSpec::CreateAccess));
+
+  ns->parameters.add("timeout",
+              ParameterSpec("How long to wait for the writer, to create the "
+                            "ring and to publish each frame, in milliseconds. "
+                            "0 waits forever.",
+                            NTA_BasicType_UInt32,
+                            1,       // elementCount
+                            "",      // constraints
+                            "10000", // defaultValue
+                            ParameterSpec::ReadWriteAccess));
+
+  ns->parameters.add("frameCount",
+              ParameterSpec("Number of frames read so far from the current "
+                            "writer of the ring.",
+                            NTA_BasicType_UInt64,
+                            1,   // elementCount
+                            "",  // constraints
+                            "0", // defaultValue
+                            ParameterSpec::ReadOnlyAccess));
+
+  return ns;
+}
+
+
+bool SharedMemoryInputRegion::operator==(const RegionImpl &o) const {
+  if (o.getType() != "SharedMemoryInputRegion") return false;
+  SharedMemoryInputRegion& other = (SharedMemoryInputRegion&)o;
+  if (name_ != other.name_) return false;
+  if (timeout_ != other.timeout_) return false;
+
+  return true;
+}
+
+} // namespace htm
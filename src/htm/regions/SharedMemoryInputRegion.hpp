@@ -0,0 +1,123 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Declarations for SharedMemoryInputRegion class
+ */
+
+//----------------------------------------------------------------------
+
+#ifndef NTA_SHARED_MEMORY_INPUT_REGION_HPP
+#define NTA_SHARED_MEMORY_INPUT_REGION_HPP
+
+//----------------------------------------------------------------------
+
+#include <memory>
+
+#include <htm/engine/RegionImpl.hpp>
+#include <htm/ntypes/Value.hpp>
+#include <htm/os/SharedMemory.hpp>
+#include <htm/types/Serializable.hpp>
+#include <htm/types/Types.hpp>
+
+namespace htm {
+
+
+/**
+ *  SharedMemoryInputRegion is the receiving end of a SharedMemoryOutputRegion
+ *  in another process.  Together they carry a Link between two Networks.
+ *
+ *  Each compute() waits for the next frame of the ring, copies the channel
+ *  'dataIn' of the writer to the output 'dataOut' (Real64) and the channel
+ *  'sdrIn' to 'sdrOut' (SDR), and acknowledges the frame.  Frames are read
+ *  in order, none is skipped; a writer with 'flowControl' waits for them
+ *  to be consumed.
+ *
+ *  The output dimensions come from the writer, so the ring must exist when
+ *  the Network is initialized; initialize() waits up to 'timeout' for it.
+ *  A ring whose writer is no longer running, such as one left by a crashed
+ *  run, is not used.  If the writer is restarted while compute() waits,
+ *  the region continues with the ring of the new writer, from its first
+ *  frame.
+ *  Networks that feed each other in a cycle cannot be connected this way.
+ */
+class SharedMemoryInputRegion : public RegionImpl, Serializable {
+public:
+  static Spec *createSpec();
+  Dimensions askImplForOutputDimensions(const std::string &name) override;
+  void setParameterString(const std::string &name, Int64 index,
+                          const std::string &s) override;
+  std::string getParameterString(const std::string &name, Int64 index) const override;
+  void setParameterUInt32(const std::string &name, Int64 index, UInt32 value) override;
+  UInt32 getParameterUInt32(const std::string &name, Int64 index) const override;
+  UInt64 getParameterUInt64(const std::string &name, Int64 index) const override;
+
+  void initialize() override;
+
+  SharedMemoryInputRegion(const ValueMap &params, Region *region);
+
+  SharedMemoryInputRegion(ArWrapper& wrapper, Region *region);
+
+  virtual ~SharedMemoryInputRegion();
+
+
+  CerealAdapter;  // see Serializable.hpp
+  // FOR Cereal Serialization
+  template<class Archive>
+  void save_ar(Archive& ar) const {
+    ar(cereal::make_nvp("name", name_));
+    ar(cereal::make_nvp("timeout", timeout_));
+    ar(CEREAL_NVP(dim_));  // in base class
+  }
+
+  // FOR Cereal Deserialization
+  // The ring is opened again by initialize(), reading from its next frame.
+  template<class Archive>
+  void load_ar(Archive& ar) {
+    ar(cereal::make_nvp("name", name_));
+    ar(cereal::make_nvp("timeout", timeout_));
+    ar(CEREAL_NVP(dim_));  // in base class
+  }
+
+  bool operator==(const RegionImpl &other) const override;
+  inline bool operator!=(const SharedMemoryInputRegion &other) const {
+    return !operator==(other);
+  }
+
+  void compute() override;
+
+private:
+  void open_();
+  // Switch to the ring of a restarted writer, if there is one.
+  void reopen_();
+
+  std::string name_;   // shared memory object name
+  UInt32 timeout_;     // milliseconds to wait for the writer
+  UInt64 next_;        // the next frame to read
+  std::unique_ptr<SharedMemoryReader> reader_;
+
+  /// Disable unsupported default constructors
+  SharedMemoryInputRegion(const SharedMemoryInputRegion &);
+  SharedMemoryInputRegion &operator=(const SharedMemoryInputRegion &);
+
+}; // end class SharedMemoryInputRegion
+
+//----------------------------------------------------------------------
+
+} // namespace htm
+
+#endif // NTA_SHARED_MEMORY_INPUT_REGION_HPP
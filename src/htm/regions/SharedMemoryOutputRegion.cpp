@@ -0,0 +1,268 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation for SharedMemoryOutputRegion class
+ */
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#if !defined(NTA_OS_WINDOWS)
+#include <unistd.h>
+#endif
+
+#include <htm/engine/Input.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/engine/Spec.hpp>
+#include <htm/regions/SharedMemoryOutputRegion.hpp>
+#include <htm/utils/Log.hpp>
+
+namespace htm {
+
+namespace {
+  // Numbers the regions of this process, for their default ring names.
+  std::atomic<UInt64> instances(0u);
+
+  UInt64 processId() {
+#if defined(NTA_OS_WINDOWS)
+    return 0u; // shared memory is not available
+#else
+    return static_cast<UInt64>(getpid());
+#endif
+  }
+} // namespace
+
+SharedMemoryOutputRegion::SharedMemoryOutputRegion(const ValueMap &params, Region *region)
+    : RegionImpl(region), instance_(++instances) {
+  name_  = params.getString("name", "");
+  slots_ = params.getScalarT<UInt32>("slots", 16u);
+  flowControl_ = params.getScalarT<bool>("flowControl", false);
+  timeout_ = params.getScalarT<UInt32>("timeout", 10000u);
+}
+
+SharedMemoryOutputRegion::SharedMemoryOutputRegion(ArWrapper &wrapper, Region *region)
+    : RegionImpl(region), slots_(16u), flowControl_(false), timeout_(10000u),
+      instance_(++instances) {
+  cereal_adapter_load(wrapper);
+}
+
+SharedMemoryOutputRegion::~SharedMemoryOutputRegion() {}
+
+std::string SharedMemoryOutputRegion::shmName_() const {
+  // Unique to this region, so that Networks which run at the same time, in
+  // one process or several, do not replace each other's rings.
+  if (name_.empty())
+    return "/htm." + std::to_string(processId()) + "." + std::to_string(instance_) + "." + getName();
+  return name_;
+}
+
+void SharedMemoryOutputRegion::initialize() {
+  NTA_CHECK(region_ != nullptr);
+  // One channel for each input with links.
+  std::vector<SharedMemoryChannel> channels;
+  channels_.clear();
+  for (const std::string inputName : {"dataIn", "sdrIn"}) {
+    std::shared_ptr<Input> in = region_->getInput(inputName);
+    if (!in->hasIncomingLinks())
+      continue;
+    const Array &data = in->getData();
+    channels.push_back({inputName, data.getType(), data.getCount(), 0u});
+    channels_.push_back(inputName);
+  }
+  if (channels_.empty()) {
+    NTA_THROW << "SharedMemoryOutputRegion::init - no input Data found\n";
+  }
+  writer_.reset(new SharedMemoryWriter(shmName_(), channels, slots_, flowControl_));
+  writer_->setTimeout(timeout_);
+}
+
+void SharedMemoryOutputRegion::compute() {
+  NTA_CHECK(writer_) << "SharedMemoryOutputRegion: not initialized";
+  std::vector<const void *> data;
+  for (const auto &name : channels_)
+    data.push_back(region_->getInput(name)->getData().getBuffer());
+  writer_->publish(data);
+}
+
+void SharedMemoryOutputRegion::setParameterString(const std::string &paramName,
+                                                  Int64 index, const std::string &s) {
+  if (paramName == "name") {
+    NTA_CHECK(!writer_) << "SharedMemoryOutputRegion: 'name' cannot be changed after initialize.";
+    name_ = s;
+  } else {
+    NTA_THROW << "SharedMemoryOutputRegion -- Unknown string parameter " << paramName;
+  }
+}
+
+std::string SharedMemoryOutputRegion::getParameterString(const std::string &paramName,
+                                                         Int64 index) const {
+  if (paramName == "name") {
+    return shmName_();
+  }
+  NTA_THROW << "SharedMemoryOutputRegion -- unknown parameter " << paramName;
+}
+
+void SharedMemoryOutputRegion::setParameterUInt32(const std::string &paramName,
+                                                  Int64 index, UInt32 value) {
+  if (paramName == "slots") {
+    NTA_CHECK(!writer_) << "SharedMemoryOutputRegion: 'slots' cannot be changed after initialize.";
+    NTA_CHECK(value > 0u) << "SharedMemoryOutputRegion: 'slots' must be > 0.";
+    slots_ = value;
+  } else if (paramName == "timeout") {
+    timeout_ = value;
+    if (writer_)
+      writer_->setTimeout(timeout_);
+  } else {
+    RegionImpl::setParameterUInt32(paramName, index, value);
+  }
+}
+
+UInt32 SharedMemoryOutputRegion::getParameterUInt32(const std::string &paramName,
+                                                    Int64 index) const {
+  if (paramName == "slots") {
+    return slots_;
+  }
+  if (paramName == "timeout") {
+    return timeout_;
+  }
+  return RegionImpl::getParameterUInt32(paramName, index);
+}
+
+void SharedMemoryOutputRegion::setParameterBool(const std::string &paramName,
+                                                Int64 index, bool value) {
+  if (paramName == "flowControl") {
+    NTA_CHECK(!writer_) << "SharedMemoryOutputRegion: 'flowControl' cannot be changed after initialize.";
+    flowControl_ = value;
+  } else {
+    RegionImpl::setParameterBool(paramName, index, value);
+  }
+}
+
+bool SharedMemoryOutputRegion::getParameterBool(const std::string &paramName,
+                                                Int64 index) const {
+  if (paramName == "flowControl") {
+    return flowControl_;
+  }
+  return RegionImpl::getParameterBool(paramName, index);
+}
+
+UInt64 SharedMemoryOutputRegion::getParameterUInt64(const std::string &paramName,
+                                                    Int64 index) const {
+  if (paramName == "frameCount") {
+    return writer_ ? writer_->getFrameCount() : 0u;
+  }
+  return RegionImpl::getParameterUInt64(paramName, index);
+}
+
+Spec *SharedMemoryOutputRegion::createSpec() {
+
+  auto ns = new Spec;
+  ns->name = "SharedMemoryOutputRegion";
+  ns->description =
+      "SharedMemoryOutputRegion publishes its inputs each compute into a "
+      "POSIX shared memory ring buffer, for local consumers such as "
+      "dashboards.  Read it with SharedMemoryReader.\n";
+
+  ns->inputs.add("dataIn",
+              InputSpec("Values to publish, the channel 'dataIn'",
+                        NTA_BasicType_Real64,
+                        0,     // count
+                        false, // required?
+                        true,  // isRegionLevel
+                        true   // isDefaultInput
+                        ));
+
+  ns->inputs.add("sdrIn",
+              InputSpec("SDR to publish in dense format, the channel 'sdrIn'",
+                        NTA_BasicType_SDR,
+                        0,     // count
+                        false, // required?
+                        true,  // isRegionLevel
+                        false  // isDefaultInput
+                        ));
+
+  ns->parameters.add("name",
+              ParameterSpec("Name of the shared memory object.  The default "
+                            "is '/htm.<process id>.<number>.<region name>', "
+                            "unique to the region.",
+                            NTA_BasicType_Byte,
+                            0,  // elementCount
+                            "", // constraints
+                            "", // defaultValue
+                            ParameterSpec::ReadWriteAccess));
+
+  ns->parameters.add("slots",
+              ParameterSpec("Number of frames in the ring buffer.  A reader "
+                            "must keep up within this many iterations.",
+                            NTA_BasicType_UInt32,
+                            1,    // elementCount
+                            "",   // constraints
+                            "16", // defaultValue
+                            ParameterSpec::ReadWriteAccess));
+
+  ns->parameters.add("flowControl",
+              ParameterSpec("If true, a single reader acknowledges the frames "
+                            "and compute() waits rather than overwrite a frame "
+                            "which was not consumed.",
+                            NTA_BasicType_Bool,
+                            1,       // elementCount
+                            "",      // constraints
+                            "false", // defaultValue
+                            ParameterSpec::ReadWriteAccess));
+
+  ns->parameters.add("timeout",
+              ParameterSpec("With flowControl, how long compute() waits for the "
+                            "reader, in milliseconds.  0 waits forever.",
+                            NTA_BasicType_UInt32,
+                            1,       // elementCount
+                            "",      // constraints
+                            "10000", // defaultValue
+                            ParameterSpec::ReadWriteAccess));
+
+  ns->parameters.add("frameCount",
+              ParameterSpec("Number of frames published so far.",
+                            NTA_BasicType_UInt64,
+                            1,   // elementCount
+                            "",  // constraints
+                            "0", // defaultValue
+                            ParameterSpec::ReadOnlyAccess));
+
+  return ns;
+}
+
+size_t
+SharedMemoryOutputRegion::getNodeOutputElementCount(const std::string &outputName) const {
+  NTA_THROW
+      << "SharedMemoryOutputRegion::getNodeOutputElementCount -- unknown output '"
+      << outputName << "'";
+}
+
+
+bool SharedMemoryOutputRegion::operator==(const RegionImpl &o) const {
+  if (o.getType() != "SharedMemoryOutputRegion") return false;
+  SharedMemoryOutputRegion& other = (SharedMemoryOutputRegion&)o;
+  if (name_ != other.name_) return false;
+  if (slots_ != other.slots_) return false;
+  if (flowControl_ != other.flowControl_) return false;
+  if (timeout_ != other.timeout_) return false;
+
+  return true;
+}
+
+} // namespace htm
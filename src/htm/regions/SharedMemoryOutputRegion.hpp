@@ -0,0 +1,132 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Declarations for SharedMemoryOutputRegion class
+ */
+
+//----------------------------------------------------------------------
+
+#ifndef NTA_SHARED_MEMORY_OUTPUT_REGION_HPP
+#define NTA_SHARED_MEMORY_OUTPUT_REGION_HPP
+
+//----------------------------------------------------------------------
+
+#include <memory>
+
+#include <htm/engine/RegionImpl.hpp>
+#include <htm/ntypes/Value.hpp>
+#include <htm/os/SharedMemory.hpp>
+#include <htm/types/Serializable.hpp>
+#include <htm/types/Types.hpp>
+
+namespace htm {
+
+
+/**
+ *  SharedMemoryOutputRegion publishes its inputs to other processes on the
+ *  same machine, through a POSIX shared memory ring buffer.
+ *
+ *  Link the outputs to publish to 'dataIn' (Real64, fan-in concatenates)
+ *  and/or 'sdrIn' (SDR, published in dense format).  Each compute() copies
+ *  the linked inputs into the next frame of the ring, one channel per input.
+ *  Consumers read the frames with a SharedMemoryReader (also available in
+ *  Python) without copies or serialization, see htm/os/SharedMemory.hpp.
+ *
+ *  The shared memory object is created by initialize() and removed when the
+ *  region is destroyed.  Its name is the 'name' parameter, by default
+ *  "/htm.<process id>.<number>.<region name>", which is unique to the
+ *  region; read it back with getParameterString("name").
+ *
+ *  With 'flowControl' the ring feeds a single SharedMemoryInputRegion in
+ *  another process, which acknowledges each frame: compute() then waits
+ *  rather than overwrite a frame which was not consumed.  Network::configure()
+ *  uses this pair for the links between partitions.
+ */
+class SharedMemoryOutputRegion : public RegionImpl, Serializable {
+public:
+  static Spec *createSpec();
+  size_t getNodeOutputElementCount(const std::string &outputName) const override;
+  void setParameterString(const std::string &name, Int64 index,
+                          const std::string &s) override;
+  std::string getParameterString(const std::string &name, Int64 index) const override;
+  void setParameterUInt32(const std::string &name, Int64 index, UInt32 value) override;
+  UInt32 getParameterUInt32(const std::string &name, Int64 index) const override;
+  void setParameterBool(const std::string &name, Int64 index, bool value) override;
+  bool getParameterBool(const std::string &name, Int64 index) const override;
+  UInt64 getParameterUInt64(const std::string &name, Int64 index) const override;
+
+  void initialize() override;
+
+  SharedMemoryOutputRegion(const ValueMap &params, Region *region);
+
+  SharedMemoryOutputRegion(ArWrapper& wrapper, Region *region);
+
+  virtual ~SharedMemoryOutputRegion();
+
+
+  CerealAdapter;  // see Serializable.hpp
+  // FOR Cereal Serialization
+  template<class Archive>
+  void save_ar(Archive& ar) const {
+    ar(cereal::make_nvp("name", name_));
+    ar(cereal::make_nvp("slots", slots_));
+    ar(cereal::make_nvp("flowControl", flowControl_));
+    ar(cereal::make_nvp("timeout", timeout_));
+    ar(CEREAL_NVP(dim_));  // in base class
+  }
+
+  // FOR Cereal Deserialization
+  // The ring is created again by initialize(), it starts empty.
+  template<class Archive>
+  void load_ar(Archive& ar) {
+    ar(cereal::make_nvp("name", name_));
+    ar(cereal::make_nvp("slots", slots_));
+    ar(cereal::make_nvp("flowControl", flowControl_));
+    ar(cereal::make_nvp("timeout", timeout_));
+    ar(CEREAL_NVP(dim_));  // in base class
+  }
+
+  bool operator==(const RegionImpl &other) const override;
+  inline bool operator!=(const SharedMemoryOutputRegion &other) const {
+    return !operator==(other);
+  }
+
+  void compute() override;
+
+private:
+  std::string shmName_() const;
+
+  std::string name_;   // shared memory object name, "" for the default
+  UInt32 slots_;       // frames in the ring
+  bool flowControl_;   // wait for the reader to acknowledge frames
+  UInt32 timeout_;     // milliseconds to wait for the reader
+  UInt64 instance_;    // numbers the regions of this process, for the default name
+  std::vector<std::string> channels_;   // the linked inputs
+  std::unique_ptr<SharedMemoryWriter> writer_;
+
+  /// Disable unsupported default constructors
+  SharedMemoryOutputRegion(const SharedMemoryOutputRegion &);
+  SharedMemoryOutputRegion &operator=(const SharedMemoryOutputRegion &);
+
+}; // end class SharedMemoryOutputRegion
+
+//----------------------------------------------------------------------
+
+} // namespace htm
+
+#endif // NTA_SHARED_MEMORY_OUTPUT_REGION_HPP
@@ -28,6 +28,7 @@
 
 #include <htm/engine/Spec.hpp>
 #include <htm/ntypes/Array.hpp>
+#include <htm/utils/Counters.hpp>
 #include <htm/utils/Log.hpp>
 #include <htm/utils/VectorHelpers.hpp>
 
@@ -75,6 +76,14 @@ TMRegion::TMRegion(ArWrapper& wrapper, Region *region)
   cereal_adapter_load(wrapper);
 }
 
+TMRegion::TMRegion(const TMRegion &other)
+    : RegionImpl(other), columnDimensions_(other.columnDimensions_), args_(other.args_),
+      computeCallback_(nullptr), tm_(other.tm_ ? new TemporalMemory(*other.tm_) : nullptr) {}
+
+std::shared_ptr<const RegionImpl> TMRegion::snapshot() const {
+  return std::shared_ptr<const RegionImpl>(new TMRegion(*this));
+}
+
 TMRegion::~TMRegion() {
 }
 
@@ -265,11 +274,10 @@ void TMRegion::compute() {
     NTA_DEBUG << "compute "<< *out << std::endl;
   
   out = getOutput("predictiveCells");
-    SDR predictive = tm_->getPredictiveCells();
     if (args_.orColumnOutputs)  // output as columns
-      out->getData().getSDR() = tm_->cellsToColumns(predictive);
+      tm_->getPredictiveColumns(out->getData().getSDR());
     else
-      out->getData().getSDR() = predictive;
+      tm_->getPredictiveCells(out->getData().getSDR());
     NTA_DEBUG << "compute " << *out << std::endl;
 }
 
@@ -294,6 +302,15 @@ std::string TMRegion::executeCommand(const std::vector<std::string> &args, Int64
 
     return "done";
   }
+  else if (command == "getCounters") {
+    NTA_CHECK(tm_) << "TMRegion: " << command << " before initialization";
+    return countersToJSON(tm_->getCounters());
+  }
+  else if (command == "resetCounters") {
+    NTA_CHECK(tm_) << "TMRegion: " << command << " before initialization";
+    tm_->resetCounters();
+    return "done";
+  }
   else
   NTA_THROW << "TMRegion - Unknown command:" << command;
 }
@@ -483,6 +500,15 @@ Spec *TMRegion::createSpec() {
                     "",                              // defaultValue
                     ParameterSpec::ReadOnlyAccess)); // access
 
+  ns->parameters.add(
+      "numSynapses",
+      ParameterSpec("(int) Number of synapses in the temporal memory. 0 before initialization.",
+                    NTA_BasicType_UInt64,            // type
+                    1,                               // elementCount
+                    "",                              // constraints
+                    "",                              // defaultValue
+                    ParameterSpec::ReadOnlyAccess)); // access
+
   ns->parameters.add(
       "anomaly",
       ParameterSpec("(Real) The anomaly Score computed for the current iteration. "
@@ -618,7 +644,12 @@ Spec *TMRegion::createSpec() {
 
 
   /* ----- commands ------ */
-  // commands TBD
+  ns->commands.add("saveConnectionsToFile",
+                   CommandSpec("Save the Connections to the file <path>.dump"));
+  ns->commands.add("getCounters",
+                   CommandSpec("Returns the hot-path counters as a JSON object. "
+                               "Empty unless built with HTM_COUNTERS."));
+  ns->commands.add("resetCounters", CommandSpec("Zero the hot-path counters."));
 
   return ns;
 }
@@ -685,6 +716,14 @@ UInt32 TMRegion::getParameterUInt32(const std::string &name, Int64 index) const
 }
 
 
+UInt64 TMRegion::getParameterUInt64(const std::string &name, Int64 index) const {
+  if (name == "numSynapses") {
+    return (tm_) ? (UInt64)tm_->connections.numSynapses() : 0u;
+  }
+  return this->RegionImpl::getParameterUInt64(name, index); // default
+}
+
+
 Int32 TMRegion::getParameterInt32(const std::string &name, Int64 index) const {
   if (name == "activationThreshold") {
     if (tm_)
@@ -38,7 +38,6 @@ class TMRegion : public RegionImpl, Serializable {
 
 public:
   TMRegion() = delete;
-  TMRegion(const TMRegion &) = delete;
   TMRegion(const ValueMap &params, Region *region);
   TMRegion(ArWrapper& wrapper, Region *region);
   virtual ~TMRegion();
@@ -137,6 +136,7 @@ public:
 
   /* -----------  Optional RegionImpl Interface methods ------- */
   UInt32 getParameterUInt32(const std::string &name, Int64 index) const override;
+  UInt64 getParameterUInt64(const std::string &name, Int64 index) const override;
   Int32 getParameterInt32(const std::string &name, Int64 index) const override;
   Real32 getParameterReal32(const std::string &name, Int64 index) const override;
   bool getParameterBool(const std::string &name, Int64 index) const override;
@@ -150,7 +150,11 @@ public:
 
   std::string executeCommand(const std::vector<std::string> &args, Int64 index) override;
 
+  std::shared_ptr<const RegionImpl> snapshot() const override;
+
 private:
+  TMRegion(const TMRegion &other); // deep copy, for snapshot()
+
   Dimensions columnDimensions_;
 
   // Note: to avoid deserialization problems due to differences in 
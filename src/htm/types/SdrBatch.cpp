@@ -0,0 +1,101 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * ---------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the SDRBatch class
+ */
+
+#include <htm/types/SdrBatch.hpp>
+
+using namespace std;
+
+namespace htm {
+
+    SDRBatch::SDRBatch( const vector<UInt> &dimensions )
+        : dimensions_( dimensions ) {
+        NTA_CHECK( not dimensions_.empty() ) << "SDRBatch: missing dimensions.";
+        sdrSize_ = 1u;
+        for( const UInt dim : dimensions_ )
+            sdrSize_ *= dim;
+    }
+
+    SDRBatch::SDRBatch( const vector<UInt>   &dimensions,
+                        SDR_sparse_t         &indices,
+                        vector<UInt64>       &offsets )
+        : SDRBatch( dimensions ) {
+        NTA_CHECK( not offsets.empty() and offsets.front() == 0u )
+            << "SDRBatch: offsets must start with zero.";
+        NTA_CHECK( offsets.back() == indices.size() )
+            << "SDRBatch: the last offset must equal the number of indices.";
+        for( size_t i = 1u; i < offsets.size(); i++ ) {
+            NTA_CHECK( offsets[i - 1u] <= offsets[i] )
+                << "SDRBatch: offsets must not decrease.";
+            checkSparse_( indices.data() + offsets[i - 1u],
+                          static_cast<size_t>(offsets[i] - offsets[i - 1u]) );
+        }
+        indices_.swap( indices );
+        offsets_.swap( offsets );
+    }
+
+    void SDRBatch::checkSparse_( const ElemSparse *sparse, size_t numActive ) const {
+        for( size_t i = 0u; i < numActive; i++ ) {
+            NTA_CHECK( sparse[i] < sdrSize_ )
+                << "SDRBatch: index " << sparse[i] << " is out of bounds of the SDR!";
+            NTA_CHECK( i == 0u or sparse[i - 1u] < sparse[i] )
+                << "SDRBatch: sparse data must be sorted and contain no duplicates!";
+        }
+    }
+
+    void SDRBatch::clear() {
+        indices_.clear();
+        offsets_.assign( 1u, 0u );
+    }
+
+    void SDRBatch::reserve( size_t numSDRs, size_t numActive ) {
+        offsets_.reserve( numSDRs + 1u );
+        indices_.reserve( numActive );
+    }
+
+    void SDRBatch::push_back( const SDR &sdr ) {
+        NTA_CHECK( sdr.dimensions == dimensions_ )
+            << "SDRBatch: SDR dimensions do not match the batch.";
+        // SDR's sparse data is already validated.
+        const auto &sparse = sdr.getSparse();
+        indices_.insert( indices_.end(), sparse.begin(), sparse.end() );
+        offsets_.push_back( indices_.size() );
+    }
+
+    void SDRBatch::push_back( const ElemSparse *sparse, size_t numActive ) {
+        checkSparse_( sparse, numActive );
+        indices_.insert( indices_.end(), sparse, sparse + numActive );
+        offsets_.push_back( indices_.size() );
+    }
+
+    void SDRBatch::get( size_t index, SDR &out ) const {
+        NTA_CHECK( index < size() ) << "SDRBatch: index " << index << " out of range.";
+        NTA_CHECK( out.dimensions == dimensions_ )
+            << "SDRBatch: SDR dimensions do not match the batch.";
+        out.setSparse( row( index ), static_cast<UInt>(rowSize( index )) );
+    }
+
+    bool SDRBatch::operator==( const SDRBatch &other ) const {
+        return dimensions_ == other.dimensions_ and
+               offsets_    == other.offsets_ and
+               indices_    == other.indices_;
+    }
+
+} // end namespace htm
@@ -0,0 +1,170 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * ---------------------------------------------------------------------- */
+
+/** @file
+ * Definitions for the SDRBatch class
+ */
+
+#ifndef SDR_BATCH_HPP
+#define SDR_BATCH_HPP
+
+#include <vector>
+
+#include <htm/types/Types.hpp>
+#include <htm/types/Sdr.hpp>
+#include <htm/types/Serializable.hpp>
+
+namespace htm {
+
+/**
+ * SDRBatch class
+ *
+ * ### Description
+ * A sequence of SDRs which all have the same dimensions, stored together in
+ * one compressed sparse row (CSR) buffer.  This is intended for handing many
+ * samples to the batch APIs at once, without allocating an SDR per sample.
+ *
+ *    indices: The sparse indices of every SDR in the batch, concatenated.
+ *    offsets: offsets[i] is where SDR number i starts in the indices, and
+ *             offsets[i+1] is where it ends.  There are size()+1 offsets and
+ *             the first one is always zero.
+ *
+ * Example usage:
+ *
+ *    SDRBatch batch({ 10 });
+ *    batch.push_back( sdrA );          // sparse { 1, 4 }
+ *    batch.push_back( sdrB );          // sparse { 2, 3, 9 }
+ *    batch.indices() -> { 1, 4, 2, 3, 9 }
+ *    batch.offsets() -> { 0, 2, 5 }
+ *    batch.get( 1, out );              // out.getSparse() -> { 2, 3, 9 }
+ */
+class SDRBatch : public Serializable
+{
+public:
+    SDRBatch() {}
+
+    /**
+     * Create an empty batch of SDRs with the given dimensions.
+     */
+    explicit SDRBatch( const std::vector<UInt> &dimensions );
+
+    /**
+     * Create a batch by swapping in existing CSR buffers.  This method
+     * modifies its arguments!
+     *
+     * @throws if the offsets are malformed, or the sparse data of any SDR is
+     * not sorted, contains duplicates or is out of bounds.
+     */
+    SDRBatch( const std::vector<UInt>  &dimensions,
+              SDR_sparse_t             &indices,
+              std::vector<UInt64>      &offsets );
+
+    /**
+     * @returns The dimensions of every SDR in the batch.
+     */
+    const std::vector<UInt> &dimensions() const { return dimensions_; }
+
+    /**
+     * @returns The number of bits in each SDR of the batch.
+     */
+    UInt sdrSize() const { return sdrSize_; }
+
+    /**
+     * @returns The number of SDRs in the batch.
+     */
+    size_t size() const { return offsets_.size() - 1u; }
+
+    bool empty() const { return size() == 0u; }
+
+    void clear();
+
+    void reserve( size_t numSDRs, size_t numActive );
+
+    /**
+     * Append a copy of the given SDR's value to the end of the batch.
+     */
+    void push_back( const SDR &sdr );
+
+    /**
+     * Append the given sparse indices, as one SDR, to the end of the batch.
+     *
+     * @throws if the sparse data is not sorted, contains duplicates or is out
+     * of bounds.
+     */
+    void push_back( const ElemSparse *sparse, size_t numActive );
+
+    /**
+     * Copy SDR number "index" into the given SDR, which must have the same
+     * dimensions as this batch.
+     */
+    void get( size_t index, SDR &out ) const;
+
+    /**
+     * @returns A pointer to the sparse indices of SDR number "index".  Use
+     * rowSize( index ) for the number of indices.
+     */
+    const ElemSparse *row( size_t index ) const
+        { return indices_.data() + offsets_[index]; }
+
+    size_t rowSize( size_t index ) const
+        { return static_cast<size_t>(offsets_[index + 1u] - offsets_[index]); }
+
+    const SDR_sparse_t        &indices() const { return indices_; }
+    const std::vector<UInt64> &offsets() const { return offsets_; }
+
+    bool operator==( const SDRBatch &other ) const;
+    inline bool operator!=( const SDRBatch &other ) const
+        { return not ((*this) == other); }
+
+    CerealAdapter;
+
+    template<class Archive>
+    void save_ar(Archive & ar) const
+    {
+        ar(cereal::make_nvp("dimensions", dimensions_),
+           cereal::make_nvp("indices",    indices_),
+           cereal::make_nvp("offsets",    offsets_));
+    }
+
+    template<class Archive>
+    void load_ar(Archive & ar)
+    {
+        std::vector<UInt>   dimensions;
+        SDR_sparse_t        indices;
+        std::vector<UInt64> offsets;
+        ar( dimensions, indices, offsets );
+        if( dimensions.empty() ) {
+            // A default constructed batch, which has no dimensions yet.
+            NTA_CHECK( indices.empty() and offsets.size() == 1u and offsets[0] == 0u )
+                << "SDRBatch: a batch without dimensions must be empty.";
+            *this = SDRBatch();
+            return;
+        }
+        *this = SDRBatch( dimensions, indices, offsets );
+    }
+
+private:
+    std::vector<UInt>   dimensions_;
+    UInt                sdrSize_ = 0u;
+    SDR_sparse_t        indices_;
+    std::vector<UInt64> offsets_ = { 0u };
+
+    void checkSparse_( const ElemSparse *sparse, size_t numActive ) const;
+};
+
+} // end namespace htm
+#endif // end ifndef SDR_BATCH_HPP
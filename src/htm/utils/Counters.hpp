@@ -0,0 +1,80 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Optional hot-path counters for the algorithms.
+ *
+ * Configure with -DHTM_COUNTERS=ON to count events such as segments created,
+ * synapses adapted or columns bursting in Connections, SpatialPooler and
+ * TemporalMemory.  Without the flag HTM_COUNT() expands to nothing, so the
+ * counters cost nothing in a normal build, and getCounters() returns an
+ * empty map.
+ */
+
+#ifndef HTM_UTIL_COUNTERS_HPP
+#define HTM_UTIL_COUNTERS_HPP
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <htm/types/Types.hpp>
+
+#ifdef HTM_COUNTERS
+  #define HTM_COUNT(counter, n) ((counter) += static_cast<htm::UInt64>(n))
+#else
+  #define HTM_COUNT(counter, n) ((void)0)
+#endif
+
+namespace htm {
+
+#ifdef HTM_COUNTERS
+  constexpr bool HTM_COUNTERS_ENABLED = true;
+#else
+  constexpr bool HTM_COUNTERS_ENABLED = false;
+#endif
+
+/** Counter name -> value, as returned by the getCounters() methods. */
+typedef std::map<std::string, UInt64> CounterMap;
+
+/**
+ * Copy all counters of source into target, with the given prefix in front of
+ * every name.
+ */
+inline void mergeCounters(CounterMap &target, const CounterMap &source,
+                          const std::string &prefix = "") {
+  for (const auto &counter : source) {
+    target[prefix + counter.first] = counter.second;
+  }
+}
+
+/** Format counters as a flat JSON object, for example {"growCalls": 12}. */
+inline std::string countersToJSON(const CounterMap &counters) {
+  std::stringstream json;
+  json << "{";
+  bool first = true;
+  for (const auto &counter : counters) {
+    json << (first ? "" : ", ") << "\"" << counter.first << "\": " << counter.second;
+    first = false;
+  }
+  json << "}";
+  return json.str();
+}
+
+} // end namespace htm
+
+#endif // HTM_UTIL_COUNTERS_HPP
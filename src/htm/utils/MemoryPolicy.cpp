@@ -0,0 +1,218 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of MemoryPolicy
+ */
+
+#include <fstream>
+#include <new>
+#include <sstream>
+
+#if defined(NTA_OS_LINUX)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <htm/utils/Log.hpp>
+#include <htm/utils/MemoryPolicy.hpp>
+
+namespace htm {
+
+using namespace std;
+
+const size_t MemoryPolicy::HUGE_PAGE_SIZE;
+
+namespace {
+
+// Parse a Linux cpu or node list, such as "0-3,8-11".
+vector<int> parseList(const string &list) {
+  vector<int> ids;
+  stringstream ss(list);
+  string range;
+  while (getline(ss, range, ',')) {
+    if (range.empty() || range == "\n")
+      continue;
+    const size_t dash = range.find('-');
+    const int first = stoi(range.substr(0, dash));
+    const int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+    for (int i = first; i <= last; i++)
+      ids.push_back(i);
+  }
+  return ids;
+}
+
+string readLine(const string &path) {
+  ifstream file(path);
+  string line;
+  getline(file, line);
+  return line;
+}
+
+bool usePolicy(size_t bytes, const MemoryPolicy &policy) {
+#if defined(NTA_OS_LINUX)
+  return !policy.isDefault() && bytes >= MemoryPolicy::HUGE_PAGE_SIZE;
+#else
+  (void)bytes;
+  (void)policy;
+  return false;
+#endif
+}
+
+#if defined(NTA_OS_LINUX)
+size_t mappedLength(size_t bytes) {
+  const size_t page = MemoryPolicy::HUGE_PAGE_SIZE;
+  return (bytes + page - 1u) / page * page;
+}
+
+// Apply the NUMA placement with the mbind system call, so that there is no
+// dependency on libnuma.  Must be called before the pages are touched.
+void bindMemory(void *ptr, size_t length, const MemoryPolicy &policy) {
+#if defined(SYS_mbind)
+  const int MPOL_PREFERRED_  = 1;
+  const int MPOL_INTERLEAVE_ = 3;
+  const size_t BITS = 8u * sizeof(unsigned long);
+  unsigned long mask[1024u / BITS] = {};
+  int mode;
+  if (policy.placement == MemoryPolicy::Placement::INTERLEAVE) {
+    mode = MPOL_INTERLEAVE_;
+    for (size_t n = 0; n < numaNodeCount() && n < 1024u; n++)
+      mask[n / BITS] |= 1ul << (n % BITS);
+  } else {
+    NTA_CHECK(policy.node >= 0 && policy.node < 1024) << "MemoryPolicy: bad NUMA node " << policy.node;
+    mode = MPOL_PREFERRED_;
+    mask[policy.node / BITS] |= 1ul << (policy.node % BITS);
+  }
+  // A failure (no NUMA support, node offline) leaves the default policy.
+  if (syscall(SYS_mbind, ptr, length, mode, mask, 1024ul, 0u) != 0) {
+    NTA_DEBUG << "MemoryPolicy: mbind failed, using the default placement.";
+  }
+#else
+  (void)ptr;
+  (void)length;
+  (void)policy;
+#endif
+}
+#endif
+
+} // namespace
+
+
+MemoryPolicy MemoryPolicy::parse(const string &str) {
+  MemoryPolicy policy;
+  stringstream ss(str);
+  string word;
+  while (getline(ss, word, '+')) {
+    if (word == "default" || word.empty()) {
+      continue;
+    } else if (word == "huge") {
+      policy.hugePages = true;
+    } else if (word == "interleave") {
+      policy.placement = Placement::INTERLEAVE;
+    } else if (word.compare(0, 5, "node:") == 0) {
+      policy.placement = Placement::NODE;
+      policy.node = stoi(word.substr(5));
+    } else {
+      NTA_THROW << "MemoryPolicy: unknown policy '" << word
+                << "', expected default, huge, interleave or node:N";
+    }
+  }
+  return policy;
+}
+
+
+string MemoryPolicy::toString() const {
+  if (isDefault())
+    return "default";
+  string str = hugePages ? "huge" : "";
+  if (placement != Placement::DEFAULT) {
+    if (!str.empty())
+      str += "+";
+    str += placement == Placement::INTERLEAVE ? "interleave" : "node:" + to_string(node);
+  }
+  return str;
+}
+
+
+void *allocateWithPolicy(size_t bytes, const MemoryPolicy &policy) {
+  if (!usePolicy(bytes, policy))
+    return ::operator new(bytes);
+#if defined(NTA_OS_LINUX)
+  // Map one extra huge page and trim the mapping to a 2 MB boundary, the
+  // kernel only backs aligned ranges with huge pages.
+  const size_t page   = MemoryPolicy::HUGE_PAGE_SIZE;
+  const size_t length = mappedLength(bytes);
+  void *raw = mmap(nullptr, length + page, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED)
+    throw std::bad_alloc();
+  char *begin = static_cast<char *>(raw);
+  char *ptr = reinterpret_cast<char *>((reinterpret_cast<size_t>(begin) + page - 1u) / page * page);
+  if (ptr > begin)
+    munmap(begin, static_cast<size_t>(ptr - begin));
+  const size_t tail = static_cast<size_t>((begin + length + page) - (ptr + length));
+  if (tail > 0u)
+    munmap(ptr + length, tail);
+
+  if (policy.hugePages) {
+    // Fails when THP is disabled, the memory is then backed by small pages.
+    madvise(ptr, length, MADV_HUGEPAGE);
+  }
+  if (policy.placement != MemoryPolicy::Placement::DEFAULT) {
+    bindMemory(ptr, length, policy);
+  }
+  return ptr;
+#else
+  return ::operator new(bytes);
+#endif
+}
+
+
+void deallocateWithPolicy(void *ptr, size_t bytes, const MemoryPolicy &policy) noexcept {
+  if (ptr == nullptr)
+    return;
+  if (!usePolicy(bytes, policy)) {
+    ::operator delete(ptr);
+    return;
+  }
+#if defined(NTA_OS_LINUX)
+  munmap(ptr, mappedLength(bytes));
+#endif
+}
+
+
+size_t numaNodeCount() {
+#if defined(NTA_OS_LINUX)
+  const auto nodes = parseList(readLine("/sys/devices/system/node/online"));
+  if (!nodes.empty())
+    return static_cast<size_t>(nodes.back()) + 1u;
+#endif
+  return 1u;
+}
+
+
+vector<int> cpusOfNumaNode(int node) {
+#if defined(NTA_OS_LINUX)
+  return parseList(readLine("/sys/devices/system/node/node" + to_string(node) + "/cpulist"));
+#else
+  (void)node;
+  return vector<int>();
+#endif
+}
+
+} // namespace htm
@@ -0,0 +1,142 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Definitions for MemoryPolicy and PolicyAllocator, which control the page
+ * size and NUMA placement of large arrays.
+ */
+
+#ifndef HTM_UTIL_MEMORY_POLICY_HPP
+#define HTM_UTIL_MEMORY_POLICY_HPP
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace htm {
+
+/**
+ * How large arrays are placed in memory.  Used by Connections for its core
+ * arrays, see Connections::setMemoryPolicy().
+ *
+ * hugePages: Back the array with 2 MB transparent huge pages, which cuts
+ *   the TLB misses of random access into multi-GB arrays.  Needs THP set
+ *   to "madvise" or "always" in /sys/kernel/mm/transparent_hugepage/enabled.
+ *
+ * placement: Where the pages go on a NUMA machine.
+ *   DEFAULT    - The kernel's first-touch policy.
+ *   INTERLEAVE - Spread the pages round-robin over all NUMA nodes, so that
+ *                threads on every node see the same average latency.
+ *   NODE       - Keep the pages on NUMA node 'node', falling back to other
+ *                nodes only when it is full.  Combine with a ThreadPool
+ *                pinned to cpusOfNumaNode(node).
+ *
+ * Only arrays of at least HUGE_PAGE_SIZE bytes are affected, smaller arrays
+ * use operator new.  The policy is a hint: it is ignored on platforms other
+ * than Linux and when the kernel refuses it, the allocation still succeeds.
+ */
+struct MemoryPolicy {
+  enum class Placement { DEFAULT, INTERLEAVE, NODE };
+
+  bool      hugePages = false;
+  Placement placement = Placement::DEFAULT;
+  int       node      = 0;
+
+  static const size_t HUGE_PAGE_SIZE = 2u * 1024u * 1024u;
+
+  bool isDefault() const { return !hugePages && placement == Placement::DEFAULT; }
+
+  bool operator==(const MemoryPolicy &o) const {
+    return hugePages == o.hugePages && placement == o.placement &&
+           (placement != Placement::NODE || node == o.node);
+  }
+  bool operator!=(const MemoryPolicy &o) const { return !(*this == o); }
+
+  /**
+   * Parse a policy from a '+' separated list of "huge", "interleave" and
+   * "node:N", or "default".  For example "huge+interleave".
+   * Throws on unknown words.
+   */
+  static MemoryPolicy parse(const std::string &str);
+
+  /** The inverse of parse(). */
+  std::string toString() const;
+};
+
+/**
+ * Allocate and free raw memory according to a policy.  deallocate must be
+ * given the same size and policy as the allocation.
+ */
+void *allocateWithPolicy(size_t bytes, const MemoryPolicy &policy);
+void deallocateWithPolicy(void *ptr, size_t bytes, const MemoryPolicy &policy) noexcept;
+
+/** Number of NUMA nodes of this machine, 1 when unknown. */
+size_t numaNodeCount();
+
+/** The CPUs of a NUMA node, empty when unknown. */
+std::vector<int> cpusOfNumaNode(int node);
+
+
+/**
+ * A std allocator which allocates with a MemoryPolicy.  The policy is part
+ * of the allocator's state, so containers keep it when they grow, and
+ * copies of a container get the same policy.
+ *
+ * Example Usage:
+ *      MemoryPolicy policy = MemoryPolicy::parse("huge+interleave");
+ *      PolicyVector<Real> big(PolicyAllocator<Real>(policy));
+ *      big.resize(1000000000u);
+ */
+template<class T>
+class PolicyAllocator {
+public:
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  PolicyAllocator() noexcept {}
+  explicit PolicyAllocator(const MemoryPolicy &policy) noexcept : policy(policy) {}
+  template<class U>
+  PolicyAllocator(const PolicyAllocator<U> &other) noexcept : policy(other.policy) {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(allocateWithPolicy(n * sizeof(T), policy));
+  }
+  void deallocate(T *ptr, size_t n) noexcept {
+    deallocateWithPolicy(ptr, n * sizeof(T), policy);
+  }
+
+  MemoryPolicy policy;
+};
+
+template<class T, class U>
+bool operator==(const PolicyAllocator<T> &a, const PolicyAllocator<U> &b) noexcept {
+  return a.policy == b.policy;
+}
+template<class T, class U>
+bool operator!=(const PolicyAllocator<T> &a, const PolicyAllocator<U> &b) noexcept {
+  return !(a == b);
+}
+
+template<class T>
+using PolicyVector = std::vector<T, PolicyAllocator<T>>;
+
+} // namespace htm
+
+#endif // HTM_UTIL_MEMORY_POLICY_HPP
@@ -37,6 +37,8 @@ MetricsHelper_::MetricsHelper_( const vector<UInt> &dimensions, UInt period ) {
     dataSource_ = nullptr;
     callback_handle_        = -1;
     destroyCallback_handle_ = -1;
+    updates_    = 0u;
+    sampleRate_ = 1u;
 }
 
 MetricsHelper_::MetricsHelper_( const SDR &dataSource, UInt period )
@@ -44,7 +46,8 @@ MetricsHelper_::MetricsHelper_( const SDR &dataSource, UInt period )
 {
     dataSource_ = &dataSource;
     callback_handle_ = dataSource_->addCallback( [&](){
-        callback( *dataSource_, 1.0f / std::min( period_, (UInt) ++samples_ ));
+        if( sample_() )
+            callback( *dataSource_, 1.0f / std::min( period_, (UInt) ++samples_ ));
     });
     destroyCallback_handle_ = dataSource_->addDestroyCallback( [&](){
         deconstruct();
@@ -67,7 +70,20 @@ void MetricsHelper_::addData(const SDR &data) {
     NTA_CHECK( dataSource_ == nullptr )
         << "Method addData can only be called if this metric was NOT initialize with an SDR!";
     NTA_CHECK( dimensions_ == data.dimensions );
-    callback( data, 1.0f / std::min( period_, (UInt) ++samples_ ));
+    if( sample_() )
+        callback( data, 1.0f / std::min( period_, (UInt) ++samples_ ));
+}
+
+void MetricsHelper_::setSampleRate(UInt k) {
+    NTA_CHECK( k > 0u );
+    sampleRate_ = k;
+}
+
+bool MetricsHelper_::sample_() {
+    if( ++updates_ < sampleRate_ )
+        return false;
+    updates_ = 0u;
+    return true;
 }
 
 
@@ -134,6 +150,7 @@ ActivationFrequency::ActivationFrequency( const SDR &dataSource,
     { initialize( dataSource.size, initialValue ); }
 
 void ActivationFrequency::initialize( UInt size, Real initialValue ) {
+    lastUpdate_.assign( size, 0u );
     if( initialValue == -1 ) {
         activationFrequency_.assign( size, 1234.567f );
         alwaysExponential_ = false;
@@ -146,46 +163,77 @@ void ActivationFrequency::initialize( UInt size, Real initialValue ) {
     }
 }
 
+// Sample number s decays every frequency by (1 - alpha(s)), where alpha(s) is
+// 1/period once alwaysExponential_ or s >= period, and 1/s before that.
+// Over the samples (from, to]:
+//      product of (1 - 1/s)      = from / to       (regular average part)
+//      product of (1 - 1/period) = (1 - 1/period) ^ (to - from)
+Real ActivationFrequency::decay_(UInt from, UInt to) const {
+    Real decay = 1.0f;
+    if( not alwaysExponential_ ) {
+        const UInt end = std::min( to, period_ );
+        if( from < end ) {
+            decay *= (Real) from / end;
+            from   = end;
+        }
+    }
+    if( from < to )
+        decay *= std::pow( 1.0f - 1.0f / period_, (Real) (to - from) );
+    return decay;
+}
+
+void ActivationFrequency::catchUp_(UInt idx, UInt to) const {
+    if( lastUpdate_[idx] != to ) {
+        activationFrequency_[idx] *= decay_( lastUpdate_[idx], to );
+        lastUpdate_[idx] = to;
+    }
+}
+
 void ActivationFrequency::callback(const SDR &dataSource, Real alpha)
 {
     if( alwaysExponential_ ) {
         alpha = 1.0f / period;
     }
 
-    const auto decay = 1.0f - alpha;
-    for(auto &value : activationFrequency_)
-        value *= decay;
-
     const auto &sparse = dataSource.getSparse();
-    for(const auto &idx : sparse)
+    for(const auto &idx : sparse) {
+        catchUp_( idx, samples_ );
         activationFrequency_[idx] += alpha;
+    }
+}
+
+const vector<Real> &ActivationFrequency::activationFrequency() const {
+    for(UInt idx = 0u; idx < activationFrequency_.size(); idx++)
+        catchUp_( idx, samples_ );
+    return activationFrequency_;
 }
 
 Real ActivationFrequency::min() const {
-    return *std::min_element(activationFrequency_.begin(),
-                             activationFrequency_.end());
+    const auto &frequencies = activationFrequency();
+    return *std::min_element(frequencies.begin(), frequencies.end());
 }
 
 Real ActivationFrequency::max() const {
-    return *std::max_element(activationFrequency_.begin(),
-                             activationFrequency_.end());
+    const auto &frequencies = activationFrequency();
+    return *std::max_element(frequencies.begin(), frequencies.end());
 }
 
 Real ActivationFrequency::mean() const  {
-    const auto sum = std::accumulate( activationFrequency_.begin(),
-                                      activationFrequency_.end(),
+    const auto &frequencies = activationFrequency();
+    const auto sum = std::accumulate( frequencies.begin(),
+                                      frequencies.end(),
                                       0.0f);
-    return (Real) sum / activationFrequency_.size();
+    return (Real) sum / frequencies.size();
 }
 
 Real ActivationFrequency::std() const {
     const auto mean_ = mean();
     auto sum_squares = 0.0f;
-    for(const auto &frequency : activationFrequency) {
+    for(const auto &frequency : activationFrequency_) {
         const auto displacement = frequency - mean_;
         sum_squares += displacement * displacement;
     }
-    const auto variance = sum_squares / activationFrequency.size();
+    const auto variance = sum_squares / activationFrequency_.size();
 
     return std::sqrt( variance );
 }
@@ -204,7 +252,7 @@ Real ActivationFrequency::entropy() const {
     const auto max_extropy = binary_entropy_({ mean() });
     if( max_extropy == 0.0f )
         return 0.0f;
-    return binary_entropy_( activationFrequency ) / max_extropy;
+    return binary_entropy_( activationFrequency_ ) / max_extropy;
 }
 
 std::ostream& operator<< (std::ostream& stream,
@@ -220,16 +268,21 @@ std::ostream& operator<< (std::ostream& stream,
 /******************************************************************************/
 
 Overlap::Overlap( const vector<UInt> &dimensions, UInt period )
-    : MetricsHelper_( dimensions, period ),
-      previous_( dimensions )
-    { initialize(); }
+    : MetricsHelper_( dimensions, period )
+{
+    UInt size = 1;
+    for(const auto &dim : dimensions)
+        size *= dim;
+    initialize( size );
+}
 
 Overlap::Overlap( const SDR &dataSource, UInt period )
-    : MetricsHelper_( dataSource, period ),
-      previous_( dataSource.dimensions )
-    { initialize(); }
+    : MetricsHelper_( dataSource, period )
+    { initialize( dataSource.size ); }
 
-void Overlap::initialize() {
+void Overlap::initialize( UInt size ) {
+    previous_.assign( (size + 63u) / 64u, 0u );
+    previousSum_ = 0u;
     overlap_    =  NAN;
     min_        =  INFINITY;
     max_        = -INFINITY;
@@ -241,9 +294,17 @@ void Overlap::initialize() {
 void Overlap::reset()
     { previousValid_ = false; }
 
+void Overlap::setPrevious_(const SDR_sparse_t &sparse) {
+    std::fill( previous_.begin(), previous_.end(), 0u );
+    for(const auto &idx : sparse)
+        previous_[idx / 64u] |= UInt64(1u) << (idx % 64u);
+    previousSum_ = (UInt) sparse.size();
+}
+
 void Overlap::callback(const SDR &dataSource, Real alpha) {
+    const auto &sparse = dataSource.getSparse();
     if( not previousValid_ ) {
-        previous_.setSDR( dataSource );
+        setPrevious_( sparse );
         previousValid_ = true;
         // It takes two data samples to compute overlap so decrement the
         // samples counter & return & wait for the next sample.
@@ -251,8 +312,10 @@ void Overlap::callback(const SDR &dataSource, Real alpha) {
         overlap_ = NAN;
         return;
     }
-    const auto nbits = std::max( previous_.getSum(), dataSource.getSum() );
-    const auto rawOverlap = previous_.getOverlap( dataSource );
+    const auto nbits = std::max( previousSum_, (UInt) sparse.size() );
+    UInt rawOverlap = 0u;
+    for(const auto &idx : sparse)
+        rawOverlap += (previous_[idx / 64u] >> (idx % 64u)) & 1u;
     overlap_ = (nbits == 0u) ? 1.0f : (Real) rawOverlap / nbits;
     min_     = std::min( min_, overlap_ );
     max_     = std::max( max_, overlap_ );
@@ -262,7 +325,7 @@ void Overlap::callback(const SDR &dataSource, Real alpha) {
     const Real incr      = alpha * diff;
                mean_    += incr;
                variance_ = (1.0f - alpha) * (variance_ + diff * incr);
-    previous_.setSDR( dataSource );
+    setPrevious_( sparse );
 }
 
 Real Overlap::min() const { return min_; }
@@ -297,6 +360,12 @@ Metrics::Metrics( const SDR &dataSource, UInt period )
 void Metrics::reset()
     { overlap_.reset(); }
 
+void Metrics::setSampleRate(UInt k) {
+    sparsity_.setSampleRate( k );
+    activationFrequency_.setSampleRate( k );
+    overlap_.setSampleRate( k );
+}
+
 void Metrics::addData(const SDR &data) {
     sparsity_.addData( data );
     activationFrequency_.addData( data );
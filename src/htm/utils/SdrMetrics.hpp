@@ -37,8 +37,17 @@ class MetricsHelper_ {
 public:
     const UInt              &period     = period_;
     const UInt              &samples    = samples_;
+    const UInt              &sampleRate = sampleRate_;
     const std::vector<UInt> &dimensions = dimensions_;
 
+    /**
+     * Only measure every k-th update of the SDR, skip the rest.  This makes
+     * the metric k times cheaper, which is useful for leaving metrics enabled
+     * on large SDRs.  The period still counts samples, so the time constant
+     * becomes (period * k) updates.  Default is 1, every update is measured.
+     */
+    void setSampleRate(UInt k);
+
     /**
      * Add an SDR datum to this Metric.  This method can only be called if the
      * Metric was constructed with dimensions and NOT an SDR.
@@ -54,6 +63,11 @@ private:
     const SDR* dataSource_;
     UInt callback_handle_;
     UInt destroyCallback_handle_;
+    UInt updates_;
+    UInt sampleRate_;
+
+    // Counts the update and returns true if it is one to measure.
+    bool sample_();
 
 protected:
     UInt period_;
@@ -164,13 +178,18 @@ private:
  * Activation frequencies are Real numbers in the range [0, 1], where zero
  * indicates never active, and one indicates always active.
  *
+ * The frequencies are decayed lazily.  Each update only touches the active
+ * bits; every other bit remembers when it was last updated and applies the
+ * missed decay in closed form when it is read.  Reading all of the
+ * frequencies (activationFrequency(), min(), entropy(), etc) is O(size).
+ *
  * Example Usage:
  *      SDR A( 2 )
  *      ActivationFrequency B( A, 1000 )
  *      A.setDense({ 0, 0 })
  *      A.setDense({ 1, 1 })
  *      A.setDense({ 0, 1 })
- *      B.activationFrequency -> { 0.33, 0.66 }
+ *      B.activationFrequency() -> { 0.33, 0.66 }
  *      B.min()     -> ~0.33
  *      B.max()     -> ~0.66
  *      B.mean()    ->  0.50
@@ -211,7 +230,7 @@ public:
     ActivationFrequency( const std::vector<UInt> &dimensions, UInt period,
                          Real initialValue = -1 );
 
-    const std::vector<Real> &activationFrequency = activationFrequency_;
+    const std::vector<Real> &activationFrequency() const;
 
     Real min() const;
     Real max() const;
@@ -234,11 +253,18 @@ public:
     friend std::ostream& operator<< (std::ostream &, const ActivationFrequency &);
 
 private:
-    std::vector<Real> activationFrequency_;
+    mutable std::vector<Real> activationFrequency_;
+    mutable std::vector<UInt> lastUpdate_; // sample at which each frequency was last brought up to date.
     bool alwaysExponential_;
 
     void initialize(UInt size, Real initialValue);
 
+    // Product of the decays applied by the samples (from, to].
+    Real decay_(UInt from, UInt to) const;
+
+    // Apply the missed decay to frequency idx, up to and including sample 'to'.
+    void catchUp_(UInt idx, UInt to) const;
+
     static Real binary_entropy_(const std::vector<Real> &frequencies);
 
     void callback(const SDR &dataSource, Real alpha) override;
@@ -301,7 +327,8 @@ public:
     friend std::ostream& operator<< ( std::ostream &, const Overlap & );
 
 private:
-    SDR  previous_;
+    std::vector<UInt64> previous_; // bitset of the previous SDR's active bits.
+    UInt previousSum_;
     bool previousValid_;
     Real overlap_;
     Real min_;
@@ -309,7 +336,9 @@ private:
     Real mean_;
     Real variance_;
 
-    void initialize();
+    void initialize(UInt size);
+
+    void setPrevious_(const SDR_sparse_t &sparse);
 
     void callback(const SDR &dataSource, Real alpha) override;
 };
@@ -366,6 +395,12 @@ public:
     /* For use with time-series data sets. */
     void reset();
 
+    /**
+     * Measure every k-th update only, for all three metrics.
+     * See MetricsHelper_::setSampleRate.
+     */
+    void setSampleRate(UInt k);
+
     const std::vector<UInt>   &dimensions          = dimensions_;
     const Sparsity            &sparsity            = sparsity_;
     const ActivationFrequency &activationFrequency = activationFrequency_;
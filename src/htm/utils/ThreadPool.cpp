@@ -0,0 +1,118 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the ThreadPool class
+ */
+
+#include <htm/utils/ThreadPool.hpp>
+#include <htm/utils/Log.hpp>
+
+#if defined(NTA_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace htm {
+
+ThreadPool::ThreadPool(size_t numThreads) {
+  if (numThreads == 0) {
+    numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0)
+      numThreads = 1;
+  }
+  workers_.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; i++) {
+    workers_.emplace_back(&ThreadPool::workerLoop_, this);
+  }
+}
+
+ThreadPool::ThreadPool(size_t numThreads, const std::vector<int> &cpus)
+    : ThreadPool(numThreads) {
+#if defined(NTA_OS_LINUX)
+  if (cpus.empty())
+    return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &set);
+  }
+  for (auto &w : workers_) {
+    if (pthread_setaffinity_np(w.native_handle(), sizeof(set), &set) != 0) {
+      NTA_WARN << "ThreadPool: could not pin a worker thread to the requested CPUs.";
+    }
+  }
+#else
+  (void)cpus;
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &w : workers_) {
+    w.join();
+  }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+  std::packaged_task<void()> pt(std::move(task));
+  std::future<void> result = pt.get_future();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(pt));
+  }
+  cv_.notify_one();
+  return result;
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)> &task) {
+  std::vector<std::future<void>> pending;
+  pending.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    pending.push_back(submit([&task, i]() { task(i); }));
+  }
+  // Wait for everything before rethrowing so that no task is still
+  // referencing 'task' when we leave this scope.
+  for (auto &f : pending) {
+    f.wait();
+  }
+  for (auto &f : pending) {
+    f.get();
+  }
+}
+
+void ThreadPool::workerLoop_() {
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+      if (queue_.empty())
+        return; // stopping and nothing left to do.
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    task();
+  }
+}
+
+} // namespace htm
@@ -0,0 +1,104 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Definitions for the ThreadPool class
+ */
+
+#ifndef HTM_UTIL_THREAD_POOL_HPP
+#define HTM_UTIL_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace htm {
+
+/**
+ * A small fixed size pool of worker threads.
+ *
+ * Tasks are run in the order they were submitted.  Exceptions thrown by a
+ * task are captured in the std::future returned by submit() and rethrown
+ * by std::future::get() on the caller's thread.
+ *
+ * Example Usage:
+ *      ThreadPool pool(4);
+ *      auto f = pool.submit([](){ heavyWork(); });
+ *      f.get();  // waits, rethrows any exception from heavyWork().
+ *
+ *      pool.parallelFor(items.size(), [&](size_t i) { process(items[i]); });
+ */
+class ThreadPool {
+public:
+  /**
+   * @param numThreads Number of worker threads.  If zero, uses
+   *        std::thread::hardware_concurrency() (at least one thread).
+   */
+  explicit ThreadPool(size_t numThreads = 0);
+
+  /**
+   * Create a pool whose workers may only run on the given CPUs, for example
+   * cpusOfNumaNode(n) to keep the work next to memory placed on NUMA node n
+   * (see MemoryPolicy).  Pinning is done on Linux only and an empty list
+   * means no pinning.
+   *
+   * @param numThreads Number of worker threads, as above.
+   * @param cpus       Ids of the CPUs the workers are allowed to run on.
+   */
+  ThreadPool(size_t numThreads, const std::vector<int> &cpus);
+
+  /**
+   * Waits for all submitted tasks to finish, then joins the workers.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * Queue a task for execution on one of the worker threads.
+   *
+   * @returns a future which becomes ready when the task has finished.
+   */
+  std::future<void> submit(std::function<void()> task);
+
+  /**
+   * Run task(0) ... task(n-1) on the pool and wait for all of them.
+   * If any task throws, the first exception (in index order) is rethrown
+   * after all tasks have finished.
+   */
+  void parallelFor(size_t n, const std::function<void(size_t)> &task);
+
+  size_t size() const { return workers_.size(); }
+
+private:
+  void workerLoop_();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::packaged_task<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+};
+
+} // namespace htm
+
+#endif // HTM_UTIL_THREAD_POOL_HPP
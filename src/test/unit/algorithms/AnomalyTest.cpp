@@ -69,4 +69,15 @@ TEST(ComputeRawAnomalyScore, PartialMatch) {
   ASSERT_FLOAT_EQ(computeRawAnomalyScore(active, predicted), 2.0f / 3.0f);
 };
 
+TEST(ComputeRawAnomalyScore, SparsePredicted) {
+  SDR active({10});
+  SDR predicted({10});
+  active.setSparse(SDR_sparse_t{2,3,6});
+  predicted.setSparse(SDR_sparse_t{3,5,7});
+
+  ASSERT_FLOAT_EQ(computeRawAnomalyScore(active, predicted.getSparse()),
+                  computeRawAnomalyScore(active, predicted));
+  ASSERT_FLOAT_EQ(computeRawAnomalyScore(active, SDR_sparse_t{}), 1.0f);
+};
+
 }
@@ -22,7 +22,9 @@
 #include "gtest/gtest.h"
 #include <fstream>
 #include <iostream>
+#include <regex>
 #include <htm/algorithms/Connections.hpp>
+#include <htm/utils/ThreadPool.hpp>
 
 using namespace std;
 using namespace htm;
@@ -657,6 +659,78 @@ TEST(ConnectionsTest, testBumpSegment) {
   }
 }
 
+/**
+ * adaptSegment() and bumpSegment() update whole segments at once, check that
+ * the result equals updating each synapse with updateSynapsePermanence().
+ */
+TEST(ConnectionsTest, testSegmentUpdateMatchesScalar) {
+  Random rng(7);
+  Connections fast(200u, 0.5f);
+  for (UInt i = 0; i < 100u; i++) {
+    const Segment seg = fast.createSegment(rng.getUInt32(200u));
+    for (UInt s = 0; s < 40u; s++) {
+      fast.createSynapse(seg, rng.getUInt32(200u), static_cast<Permanence>(rng.getReal64()));
+    }
+  }
+  Connections scalar = fast;
+
+  SDR inputs({200u});
+  for (UInt round = 0; round < 20u; round++) {
+    inputs.randomize(0.3f, rng);
+    const auto &dense = inputs.getDense();
+    const Permanence bump = static_cast<Permanence>(rng.getReal64() * 0.2 - 0.1);
+    for (Segment seg = 0; seg < fast.segmentFlatListLength(); seg++) {
+      if (seg % 2u) {
+        fast.adaptSegment(seg, inputs, 0.05f, 0.03f, false);
+        for (const auto syn : scalar.synapsesForSegment(seg)) {
+          const auto &synData = scalar.dataForSynapse(syn);
+          scalar.updateSynapsePermanence(syn, synData.permanence
+              + (dense[synData.presynapticCell] ? 0.05f : -0.03f));
+        }
+      } else {
+        fast.bumpSegment(seg, bump);
+        for (const auto syn : scalar.synapsesForSegment(seg)) {
+          scalar.updateSynapsePermanence(syn, scalar.dataForSynapse(syn).permanence + bump);
+        }
+      }
+    }
+    ASSERT_EQ(fast, scalar) << "round " << round;
+    const auto active = fast.computeActivity(inputs.getSparse(), false);
+    ASSERT_EQ(active, scalar.computeActivity(inputs.getSparse(), false));
+  }
+}
+
+/**
+ * adaptSegments() on a thread pool must build the same connections as the
+ * serial loop, including the order of the presynaptic maps.
+ */
+TEST(ConnectionsTest, testAdaptSegmentsParallel) {
+  Random rng(11);
+  Connections serial(300u, 0.5f);
+  for (UInt i = 0; i < 300u; i++) {
+    const Segment seg = serial.createSegment(i);
+    for (UInt s = 0; s < 30u; s++) {
+      serial.createSynapse(seg, rng.getUInt32(300u), static_cast<Permanence>(rng.getReal64()));
+    }
+  }
+  Connections parallel = serial;
+  ThreadPool pool(4);
+
+  SDR inputs({300u});
+  for (UInt round = 0; round < 20u; round++) {
+    inputs.randomize(0.1f, rng);
+    vector<Segment> segments;
+    for (Segment seg = 0; seg < 300u; seg++) {
+      if (rng.getReal64() < 0.3) segments.push_back(seg);
+    }
+    serial.adaptSegments(segments, inputs, 0.04f, 0.02f, 12u);
+    parallel.adaptSegments(segments, inputs, 0.04f, 0.02f, 12u, &pool);
+    ASSERT_EQ(parallel, serial) << "round " << round;
+    ASSERT_EQ(parallel.computeActivity(inputs.getSparse(), false),
+              serial.computeActivity(inputs.getSparse(), false));
+  }
+}
+
 /**
  * Test the mapping semgnets to cells by cellForSegment() method.
  */
@@ -802,6 +876,100 @@ TEST(ConnectionsTest, testSaveLoad) {
   ASSERT_EQ(c1, c2);
 }
 
+/**
+ * Binary formats store the arrays as blocks and rebuild the presynaptic maps
+ * on load, text formats store every record. All of them must round-trip,
+ * including synapses which moved between the potential and connected maps.
+ */
+TEST(ConnectionsTest, testSaveLoadAllFormats) {
+  Connections c1(1024, 0.5f);
+  setupSampleConnections(c1);
+
+  //several synapses from the same presynaptic cell 400, so that their
+  //presynaptic map indices get shuffled by the updates below.
+  const auto syn1 = c1.createSynapse(c1.createSegment(10), 400, 0.2f);
+  const auto syn2 = c1.createSynapse(c1.createSegment(11), 400, 0.2f);
+  c1.createSynapse(c1.createSegment(12), 400, 0.2f);
+  c1.updateSynapsePermanence(syn1, 0.9f); //potential -> connected
+  c1.destroySynapse(syn2);
+  c1.updateSynapsePermanence(syn1, 0.1f); //and back
+  computeSampleActivity(c1);
+
+  for (const auto fmt : {SerializableFormat::BINARY, SerializableFormat::PORTABLE,
+                         SerializableFormat::JSON,   SerializableFormat::XML}) {
+    Connections c2;
+    stringstream ss;
+    c1.save(ss, fmt);
+    c2.load(ss, fmt);
+    ASSERT_EQ(c1, c2) << "format " << fmt;
+
+    //the restored instance keeps working like the original
+    Connections c3 = c1;
+    computeSampleActivity(c2);
+    computeSampleActivity(c3);
+    ASSERT_EQ(c2, c3) << "format " << fmt;
+  }
+}
+
+/**
+ * Older versions stored the records in binary archives too, without the
+ * header of the binary layout.  Such data must still load.
+ */
+TEST(ConnectionsTest, testLoadBinaryWithoutHeader) {
+  stringstream ss;
+  {
+    cereal::BinaryOutputArchive ar(ss);
+    const Permanence threshold = 0.5f;
+    const UInt32 iteration = 7u;
+    const vector<CellData> cells(3);
+    const vector<SegmentData> segments;
+    const vector<SynapseData> synapses;
+    const size_t destroyed = 0u;
+    const unordered_map<CellIdx, vector<Synapse>> synapsesForCell;
+    const unordered_map<CellIdx, vector<Segment>> segmentsForCell;
+    const Segment segmentCount = 0u;
+    const Synapse synapseCount = 0u;
+    const bool timeseries = false;
+    const vector<Permanence> updates;
+    ar(threshold, iteration, cells, segments, synapses, destroyed, destroyed,
+       synapsesForCell, synapsesForCell, segmentsForCell, segmentsForCell,
+       segmentCount, synapseCount, timeseries, updates, updates,
+       synapseCount, segmentCount);
+  }
+
+  Connections c;
+#ifdef HTM_64BIT_INDICES
+  EXPECT_ANY_THROW(c.load(ss, SerializableFormat::BINARY));
+#else
+  c.load(ss, SerializableFormat::BINARY);
+  EXPECT_EQ(c.numCells(), 3u);
+  EXPECT_EQ(c.getConnectedThreshold(), 0.5f);
+  EXPECT_EQ(c.numSegments(), 0u);
+
+  //and it keeps working
+  const Segment seg = c.createSegment(1);
+  c.createSynapse(seg, 2, 0.6f);
+  EXPECT_EQ(c.numSynapses(), 1u);
+#endif
+}
+
+TEST(ConnectionsTest, testLoadBinaryUnknownVersion) {
+  Connections c1(16, 0.5f);
+  stringstream ss;
+  c1.save(ss, SerializableFormat::BINARY);
+  string data = ss.str();
+  data[4] = 99; //version byte, after the 4 byte magic
+
+  Connections c2;
+  stringstream in(data);
+  EXPECT_ANY_THROW(c2.load(in, SerializableFormat::BINARY));
+
+  //and not corrupted by this test
+  stringstream ok(ss.str());
+  EXPECT_NO_THROW(c2.load(ok, SerializableFormat::BINARY));
+  EXPECT_EQ(c1, c2);
+}
+
 TEST(ConnectionsTest, testCreateSegmentOverflow) {
     const auto LIMIT = std::numeric_limits<Segment>::max();
     if(LIMIT <= 256) { //connections::Segment is too large (likely uint32), so this test would run, but memory 
@@ -837,6 +1005,106 @@ TEST(ConnectionsTest, testCreateSynapseOverflow) {
   }
 }
 
+TEST(ConnectionsTest, testIndexWidth) {
+#ifdef HTM_64BIT_INDICES
+  EXPECT_EQ(sizeof(Segment), 8u);
+  EXPECT_EQ(sizeof(Synapse), 8u);
+#else
+  EXPECT_EQ(sizeof(Segment), 4u);
+  EXPECT_EQ(sizeof(Synapse), 4u);
+#endif
+  EXPECT_EQ(ConnectionsRemap::INVALID, std::numeric_limits<Segment>::max());
+  EXPECT_EQ(static_cast<Synapse>(ConnectionsRemap::INVALID), std::numeric_limits<Synapse>::max());
+}
+
+/**
+ * Synapse ids come from a counter which never goes back, except in reorder().
+ * Creating the synapses to reach its limit takes too long, so set the counter
+ * through a JSON save instead.
+ */
+TEST(ConnectionsTest, testSynapseOrdinalOverflow) {
+  Connections c1(16, 0.5f);
+  const Segment seg = c1.createSegment(0);
+  c1.createSynapse(seg, 1, 0.6f);
+  const Synapse doomed = c1.createSynapse(seg, 2, 0.6f);
+  c1.destroySynapse(doomed);
+
+  stringstream json;
+  c1.save(json, SerializableFormat::JSON);
+  const std::regex ordinal("(\"nextSynapseOrdinal_\":\\s*\"?)[0-9]+");
+  const auto nearLimit = std::to_string(std::numeric_limits<Synapse>::max() - 1u);
+  const string edited = std::regex_replace(json.str(), ordinal, "${1}" + nearLimit);
+  ASSERT_NE(edited, json.str());
+
+  Connections c2;
+  stringstream in(edited);
+  c2.load(in, SerializableFormat::JSON);
+
+  EXPECT_NO_THROW(c2.createSynapse(seg, 3, 0.6f)); //takes the last id
+  EXPECT_ANY_THROW(c2.createSynapse(seg, 4, 0.6f));
+  EXPECT_EQ(c2.numSynapses(), 2u);
+
+  //reorder() renumbers the ids, which makes room again
+  c2.reorder();
+  EXPECT_NO_THROW(c2.createSynapse(seg, 4, 0.6f));
+  EXPECT_EQ(c2.numSynapses(), 3u);
+}
+
+/**
+ * Binary saves record the index width, and a build with the other width
+ * must refuse them.
+ */
+TEST(ConnectionsTest, testLoadBinaryIndexWidthMismatch) {
+  Connections c1(16, 0.5f);
+  c1.createSynapse(c1.createSegment(0), 1, 0.6f);
+  stringstream ss;
+  c1.save(ss, SerializableFormat::BINARY);
+  string data = ss.str();
+  ASSERT_EQ(static_cast<size_t>(data[5]), sizeof(Synapse)); //after magic and version
+  data[5] = static_cast<char>(sizeof(Synapse) == 4u ? 8 : 4);
+
+  Connections c2;
+  stringstream in(data);
+  try {
+    c2.load(in, SerializableFormat::BINARY);
+    FAIL() << "loaded binary data with the other index width";
+  } catch (const htm::Exception &e) {
+    EXPECT_NE(string(e.what()).find("HTM_64BIT_INDICES"), string::npos) << e.what();
+  }
+}
+
+TEST(ConnectionsTest, testReorderReclaimsSynapseIds) {
+  Connections C(100u, 0.5f);
+  const Segment seg = C.createSegment(0u);
+  // Churn: the synapse ids keep growing while few synapses are alive.
+  for (UInt round = 0; round < 50u; round++) {
+    for (CellIdx cell = 0; cell < 10u; cell++) {
+      C.createSynapse(seg, cell, 0.6f);
+    }
+    for (CellIdx cell = 0; cell < 10u; cell += 2u) {
+      C.destroySynapse(C.synapsesForSegment(seg)[cell / 2u]);
+    }
+  }
+  const size_t numSynapses = C.numSynapses();
+  Synapse maxId = 0;
+  for (const auto syn : C.synapsesForSegment(seg)) {
+    maxId = std::max(maxId, C.dataForSynapse(syn).id);
+  }
+  ASSERT_GE(maxId, static_cast<Synapse>(numSynapses));
+
+  C.reorder();
+  const auto &syns = C.synapsesForSegment(seg);
+  ASSERT_EQ(syns.size(), numSynapses);
+  for (size_t i = 0; i < syns.size(); i++) {
+    EXPECT_EQ(C.dataForSynapse(syns[i]).id, static_cast<Synapse>(i));
+  }
+  // New ids continue after the reclaimed ones, and keep the list sorted.
+  const Synapse syn = C.createSynapse(seg, 99u, 0.6f);
+  EXPECT_EQ(C.dataForSynapse(syn).id, static_cast<Synapse>(numSynapses));
+  C.destroySynapse(syns[0]);
+  EXPECT_EQ(C.numSynapses(), numSynapses);
+}
+
 TEST(ConnectionsTest, testTimeseries) {
   Connections C( 1, .5, true );
   auto seg = C.createSegment(0);
@@ -871,3 +1139,110 @@ TEST(ConnectionsTest, testTimeseries) {
     ASSERT_TRUE( (synData.permanence == 0.0f) or (synData.permanence == 1.0f) );
   }
 }
+
+
+TEST(ConnectionsTest, testCounters) {
+  Connections C(10u, 0.5f);
+  const Segment seg = C.createSegment(1u, 1u);
+  C.createSynapse(seg, 2u, 0.6f);
+  C.createSynapse(seg, 3u, 0.4f);
+  C.computeActivity({2u, 3u, 4u});
+
+  SDR inputs({10u});
+  inputs.setSparse(SDR_sparse_t{2u});
+  C.adaptSegment(seg, inputs, 0.1f, 0.1f);
+  Random rng(42);
+  C.growSynapses(seg, {5u, 6u}, 0.3f, rng, 1u, 0u);
+  // Exceed maxSegmentsPerCell, evicting the first segment & its synapses.
+  C.createSegment(1u, 1u);
+
+  const auto counters = C.getCounters();
+  if (not HTM_COUNTERS_ENABLED) {
+    EXPECT_TRUE(counters.empty());
+    return;
+  }
+  EXPECT_EQ(counters.at("computeActivityCalls"), 1u);
+  EXPECT_EQ(counters.at("cellsTouched"),         3u);
+  EXPECT_EQ(counters.at("segmentsTouched"),      1u);
+  EXPECT_EQ(counters.at("synapsesAdapted"),      2u);
+  EXPECT_EQ(counters.at("growCalls"),            1u);
+  EXPECT_EQ(counters.at("segmentsCreated"),      2u);
+  EXPECT_EQ(counters.at("segmentsDestroyed"),    1u);
+  EXPECT_EQ(counters.at("segmentsEvicted"),      1u);
+  EXPECT_EQ(counters.at("synapsesCreated"),      3u);
+  EXPECT_EQ(counters.at("synapsesDestroyed"),    3u);
+
+  C.resetCounters();
+  for (const auto &counter : C.getCounters()) {
+    EXPECT_EQ(counter.second, 0u) << counter.first;
+  }
+}
+
+
+TEST(ConnectionsTest, testReorder) {
+  Connections C(100u, 0.5f);
+  Random rng(42);
+  vector<Segment> segments;
+  for (UInt i = 0; i < 200u; i++) {
+    const Segment seg = C.createSegment(rng.getUInt32(100u));
+    segments.push_back(seg);
+    for (UInt s = 0; s < 10u; s++) {
+      C.createSynapse(seg, rng.getUInt32(100u), static_cast<Permanence>(rng.getReal64()));
+    }
+  }
+  // Leave holes in the arrays.
+  for (UInt i = 0; i < 200u; i += 7u) {
+    C.destroySegment(segments[i]);
+  }
+  C.destroySynapse(C.synapsesForSegment(segments[1])[0]);
+
+  SDR active({100u});
+  active.randomize(0.2f, rng);
+  vector<SynapseIdx> potentialBefore(C.segmentFlatListLength());
+  const auto connectedBefore = C.computeActivity(potentialBefore, active.getSparse(), false);
+  const auto numSegments = C.numSegments();
+  const auto numSynapses = C.numSynapses();
+
+  const auto remap = C.reorder();
+  ASSERT_EQ(remap.segments.size(), connectedBefore.size());
+  EXPECT_EQ(C.segmentFlatListLength(), numSegments);
+  EXPECT_EQ(C.numSegments(), numSegments);
+  EXPECT_EQ(C.numSynapses(), numSynapses);
+
+  // Same activity, at the new indices.
+  vector<SynapseIdx> potentialAfter(C.segmentFlatListLength());
+  const auto connectedAfter = C.computeActivity(potentialAfter, active.getSparse(), false);
+  for (Segment seg = 0; seg < connectedBefore.size(); seg++) {
+    const Segment newSeg = remap.segments[seg];
+    if (newSeg == ConnectionsRemap::INVALID) continue;
+    EXPECT_EQ(connectedAfter[newSeg], connectedBefore[seg]);
+    EXPECT_EQ(potentialAfter[newSeg], potentialBefore[seg]);
+  }
+  EXPECT_EQ(remap.segments[segments[0]], ConnectionsRemap::INVALID);
+
+  // Segments are ordered by cell, synapses by segment & presynaptic cell.
+  for (Segment seg = 1; seg < C.segmentFlatListLength(); seg++) {
+    EXPECT_FALSE(C.compareSegments(seg, seg - 1));
+  }
+  Synapse expected = 0;
+  for (Segment seg = 0; seg < C.segmentFlatListLength(); seg++) {
+    const auto &syns = C.synapsesForSegment(seg);
+    vector<Synapse> sorted(syns.begin(), syns.end());
+    std::sort(sorted.begin(), sorted.end());
+    for (const auto syn : sorted) {
+      EXPECT_EQ(syn, expected++);
+      EXPECT_EQ(C.segmentForSynapse(syn), seg);
+      if (syn > 0 and C.segmentForSynapse(syn - 1) == seg) {
+        EXPECT_LE(C.dataForSynapse(syn - 1).presynapticCell, C.dataForSynapse(syn).presynapticCell);
+      }
+    }
+  }
+
+  // Still fully functional.
+  const Segment seg = C.createSegment(3u);
+  const Synapse syn = C.createSynapse(seg, 4u, 0.6f);
+  C.destroySynapse(C.synapsesForSegment(0u)[0]);
+  C.destroySegment(seg);
+  EXPECT_EQ(C.numSynapses(), numSynapses - 1u);
+  EXPECT_GT(syn, 0u);
+}
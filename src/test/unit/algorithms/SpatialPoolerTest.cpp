@@ -2117,4 +2117,66 @@ TEST(SpatialPoolerTest, ExactOutput) {
 }
 
 
+TEST(SpatialPoolerTest, testParallelLearning) {
+  SDR inputs({ 1000 });
+  SDR columns1({ 400 });
+  SDR columns4({ 400 });
+  SpatialPooler sp1({inputs.dimensions}, {columns1.dimensions},
+                    /*potentialRadius*/ 99999,
+                    /*potentialPct*/ 0.5f,
+                    /*globalInhibition*/ true,
+                    /*localAreaDensity*/ 0.05f,
+                    /*numActiveColumnsPerInhArea */ 0,
+                    /*stimulusThreshold*/ 8u);
+  SpatialPooler sp4 = sp1;
+  sp4.setNumThreads(4);
+  EXPECT_EQ(sp4.getNumThreads(), 4u);
+  EXPECT_EQ(sp1.getNumThreads(), 1u);
+  ASSERT_NE(&sp1.getConnections(), &sp4.getConnections());
+  ASSERT_EQ(&sp4.connections, &sp4.getConnections()); //the copy has its own Connections
+  const Connections initial = sp1.getConnections();
+
+  Random rng(42);
+  for(UInt i = 0; i < 100; i++) {
+    inputs.randomize( 0.1f, rng );
+    sp1.compute(inputs, true, columns1);
+    sp4.compute(inputs, true, columns4);
+    ASSERT_EQ(columns1, columns4) << "step " << i;
+  }
+  ASSERT_NE(initial, sp1.getConnections()) << "the SP did not learn";
+  EXPECT_EQ(sp1.getConnections(), sp4.getConnections());
+  EXPECT_EQ(sp1, sp4);
+}
+
+
+TEST(SpatialPoolerTest, testDenseInputOverlap) {
+  // Dense inputs take the bitset overlap, sparse ones the presynaptic maps.
+  // Alternate both while learning, the overlaps must always be exact.
+  SDR inputs({ 1000 });
+  SDR columns({ 200 });
+  SpatialPooler sp({inputs.dimensions}, {columns.dimensions},
+                   /*potentialRadius*/ 99999,
+                   /*potentialPct*/ 0.5f,
+                   /*globalInhibition*/ true,
+                   /*localAreaDensity*/ 0.05f);
+  Random rng(7);
+  for(UInt i = 0; i < 30; i++) {
+    inputs.randomize( i % 3 == 0 ? 0.02f : 0.4f, rng );
+    Connections reference = sp.connections;
+    const auto expected = reference.computeActivity(inputs.getSparse(), false);
+    const auto overlaps = sp.compute(inputs, true, columns);
+    ASSERT_EQ(overlaps, expected) << "step " << i;
+  }
+
+  // setPermanence() must also update the bitsets.
+  auto perm = sp.getPermanence(5);
+  for(auto &p : perm) p = p > 0.0f ? 1.0f : 0.0f;
+  sp.setPermanence(5, perm.data());
+  inputs.randomize( 0.4f, rng );
+  Connections reference = sp.connections;
+  const auto expected = reference.computeActivity(inputs.getSparse(), false);
+  ASSERT_EQ(sp.compute(inputs, false, columns), expected);
+}
+
+
 } // end anonymous namespace
@@ -21,6 +21,7 @@
 
 #include <cstring>
 #include <fstream>
+#include <set>
 
 #include <htm/types/Types.hpp>
 #include <htm/types/Sdr.hpp>
@@ -1662,6 +1663,143 @@ TEST(TemporalMemoryTest, testIncorrectDefaultConstructor) {
   EXPECT_NO_THROW(tmOk.compute(data2, true));
 }
 
+TEST(TemporalMemoryTest, testCounters) {
+  TemporalMemory tm({64}, 4);
+  SDR a({64}), b({64});
+  SDR_sparse_t first, second;
+  for (UInt i = 0; i < 16; i++) {
+    first.push_back(i);
+    second.push_back(16 + i);
+  }
+  a.setSparse(first);
+  b.setSparse(second);
+  for (int i = 0; i < 10; i++) {
+    tm.compute(a, true);
+    tm.compute(b, true);
+  }
+
+  const auto counters = tm.getCounters();
+  if (not HTM_COUNTERS_ENABLED) {
+    EXPECT_TRUE(counters.empty());
+    return;
+  }
+  EXPECT_EQ(counters.at("computeCalls"), 20u);
+  EXPECT_EQ(counters.at("activeColumns"), 320u);
+  EXPECT_EQ(counters.at("burstingColumns") + counters.at("predictedColumns"), 320u);
+  EXPECT_GT(counters.at("predictedColumns"), 0u) << "The sequence should be learned.";
+  EXPECT_GE(counters.at("burstingColumns"), 32u) << "Both inputs burst at first.";
+  EXPECT_EQ(counters.at("connections.segmentsCreated"), counters.at("segmentsGrown"));
+  EXPECT_EQ(counters.at("connections.computeActivityCalls"), 20u);
+
+  tm.resetCounters();
+  for (const auto &counter : tm.getCounters()) {
+    EXPECT_EQ(counter.second, 0u) << counter.first;
+  }
+}
+
+TEST(TemporalMemoryTest, testReorderKeepsOutput) {
+  TemporalMemory tm1({100}, 8, 3, 0.21f, 0.5f, 2, 4, 0.1f, 0.05f, 0.01f, 42, 6, 8);
+  TemporalMemory tm2({100}, 8, 3, 0.21f, 0.5f, 2, 4, 0.1f, 0.05f, 0.01f, 42, 6, 8);
+  tm2.setReorderPeriod(7);
+  Random rng(7);
+  vector<SDR> sequence(20, SDR({100}));
+  for (auto &sdr : sequence) {
+    sdr.randomize(0.05f, rng);
+  }
+  for (UInt i = 0; i < 300; i++) {
+    const SDR &input = sequence[i % sequence.size()];
+    tm1.compute(input, true);
+    tm2.compute(input, true);
+    ASSERT_EQ(tm1.getActiveCells(), tm2.getActiveCells()) << "step " << i;
+    ASSERT_EQ(tm1.getWinnerCells(), tm2.getWinnerCells()) << "step " << i;
+    ASSERT_EQ(tm1.anomaly, tm2.anomaly) << "step " << i;
+  }
+  EXPECT_EQ(tm1.connections.numSynapses(), tm2.connections.numSynapses());
+  EXPECT_EQ(tm2.connections.segmentFlatListLength(), tm2.connections.numSegments());
+}
+
+/**
+ * A copy must not share state with the original, as Network::saveToFileAsync()
+ * serializes a copy while the original keeps computing.
+ */
+TEST(TemporalMemoryTest, testCopyIsIndependent) {
+  TemporalMemory tm({100}, 8, 3, 0.21f, 0.5f, 2, 4, 0.1f, 0.05f, 0.01f, 42, 6, 8);
+  Random rng(7);
+  vector<SDR> sequence(20, SDR({100}));
+  for (auto &sdr : sequence) {
+    sdr.randomize(0.05f, rng);
+  }
+  for (UInt i = 0; i < 100; i++) {
+    tm.compute(sequence[i % sequence.size()], true);
+  }
+  ASSERT_FALSE(tm.getActiveSegments().empty());
+
+  const TemporalMemory copy(tm);
+  EXPECT_NE(&copy.connections, &tm.connections);
+  EXPECT_NE(&copy.anomaly, &tm.anomaly);
+  EXPECT_NE(&copy.externalPredictiveInputs, &tm.externalPredictiveInputs);
+  stringstream before;
+  tm.save(before);
+
+  //change the original: new input, and segments destroyed and moved
+  tm.setReorderPeriod(1);
+  for (UInt i = 0; i < 50; i++) {
+    SDR input({100});
+    input.randomize(0.05f, rng);
+    tm.compute(input, true);
+  }
+  for (CellIdx cell = 0; cell < tm.numberOfCells(); cell++) {
+    for (const Segment seg : vector<Segment>(tm.connections.segmentsForCell(cell))) {
+      tm.destroySegment(seg);
+    }
+  }
+
+  stringstream after;
+  copy.save(after);
+  EXPECT_EQ(before.str(), after.str());
+
+  TemporalMemory restored;
+  restored.load(after);
+  EXPECT_TRUE(restored == copy);
+}
+
+TEST(TemporalMemoryTest, testPredictiveCache) {
+  TemporalMemory tm({100}, 8, 3, 0.21f, 0.5f, 2, 4, 0.1f, 0.05f, 0.01f, 42, 6, 8);
+  tm.setReorderPeriod(11);
+  Random rng(3);
+  vector<SDR> sequence(10, SDR({100}));
+  for (auto &sdr : sequence) {
+    sdr.randomize(0.05f, rng);
+  }
+  SDR cells({100, 8});
+  SDR columns({100});
+  size_t numPredicted = 0;
+  for (UInt i = 0; i < 200; i++) {
+    tm.compute(sequence[i % sequence.size()], true);
+    if (i % 50 == 49) {
+      tm.reset();
+      EXPECT_ANY_THROW(tm.getPredictiveColumnsSparse());
+    }
+    tm.activateDendrites(true);
+
+    // Compare against the set of cells with an active segment.
+    std::set<CellIdx> expected;
+    for (const auto segment : tm.getActiveSegments()) {
+      expected.insert(tm.connections.cellForSegment(segment));
+    }
+    ASSERT_EQ(vector<CellIdx>(expected.begin(), expected.end()),
+              tm.getPredictiveCellsSparse()) << "step " << i;
+
+    tm.getPredictiveCells(cells);
+    tm.getPredictiveColumns(columns);
+    ASSERT_EQ(tm.getPredictiveCells(), cells);
+    ASSERT_EQ(tm.cellsToColumns(cells), columns) << "step " << i;
+    ASSERT_EQ(columns.getSparse(), tm.getPredictiveColumnsSparse());
+    numPredicted += columns.getSum();
+  }
+  EXPECT_GT(numPredicted, 0u);
+}
+
 // Uncomment these tests individually to save/load from a file.
 // This is useful for ad-hoc testing of backwards-compatibility.
 
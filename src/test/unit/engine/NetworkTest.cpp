@@ -21,6 +21,8 @@
 
 #include "gtest/gtest.h"
 
+#include <thread>
+
 #include <htm/engine/Network.hpp>
 #include <htm/engine/Region.hpp>
 #include <htm/engine/Input.hpp>
@@ -28,6 +30,8 @@
 #include <htm/ntypes/Dimensions.hpp>
 #include <htm/engine/RegionImpl.hpp>
 #include <htm/engine/RegisteredRegionImplCpp.hpp>
+#include <htm/os/Directory.hpp>
+#include <htm/os/SharedMemory.hpp>
 #include <htm/utils/Log.hpp>
 
 namespace testing {
@@ -471,6 +475,169 @@ TEST(NetworkTest, Callback) {
   EXPECT_STREQ("level3", mydata[5].c_str());
 }
 
+TEST(NetworkTest, ComputePeriod) {
+  Network n;
+  auto l1 = n.addRegion("level1", "TestNode", "{dim: [1]}");
+  auto l2 = n.addRegion("level2", "TestNode", "{dim: [1]}");
+  auto l3 = n.addRegion("level3", "TestNode", "{dim: [1]}");
+  std::set<UInt32> phases;
+  phases.insert(0);
+  n.setPhases("level2", phases);
+  n.setPhases("level3", phases);
+
+  EXPECT_THROW(n.setComputePeriod("level2", 0), std::exception);
+  EXPECT_THROW(n.setComputePeriod("level2", 2, 2), std::exception);
+  EXPECT_THROW(n.setComputePeriod("nonexistent", 2), std::exception);
+  n.setComputePeriod("level2", 2);
+  n.setComputePeriod("level3", 3, 1);
+  EXPECT_EQ(2u, n.getComputePeriod("level2"));
+  EXPECT_EQ(1u, n.getComputeOffset("level3"));
+  EXPECT_EQ(1u, n.getComputePeriod("level1"));
+  n.initialize();
+
+  l1->setParameterUInt64("computeCallback", (UInt64)recordCompute);
+  l2->setParameterUInt64("computeCallback", (UInt64)recordCompute);
+  l3->setParameterUInt64("computeCallback", (UInt64)recordCompute);
+
+  computeHistory.clear();
+  n.run(6);
+  std::map<std::string, int> counts;
+  for (const auto &name : computeHistory)
+    counts[name]++;
+  EXPECT_EQ(6, counts["level1"]);
+  EXPECT_EQ(3, counts["level2"]); // iterations 0, 2, 4
+  EXPECT_EQ(2, counts["level3"]); // iterations 1, 4
+
+  // The schedule is saved with the network.
+  std::stringstream ss;
+  n.save(ss);
+  Network n2;
+  n2.load(ss);
+  EXPECT_EQ(2u, n2.getComputePeriod("level2"));
+  EXPECT_EQ(3u, n2.getComputePeriod("level3"));
+  EXPECT_EQ(1u, n2.getComputeOffset("level3"));
+  EXPECT_EQ(1u, n2.getComputePeriod("level1"));
+}
+
+TEST(NetworkTest, ComputePeriodConfigure) {
+  Network n;
+  n.configure(R"(network:
+    - addRegion: {name: "fast", type: "TestNode", params: {dim: [1]}}
+    - addRegion: {name: "slow", type: "TestNode", params: {dim: [1]}, phase: 1, period: 10, offset: 9}
+  )");
+  EXPECT_EQ(1u,  n.getComputePeriod("fast"));
+  EXPECT_EQ(10u, n.getComputePeriod("slow"));
+  EXPECT_EQ(9u,  n.getComputeOffset("slow"));
+}
+
+static void recordSPOutput(Network *net, UInt64 iteration, void *data) {
+  auto history = static_cast<std::vector<SDR_sparse_t> *>(data);
+  history->push_back(net->getRegion("sp")->getOutputData("bottomUpOut").getSDR().getSparse());
+}
+
+TEST(NetworkTest, BatchSize) {
+  const std::string config = R"(network:
+    - addRegion: {name: "encoder", type: "RDSEEncoderRegion", params: {size: 400, sparsity: 0.1, radius: 1.0, noise: 0.05, seed: 42, sensedValue: 5}}
+    - addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 200, globalInhibition: true, seed: 42}, phase: 1}
+    - addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 4, seed: 42}, phase: 2}
+    - addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}
+    - addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn"}
+  )";
+  Network plain;
+  plain.configure(config);
+  Network batched;
+  batched.configure(config);
+  EXPECT_THROW(batched.setBatchSize(0), std::exception);
+  batched.setBatchSize(4);
+  EXPECT_EQ(4u, batched.getBatchSize());
+
+  std::vector<SDR_sparse_t> plainHistory, batchedHistory;
+  plain.getCallbacks().add("record", Network::callbackItem(recordSPOutput, &plainHistory));
+  batched.getCallbacks().add("record", Network::callbackItem(recordSPOutput, &batchedHistory));
+
+  // Not a multiple of the batch size, the last batch is short.
+  plain.run(10);
+  batched.run(10);
+  ASSERT_EQ(10u, batchedHistory.size());
+  EXPECT_EQ(plainHistory, batchedHistory);
+  EXPECT_EQ(plain.getRegion("tm")->getOutputData("bottomUpOut").getSDR(),
+            batched.getRegion("tm")->getOutputData("bottomUpOut").getSDR());
+
+  // Back to one iteration at a time.
+  batched.setBatchSize(1);
+  plain.run(3);
+  batched.run(3);
+  EXPECT_EQ(plainHistory, batchedHistory);
+}
+
+#if !defined(NTA_OS_WINDOWS)
+static void recordTMOutput(Network *net, UInt64 iteration, void *data) {
+  auto history = static_cast<std::vector<SDR_sparse_t> *>(data);
+  history->push_back(net->getRegion("tm")->getOutputData("bottomUpOut").getSDR().getSparse());
+}
+
+TEST(NetworkTest, Partition) {
+  const std::string config = R"(network:
+    - addRegion: {name: "encoder", type: "RDSEEncoderRegion", params: {size: 400, sparsity: 0.1, radius: 1.0, seed: 42}, partition: "front"}
+    - addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 200, globalInhibition: true, seed: 42}, partition: "front"}
+    - addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 4, seed: 42}, partition: "back"}
+    - addLink:   {src: "INPUT.value", dest: "encoder.values", dim: [1]}
+    - addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}
+    - addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn", slots: 2}
+  )";
+  const int iterations = 20;
+  auto value = [](int i) { return Array(std::vector<Real64>({static_cast<Real64>(i % 7)})); };
+
+  // Without a partition, configure() ignores the partitions.
+  Network whole;
+  whole.configure(config);
+  EXPECT_EQ(4u, whole.getRegions().size()) << "INPUT, encoder, sp and tm";
+  std::vector<SDR_sparse_t> wholeHistory;
+  whole.getCallbacks().add("record", Network::callbackItem(recordTMOutput, &wholeHistory));
+  for (int i = 0; i < iterations; i++) {
+    whole.setInputData("value", value(i));
+    whole.run(1);
+  }
+
+  Network front;
+  front.setPartition("front", "/htm.test.partition.");
+  front.configure(config);
+  EXPECT_EQ("front", front.getPartition());
+  EXPECT_EQ(4u, front.getRegions().size()) << "INPUT, encoder, sp and the writer of sp.bottomUpOut";
+  EXPECT_EQ("SharedMemoryOutputRegion", front.getRegion("partition_sp_bottomUpOut_back")->getType());
+
+  Network back;
+  back.setPartition("back", "/htm.test.partition.");
+  back.configure(config);
+  EXPECT_EQ(2u, back.getRegions().size()) << "the reader of sp.bottomUpOut and tm";
+  EXPECT_EQ("SharedMemoryInputRegion", back.getRegion("partition_sp_bottomUpOut")->getType());
+  std::vector<SDR_sparse_t> backHistory;
+  back.getCallbacks().add("record", Network::callbackItem(recordTMOutput, &backHistory));
+
+  // The back partition waits for the front one to create the ring, and then
+  // for each of its frames.
+  std::thread backThread([&back]() { back.run(iterations); });
+  for (int i = 0; i < iterations; i++) {
+    front.setInputData("value", value(i));
+    front.run(1);
+  }
+  backThread.join();
+  EXPECT_EQ(wholeHistory, backHistory);
+
+  // The default ring names fit the shm_open() limit of the system.
+  Network defaultNames;
+  defaultNames.setPartition("front");
+  defaultNames.configure(config);
+  const std::string ring = defaultNames.getRegion("partition_sp_bottomUpOut_back")->getParameterString("name");
+  EXPECT_EQ("/htm.link.", ring.substr(0u, 10u));
+  EXPECT_LE(ring.size(), SharedMemoryWriter::maxNameLength());
+
+  // Nothing more from the front partition.
+  back.getRegion("partition_sp_bottomUpOut")->setParameterUInt32("timeout", 50u);
+  EXPECT_ANY_THROW(back.run(1));
+}
+#endif
+
 /**
  * Test operator '=='
  */
@@ -615,4 +782,128 @@ TEST(NetworkTest, SaveRestore) {
   ASSERT_STREQ(s1.c_str(), s2.c_str());
 }
 
+
+TEST(NetworkTest, SaveRestoreSectioned) {
+  const std::string config = R"(
+  {network: [
+       {addRegion: {name: "encoder", type: "RDSEEncoderRegion", params: {size: 1000, sparsity: 0.2, radius: 0.03, seed: 2019, noise: 0.01}}},
+       {addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 1000, globalInhibition: true, seed: 42}}},
+       {addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 8, orColumnOutputs: true, seed: 42}}},
+       {addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}},
+       {addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn"}}
+  ]})";
+  Network net1;
+  net1.configure(config);
+  for (int i = 0; i < 10; i++) {
+    net1.getRegion("encoder")->setParameterReal64("sensedValue", 0.1 * i);
+    net1.run(1);
+  }
+
+  Directory::removeTree("TestOutputDir", true);
+  net1.saveToFileSectioned("TestOutputDir/sectioned.snapshot");
+
+  // Eager, parallel restore.
+  Network net2;
+  net2.loadFromFileSectioned("TestOutputDir/sectioned.snapshot", 2);
+  EXPECT_TRUE(net2.getRegion("tm")->isImplLoaded());
+  EXPECT_TRUE(net1 == net2) << "Sectioned restore does not match the original network.";
+
+  // Lazy restore; each region is deserialized on its first compute().
+  Network net3;
+  net3.loadFromFileSectioned("TestOutputDir/sectioned.snapshot", 0, true);
+  EXPECT_FALSE(net3.getRegion("sp")->isImplLoaded());
+  EXPECT_FALSE(net3.getRegion("tm")->isImplLoaded());
+
+  // A lazily loaded network can itself be saved without loading every region.
+  net3.saveToFileSectioned("TestOutputDir/sectioned2.snapshot");
+  EXPECT_FALSE(net3.getRegion("tm")->isImplLoaded());
+
+  for (auto net : {&net1, &net2, &net3}) {
+    net->getRegion("encoder")->setParameterReal64("sensedValue", 0.5);
+    net->run(1);
+  }
+  EXPECT_TRUE(net3.getRegion("sp")->isImplLoaded());
+  EXPECT_TRUE(net3.getRegion("tm")->isImplLoaded());
+  EXPECT_EQ(net1.getRegion("tm")->getOutputData("bottomUpOut"),
+            net2.getRegion("tm")->getOutputData("bottomUpOut"));
+  EXPECT_EQ(net1.getRegion("tm")->getOutputData("bottomUpOut"),
+            net3.getRegion("tm")->getOutputData("bottomUpOut"));
+
+  Network net4;
+  net4.loadFromFileSectioned("TestOutputDir/sectioned2.snapshot");
+  net4.getRegion("encoder")->setParameterReal64("sensedValue", 0.5);
+  net4.run(1);
+  EXPECT_EQ(net1.getRegion("tm")->getOutputData("bottomUpOut"),
+            net4.getRegion("tm")->getOutputData("bottomUpOut"));
+
+  // Not a sectioned snapshot.
+  net1.saveToFile("TestOutputDir/plain.snapshot");
+  Network net5;
+  EXPECT_THROW(net5.loadFromFileSectioned("TestOutputDir/plain.snapshot"), htm::Exception);
+
+  Directory::removeTree("TestOutputDir", true);
+}
+
+static void checkpointCallback(Network *net, UInt64 iteration, void *data) {
+  if (iteration == 3) {
+    *static_cast<std::shared_future<void> *>(data) =
+        net->saveToFileAsync("TestOutputDir/callback.snapshot");
+  }
+}
+
+TEST(NetworkTest, SaveToFileAsync) {
+  const std::string config = R"(
+  {network: [
+       {addRegion: {name: "encoder", type: "RDSEEncoderRegion", params: {size: 1000, sparsity: 0.2, radius: 0.03, seed: 2019, noise: 0.01}}},
+       {addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 1000, globalInhibition: true, seed: 42}}},
+       {addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 8, orColumnOutputs: true, seed: 42}}},
+       {addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}},
+       {addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn"}}
+  ]})";
+  Directory::removeTree("TestOutputDir", true);
+  Network net1;
+  net1.configure(config);
+  net1.getRegion("encoder")->setParameterReal64("sensedValue", 0.1);
+  net1.run(5);
+  // SP and TM are captured as copies and serialized by the writer thread.
+  EXPECT_TRUE(net1.getRegion("sp")->snapshotImpl() != nullptr);
+  EXPECT_TRUE(net1.getRegion("tm")->snapshotImpl() != nullptr);
+  EXPECT_TRUE(net1.getRegion("encoder")->snapshotImpl() == nullptr);
+
+  // The async checkpoint holds the state at this point, even though
+  // net1 keeps running while it is being written.
+  std::shared_future<void> done = net1.saveToFileAsync("TestOutputDir/async.snapshot");
+  net1.saveToFileSectioned("TestOutputDir/sync.snapshot");
+  net1.getRegion("encoder")->setParameterReal64("sensedValue", 0.7);
+  net1.run(5);
+  ASSERT_NO_THROW(done.get());
+
+  Network net2, net3;
+  net2.loadFromFileSectioned("TestOutputDir/async.snapshot");
+  net3.loadFromFileSectioned("TestOutputDir/sync.snapshot");
+  EXPECT_TRUE(net2 == net3) << "Async checkpoint does not match the state when it was requested.";
+  EXPECT_FALSE(net1 == net2);
+
+  // Requested from a run callback; taken at the end of iteration 3 while run(5) continues.
+  Network net4;
+  net4.configure(config);
+  std::shared_future<void> fromCallback;
+  net4.getCallbacks().add("checkpoint", Network::callbackItem(checkpointCallback, &fromCallback));
+  net4.run(5);
+  ASSERT_TRUE(fromCallback.valid());
+  ASSERT_NO_THROW(fromCallback.get());
+
+  Network net5, net6;
+  net5.configure(config);
+  net5.run(3);
+  net6.loadFromFileSectioned("TestOutputDir/callback.snapshot");
+  EXPECT_TRUE(net5 == net6) << "Checkpoint from a callback is not at the iteration boundary.";
+
+  // Errors surface through the future.
+  Directory::create("TestOutputDir/isADirectory", false, true);
+  EXPECT_THROW(net1.saveToFileAsync("TestOutputDir/isADirectory").get(), htm::Exception);
+
+  Directory::removeTree("TestOutputDir", true);
+}
+
 } // namespace testing
@@ -0,0 +1,171 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <fstream>
+#include <set>
+
+#include <htm/engine/ParameterSweep.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/os/Directory.hpp>
+
+namespace testing {
+
+using namespace htm;
+
+static const std::string config = R"(
+   {network: [
+       {addRegion: {name: "encoder", type: "RDSERegion", params: {size: 400, sparsity: 0.1, radius: 0.1, seed: 2019}}},
+       {addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 256, globalInhibition: true, seed: 7}}},
+       {addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 4, seed: 7}}},
+       {addLink:   {src: "INPUT.source", dest: "encoder.values", dim: [1]}},
+       {addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}},
+       {addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn"}}
+    ]})";
+
+static std::vector<std::vector<Real64>> dataset(size_t n) {
+  std::vector<std::vector<Real64>> rows;
+  for (size_t i = 0u; i < n; i++)
+    rows.push_back({std::sin(0.3 * static_cast<Real64>(i))});
+  return rows;
+}
+
+
+TEST(ParameterSweepTest, gridConfigurations) {
+  ParameterSweep sweep(config);
+  sweep.configure(R"({parameters: {sp.columnCount: [128, 256],
+                                   tm.cellsPerColumn: {min: 2, max: 8, integer: true, steps: 3}}})");
+  const auto configs = sweep.configurations();
+  ASSERT_EQ(configs.size(), 6u);
+  std::set<std::string> seen;
+  for (const auto &c : configs) {
+    ASSERT_EQ(c.size(), 2u);
+    seen.insert(c.at("sp.columnCount") + "/" + c.at("tm.cellsPerColumn"));
+  }
+  EXPECT_EQ(seen, std::set<std::string>({"128/2", "128/5", "128/8", "256/2", "256/5", "256/8"}));
+
+  ParameterSweep range(config);
+  range.addRange("sp.potentialPct", 0.5, 0.9);
+  EXPECT_ANY_THROW(range.configurations()) << "a grid search needs steps";
+  EXPECT_ANY_THROW(range.addChoices("columnCount", {"128"})) << "not <region>.<param>";
+}
+
+
+TEST(ParameterSweepTest, randomConfigurations) {
+  ParameterSweep sweep(config);
+  sweep.configure(R"({search: random, samples: 20, seed: 3,
+                      parameters: {sp.columnCount: [128, 256],
+                                   sp.potentialPct: {min: 0.5, max: 0.9},
+                                   tm.cellsPerColumn: {min: 2, max: 8, integer: true}}})");
+  const auto configs = sweep.configurations();
+  ASSERT_EQ(configs.size(), 20u);
+  for (const auto &c : configs) {
+    EXPECT_TRUE(c.at("sp.columnCount") == "128" || c.at("sp.columnCount") == "256");
+    const Real64 pct = std::stod(c.at("sp.potentialPct"));
+    EXPECT_TRUE(pct >= 0.5 && pct <= 0.9);
+    const int cells = std::stoi(c.at("tm.cellsPerColumn"));
+    EXPECT_TRUE(cells >= 2 && cells <= 8);
+  }
+  EXPECT_EQ(configs, sweep.configurations()) << "same seed, same samples";
+}
+
+
+TEST(ParameterSweepTest, networkConfig) {
+  ParameterSweep sweep(config);
+  const std::string yaml = sweep.networkConfig({{"sp.columnCount", "128"}, {"tm.activationThreshold", "5"}});
+  Network net;
+  net.configure(yaml);
+  EXPECT_EQ(net.getRegion("sp")->getParameterUInt32("columnCount"), 128u);
+  EXPECT_EQ(net.getRegion("sp")->getParameterBool("globalInhibition"), true) << "base params are kept";
+  EXPECT_EQ(net.getRegion("tm")->getParameterUInt32("activationThreshold"), 5u);
+  EXPECT_ANY_THROW(sweep.networkConfig({{"nosuchregion.columnCount", "128"}}));
+}
+
+
+TEST(ParameterSweepTest, run) {
+  ParameterSweep sweep(config);
+  sweep.configure(R"({threads: 3, metric: {output: tm.anomaly, skip: 10},
+                      parameters: {sp.columnCount: [128, 256], tm.cellsPerColumn: [2, 4, 0]}})");
+  const std::vector<std::vector<Real64>> rows = dataset(40u);
+  sweep.setDataset(rows);
+  const auto configs = sweep.configurations();
+  const auto results = sweep.run();
+  ASSERT_EQ(results.size(), configs.size());
+
+  for (size_t i = 0u; i < results.size(); i++) {
+    const auto &r = results[i];
+    EXPECT_EQ(r.index, i);
+    EXPECT_EQ(r.parameters, configs[i]);
+    if (configs[i].at("tm.cellsPerColumn") == "0") {
+      EXPECT_FALSE(r.error.empty()) << "a failed configuration is reported";
+      EXPECT_TRUE(std::isnan(r.score));
+      continue;
+    }
+    ASSERT_TRUE(r.error.empty()) << r.error;
+
+    // The same as running the configuration alone.
+    Network net;
+    net.configure(sweep.networkConfig(configs[i]));
+    Real64 sum = 0.0;
+    for (size_t j = 0u; j < rows.size(); j++) {
+      net.setInputData("source", Array(rows[j]));
+      net.run(1);
+      if (j >= 10u)
+        sum += net.getRegion("tm")->getOutputData("anomaly").asVector<Real64>()[0];
+    }
+    EXPECT_NEAR(r.score, sum / 30.0, 1e-9) << "configuration " << i;
+  }
+
+  const auto best = sweep.best(results);
+  for (const auto &r : results) {
+    if (r.error.empty())
+      EXPECT_LE(best.score, r.score);
+  }
+
+  sweep.setMetric([](Network &, size_t iteration) { return static_cast<Real64>(iteration); }, 30u, false);
+  const auto custom = sweep.run();
+  EXPECT_DOUBLE_EQ(custom[0].score, 34.5);
+  EXPECT_DOUBLE_EQ(sweep.best(custom).score, 34.5);
+
+  sweep.setMetric("tm.anomaly", 40u);
+  EXPECT_ANY_THROW(sweep.run()) << "nothing left after the warm up";
+}
+
+
+TEST(ParameterSweepTest, loadDataset) {
+  const std::string path = "TestOutputDir/sweep_dataset.csv";
+  Directory::create("TestOutputDir", false, true);
+  {
+    std::ofstream f(path.c_str());
+    f << "value\n0.5\n# comment\n-1.25 \n\n3\n";
+  }
+  ParameterSweep sweep(config);
+  sweep.loadDataset(path);
+  EXPECT_EQ(sweep.getDatasetSize(), 3u);
+
+  {
+    std::ofstream f(path.c_str());
+    f << "0.5\nabc\n";
+  }
+  EXPECT_ANY_THROW(sweep.loadDataset(path));
+  EXPECT_ANY_THROW(sweep.loadDataset("TestOutputDir/nosuchfile.csv"));
+  Directory::removeTree("TestOutputDir");
+}
+
+} // namespace testing
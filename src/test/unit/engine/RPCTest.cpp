@@ -0,0 +1,282 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+//
+// Test the binary RPC server and client.
+// The server runs in a new thread, the original thread acts as the client.
+//
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <htm/engine/RPCclient.hpp>
+#include <htm/engine/RPCserver.hpp>
+
+namespace testing {
+
+using namespace htm;
+
+#if !defined(NTA_OS_WINDOWS)
+
+static const std::string address = "/tmp/htm_rpc_test.sock";
+
+static const std::string config = R"(
+   {network: [
+       {addRegion: {name: "encoder", type: "RDSERegion", params: {size: 1000, sparsity: 0.2, radius: 0.03, seed: 2019}}},
+       {addRegion: {name: "sp", type: "SPRegion", params: {columnCount: 2048, globalInhibition: true}}},
+       {addRegion: {name: "tm", type: "TMRegion", params: {cellsPerColumn: 8, orColumnOutputs: true}}},
+       {addLink:   {src: "INPUT.source", dest: "encoder.values", dim: [1]}},
+       {addLink:   {src: "encoder.encoded", dest: "sp.bottomUpIn"}},
+       {addLink:   {src: "sp.bottomUpOut", dest: "tm.bottomUpIn"}}
+    ]})";
+
+static Array sample(size_t i) { return Array(std::vector<Real64>({std::sin(0.01 * (Real64)i)})); }
+
+// Start a server in its own thread and wait until it accepts connections.
+static std::thread startServer(RPCserver &server, const std::string &address) {
+  std::thread t(&RPCserver::listen, &server, address);
+  for (int i = 0; i < 500 && !server.isListening(); i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_TRUE(server.isListening());
+  return t;
+}
+
+
+TEST(RPCTest, buffer) {
+  SDR sdr({10u, 10u});
+  sdr.setSparse(SDR_sparse_t({1u, 5u, 99u}));
+  RPCbuffer out;
+  out.putUInt32(42u).putString("hello").putArray(Array(sdr)).putArray(Array(std::vector<Real32>({1.5f, -2.0f})));
+
+  std::vector<char> frame;
+  out.appendFrame(frame, 7u, static_cast<std::uint8_t>(RPCop::RUN));
+  frame.push_back('x'); // the start of the next frame
+
+  size_t offset = 0u;
+  UInt32 sequence;
+  std::uint8_t code;
+  RPCbuffer in;
+  ASSERT_TRUE(rpc::takeFrame(frame, offset, sequence, code, in));
+  EXPECT_EQ(offset, frame.size() - 1u);
+  EXPECT_EQ(sequence, 7u);
+  EXPECT_EQ(code, static_cast<std::uint8_t>(RPCop::RUN));
+  EXPECT_FALSE(rpc::takeFrame(frame, offset, sequence, code, in)) << "incomplete frame";
+
+  EXPECT_EQ(in.getUInt32(), 42u);
+  EXPECT_EQ(in.getString(), "hello");
+  Array a = in.getArray();
+  ASSERT_EQ(a.getType(), NTA_BasicType_SDR);
+  EXPECT_EQ(a.getSDR(), sdr);
+  std::vector<UInt> dims;
+  Array b = in.getArray(&dims);
+  EXPECT_EQ(dims, std::vector<UInt>({2u}));
+  EXPECT_EQ(b.asVector<Real32>(), std::vector<Real32>({1.5f, -2.0f}));
+  EXPECT_TRUE(in.atEnd());
+  EXPECT_ANY_THROW(in.getUInt32()) << "read past the end";
+}
+
+
+// Replace the UInt32 at 'offset' of an encoded payload.
+static RPCbuffer patched(const RPCbuffer &buffer, size_t offset, UInt32 value) {
+  std::vector<char> data = buffer.data();
+  std::memcpy(&data[offset], &value, sizeof(value));
+  return RPCbuffer(std::move(data));
+}
+
+
+TEST(RPCTest, malformedArray) {
+  // Layout of an SDR: type [0], number of dimensions [1], dimensions [5],
+  // number of active bits and the sparse indices.
+  SDR sdr({10u, 10u});
+  sdr.setSparse(SDR_sparse_t({1u, 5u}));
+  RPCbuffer valid;
+  valid.putArray(Array(sdr));
+  const size_t count = 13u;
+  const size_t first = 17u;
+  const size_t second = 21u;
+  EXPECT_EQ(RPCbuffer(std::vector<char>(valid.data())).getArray().getSDR(), sdr);
+
+  EXPECT_ANY_THROW(patched(valid, 1u, 0xFFFFFFFFu).getArray()) << "more dimensions than bytes";
+  EXPECT_ANY_THROW(patched(valid, 1u, 0u).getArray()) << "no dimensions";
+  EXPECT_ANY_THROW(patched(patched(valid, 5u, 0x10000u), 9u, 0x10000u).getArray()) << "dimensions overflow";
+  EXPECT_ANY_THROW(patched(valid, count, 0xFFFFFFFFu).getArray()) << "more indices than bytes";
+  EXPECT_ANY_THROW(patched(valid, first, 5u).getArray()) << "duplicate index";
+  EXPECT_ANY_THROW(patched(valid, first, 7u).getArray()) << "unsorted indices";
+  EXPECT_ANY_THROW(patched(valid, second, 100u).getArray()) << "index out of range";
+  EXPECT_ANY_THROW(patched(valid, second, 0xFFFFFFFFu).getArray()) << "index out of range";
+
+  // Layout of other arrays: type, number of dimensions, dimensions, count and the data.
+  RPCbuffer dense;
+  dense.putArray(Array(std::vector<Real32>({1.0f, 2.0f})));
+  EXPECT_ANY_THROW(patched(dense, 9u, 3u).getArray()) << "count larger than the dimensions";
+  EXPECT_ANY_THROW(patched(dense, 9u, 1u).getArray()) << "count smaller than the dimensions";
+  EXPECT_ANY_THROW(patched(dense, 9u, 0xFFFFFFFFu).getArray()) << "more elements than bytes";
+
+  EXPECT_ANY_THROW(RPCbuffer().putUInt32(0xFFFFFFFFu).getString()) << "string longer than the message";
+
+  // The server answers malformed requests with an error.
+  RPCserver server;
+  RPCbuffer create = RPCbuffer().putString("").putString(config);
+  const std::string id = server.handle(RPCop::CREATE_NETWORK, create).getString();
+  RPCbuffer batch = RPCbuffer().putString(id).putString("source").putUInt32(0xFFFFFFFFu);
+  EXPECT_ANY_THROW(server.handle(RPCop::RUN_BATCH, batch)) << "more inputs than bytes";
+  batch = RPCbuffer().putString(id).putString("source").putUInt32(0u).putUInt32(0xFFFFFFFFu);
+  EXPECT_ANY_THROW(server.handle(RPCop::RUN_BATCH, batch)) << "more outputs than bytes";
+
+  std::thread serverThread = startServer(server, address);
+  {
+    RPCclient client(address);
+    RPCbuffer input = RPCbuffer().putString(id).putString("source");
+    const size_t start = input.data().size();
+    input.putArray(Array(sdr));
+    EXPECT_ANY_THROW(client.receive(client.send(RPCop::SET_INPUT, patched(input, start + first, 5u))));
+    EXPECT_NO_THROW(client.run(id)) << "the connection is still usable";
+    client.stopServer();
+  }
+  serverThread.join();
+}
+
+
+TEST(RPCTest, clientServer) {
+  RPCserver server;
+  std::thread serverThread = startServer(server, address);
+  {
+    RPCclient client(address);
+    const std::string id = client.createNetwork(config);
+    EXPECT_FALSE(id.empty());
+
+    client.setInput(id, "source", sample(0u));
+    client.run(id);
+    Array encoded = client.getOutput(id, "encoder", "encoded");
+    EXPECT_EQ(encoded.getType(), NTA_BasicType_SDR);
+    EXPECT_EQ(encoded.getCount(), 1000u);
+    EXPECT_EQ(client.getInput(id, "sp", "bottomUpIn").getSDR(), encoded.getSDR());
+
+    client.setParameter(id, "sp", "learningMode", "0");
+    EXPECT_EQ(client.getParameter(id, "sp", "learningMode"), "0");
+    client.setParameter(id, "sp", "learningMode", "1");
+
+    // Errors are reported by the call that caused them.
+    EXPECT_ANY_THROW(client.getOutput(id, "nosuchregion", "anomaly"));
+    EXPECT_ANY_THROW(client.run("nosuchid"));
+    EXPECT_NO_THROW(client.run(id)) << "the connection is still usable";
+
+    // A pipelined sequence gives the same results as the one at a time calls.
+    const std::string id2 = client.createNetwork(config, "second");
+    EXPECT_EQ(id2, "second");
+    Array anomaly;
+    for (size_t i = 1u; i <= 5u; i++) {
+      client.setInput(id, "source", sample(i));
+      client.run(id);
+      anomaly = client.getOutput(id, "tm", "anomaly");
+    }
+    client.send(RPCop::SET_INPUT, RPCbuffer().putString(id2).putString("source").putArray(sample(0u)));
+    client.send(RPCop::RUN, RPCbuffer().putString(id2).putUInt32(2u));
+    UInt32 last = 0u;
+    for (size_t i = 1u; i <= 5u; i++) {
+      client.send(RPCop::SET_INPUT, RPCbuffer().putString(id2).putString("source").putArray(sample(i)));
+      client.send(RPCop::RUN, RPCbuffer().putString(id2).putUInt32(1u));
+      last = client.send(RPCop::GET_OUTPUT, RPCbuffer().putString(id2).putString("tm").putString("anomaly"));
+    }
+    EXPECT_EQ(client.receive(last).getArray().asVector<Real32>(), anomaly.asVector<Real32>());
+
+    // An error in a pipeline is thrown by receive() of that or a later request.
+    client.send(RPCop::RUN, RPCbuffer().putString("nosuchid").putUInt32(1u));
+    last = client.send(RPCop::RUN, RPCbuffer().putString(id2).putUInt32(1u));
+    EXPECT_ANY_THROW(client.receive(last));
+    client.run(id); // as the RUN of id2 after the error
+
+    // A batch gives the same results as single iterations.
+    std::vector<Array> inputs;
+    std::vector<Array> expected;
+    for (size_t i = 6u; i < 10u; i++) {
+      inputs.push_back(sample(i));
+      client.setInput(id, "source", sample(i));
+      client.run(id);
+      expected.push_back(client.getOutput(id, "sp", "bottomUpOut"));
+    }
+    const auto batch = client.runBatch(id2, "source", inputs, {"sp.bottomUpOut", "tm.anomaly"});
+    ASSERT_EQ(batch.size(), inputs.size());
+    for (size_t i = 0u; i < batch.size(); i++) {
+      ASSERT_EQ(batch[i].size(), 2u);
+      EXPECT_EQ(batch[i][0].getSDR(), expected[i].getSDR()) << "iteration " << i;
+      EXPECT_EQ(batch[i][1].getCount(), 1u);
+    }
+
+    client.deleteNetwork(id2);
+    EXPECT_ANY_THROW(client.run(id2));
+    client.deleteNetwork(id);
+    EXPECT_NO_THROW(client.stopServer()) << "the server replies before it closes the connection";
+  }
+  serverThread.join();
+  EXPECT_FALSE(server.isListening());
+  EXPECT_ANY_THROW(RPCclient client(address)) << "socket file removed";
+}
+
+
+TEST(RPCTest, pipelineFillsBuffers) {
+  // Many more requests and results than the socket buffers hold, sent
+  // without reading any result until the last one.
+  RPCserver server;
+  std::thread serverThread = startServer(server, address);
+  {
+    RPCclient client(address);
+    const std::string id = client.createNetwork(config);
+    client.setInput(id, "source", sample(1u));
+    client.run(id);
+    const SDR encoded = client.getOutput(id, "encoder", "encoded").getSDR();
+
+    UInt32 last = 0u;
+    for (size_t i = 0u; i < 20000u; i++)
+      last = client.send(RPCop::GET_OUTPUT, RPCbuffer().putString(id).putString("encoder").putString("encoded"));
+    EXPECT_EQ(client.receive(last).getArray().getSDR(), encoded);
+    client.stopServer();
+  }
+  serverThread.join();
+}
+
+
+TEST(RPCTest, tcp) {
+  RPCserver server;
+  std::thread serverThread = startServer(server, "tcp://127.0.0.1:8051");
+  {
+    RPCclient client("tcp://127.0.0.1:8051");
+    const std::string id = client.createNetwork(config);
+    client.setInput(id, "source", sample(1u));
+    client.run(id, 3u);
+    EXPECT_EQ(client.getOutput(id, "tm", "anomaly").getCount(), 1u);
+  }
+  server.stop();
+  serverThread.join();
+
+  // An empty host is the loopback interface.
+  std::thread loopbackThread = startServer(server, "tcp://:8052");
+  {
+    RPCclient client("tcp://:8052");
+    EXPECT_FALSE(client.createNetwork(config).empty());
+  }
+  server.stop();
+  loopbackThread.join();
+}
+
+#endif // NTA_OS_WINDOWS
+
+} // namespace testing
@@ -0,0 +1,119 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+/** @file
+ * Implementation of the TraceRecorder / TraceReplayer test
+ */
+
+#include <fstream>
+#include <string>
+
+#include <htm/engine/Network.hpp>
+#include <htm/engine/Region.hpp>
+#include <htm/engine/Trace.hpp>
+#include <htm/os/Directory.hpp>
+#include <htm/types/Sdr.hpp>
+#include <htm/utils/Random.hpp>
+
+#include <gtest/gtest.h>
+
+namespace testing {
+
+using namespace htm;
+
+static void buildNetwork(Network &net) {
+  net.addRegion("sp", "SPRegion", "{dim: [200], seed: 42}");
+  net.addRegion("tm", "TMRegion", "{seed: 42}");
+  net.link("sp", "tm");
+  net.link("INPUT", "sp", "", "{dim: 100}", "app_source", "bottomUpIn");
+  net.initialize();
+}
+
+TEST(TraceTest, RecordAndReplay) {
+  Directory::removeTree("TestOutputDir", true);
+  Network net1;
+  buildNetwork(net1);
+  net1.run(1); // the snapshot is taken after this iteration.
+
+  Random rng(7);
+  SDR input({100});
+  {
+    TraceRecorder trace("TestOutputDir/workload.trace", true);
+    trace.attachToNetwork(net1);
+    for (int i = 0; i < 10; i++) {
+      input.randomize(0.1f, rng);
+      net1.setInputData("app_source", Array(input));
+      net1.run(2); // the second iteration has an unchanged input.
+    }
+    trace.detachFromNetwork(net1);
+    net1.run(1); // not recorded
+    EXPECT_EQ(trace.getFrameCount(), 20u);
+  }
+
+  TraceReplayer replay("TestOutputDir/workload.trace");
+  ASSERT_EQ(replay.getInputNames(), std::vector<std::string>({"app_source"}));
+  EXPECT_TRUE(replay.hasOutputs());
+
+  Network net2;
+  TraceReplayReport report = replay.replay(net2);
+  EXPECT_EQ(report.iterations, 20u);
+  EXPECT_EQ(report.mismatches, 0u) << report.firstMismatch;
+  EXPECT_TRUE(report.firstMismatch.empty());
+
+  // The replayed network is in the state of net1 before the last run.
+  net2.run(1);
+  EXPECT_EQ(net1.getRegion("tm")->getOutputData("bottomUpOut"),
+            net2.getRegion("tm")->getOutputData("bottomUpOut"));
+}
+
+TEST(TraceTest, InputsOnly) {
+  Directory::removeTree("TestOutputDir", true);
+  Network net1;
+  buildNetwork(net1);
+
+  SDR input({100});
+  TraceRecorder trace("TestOutputDir/inputs.trace");
+  trace.attachToNetwork(net1);
+  for (UInt i = 0; i < 5; i++) {
+    input.setSparse(SDR_sparse_t({i, i + 10u, i + 20u}));
+    net1.setInputData("app_source", Array(input));
+    net1.run(1);
+  }
+  trace.close();
+
+  TraceReplayer replay("TestOutputDir/inputs.trace");
+  EXPECT_FALSE(replay.hasOutputs());
+  EXPECT_TRUE(replay.getOutputNames().empty());
+  Network net2;
+  TraceReplayReport report = replay.replay(net2);
+  EXPECT_EQ(report.iterations, 5u);
+  EXPECT_EQ(report.mismatches, 0u);
+  EXPECT_EQ(net1.getRegion("sp")->getOutputData("bottomUpOut"),
+            net2.getRegion("sp")->getOutputData("bottomUpOut"));
+}
+
+TEST(TraceTest, NotATrace) {
+  Directory::removeTree("TestOutputDir", true);
+  Directory::create("TestOutputDir", false, true);
+  std::ofstream f("TestOutputDir/garbage.trace");
+  f << "not a trace";
+  f.close();
+  EXPECT_THROW(TraceReplayer("TestOutputDir/garbage.trace"), htm::Exception);
+  EXPECT_THROW(TraceReplayer("TestOutputDir/missing.trace"), htm::Exception);
+}
+
+} // namespace testing
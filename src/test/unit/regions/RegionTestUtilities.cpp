@@ -137,6 +137,27 @@ void checkGetSetAgainstSpec(std::shared_ptr<Region> region1, size_t expectedSpec
           break;
         }
 
+        case NTA_BasicType_UInt64: {
+          VERBOSE << "Parameter \"" << name << "\" type: " << BasicType::getName(p.second.dataType) << std::endl;
+          // check the getter.
+          UInt64 v = region1->getParameterUInt64(name);
+          if (!p.second.defaultValue.empty()) {
+            UInt64 d = std::stoull(p.second.defaultValue, nullptr, 0);
+            EXPECT_EQ(v, d) << "Failure: Parameter \"" << name
+                                << "\" Actual value does not match default. Expected=" << d << ", Actual=" << v;
+          }
+          // check the setter.
+          if (p.second.accessMode == ParameterSpec::ReadWriteAccess) {
+            if (p.second.constraints == "") {
+              region1->setParameterUInt64(name, 0xFFFFFFFFFFFFFFFF); // set max value
+              UInt64 s = region1->getParameterUInt64(name);
+              EXPECT_EQ(s, 0xFFFFFFFFFFFFFFFF)
+                  << "Parameter \"" << name << "\" Actual value does not match UInt64 max.";
+              region1->setParameterUInt64(name, v); // return to original value.
+            }
+          }
+          break;
+        }
         case NTA_BasicType_Real32: {
           VERBOSE << "Parameter \"" << name << "\" type: " << BasicType::getName(p.second.dataType) << std::endl;
           // check the getter.
@@ -69,7 +69,7 @@
 static bool verbose = false;  // turn this on to print extra stuff for debugging the test.
 
 // The following string should contain a valid expected Spec length - manually verified. 
-const UInt EXPECTED_SPEC_COUNT =  20u;  // The number of parameters expected in the SPRegion Spec
+const UInt EXPECTED_SPEC_COUNT =  21u;  // The number of parameters expected in the SPRegion Spec
 
 using namespace htm;
 namespace testing 
@@ -405,6 +405,7 @@ TEST(SPRegionTest, testGetParameters)
   "wrapAround": true,
   "learningMode": 1,
   "activeOutputCount": 0,
+  "numSynapses": 0,
   "spatialImp": null
 })";
 
@@ -434,6 +435,7 @@ TEST(SPRegionTest, testGetParameters)
   "wrapAround": true,
   "learningMode": 1,
   "activeOutputCount": 100,
+  "numSynapses": 500,
   "spatialImp": null
 })";
 
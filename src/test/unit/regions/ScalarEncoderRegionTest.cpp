@@ -390,6 +390,75 @@ namespace testing
     EXPECT_STREQ(json.c_str(), expected.c_str());
   }
 
+  TEST(ScalarEncoderRegionTest, testSkipUnchanged) {
+    // The encoder is pure, so Network::run() computes it only when the
+    // sensedValue changes.  The SP downstream is not pure, even without
+    // learning, because its compute() advances the SP iteration counter.
+    Network net;
+    auto encoder = net.addRegion("encoder", "ScalarEncoderRegion", "{n: 100, w: 4}");
+    auto sp = net.addRegion("sp", "SPRegion", "{columnCount: 200, learningMode: 0}");
+    net.link("encoder", "sp");
+    net.initialize();
+    encoder->enableProfiling();
+    sp->enableProfiling();
+
+    // The compute timer also times the finishRun() at the end of each run().
+    UInt64 runs = 0u;
+    auto computes = [&runs](std::shared_ptr<Region> region) {
+      return region->getComputeTimer().getStartCount() - runs;
+    };
+
+    encoder->setParameterReal64("sensedValue", 0.5);
+    net.run(3); runs++;
+    EXPECT_EQ(1u, computes(encoder));
+    EXPECT_EQ(3u, computes(sp));
+    const SDR first = sp->getOutputData("bottomUpOut").getSDR();
+
+    encoder->setParameterReal64("sensedValue", 0.5); // same value
+    net.run(1); runs++;
+    EXPECT_EQ(1u, computes(encoder));
+    EXPECT_EQ(4u, computes(sp));
+
+    encoder->setParameterReal64("sensedValue", -0.5);
+    net.run(2); runs++;
+    EXPECT_EQ(2u, computes(encoder));
+    EXPECT_EQ(6u, computes(sp));
+
+    encoder->setParameterReal64("sensedValue", 0.5);
+    net.run(1); runs++;
+    EXPECT_EQ(3u, computes(encoder));
+    EXPECT_EQ(7u, computes(sp));
+    EXPECT_EQ(first, sp->getOutputData("bottomUpOut").getSDR());
+  }
+
+  TEST(ScalarEncoderRegionTest, testSkipKeepsDownstreamState) {
+    // Skipping the pure encoder must not change the state of the SP
+    // downstream, compared to a Network which computes every region.
+    auto build = [](Network &net) {
+      net.addRegion("encoder", "ScalarEncoderRegion", "{n: 100, w: 4}");
+      net.addRegion("sp", "SPRegion", "{columnCount: 200, learningMode: 0}");
+      net.link("encoder", "sp");
+      net.initialize();
+    };
+    Network skipping;
+    build(skipping);
+    Network plain;
+    build(plain);
+
+    const Real64 values[] = {0.5, 0.5, 0.5, -0.5, -0.5, 0.5};
+    for (const Real64 value : values) {
+      skipping.getRegion("encoder")->setParameterReal64("sensedValue", value);
+      skipping.run(1);
+      // Setting a parameter forces the next compute, so plain computes every region.
+      plain.getRegion("encoder")->setParameterReal64("sensedValue", value + 1.0);
+      plain.getRegion("encoder")->setParameterReal64("sensedValue", value);
+      plain.run(1);
+    }
+    EXPECT_EQ(plain.getRegion("sp")->getOutputData("bottomUpOut").getSDR(),
+              skipping.getRegion("sp")->getOutputData("bottomUpOut").getSDR());
+    EXPECT_TRUE(*plain.getRegion("sp") == *skipping.getRegion("sp"));
+  }
+
   TEST(ScalarEncoderRegionTest, getParameters) {
     std::string expected = R"({
   "sensedValue": -1.000000,
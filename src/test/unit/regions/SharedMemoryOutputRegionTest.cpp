@@ -0,0 +1,317 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#if !defined(NTA_OS_WINDOWS)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <htm/engine/Network.hpp>
+#include <htm/os/SharedMemory.hpp>
+#include <htm/regions/SharedMemoryInputRegion.hpp>
+#include <htm/regions/SharedMemoryOutputRegion.hpp>
+
+namespace testing {
+
+using namespace htm;
+
+#if !defined(NTA_OS_WINDOWS)
+
+TEST(SharedMemoryOutputRegionTest, ringBuffer) {
+  Real64 values[3] = {1.0, 2.0, 3.0};
+  Byte   bits[8]   = {0, 1, 0, 1, 0, 0, 0, 1};
+  SharedMemoryWriter writer("htm.test.ring",
+                            {{"values", NTA_BasicType_Real64, 3u, 0u},
+                             {"bits",   NTA_BasicType_Byte,   8u, 0u}},
+                            4u);
+  EXPECT_EQ("/htm.test.ring", writer.getName());
+
+  SharedMemoryReader reader("/htm.test.ring");
+  ASSERT_EQ(2u, reader.getChannels().size());
+  EXPECT_EQ("bits", reader.getChannels()[1].name);
+  EXPECT_EQ(NTA_BasicType_Real64, reader.getChannels()[0].type);
+  EXPECT_EQ(8u, reader.getChannels()[1].count);
+  EXPECT_EQ(4u, reader.getSlots());
+  EXPECT_EQ(0u, reader.getFrameCount());
+
+  SharedMemoryFrame frame;
+  EXPECT_FALSE(reader.read(0u, frame)) << "nothing published yet";
+
+  for (int i = 0; i < 6; i++) {
+    values[0] = static_cast<Real64>(i);
+    writer.publish({values, bits});
+  }
+  EXPECT_EQ(6u, reader.getFrameCount());
+  EXPECT_FALSE(reader.read(1u, frame)) << "overwritten by frame 5";
+
+  ASSERT_TRUE(reader.read(5u, frame));
+  const Real64 *v = static_cast<const Real64 *>(frame.getChannel(0));
+  EXPECT_EQ(5.0, v[0]);
+  EXPECT_EQ(3.0, v[2]);
+  EXPECT_EQ(0, memcmp(bits, frame.getChannel(1), sizeof(bits)));
+  EXPECT_TRUE(reader.isValid(frame));
+
+  // The slot is reused while the frame is held.
+  ASSERT_TRUE(reader.read(2u, frame));
+  writer.publish({values, bits});
+  EXPECT_FALSE(reader.isValid(frame));
+}
+
+TEST(SharedMemoryOutputRegionTest, publishInputs) {
+  {
+    Network net;
+    auto encoder = net.addRegion("encoder", "ScalarEncoderRegion",
+                                 "{size: 100, activeBits: 10, minValue: 0, maxValue: 10}");
+    auto output  = net.addRegion("shm", "SharedMemoryOutputRegion",
+                                 "{name: 'htm.test.region', slots: 4}");
+    net.link("encoder", "shm", "", "", "bucket", "dataIn");
+    net.link("encoder", "shm", "", "", "encoded", "sdrIn");
+    net.initialize();
+    EXPECT_EQ("htm.test.region", output->getParameterString("name"));
+
+    SharedMemoryReader reader("htm.test.region");
+    ASSERT_EQ(2u, reader.getChannels().size());
+    EXPECT_EQ("dataIn", reader.getChannels()[0].name);
+    EXPECT_EQ("sdrIn",  reader.getChannels()[1].name);
+    EXPECT_EQ(100u, reader.getChannels()[1].count);
+
+    for (int i = 0; i < 5; i++) {
+      encoder->setParameterReal64("sensedValue", static_cast<Real64>(i));
+      net.run(1);
+
+      SharedMemoryFrame frame;
+      ASSERT_TRUE(reader.read(reader.getFrameCount() - 1u, frame));
+      EXPECT_EQ(static_cast<UInt64>(i), frame.getFrame());
+      const Real64 bucket = ((const Real64 *)encoder->getOutputData("bucket").getBuffer())[0];
+      EXPECT_EQ(bucket, *static_cast<const Real64 *>(frame.getChannel(0)));
+      const SDR &encoded = encoder->getOutputData("encoded").getSDR();
+      EXPECT_EQ(0, memcmp(encoded.getDense().data(), frame.getChannel(1), encoded.size));
+      EXPECT_TRUE(reader.isValid(frame));
+    }
+    EXPECT_EQ(5u, output->getParameterUInt64("frameCount"));
+  }
+  // The shared memory is removed with the region.
+  EXPECT_ANY_THROW(SharedMemoryReader("htm.test.region"));
+}
+
+TEST(SharedMemoryOutputRegionTest, defaultName) {
+  Network net;
+  net.addRegion("encoder", "ScalarEncoderRegion",
+                "{size: 100, activeBits: 10, minValue: 0, maxValue: 10}");
+  auto output = net.addRegion("tap", "SharedMemoryOutputRegion", "");
+  const std::string name = output->getParameterString("name");
+  EXPECT_EQ("/htm.", name.substr(0u, 5u));
+  EXPECT_EQ(".tap", name.substr(name.size() - 4u));
+  net.link("encoder", "tap", "", "", "encoded", "sdrIn");
+  net.initialize();
+  SharedMemoryReader reader(name);
+  EXPECT_EQ(1u, reader.getChannels().size());
+  EXPECT_ANY_THROW(output->setParameterUInt32("slots", 8u)) << "fixed after initialize";
+
+  // Another Network, as in a parameter sweep, gets its own ring.
+  Network other;
+  other.addRegion("encoder", "ScalarEncoderRegion",
+                  "{size: 100, activeBits: 10, minValue: 0, maxValue: 10}");
+  auto otherOutput = other.addRegion("tap", "SharedMemoryOutputRegion", "");
+  other.link("encoder", "tap", "", "", "encoded", "sdrIn");
+  other.initialize();
+  EXPECT_NE(name, otherOutput->getParameterString("name"));
+  EXPECT_TRUE(reader.isCurrent());
+}
+
+TEST(SharedMemoryOutputRegionTest, noInputs) {
+  Network net;
+  net.addRegion("tap", "SharedMemoryOutputRegion", "");
+  EXPECT_ANY_THROW(net.initialize());
+}
+
+TEST(SharedMemoryOutputRegionTest, flowControl) {
+  Real64 value = 1.0;
+  SharedMemoryWriter writer("htm.test.flow", {{"value", NTA_BasicType_Real64, 1u, 0u}}, 2u, true);
+  writer.setTimeout(50u);
+  SharedMemoryReader reader("htm.test.flow", true);
+
+  writer.publish({&value});
+  writer.publish({&value});
+  EXPECT_ANY_THROW(writer.publish({&value})) << "both slots hold unacknowledged frames";
+  EXPECT_EQ(2u, writer.getFrameCount());
+
+  reader.acknowledge(0u);
+  EXPECT_EQ(1u, reader.getAcknowledgedCount());
+  value = 2.0;
+  writer.publish({&value}); // reuses the slot of frame 0
+  EXPECT_TRUE(reader.waitFor(2u, 0u));
+  EXPECT_FALSE(reader.waitFor(3u, 10u)) << "not published";
+  SharedMemoryFrame frame;
+  ASSERT_TRUE(reader.read(2u, frame));
+  EXPECT_EQ(2.0, *static_cast<const Real64 *>(frame.getChannel(0)));
+
+  SharedMemoryReader readOnly("htm.test.flow");
+  EXPECT_ANY_THROW(readOnly.acknowledge(2u));
+}
+
+TEST(SharedMemoryOutputRegionTest, inputRegion) {
+  // Two Networks connected by a ring, as if in two processes.
+  Network source;
+  auto encoder = source.addRegion("encoder", "ScalarEncoderRegion",
+                                  "{size: 100, activeBits: 10, minValue: 0, maxValue: 10}");
+  source.addRegion("shm", "SharedMemoryOutputRegion",
+                   "{name: 'htm.test.link', slots: 2, flowControl: true, timeout: 100}");
+  source.link("encoder", "shm", "", "", "bucket", "dataIn");
+  source.link("encoder", "shm", "", "", "encoded", "sdrIn");
+  source.initialize();
+
+  Network sink;
+  auto input = sink.addRegion("shm", "SharedMemoryInputRegion", "{name: 'htm.test.link', timeout: 100}");
+  sink.initialize();
+  EXPECT_EQ(100u, input->getOutputData("sdrOut").getCount());
+  EXPECT_EQ(1u, input->getOutputData("dataOut").getCount());
+
+  for (int i = 0; i < 5; i++) {
+    encoder->setParameterReal64("sensedValue", static_cast<Real64>(i));
+    source.run(1);
+    sink.run(1);
+    EXPECT_EQ(encoder->getOutputData("encoded").getSDR(), input->getOutputData("sdrOut").getSDR());
+    EXPECT_EQ(((const Real64 *)encoder->getOutputData("bucket").getBuffer())[0],
+              ((const Real64 *)input->getOutputData("dataOut").getBuffer())[0]);
+  }
+  EXPECT_EQ(5u, input->getParameterUInt64("frameCount"));
+
+  // The sink waits for the source, and the source for the sink.
+  EXPECT_ANY_THROW(sink.run(1));
+  source.run(2);
+  EXPECT_ANY_THROW(source.run(1));
+}
+
+TEST(SharedMemoryOutputRegionTest, generation) {
+  const std::vector<SharedMemoryChannel> channels = {{"dataIn", NTA_BasicType_Real64, 1u, 0u}};
+  std::unique_ptr<SharedMemoryWriter> writer(new SharedMemoryWriter("htm.test.generation", channels));
+  SharedMemoryReader reader("htm.test.generation");
+  EXPECT_NE(0u, reader.getGeneration());
+  EXPECT_EQ(writer->getGeneration(), reader.getGeneration());
+  EXPECT_TRUE(reader.isCurrent());
+
+  std::unique_ptr<SharedMemoryWriter> replacement(new SharedMemoryWriter("htm.test.generation", channels));
+  EXPECT_FALSE(reader.isCurrent()) << "replaced by a new writer";
+  EXPECT_NE(replacement->getGeneration(), reader.getGeneration());
+  writer.reset();
+  SharedMemoryReader current("htm.test.generation");
+  EXPECT_EQ(replacement->getGeneration(), current.getGeneration()) << "the old writer leaves the new ring";
+  EXPECT_TRUE(current.isCurrent());
+  replacement.reset();
+  EXPECT_FALSE(current.isCurrent()) << "removed";
+}
+
+// Leave a ring with 'frames' frames of 'value', as a run which crashed.
+static void crashedWriter(const std::string &name, int frames, Real64 value) {
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    SharedMemoryWriter *writer =
+        new SharedMemoryWriter(name, {{"dataIn", NTA_BasicType_Real64, 1u, 0u}}, 4u, true);
+    for (int i = 0; i < frames; i++)
+      writer->publish({&value});
+    _exit(0); // without removing the ring
+  }
+  int status;
+  waitpid(pid, &status, 0);
+}
+
+TEST(SharedMemoryOutputRegionTest, staleRing) {
+  crashedWriter("htm.test.stale", 2, 7.0);
+  SharedMemoryReader stale("htm.test.stale");
+  EXPECT_EQ(2u, stale.getFrameCount());
+  EXPECT_FALSE(stale.isCurrent()) << "its writer is not running";
+
+  Network early;
+  early.addRegion("shm", "SharedMemoryInputRegion", "{name: 'htm.test.stale', timeout: 50}");
+  EXPECT_ANY_THROW(early.initialize()) << "the stale ring is not used";
+
+  // A writer which starts while the sink waits replaces the stale ring.
+  Network sink;
+  auto input = sink.addRegion("shm", "SharedMemoryInputRegion", "{name: 'htm.test.stale', timeout: 5000}");
+  std::unique_ptr<SharedMemoryWriter> writer;
+  Real64 value = 1.0;
+  std::thread start([&writer, &value]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    writer.reset(new SharedMemoryWriter("htm.test.stale", {{"dataIn", NTA_BasicType_Real64, 1u, 0u}}, 4u, true));
+    writer->publish({&value});
+  });
+  sink.initialize();
+  start.join();
+  sink.run(1);
+  EXPECT_EQ(1.0, ((const Real64 *)input->getOutputData("dataOut").getBuffer())[0]);
+  EXPECT_EQ(1u, input->getParameterUInt64("frameCount"));
+}
+
+TEST(SharedMemoryOutputRegionTest, restartedWriter) {
+  const std::vector<SharedMemoryChannel> channels = {{"dataIn", NTA_BasicType_Real64, 1u, 0u}};
+  Real64 value = 1.0;
+  std::unique_ptr<SharedMemoryWriter> writer(new SharedMemoryWriter("htm.test.restart", channels, 4u, true));
+  writer->publish({&value});
+
+  Network sink;
+  auto input = sink.addRegion("shm", "SharedMemoryInputRegion", "{name: 'htm.test.restart', timeout: 5000}");
+  sink.initialize();
+  sink.run(1);
+  EXPECT_EQ(1.0, ((const Real64 *)input->getOutputData("dataOut").getBuffer())[0]);
+
+  // The writer restarts while the sink waits for its next frame.
+  std::thread restart([&writer, &value, &channels]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    writer.reset();
+    writer.reset(new SharedMemoryWriter("htm.test.restart", channels, 4u, true));
+    value = 2.0;
+    writer->publish({&value});
+  });
+  sink.run(1);
+  restart.join();
+  EXPECT_EQ(2.0, ((const Real64 *)input->getOutputData("dataOut").getBuffer())[0]);
+  EXPECT_EQ(1u, input->getParameterUInt64("frameCount")) << "counting the frames of the new writer";
+
+  // A writer with other channels cannot be followed.
+  std::thread resize([&writer]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    writer.reset(new SharedMemoryWriter("htm.test.restart", {{"dataIn", NTA_BasicType_Real64, 3u, 0u}}, 4u, true));
+  });
+  EXPECT_ANY_THROW(sink.run(1));
+  resize.join();
+}
+
+TEST(SharedMemoryOutputRegionTest, nameTooLong) {
+  const std::string name(SharedMemoryWriter::maxNameLength(), 'x'); // and the leading '/'
+  const std::vector<SharedMemoryChannel> channels = {{"dataIn", NTA_BasicType_Real64, 1u, 0u}};
+  EXPECT_ANY_THROW(SharedMemoryWriter writer(name, channels));
+  EXPECT_ANY_THROW(SharedMemoryReader reader(name));
+}
+
+TEST(SharedMemoryOutputRegionTest, noWriter) {
+  Network sink;
+  sink.addRegion("shm", "SharedMemoryInputRegion", "{name: 'htm.test.nowriter', timeout: 50}");
+  EXPECT_ANY_THROW(sink.initialize());
+}
+
+#endif
+
+} // namespace testing
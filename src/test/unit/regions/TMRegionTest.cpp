@@ -71,7 +71,7 @@ static bool verbose = false; // turn this on to print extra stuff for debugging
 
 // The following string should contain a valid expected Spec - manually
 // verified.
-#define EXPECTED_SPEC_COUNT 18 // The number of parameters expected in the TMRegion Spec
+#define EXPECTED_SPEC_COUNT 19 // The number of parameters expected in the TMRegion Spec
 
 using namespace htm;
 
@@ -450,6 +450,7 @@ TEST(TMRegionTest, testGetParameters) {
   "inputWidth": 0,
   "learningMode": true,
   "activeOutputCount": 0,
+  "numSynapses": 0,
   "anomaly": -1.000000,
   "orColumnOutputs": false
 })";
@@ -476,6 +477,7 @@ TEST(TMRegionTest, testGetParameters) {
   "inputWidth": 100,
   "learningMode": true,
   "activeOutputCount": 0,
+  "numSynapses": 0,
   "anomaly": -1.000000,
   "orColumnOutputs": false
 })";
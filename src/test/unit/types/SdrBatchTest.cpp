@@ -0,0 +1,128 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * ---------------------------------------------------------------------- */
+
+#include <gtest/gtest.h>
+#include <htm/types/SdrBatch.hpp>
+#include <sstream>
+#include <vector>
+
+namespace testing {
+
+using namespace std;
+using namespace htm;
+
+TEST(SdrBatchTest, TestPushBackAndGet) {
+    SDRBatch batch({ 4, 5 });
+    ASSERT_EQ( batch.sdrSize(), 20u );
+    ASSERT_TRUE( batch.empty() );
+
+    SDR A({ 4, 5 });
+    A.setSparse(SDR_sparse_t({ 1, 4, 19 }));
+    SDR B({ 4, 5 });
+    batch.push_back( A );
+    batch.push_back( B );
+    const ElemSparse C[] = { 0, 7 };
+    batch.push_back( C, 2u );
+
+    ASSERT_EQ( batch.size(), 3u );
+    ASSERT_EQ( batch.indices(), SDR_sparse_t({ 1, 4, 19, 0, 7 }) );
+    ASSERT_EQ( batch.offsets(), vector<UInt64>({ 0, 3, 3, 5 }) );
+    ASSERT_EQ( batch.rowSize( 1 ), 0u );
+
+    SDR out({ 4, 5 });
+    batch.get( 0, out );
+    ASSERT_EQ( out, A );
+    batch.get( 1, out );
+    ASSERT_EQ( out, B );
+    batch.get( 2, out );
+    ASSERT_EQ( out.getSparse(), SDR_sparse_t({ 0, 7 }) );
+
+    ASSERT_ANY_THROW( batch.get( 3, out ) );
+    SDR wrongDims({ 20 });
+    ASSERT_ANY_THROW( batch.get( 0, wrongDims ) );
+    ASSERT_ANY_THROW( batch.push_back( wrongDims ) );
+
+    batch.clear();
+    ASSERT_TRUE( batch.empty() );
+    ASSERT_TRUE( batch.indices().empty() );
+}
+
+TEST(SdrBatchTest, TestValidation) {
+    SDRBatch batch({ 10 });
+    const ElemSparse unsorted[]   = { 3, 2 };
+    const ElemSparse duplicates[] = { 2, 2 };
+    const ElemSparse outOfRange[] = { 2, 10 };
+    ASSERT_ANY_THROW( batch.push_back( unsorted,   2u ) );
+    ASSERT_ANY_THROW( batch.push_back( duplicates, 2u ) );
+    ASSERT_ANY_THROW( batch.push_back( outOfRange, 2u ) );
+    ASSERT_TRUE( batch.empty() );
+
+    SDR_sparse_t        indices = { 1, 2, 0, 9 };
+    vector<UInt64>      offsets = { 0, 2, 4 };
+    SDRBatch csr({ 10 }, indices, offsets);
+    ASSERT_EQ( csr.size(), 2u );
+    ASSERT_EQ( csr.rowSize( 1 ), 2u );
+
+    SDR_sparse_t   badIndices = { 1, 2, 0, 9 };
+    vector<UInt64> badOffsets = { 0, 3, 4 }; // Second row would be { 9 }, first { 1, 2, 0 }.
+    ASSERT_ANY_THROW( SDRBatch({ 10 }, badIndices, badOffsets) );
+    badOffsets = { 0, 2 }; // Does not cover all indices.
+    ASSERT_ANY_THROW( SDRBatch({ 10 }, badIndices, badOffsets) );
+    badOffsets = { 1, 4 };
+    ASSERT_ANY_THROW( SDRBatch({ 10 }, badIndices, badOffsets) );
+}
+
+TEST(SdrBatchTest, TestSerialization) {
+    SDRBatch batch({ 3, 3 });
+    SDR A({ 3, 3 });
+    for( UInt i = 0; i < 5; i++ ) {
+        A.setSparse(SDR_sparse_t({ i, i + 2, 8 }));
+        batch.push_back( A );
+    }
+    stringstream ss;
+    batch.save( ss );
+    SDRBatch loaded;
+    loaded.load( ss );
+    ASSERT_EQ( batch, loaded );
+    ASSERT_EQ( loaded.sdrSize(), 9u );
+}
+
+TEST(SdrBatchTest, TestSerializationEmpty) {
+    // A default constructed batch has no dimensions.
+    for( const auto fmt : { SerializableFormat::BINARY, SerializableFormat::JSON } ) {
+        SDRBatch empty;
+        stringstream ss;
+        empty.save( ss, fmt );
+        SDRBatch loaded({ 4 });
+        loaded.push_back( SDR({ 4 }) );
+        loaded.load( ss, fmt );
+        ASSERT_EQ( empty, loaded );
+        ASSERT_TRUE( loaded.empty() );
+        ASSERT_TRUE( loaded.dimensions().empty() );
+    }
+
+    // A batch with dimensions but no SDRs.
+    SDRBatch noRows({ 2, 5 });
+    stringstream ss;
+    noRows.save( ss );
+    SDRBatch loaded;
+    loaded.load( ss );
+    ASSERT_EQ( noRows, loaded );
+    ASSERT_EQ( loaded.sdrSize(), 10u );
+}
+
+} // namespace testing
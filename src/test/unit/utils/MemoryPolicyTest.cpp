@@ -0,0 +1,86 @@
+/* ---------------------------------------------------------------------
+ * HTM Community Edition of NuPIC
+ * Copyright (C) 2020, Numenta, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Affero Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses.
+ * --------------------------------------------------------------------- */
+
+
+/** @file
+ * Unit tests for MemoryPolicy and PolicyAllocator
+ */
+
+#include "gtest/gtest.h"
+
+#include <htm/algorithms/Connections.hpp>
+#include <htm/utils/MemoryPolicy.hpp>
+
+namespace testing {
+
+using namespace htm;
+
+TEST(MemoryPolicyTest, ParseAndToString) {
+  EXPECT_TRUE(MemoryPolicy::parse("default").isDefault());
+  EXPECT_TRUE(MemoryPolicy::parse("").isDefault());
+
+  const auto policy = MemoryPolicy::parse("huge+node:1");
+  EXPECT_TRUE(policy.hugePages);
+  EXPECT_EQ(policy.placement, MemoryPolicy::Placement::NODE);
+  EXPECT_EQ(policy.node, 1);
+
+  for (const std::string str : {"default", "huge", "interleave", "node:0", "huge+interleave"}) {
+    EXPECT_EQ(MemoryPolicy::parse(str).toString(), str);
+  }
+  EXPECT_ANY_THROW(MemoryPolicy::parse("huge+gigantic"));
+}
+
+TEST(MemoryPolicyTest, PolicyVector) {
+  const MemoryPolicy policy = MemoryPolicy::parse("huge+interleave");
+  PolicyVector<UInt> big{PolicyAllocator<UInt>(policy)};
+  // Large enough to be mapped with the policy, the size is not a multiple
+  // of the huge page size.
+  const size_t size = 3u * MemoryPolicy::HUGE_PAGE_SIZE / sizeof(UInt) + 7u;
+  big.resize(size);
+  for (size_t i = 0; i < size; i++)
+    big[i] = static_cast<UInt>(i);
+
+  auto copy = big;
+  EXPECT_EQ(copy.get_allocator().policy, policy);
+  EXPECT_EQ(copy, big);
+  copy.resize(10u);
+  copy.shrink_to_fit();
+  EXPECT_EQ(copy[9], 9u);
+  EXPECT_EQ(big[size - 1u], static_cast<UInt>(size - 1u));
+}
+
+TEST(MemoryPolicyTest, ConnectionsKeepContents) {
+  Connections c(2048u, 0.5f);
+  for (CellIdx cell = 0; cell < 2048u; cell++) {
+    const Segment seg = c.createSegment(cell);
+    for (CellIdx pre = 0; pre < 20u; pre++)
+      c.createSynapse(seg, (cell + pre * 97u) % 2048u, pre % 2u ? 0.4f : 0.6f);
+  }
+  const Connections before = c;
+
+  c.setMemoryPolicy(MemoryPolicy::parse("huge"));
+  EXPECT_TRUE(c.getMemoryPolicy().hugePages);
+  EXPECT_EQ(c, before);
+
+  // Keeps working after the move.
+  const Segment seg = c.createSegment(0u);
+  c.createSynapse(seg, 1u, 0.6f);
+  EXPECT_EQ(c.numSynapses(), before.numSynapses() + 1u);
+  EXPECT_EQ(c.getMemoryPolicy(), MemoryPolicy::parse("huge"));
+}
+
+} // namespace testing
@@ -192,7 +192,7 @@ TEST(SdrMetricsTest, TestAF_Construct) {
     F.mean();
     F.std();
     F.max();
-    ASSERT_EQ( F.activationFrequency.size(), A->size );
+    ASSERT_EQ( F.activationFrequency().size(), A->size );
 
     // Test with junk data.
     A->zero(); A->randomize( 0.5f ); A->randomize( 1.0f ); A->randomize( 0.5f );
@@ -200,7 +200,7 @@ TEST(SdrMetricsTest, TestAF_Construct) {
     F.mean();
     F.std();
     F.max();
-    ASSERT_EQ( F.activationFrequency.size(), A->size );
+    ASSERT_EQ( F.activationFrequency().size(), A->size );
 
     // Test use after freeing parent SDR.
     auto A_size = A->size;
@@ -209,7 +209,7 @@ TEST(SdrMetricsTest, TestAF_Construct) {
     F.mean();
     F.std();
     F.max();
-    ASSERT_EQ( F.activationFrequency.size(), A_size );
+    ASSERT_EQ( F.activationFrequency().size(), A_size );
 }
 
 /**
@@ -221,16 +221,16 @@ TEST(SdrMetricsTest, TestAF_Example) {
     ActivationFrequency F( A, 10u );
 
     A.setDense(SDR_dense_t{ 0, 0 });
-    ASSERT_EQ( F.activationFrequency, vector<Real>({ 0.0f, 0.0f }));
+    ASSERT_EQ( F.activationFrequency(), vector<Real>({ 0.0f, 0.0f }));
 
     A.setDense(SDR_dense_t{ 1, 1 });
-    ASSERT_EQ( F.activationFrequency, vector<Real>({ 0.5f, 0.5f }));
+    ASSERT_EQ( F.activationFrequency(), vector<Real>({ 0.5f, 0.5f }));
 
     A.setDense(SDR_dense_t{ 0, 1 });
-    ASSERT_NEAR( F.activationFrequency[0], 0.3333333333333333f, 0.001f );
-    ASSERT_NEAR( F.activationFrequency[1], 0.6666666666666666f, 0.001f );
-    ASSERT_EQ( F.min(), F.activationFrequency[0] );
-    ASSERT_EQ( F.max(), F.activationFrequency[1] );
+    ASSERT_NEAR( F.activationFrequency()[0], 0.3333333333333333f, 0.001f );
+    ASSERT_NEAR( F.activationFrequency()[1], 0.6666666666666666f, 0.001f );
+    ASSERT_EQ( F.min(), F.activationFrequency()[0] );
+    ASSERT_EQ( F.max(), F.activationFrequency()[1] );
     ASSERT_FLOAT_EQ( F.mean(), 0.5f );
     ASSERT_NEAR( F.std(), 0.16666666666666666f, 0.001f );
     ASSERT_NEAR( F.entropy(), 0.9182958340544896f, 0.001f );
@@ -333,6 +333,37 @@ TEST(SdrMetricsTest, TestAF_Print) {
     VERBOSE << ss.str() << std::endl;
 }
 
+/*
+ * ActivationFrequency
+ * The lazy decay must match decaying every frequency on every update.
+ */
+TEST(SdrMetricsTest, TestAF_LazyDecay) {
+    const UInt size   = 100u;
+    const UInt period = 20u;
+    Random rng( 42 );
+    for(const Real initialValue : { -1.0f, 0.1f }) {
+        SDR A({ size });
+        ActivationFrequency F( A, period, initialValue );
+        vector<Real> expected( size, initialValue == -1.0f ? 1234.567f : initialValue );
+        for(UInt sample = 1u; sample <= 100u; sample++) {
+            A.randomize( 0.05f, rng );
+            const Real alpha = initialValue == -1.0f ? 1.0f / std::min( period, sample )
+                                                     : 1.0f / period;
+            for(auto &value : expected)
+                value *= 1.0f - alpha;
+            for(const auto &idx : A.getSparse())
+                expected[idx] += alpha;
+
+            // Read only now and then, so that some frequencies lag many samples behind.
+            if( sample % 7u == 0u or sample <= 3u ) {
+                const auto &actual = F.activationFrequency();
+                for(UInt i = 0u; i < size; i++)
+                    ASSERT_NEAR( actual[i], expected[i], 1e-5f ) << "sample " << sample << " bit " << i;
+            }
+        }
+    }
+}
+
 TEST(SdrMetricsTest, TestOverlap_Construct) {
     SDR *A = new SDR({ 1000u });
     Overlap V( *A, 100u );
@@ -557,4 +588,24 @@ TEST(SdrMetricsTest, TestAddData) {
     ASSERT_NEAR( M.overlap.mean(),  0.5f, 0.01f );
     ASSERT_NEAR( M.activationFrequency.mean(), 0.2f, 0.01f );
 }
+
+TEST(SdrMetricsTest, TestMetrics_SampleRate) {
+    SDR A({ 1000u });
+    Metrics M( A, 100u );
+    ASSERT_ANY_THROW( M.setSampleRate( 0u ) );
+    M.setSampleRate( 5u );
+    ASSERT_EQ( M.sparsity.sampleRate, 5u );
+
+    A.randomize( 0.02f );
+    for(auto i = 0u; i < 100u; i++)
+        A.addNoise( 0.5f );
+    // 101 updates, every 5th is measured.
+    ASSERT_EQ( M.sparsity.samples, 20u );
+    ASSERT_EQ( M.activationFrequency.samples, 20u );
+    ASSERT_EQ( M.overlap.samples, 19u ); // the first sample has nothing to overlap with.
+    ASSERT_NEAR( M.sparsity.mean(), 0.02f, 0.001f );
+    ASSERT_NEAR( M.activationFrequency.mean(), 0.02f, 0.001f );
+    // Overlap between every 5th SDR, each step adds 50% noise.
+    ASSERT_LT( M.overlap.mean(), 0.25f );
+}
 }